@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "embedded/circular_buffer_adapter.h"
+#include "embedded/circular_buffer_algorithm.h"
+
+using namespace embedded;
+
+namespace {
+
+constexpr std::size_t capacity = 1024;
+
+// A half-full buffer that wraps around the end of its memory
+template <std::size_t Capacity>
+class filled_buffer {
+ public:
+  filled_buffer()
+      : raw_(capacity)
+      , cba_(raw_.data(), capacity, capacity - capacity / 4, 0) {
+    for (std::size_t i = 0; i < capacity / 2; ++i) {
+      cba_.push_back(static_cast<std::int32_t>(i));
+    }
+  }
+
+  auto get() -> circular_buffer_adapter<std::int32_t, Capacity>& {
+    return cba_;
+  }
+
+ private:
+  std::vector<std::int32_t> raw_;
+  circular_buffer_adapter<std::int32_t, Capacity> cba_;
+};
+
+template <std::size_t Capacity>
+void iterate(benchmark::State& state) {
+  filled_buffer<Capacity> buf;
+  auto& cba = buf.get();
+  for (auto _ : state) {
+    std::int32_t sum = 0;
+    for (auto x : cba) {
+      sum += x;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * cba.size());
+}
+
+template <std::size_t Capacity>
+void index(benchmark::State& state) {
+  filled_buffer<Capacity> buf;
+  auto& cba = buf.get();
+  for (auto _ : state) {
+    std::int32_t sum = 0;
+    for (std::size_t i = 0; i < cba.size(); ++i) {
+      sum += cba[i];
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * cba.size());
+}
+
+template <std::size_t Capacity>
+void accumulate(benchmark::State& state) {
+  filled_buffer<Capacity> buf;
+  auto& cba = buf.get();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::accumulate(cba.begin(), cba.end(), 0));
+  }
+  state.SetItemsProcessed(state.iterations() * cba.size());
+}
+
+template <std::size_t Capacity>
+void accumulate_segmented(benchmark::State& state) {
+  filled_buffer<Capacity> buf;
+  auto& cba = buf.get();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(embedded::accumulate(cba.begin(), cba.end(), 0));
+  }
+  state.SetItemsProcessed(state.iterations() * cba.size());
+}
+
+// FIR-style dot product of the buffer contents with coefficients
+template <std::size_t Capacity>
+void dot(benchmark::State& state) {
+  filled_buffer<Capacity> buf;
+  auto& cba = buf.get();
+  std::vector<std::int32_t> coef(cba.size(), 3);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        std::inner_product(cba.begin(), cba.end(), coef.begin(), 0));
+  }
+  state.SetItemsProcessed(state.iterations() * cba.size());
+}
+
+template <std::size_t Capacity>
+void dot_segmented(benchmark::State& state) {
+  filled_buffer<Capacity> buf;
+  auto& cba = buf.get();
+  std::vector<std::int32_t> coef(cba.size(), 3);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        embedded::inner_product(cba.begin(), cba.end(), coef.begin(), 0));
+  }
+  state.SetItemsProcessed(state.iterations() * cba.size());
+}
+
+// Iterator arithmetic and comparisons
+template <std::size_t Capacity>
+void lower_bound(benchmark::State& state) {
+  filled_buffer<Capacity> buf;
+  auto& cba = buf.get();
+  auto const n = static_cast<std::int32_t>(cba.size());
+  std::int32_t key = 0;
+  for (auto _ : state) {
+    key = (key + 97) % n;
+    benchmark::DoNotOptimize(std::lower_bound(cba.begin(), cba.end(), key));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+template <std::size_t Capacity>
+void push_pop(benchmark::State& state) {
+  filled_buffer<Capacity> buf;
+  auto& cba = buf.get();
+  std::int32_t x = 0;
+  for (auto _ : state) {
+    for (int i = 0; i < 64; ++i) {
+      cba.push_back(x++);
+      benchmark::DoNotOptimize(cba.front());
+      cba.pop_front();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 64);
+}
+
+BENCHMARK_TEMPLATE(iterate, 0)->Name("dynamic/iterate");
+BENCHMARK_TEMPLATE(iterate, capacity)->Name("pow2/iterate");
+BENCHMARK_TEMPLATE(index, 0)->Name("dynamic/index");
+BENCHMARK_TEMPLATE(index, capacity)->Name("pow2/index");
+BENCHMARK_TEMPLATE(accumulate, 0)->Name("dynamic/accumulate");
+BENCHMARK_TEMPLATE(accumulate, capacity)->Name("pow2/accumulate");
+BENCHMARK_TEMPLATE(accumulate_segmented, 0)
+    ->Name("dynamic/accumulate/segmented");
+BENCHMARK_TEMPLATE(accumulate_segmented, capacity)
+    ->Name("pow2/accumulate/segmented");
+BENCHMARK_TEMPLATE(dot, 0)->Name("dynamic/dot");
+BENCHMARK_TEMPLATE(dot, capacity)->Name("pow2/dot");
+BENCHMARK_TEMPLATE(dot_segmented, 0)->Name("dynamic/dot/segmented");
+BENCHMARK_TEMPLATE(dot_segmented, capacity)->Name("pow2/dot/segmented");
+BENCHMARK_TEMPLATE(lower_bound, 0)->Name("dynamic/lower_bound");
+BENCHMARK_TEMPLATE(lower_bound, capacity)->Name("pow2/lower_bound");
+BENCHMARK_TEMPLATE(push_pop, 0)->Name("dynamic/push_pop");
+BENCHMARK_TEMPLATE(push_pop, capacity)->Name("pow2/push_pop");
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,61 @@
+#
+# Copyright (c) Marcus Holland-Moritz
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+#
+
+# Toolchain file for the on-target benchmarks, select the core with
+#
+#   -DCMAKE_TOOLCHAIN_FILE=arm-none-eabi.cmake -DCORTEX_M_CPU=cortex-m4
+#
+# Supported cores are cortex-m0plus, cortex-m4 and cortex-m7.
+
+set(CMAKE_SYSTEM_NAME Generic)
+set(CMAKE_SYSTEM_PROCESSOR arm)
+
+set(CMAKE_C_COMPILER arm-none-eabi-gcc)
+set(CMAKE_CXX_COMPILER arm-none-eabi-g++)
+
+# there's no startup code for a test executable
+set(CMAKE_TRY_COMPILE_TARGET_TYPE STATIC_LIBRARY)
+
+set(CORTEX_M_CPU cortex-m4 CACHE STRING "target core")
+set_property(CACHE CORTEX_M_CPU PROPERTY STRINGS
+             cortex-m0plus cortex-m4 cortex-m7)
+list(APPEND CMAKE_TRY_COMPILE_PLATFORM_VARIABLES CORTEX_M_CPU)
+
+if(CORTEX_M_CPU STREQUAL "cortex-m0plus")
+  set(cpu_flags "-mcpu=cortex-m0plus -mfloat-abi=soft")
+elseif(CORTEX_M_CPU STREQUAL "cortex-m4")
+  set(cpu_flags "-mcpu=cortex-m4 -mfpu=fpv4-sp-d16 -mfloat-abi=hard")
+elseif(CORTEX_M_CPU STREQUAL "cortex-m7")
+  set(cpu_flags "-mcpu=cortex-m7 -mfpu=fpv5-d16 -mfloat-abi=hard")
+else()
+  message(FATAL_ERROR "unsupported CORTEX_M_CPU: ${CORTEX_M_CPU}")
+endif()
+
+set(CMAKE_C_FLAGS_INIT "${cpu_flags} -mthumb")
+set(CMAKE_CXX_FLAGS_INIT
+    "${cpu_flags} -mthumb -fno-exceptions -fno-rtti -fno-threadsafe-statics")
+set(CMAKE_EXE_LINKER_FLAGS_INIT
+    "-nostartfiles --specs=nano.specs --specs=nosys.specs")
+
+set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
+set(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_INCLUDE ONLY)
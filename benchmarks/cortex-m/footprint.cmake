@@ -0,0 +1,53 @@
+#
+# Copyright (c) Marcus Holland-Moritz
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+#
+
+# Extract the code size of each benchmark kernel from the image, run as
+#
+#   cmake -DNM=<nm> -DELF=<image> -DOUTPUT=<file> -P footprint.cmake
+#
+# Each kernel's work is done by a `kernel::...::operator()()` that is
+# never inlined, so its symbol size is the code the kernel adds to the
+# flash footprint (excluding library functions shared with other kernels,
+# e.g. the soft float routines).
+
+execute_process(
+  COMMAND ${NM} --demangle --print-size --size-sort --radix=d ${ELF}
+  OUTPUT_VARIABLE symbols
+  RESULT_VARIABLE result)
+
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "${NM} failed on ${ELF}")
+endif()
+
+string(REPLACE "\n" ";" symbols "${symbols}")
+
+set(pattern "^[0-9]+ ([0-9]+) [tTwW] (kernel::.*::operator\\(\\)\\(\\))$")
+set(report "code,kernel\n")
+foreach(symbol IN LISTS symbols)
+  if(symbol MATCHES "${pattern}")
+    math(EXPR size "${CMAKE_MATCH_1}")
+    string(APPEND report "${size},\"${CMAKE_MATCH_2}\"\n")
+  endif()
+endforeach()
+
+file(WRITE ${OUTPUT} "${report}")
+message(STATUS "kernel code size written to ${OUTPUT}")
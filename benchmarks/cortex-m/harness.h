@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Minimal bare-metal support for the on-target benchmarks: a cycle
+// counter, a line based report channel and the system setup that has to
+// happen before `main()`. Only architectural (core) registers are used,
+// so this works on any Cortex-M part regardless of the vendor.
+
+namespace harness {
+
+/**
+ * Benchmark entry point, called by the reset handler
+ *
+ * This takes the place of `main()`, which C++ doesn't allow to be
+ * called from within the program.
+ */
+void run();
+
+namespace detail {
+
+inline auto reg(std::uintptr_t addr) -> std::uint32_t volatile& {
+  return *reinterpret_cast<std::uint32_t volatile*>(addr);
+}
+
+constexpr std::uintptr_t demcr{0xE000EDFC};
+constexpr std::uintptr_t dwt_ctrl{0xE0001000};
+constexpr std::uintptr_t dwt_cyccnt{0xE0001004};
+constexpr std::uintptr_t dwt_lar{0xE0001FB0};
+constexpr std::uintptr_t syst_csr{0xE000E010};
+constexpr std::uintptr_t syst_rvr{0xE000E014};
+constexpr std::uintptr_t syst_cvr{0xE000E018};
+constexpr std::uintptr_t itm_stim0{0xE0000000};
+constexpr std::uintptr_t itm_ter{0xE0000E00};
+constexpr std::uintptr_t itm_tcr{0xE0000E80};
+constexpr std::uintptr_t cpacr{0xE000ED88};
+constexpr std::uintptr_t ccr{0xE000ED14};
+constexpr std::uintptr_t ccsidr{0xE000ED80};
+constexpr std::uintptr_t csselr{0xE000ED84};
+constexpr std::uintptr_t iciallu{0xE000EF50};
+constexpr std::uintptr_t dcisw{0xE000EF60};
+
+inline void barrier() { __asm__ volatile("dsb\n\tisb" ::: "memory"); }
+
+} // namespace detail
+
+#if defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_8M_BASE__)
+
+/**
+ * Cycle counter based on SysTick
+ *
+ * ARMv6-M and ARMv8-M baseline cores (e.g. Cortex-M0+) have no DWT cycle
+ * counter, but SysTick runs from the core clock, too. It is a 24-bit
+ * down counter, so a single measurement must stay below `max_interval`
+ * cycles.
+ */
+class cycle_counter {
+ public:
+  static constexpr std::uint32_t max_interval{0xFFFFFF};
+
+  static void init() {
+    detail::reg(detail::syst_rvr) = max_interval;
+    detail::reg(detail::syst_cvr) = 0;
+    // enable, no interrupt, processor clock
+    detail::reg(detail::syst_csr) = 0x5;
+  }
+
+  static auto now() -> std::uint32_t {
+    return max_interval - detail::reg(detail::syst_cvr);
+  }
+
+  static auto elapsed(std::uint32_t t0, std::uint32_t t1) -> std::uint32_t {
+    return (t1 - t0) & max_interval;
+  }
+};
+
+#else
+
+/**
+ * Cycle counter based on DWT CYCCNT
+ */
+class cycle_counter {
+ public:
+  static constexpr std::uint32_t max_interval{0xFFFFFFFF};
+
+  static void init() {
+    // TRCENA, enables the DWT and ITM units
+    detail::reg(detail::demcr) |= 1u << 24;
+    // software lock, only implemented on some cores (e.g. Cortex-M7)
+    detail::reg(detail::dwt_lar) = 0xC5ACCE55;
+    detail::reg(detail::dwt_cyccnt) = 0;
+    detail::reg(detail::dwt_ctrl) |= 1u;
+  }
+
+  static auto now() -> std::uint32_t {
+    return detail::reg(detail::dwt_cyccnt);
+  }
+
+  static auto elapsed(std::uint32_t t0, std::uint32_t t1) -> std::uint32_t {
+    return t1 - t0;
+  }
+};
+
+#endif
+
+#ifdef HARNESS_OUTPUT_ITM
+
+// ITM stimulus port 0, usually captured through SWO. The port has to be
+// enabled by the debugger, output is silently dropped otherwise.
+inline void write(char const* str) {
+  if ((detail::reg(detail::itm_tcr) & 1u) == 0 ||
+      (detail::reg(detail::itm_ter) & 1u) == 0) {
+    return;
+  }
+  for (; *str; ++str) {
+    while (detail::reg(detail::itm_stim0) == 0) {
+    }
+    *reinterpret_cast<std::uint8_t volatile*>(detail::itm_stim0) =
+        static_cast<std::uint8_t>(*str);
+  }
+}
+
+[[noreturn]] inline void exit() {
+  for (;;) {
+    __asm__ volatile("wfi");
+  }
+}
+
+#else
+
+namespace detail {
+
+// Semihosting call, see the ARM "Semihosting for AArch32 and AArch64"
+// specification. This traps into the debugger, so it must not be used
+// without a debugger (or simulator) attached.
+inline auto semihost(std::uint32_t op, void const* arg) -> std::uint32_t {
+  std::uint32_t rv;
+  __asm__ volatile("mov r0, %1\n\t"
+                   "mov r1, %2\n\t"
+                   "bkpt 0xab\n\t"
+                   "mov %0, r0"
+                   : "=r"(rv)
+                   : "r"(op), "r"(arg)
+                   : "r0", "r1", "memory");
+  return rv;
+}
+
+constexpr std::uint32_t sys_write0{0x04};
+constexpr std::uint32_t sys_exit{0x18};
+constexpr std::uint32_t adp_stopped_application_exit{0x20026};
+
+} // namespace detail
+
+inline void write(char const* str) {
+  detail::semihost(detail::sys_write0, str);
+}
+
+[[noreturn]] inline void exit() {
+  detail::semihost(detail::sys_exit,
+                   reinterpret_cast<void const*>(
+                       detail::adp_stopped_application_exit));
+  for (;;) {
+  }
+}
+
+#endif
+
+/**
+ * Single line of output
+ *
+ * Formatting is done in a fixed buffer to avoid pulling `printf` into
+ * the image, which would dominate the flash footprint on small parts.
+ */
+class line {
+ public:
+  ~line() {
+    put('\n');
+    buf_[len_] = '\0';
+    write(buf_);
+  }
+
+  auto operator<<(char const* str) -> line& {
+    while (*str) {
+      put(*str++);
+    }
+    return *this;
+  }
+
+  auto operator<<(std::uint32_t value) -> line& {
+    char digits[10];
+    std::size_t n = 0;
+    do {
+      digits[n++] = static_cast<char>('0' + value % 10);
+      value /= 10;
+    } while (value != 0);
+    while (n > 0) {
+      put(digits[--n]);
+    }
+    return *this;
+  }
+
+  // `num / den` with two decimal places
+  auto ratio(std::uint32_t num, std::uint32_t den) -> line& {
+    auto const scaled = static_cast<std::uint32_t>(
+        (std::uint64_t{num} * 100 + den / 2) / den);
+    *this << scaled / 100;
+    put('.');
+    put(static_cast<char>('0' + scaled / 10 % 10));
+    put(static_cast<char>('0' + scaled % 10));
+    return *this;
+  }
+
+ private:
+  void put(char c) {
+    if (len_ < sizeof(buf_) - 1) {
+      buf_[len_++] = c;
+    }
+  }
+
+  char buf_[128];
+  std::size_t len_{0};
+};
+
+/**
+ * Core setup, called from the reset handler before static constructors
+ *
+ * Enables the FPU if the image uses it and, on Cortex-M7, the caches,
+ * as cycle counts with caches disabled would mostly measure flash wait
+ * states.
+ */
+inline void system_init() {
+#if defined(__ARM_FP)
+  detail::reg(detail::cpacr) |= 0xFu << 20;
+  detail::barrier();
+#endif
+
+#ifdef HARNESS_CORTEX_M7
+  // instruction cache
+  detail::barrier();
+  detail::reg(detail::iciallu) = 0;
+  detail::barrier();
+  detail::reg(detail::ccr) |= 1u << 17;
+  detail::barrier();
+
+  // data cache, invalidate by set/way before enabling it
+  detail::reg(detail::csselr) = 0;
+  detail::barrier();
+  std::uint32_t const ccsidr = detail::reg(detail::ccsidr);
+  std::uint32_t const sets = (ccsidr >> 13) & 0x7FFF;
+  std::uint32_t const ways = (ccsidr >> 3) & 0x3FF;
+  for (std::uint32_t s = 0; s <= sets; ++s) {
+    for (std::uint32_t w = 0; w <= ways; ++w) {
+      detail::reg(detail::dcisw) = ((s & 0x1FF) << 5) | ((w & 0x3) << 30);
+    }
+  }
+  detail::barrier();
+  detail::reg(detail::ccr) |= 1u << 16;
+  detail::barrier();
+#endif
+}
+
+/**
+ * Measure a kernel and report it as a single CSV line
+ *
+ * The columns are `name,samples,cycles,cycles/sample,flash,ram`.
+ *
+ * A kernel is a callable that processes `Kernel::samples` items per call
+ * and provides the static storage it uses through `flash()` (read-only
+ * data, e.g. coefficients) and `ram()` (mutable state). Code size is not
+ * known at runtime, it is extracted from the image at build time (see
+ * `footprint.cmake`).
+ *
+ * The kernel is run once to warm up caches and flash accelerators, after
+ * which the fastest of `Repeat` runs is reported, minus the cost of
+ * reading the cycle counter.
+ */
+template <std::size_t Repeat = 8, typename Kernel>
+void measure(char const* name, Kernel& kernel) {
+  std::uint32_t overhead = cycle_counter::max_interval;
+  for (std::size_t i = 0; i < Repeat; ++i) {
+    auto const t0 = cycle_counter::now();
+    auto const t1 = cycle_counter::now();
+    auto const dt = cycle_counter::elapsed(t0, t1);
+    overhead = dt < overhead ? dt : overhead;
+  }
+
+  kernel();
+
+  std::uint32_t best = cycle_counter::max_interval;
+  for (std::size_t i = 0; i < Repeat; ++i) {
+    auto const t0 = cycle_counter::now();
+    kernel();
+    auto const t1 = cycle_counter::now();
+    auto const dt = cycle_counter::elapsed(t0, t1);
+    best = dt < best ? dt : best;
+  }
+  best = best > overhead ? best - overhead : 0;
+
+  auto const samples = static_cast<std::uint32_t>(Kernel::samples);
+  line out;
+  out << name << "," << samples << "," << best << ",";
+  out.ratio(best, samples) << "," << static_cast<std::uint32_t>(kernel.flash())
+                           << "," << static_cast<std::uint32_t>(kernel.ram());
+}
+
+} // namespace harness
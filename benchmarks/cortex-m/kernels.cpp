@@ -0,0 +1,359 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#include "embedded/circular_buffer_adapter.h"
+#include "embedded/function.h"
+#include "embedded/signal/filter.h"
+#include "embedded/signal/fpm.h"
+#include "embedded/signal/order.h"
+#include "embedded/spsc_circular_buffer_adapter.h"
+#include "embedded/varint.h"
+
+#include "harness.h"
+
+namespace kernel {
+
+using fixed = fpm::fixed<std::int32_t, std::int64_t, 24>;
+
+// Small enough for the SysTick counter on Cortex-M0+ even with software
+// floating point, large enough to hide the call overhead
+constexpr std::size_t block_size = 64;
+
+inline auto lcg(std::uint32_t& seed) -> std::uint32_t {
+  seed = seed * 1103515245 + 12345;
+  return seed >> 16 & 0x7fff;
+}
+
+template <typename T>
+void fill(T (&in)[block_size]) {
+  std::uint32_t seed = 1;
+  for (auto& x : in) {
+    x = T(static_cast<double>(lcg(seed)) / 32768.0 - 0.5);
+  }
+}
+
+template <typename Family, std::size_t Order>
+constexpr auto base_design()
+    -> embedded::signal::iirfilter<double>::design<Order> {
+  return embedded::signal::iirfilter<double>(48000.0).lowpass(
+      Family::template prototype<Order>(1.0, 60.0), 1000.0);
+}
+
+template <typename T>
+struct sos_structure_for {
+  using type = embedded::signal::sos_structure::df2t;
+};
+
+template <>
+struct sos_structure_for<fixed> {
+  using type = embedded::signal::sos_structure::df1_wide<>;
+};
+
+template <typename Family, std::size_t Order, typename T>
+struct sos_realization {
+  using structure = typename sos_structure_for<T>::type;
+  using design_type = embedded::signal::sos_design<T, Order, structure>;
+
+  static constexpr design_type design{
+      base_design<Family, Order>().template sos<T, structure>(
+          embedded::signal::sos_gain::distribute)};
+};
+
+template <typename Family, std::size_t Order, typename T>
+constexpr typename sos_realization<Family, Order, T>::design_type
+    sos_realization<Family, Order, T>::design;
+
+// Filter one block sample by sample, or with a single `process()` call
+template <typename Realization, bool Block>
+class sos {
+ public:
+  using design_type = typename Realization::design_type;
+  using value_type = typename design_type::section_type::value_type;
+
+  static constexpr std::size_t samples = block_size;
+
+  sos() { fill(in_); }
+
+  __attribute__((noinline)) void operator()() {
+    if (Block) {
+      filter_.process(in_, out_, block_size);
+    } else {
+      for (std::size_t i = 0; i < block_size; ++i) {
+        out_[i] = filter_(in_[i]);
+      }
+    }
+  }
+
+  static constexpr auto flash() -> std::size_t {
+    return sizeof(Realization::design);
+  }
+
+  static constexpr auto ram() -> std::size_t { return sizeof(instance_type); }
+
+ private:
+  using instance_type = decltype(Realization::design.instance());
+
+  instance_type filter_{Realization::design.instance()};
+  value_type in_[block_size];
+  value_type out_[block_size];
+};
+
+template <typename Family, std::size_t Order, typename T>
+void run_sos(char const* name_sample, char const* name_block) {
+  using realization = sos_realization<Family, Order, T>;
+  static sos<realization, false> per_sample;
+  static sos<realization, true> block;
+  harness::measure(name_sample, per_sample);
+  harness::measure(name_block, block);
+}
+
+// Encode or decode one block of values of mixed encoded length
+template <bool Decode>
+class varint {
+ public:
+  static constexpr std::size_t samples = block_size;
+
+  varint() {
+    std::uint32_t seed = 1;
+    for (auto& v : values_) {
+      v = lcg(seed) << (lcg(seed) % 18);
+    }
+    encode();
+  }
+
+  __attribute__((noinline)) void operator()() {
+    if (Decode) {
+      decode();
+    } else {
+      encode();
+    }
+  }
+
+  static constexpr auto flash() -> std::size_t { return 0; }
+
+  static constexpr auto ram() -> std::size_t {
+    return sizeof(values_) + sizeof(buffer_);
+  }
+
+ private:
+  void encode() {
+    auto it = buffer_;
+    for (auto v : values_) {
+      it = embedded::varint::encode(v, it, buffer_ + sizeof(buffer_));
+    }
+  }
+
+  void decode() {
+    std::uint8_t const* it = buffer_;
+    std::uint8_t const* const end = buffer_ + sizeof(buffer_);
+    for (auto& v : values_) {
+      it = embedded::varint::decode(v, it, end);
+    }
+  }
+
+  std::uint32_t values_[block_size];
+  // maximum encoded size is five bytes per value
+  std::uint8_t buffer_[5 * block_size];
+};
+
+// Call through `embedded::function` with a small capture
+template <typename Layout>
+class function {
+ public:
+  using function_type = embedded::function<std::int32_t(std::int32_t),
+                                           3 * sizeof(void*), alignof(void*),
+                                           Layout>;
+
+  static constexpr std::size_t samples = block_size;
+
+  function()
+      : fn_{[this](std::int32_t x) { return x * scale_ + 1; }} {}
+
+  __attribute__((noinline)) void operator()() {
+    for (std::size_t i = 0; i < block_size; ++i) {
+      acc_ = fn_(acc_);
+    }
+  }
+
+  static constexpr auto flash() -> std::size_t { return 0; }
+  static constexpr auto ram() -> std::size_t { return sizeof(function_type); }
+
+ private:
+  std::int32_t volatile scale_{3};
+  std::int32_t acc_{0};
+  function_type fn_;
+};
+
+// Stream one block through a circular buffer, item by item or in bulk,
+// with a dynamic or a static power-of-two capacity
+template <bool Bulk, std::size_t Capacity = 0>
+class circular_buffer {
+ public:
+  using value_type = std::int16_t;
+  using adapter_type = embedded::circular_buffer_adapter<value_type, Capacity>;
+
+  static constexpr std::size_t capacity = Capacity != 0 ? Capacity : 48;
+  static constexpr std::size_t samples = block_size;
+
+  circular_buffer() {
+    for (std::size_t i = 0; i < block_size; ++i) {
+      in_[i] = static_cast<value_type>(i);
+    }
+  }
+
+  __attribute__((noinline)) void operator()() {
+    constexpr std::size_t chunk = 16;
+    for (std::size_t i = 0; i < block_size; i += chunk) {
+      if (Bulk) {
+        cb_.copy_in_back(in_ + i, chunk);
+        cb_.copy_out_front(out_ + i, chunk);
+      } else {
+        for (std::size_t j = i; j < i + chunk; ++j) {
+          cb_.push_back(in_[j]);
+        }
+        for (std::size_t j = i; j < i + chunk; ++j) {
+          out_[j] = cb_.front();
+          cb_.pop_front();
+        }
+      }
+    }
+  }
+
+  static constexpr auto flash() -> std::size_t { return 0; }
+
+  static constexpr auto ram() -> std::size_t {
+    return sizeof(adapter_type) + sizeof(storage_);
+  }
+
+ private:
+  value_type storage_[capacity];
+  // start in the middle so that both copies wrap around
+  adapter_type cb_{storage_, capacity, capacity - 8, 0};
+  value_type in_[block_size];
+  value_type out_[block_size];
+};
+
+// Same as `circular_buffer`, but through the lock-free SPSC adapter
+template <bool Bulk>
+class spsc_circular_buffer {
+ public:
+  using value_type = std::int16_t;
+  using adapter_type = embedded::spsc_circular_buffer_adapter<value_type>;
+
+  static constexpr std::size_t capacity = 48;
+  static constexpr std::size_t samples = block_size;
+
+  spsc_circular_buffer() {
+    for (std::size_t i = 0; i < block_size; ++i) {
+      in_[i] = static_cast<value_type>(i);
+    }
+  }
+
+  __attribute__((noinline)) void operator()() {
+    constexpr std::size_t chunk = 16;
+    for (std::size_t i = 0; i < block_size; i += chunk) {
+      if (Bulk) {
+        cb_.copy_in_back(in_ + i, chunk);
+        cb_.copy_out_front(out_ + i, chunk);
+      } else {
+        for (std::size_t j = i; j < i + chunk; ++j) {
+          cb_.try_push_back(in_[j]);
+        }
+        for (std::size_t j = i; j < i + chunk; ++j) {
+          cb_.try_pop_front(out_[j]);
+        }
+      }
+    }
+  }
+
+  static constexpr auto flash() -> std::size_t { return 0; }
+
+  static constexpr auto ram() -> std::size_t {
+    return sizeof(adapter_type) + sizeof(storage_);
+  }
+
+ private:
+  value_type storage_[capacity];
+  // start in the middle so that both copies wrap around
+  adapter_type cb_{storage_, capacity, capacity - 8, 0};
+  value_type in_[block_size];
+  value_type out_[block_size];
+};
+
+template <typename Kernel>
+void run(char const* name) {
+  static Kernel k;
+  harness::measure(name, k);
+}
+
+} // namespace kernel
+
+// Runs all kernels and reports them as CSV lines
+void harness::run() {
+  using namespace embedded::signal;
+
+  cycle_counter::init();
+
+  line() << "name,samples,cycles,cycles/sample,flash,ram";
+
+  kernel::run_sos<family::butterworth, 2, float>("sos/butter/2/float/sample",
+                                                 "sos/butter/2/float/block");
+  kernel::run_sos<family::butterworth, 4, float>("sos/butter/4/float/sample",
+                                                 "sos/butter/4/float/block");
+  kernel::run_sos<family::butterworth, 8, float>("sos/butter/8/float/sample",
+                                                 "sos/butter/8/float/block");
+  kernel::run_sos<family::elliptic, 4, float>("sos/ellip/4/float/sample",
+                                              "sos/ellip/4/float/block");
+
+  kernel::run_sos<family::butterworth, 4, double>(
+      "sos/butter/4/double/sample", "sos/butter/4/double/block");
+  kernel::run_sos<family::elliptic, 4, double>("sos/ellip/4/double/sample",
+                                               "sos/ellip/4/double/block");
+
+  kernel::run_sos<family::butterworth, 2, kernel::fixed>(
+      "sos/butter/2/fixed/sample", "sos/butter/2/fixed/block");
+  kernel::run_sos<family::butterworth, 4, kernel::fixed>(
+      "sos/butter/4/fixed/sample", "sos/butter/4/fixed/block");
+  kernel::run_sos<family::butterworth, 8, kernel::fixed>(
+      "sos/butter/8/fixed/sample", "sos/butter/8/fixed/block");
+  kernel::run_sos<family::elliptic, 4, kernel::fixed>(
+      "sos/ellip/4/fixed/sample", "sos/ellip/4/fixed/block");
+
+  kernel::run<kernel::varint<false>>("varint/encode");
+  kernel::run<kernel::varint<true>>("varint/decode");
+  kernel::run<kernel::function<embedded::function_layout::compact>>(
+      "function/compact");
+  kernel::run<kernel::function<embedded::function_layout::inline_call>>(
+      "function/inline_call");
+  kernel::run<kernel::circular_buffer<false>>("circular_buffer/item");
+  kernel::run<kernel::circular_buffer<true>>("circular_buffer/bulk");
+  kernel::run<kernel::circular_buffer<false, 64>>("circular_buffer/item/pow2");
+  kernel::run<kernel::circular_buffer<true, 64>>("circular_buffer/bulk/pow2");
+  kernel::run<kernel::spsc_circular_buffer<false>>(
+      "spsc_circular_buffer/item");
+  kernel::run<kernel::spsc_circular_buffer<true>>("spsc_circular_buffer/bulk");
+
+  line() << "done";
+}
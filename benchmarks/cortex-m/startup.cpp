@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdint>
+
+#include "harness.h"
+
+// Symbols defined by the linker script. The initial stack pointer is
+// declared as a function so that it can be placed in the vector table
+// without a cast.
+extern "C" {
+extern std::uint32_t __data_load[];
+extern std::uint32_t __data_start[];
+extern std::uint32_t __data_end[];
+extern std::uint32_t __bss_start[];
+extern std::uint32_t __bss_end[];
+extern void (*__init_array_start[])();
+extern void (*__init_array_end[])();
+void __stack_top();
+
+[[noreturn]] void reset_handler();
+[[noreturn]] void fault_handler();
+}
+
+namespace {
+
+using handler = void (*)();
+
+// Only the core exceptions, the harness doesn't use any interrupts
+__attribute__((section(".vectors"), used)) handler const vectors[] = {
+    &__stack_top,   // initial stack pointer
+    &reset_handler, // reset
+    &fault_handler, // NMI
+    &fault_handler, // hard fault
+    &fault_handler, // memory management fault
+    &fault_handler, // bus fault
+    &fault_handler, // usage fault
+};
+
+} // namespace
+
+void reset_handler() {
+  std::uint32_t const* src = __data_load;
+  for (std::uint32_t* dst = __data_start; dst < __data_end;) {
+    *dst++ = *src++;
+  }
+  for (std::uint32_t* dst = __bss_start; dst < __bss_end;) {
+    *dst++ = 0;
+  }
+
+  harness::system_init();
+
+  for (auto ctor = __init_array_start; ctor < __init_array_end; ++ctor) {
+    (*ctor)();
+  }
+
+  harness::run();
+  harness::exit();
+}
+
+void fault_handler() {
+  harness::write("fault\n");
+  harness::exit();
+}
@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "embedded/callback_table.h"
+#include "embedded/function.h"
+
+using namespace embedded;
+
+namespace {
+
+template <typename Layout>
+using callback = function<std::uint32_t(std::uint32_t), 3 * sizeof(void*),
+                          alignof(void*), Layout>;
+
+// Small callables of different types, so the callbacks in a table use
+// different vtables
+template <std::uint32_t K>
+struct step {
+  std::uint32_t mul;
+  auto operator()(std::uint32_t x) const -> std::uint32_t {
+    return x * mul + K;
+  }
+};
+
+// Same as `step`, but not trivially copyable, so moves and destruction
+// go through the vtable
+struct tracked_step : step<1> {
+  explicit tracked_step(std::uint32_t m) noexcept
+      : step<1>{m} {}
+  tracked_step(tracked_step&& other) noexcept
+      : step<1>{other.mul} {}
+  ~tracked_step() {}
+};
+
+template <typename Layout>
+auto make_table(std::size_t size) -> std::vector<callback<Layout>> {
+  std::vector<callback<Layout>> table;
+  table.reserve(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    auto const mul = static_cast<std::uint32_t>(2 * i + 1);
+    switch (i % 4) {
+    case 0:
+      table.emplace_back(step<1>{mul});
+      break;
+    case 1:
+      table.emplace_back(step<2>{mul});
+      break;
+    case 2:
+      table.emplace_back(step<3>{mul});
+      break;
+    default:
+      table.emplace_back(step<4>{mul});
+      break;
+    }
+  }
+  return table;
+}
+
+// Repeatedly call the same callback, each call depends on the previous
+// result
+template <typename Layout>
+void single(benchmark::State& state) {
+  callback<Layout> fn{step<1>{3}};
+  std::uint32_t x = 0;
+  for (auto _ : state) {
+    x = fn(x);
+    benchmark::DoNotOptimize(x);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Call all callbacks of a table in turn, like an event loop
+template <typename Layout>
+void table(benchmark::State& state) {
+  auto const size = static_cast<std::size_t>(state.range(0));
+  auto callbacks = make_table<Layout>(size);
+  std::uint32_t x = 0;
+  for (auto _ : state) {
+    for (auto& fn : callbacks) {
+      x = fn(x);
+    }
+    benchmark::DoNotOptimize(x);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Move callbacks through a queue, like a work queue passing them on
+template <typename Layout, typename Callable>
+void move(benchmark::State& state) {
+  constexpr std::size_t size = 64;
+  std::vector<callback<Layout>> queue;
+  queue.reserve(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    queue.emplace_back(Callable{static_cast<std::uint32_t>(i)});
+  }
+  for (auto _ : state) {
+    auto tmp = std::move(queue.front());
+    for (std::size_t i = 1; i < size; ++i) {
+      queue[i - 1] = std::move(queue[i]);
+    }
+    queue.back() = std::move(tmp);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * (size + 1));
+}
+
+// Tick handlers in an array of functions vs. a callback table
+template <std::uint32_t K>
+struct handler {
+  std::uint32_t mul;
+  void operator()(std::uint32_t* acc) const { acc[K - 1] += mul; }
+};
+
+constexpr std::size_t max_handlers = 256;
+
+template <typename Layout>
+using handler_function =
+    function<void(std::uint32_t*), 3 * sizeof(void*), alignof(void*), Layout>;
+
+using handler_callback_table =
+    callback_table<void(std::uint32_t*), 8 * max_handlers, max_handlers, 4>;
+
+template <typename Layout, typename Handler>
+void add_handler(std::vector<handler_function<Layout>>& handlers,
+                 Handler const& h) {
+  handlers.emplace_back(h);
+}
+
+template <typename Handler>
+void add_handler(handler_callback_table& handlers, Handler const& h) {
+  handlers.add(h);
+}
+
+// Adds `size` handlers of four different types in round-robin order
+template <typename Container>
+void add_handlers(Container& handlers, std::size_t size) {
+  for (std::size_t i = 0; i < size; ++i) {
+    auto const mul = static_cast<std::uint32_t>(2 * i + 1);
+    switch (i % 4) {
+    case 0:
+      add_handler(handlers, handler<1>{mul});
+      break;
+    case 1:
+      add_handler(handlers, handler<2>{mul});
+      break;
+    case 2:
+      add_handler(handlers, handler<3>{mul});
+      break;
+    default:
+      add_handler(handlers, handler<4>{mul});
+      break;
+    }
+  }
+}
+
+template <typename Layout>
+void handler_array(benchmark::State& state) {
+  auto const size = static_cast<std::size_t>(state.range(0));
+  std::vector<handler_function<Layout>> handlers;
+  handlers.reserve(size);
+  add_handlers(handlers, size);
+  std::uint32_t acc[4] = {};
+  for (auto _ : state) {
+    for (auto& fn : handlers) {
+      fn(acc);
+    }
+    benchmark::DoNotOptimize(acc);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void handler_table(benchmark::State& state) {
+  static handler_callback_table handlers;
+  handlers.clear();
+  add_handlers(handlers, static_cast<std::size_t>(state.range(0)));
+  std::uint32_t acc[4] = {};
+  for (auto _ : state) {
+    handlers.invoke_all(acc);
+    benchmark::DoNotOptimize(acc);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Layout>
+void register_layout(std::string const& name) {
+  benchmark::RegisterBenchmark((name + "/single").c_str(), &single<Layout>);
+  benchmark::RegisterBenchmark((name + "/move/trivial").c_str(),
+                               &move<Layout, step<1>>);
+  benchmark::RegisterBenchmark((name + "/move/non_trivial").c_str(),
+                               &move<Layout, tracked_step>);
+  benchmark::RegisterBenchmark((name + "/table").c_str(), &table<Layout>)
+      ->RangeMultiplier(16)
+      ->Range(16, 16384);
+  benchmark::RegisterBenchmark((name + "/handlers").c_str(),
+                               &handler_array<Layout>)
+      ->RangeMultiplier(4)
+      ->Range(16, max_handlers);
+}
+
+int register_all() {
+  register_layout<function_layout::compact>("compact");
+  register_layout<function_layout::inline_call>("inline_call");
+  benchmark::RegisterBenchmark("callback_table/handlers", &handler_table)
+      ->RangeMultiplier(4)
+      ->Range(16, max_handlers);
+  return 0;
+}
+
+int const registered = register_all();
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <benchmark/benchmark.h>
+
+#include "embedded/signal/filter.h"
+#include "embedded/signal/fpm.h"
+#include "embedded/signal/order.h"
+
+using namespace embedded::signal;
+
+namespace {
+
+using fixed = fpm::fixed<std::int32_t, std::int64_t, 24>;
+
+constexpr std::size_t block_size = 1024;
+
+// Reference cycles, i.e. the TSC on x86, which runs at the nominal clock
+// rate. Returns zero where no cycle counter is available, in which case
+// the cycles/sample counter is omitted.
+inline std::uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+template <typename T>
+std::vector<T> input() {
+  std::vector<T> in;
+  std::uint32_t seed = 1;
+  for (std::size_t i = 0; i < block_size; ++i) {
+    seed = seed * 1103515245 + 12345;
+    in.push_back(T(static_cast<double>(seed >> 16 & 0x7fff) / 32768.0 - 0.5));
+  }
+  return in;
+}
+
+template <typename Family, std::size_t Order>
+constexpr auto base_design() -> iirfilter<double>::design<Order> {
+  return iirfilter<double>(48000.0)
+      .lowpass(Family::template prototype<Order>(1.0, 60.0), 1000.0);
+}
+
+// Structure used for SOS designs, fixed point types need a wide
+// accumulator
+template <typename T>
+struct sos_structure_for {
+  using type = sos_structure::df2t;
+};
+
+template <>
+struct sos_structure_for<fixed> {
+  using type = sos_structure::df1_wide<>;
+};
+
+template <typename Family, std::size_t Order, typename T>
+struct sos_realization {
+  using structure = typename sos_structure_for<T>::type;
+
+  static auto design() -> sos_design<T, Order, structure> const& {
+    static constexpr auto d =
+        base_design<Family, Order>().template sos<T, structure>(
+            sos_gain::distribute);
+    return d;
+  }
+};
+
+template <typename Family, std::size_t Order, typename T>
+struct poly_realization {
+  static auto design() -> poly_design<T, Order> const& {
+    static constexpr auto d = base_design<Family, Order>().template poly<T>();
+    return d;
+  }
+};
+
+void report(benchmark::State& state, std::uint64_t elapsed) {
+  auto const samples = static_cast<double>(state.iterations() * block_size);
+  state.counters["samples/s"] =
+      benchmark::Counter(samples, benchmark::Counter::kIsRate);
+  if (elapsed > 0) {
+    state.counters["cycles/sample"] = static_cast<double>(elapsed) / samples;
+  }
+}
+
+template <typename Realization, typename T>
+void per_sample(benchmark::State& state) {
+  auto filter = Realization::design().instance();
+  auto const in = input<T>();
+  std::vector<T> out(block_size);
+  std::uint64_t elapsed = 0;
+  for (auto _ : state) {
+    auto const t0 = cycles();
+    for (std::size_t i = 0; i < block_size; ++i) {
+      out[i] = filter(in[i]);
+    }
+    elapsed += cycles() - t0;
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  report(state, elapsed);
+}
+
+template <typename Realization, typename T>
+void block(benchmark::State& state) {
+  auto filter = Realization::design().instance();
+  auto const in = input<T>();
+  std::vector<T> out(block_size);
+  std::uint64_t elapsed = 0;
+  for (auto _ : state) {
+    auto const t0 = cycles();
+    filter.process(in.data(), out.data(), block_size);
+    elapsed += cycles() - t0;
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  report(state, elapsed);
+}
+
+template <typename Realization, typename T>
+void register_apis(std::string const& name) {
+  benchmark::RegisterBenchmark((name + "/sample").c_str(),
+                               &per_sample<Realization, T>);
+  benchmark::RegisterBenchmark((name + "/block").c_str(),
+                               &block<Realization, T>);
+}
+
+// poly_design only supports floating point types
+template <typename Family, std::size_t Order, typename T>
+void register_poly(std::string const& name, std::true_type) {
+  register_apis<poly_realization<Family, Order, T>, T>("poly/" + name);
+}
+
+template <typename Family, std::size_t Order, typename T>
+void register_poly(std::string const&, std::false_type) {}
+
+template <typename Family, std::size_t Order, typename T>
+void register_type(std::string const& family, std::string const& type) {
+  auto const name = family + "/" + std::to_string(Order) + "/" + type;
+  register_apis<sos_realization<Family, Order, T>, T>("sos/" + name);
+  register_poly<Family, Order, T>(name, std::is_floating_point<T>{});
+}
+
+template <typename Family, std::size_t Order>
+void register_order(std::string const& family) {
+  register_type<Family, Order, float>(family, "float");
+  register_type<Family, Order, double>(family, "double");
+  register_type<Family, Order, fixed>(family, "fixed");
+}
+
+template <typename Family>
+void register_family(std::string const& family) {
+  register_order<Family, 2>(family);
+  register_order<Family, 4>(family);
+  register_order<Family, 8>(family);
+  register_order<Family, 16>(family);
+}
+
+int register_all() {
+  register_family<family::butterworth>("butter");
+  register_family<family::chebyshev1>("cheby1");
+  register_family<family::chebyshev2>("cheby2");
+  register_family<family::elliptic>("ellip");
+  return 0;
+}
+
+int const registered = register_all();
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "embedded/signal/butterworth.h"
+#include "embedded/signal/filter.h"
+#include "embedded/signal/parallel.h"
+
+using namespace embedded::signal;
+
+namespace {
+
+constexpr std::size_t channels = 256;
+constexpr std::size_t samples = 1 << 16;
+
+constexpr auto design =
+    iirfilter<double>(48000.0).lowpass(butterworth<8>(), 1000.0).sos<float>();
+
+std::vector<float> input() {
+  std::vector<float> in(channels * samples);
+  std::uint32_t seed = 1;
+  for (auto& x : in) {
+    seed = seed * 1103515245 + 12345;
+    x = static_cast<float>(seed >> 16 & 0x7fff) / 32768.0f - 0.5f;
+  }
+  return in;
+}
+
+// One channel after the other on a single core
+void per_channel(benchmark::State& state) {
+  auto const in = input();
+  std::vector<float> out(in.size());
+
+  for (auto _ : state) {
+    for (std::size_t c = 0; c < channels; ++c) {
+      auto filter = design.instance();
+      filter.process(in.data() + c * samples, out.data() + c * samples,
+                     samples);
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * channels * samples);
+}
+
+void engine(benchmark::State& state) {
+  auto const in = input();
+  std::vector<float> out(in.size());
+  sos_parallel_engine eng(static_cast<std::size_t>(state.range(0)));
+
+  for (auto _ : state) {
+    eng.process(design, in.data(), out.data(), channels, samples);
+    benchmark::DoNotOptimize(out.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * channels * samples);
+}
+
+} // namespace
+
+BENCHMARK(per_channel)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(engine)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "embedded/utility/integer_sequence.h"
+#include "embedded/variant.h"
+#include "embedded/visit.h"
+
+using namespace embedded;
+
+namespace {
+
+// Message types of a dispatcher, each handled differently
+template <std::size_t K>
+struct message {
+  std::uint32_t value;
+};
+
+struct handler {
+  std::uint32_t* acc;
+
+  template <std::size_t K>
+  void operator()(message<K> const& m) const {
+    acc[K % 4] += m.value * (2 * K + 1);
+  }
+};
+
+template <std::size_t... Ks>
+variant<message<Ks>...> make_variant_type(index_sequence<Ks...>);
+
+template <std::size_t N>
+using message_variant =
+    decltype(make_variant_type(make_index_sequence<N>{}));
+
+template <std::size_t N, std::size_t... Ks>
+message_variant<N> make_message(std::size_t k, std::uint32_t value,
+                                index_sequence<Ks...>) {
+  using factory = message_variant<N> (*)(std::uint32_t);
+  static factory const make[] = {[](std::uint32_t v) {
+    return message_variant<N>{message<Ks>{v}};
+  }...};
+  return make[k](value);
+}
+
+// A queue of messages with pseudo-random types
+template <std::size_t N>
+std::vector<message_variant<N>> make_queue(std::size_t size) {
+  std::vector<message_variant<N>> queue;
+  queue.reserve(size);
+  std::uint32_t x = 12345;
+  for (std::size_t i = 0; i < size; ++i) {
+    x = x * 1103515245 + 12345;
+    queue.push_back(make_message<N>((x >> 16) % N, static_cast<uint32_t>(i),
+                                    make_index_sequence<N>{}));
+  }
+  return queue;
+}
+
+struct mpark_visit {
+  template <typename Visitor, typename Variant>
+  static void apply(Visitor const& vis, Variant const& v) {
+    visit(vis, v);
+  }
+};
+
+struct embedded_flat_visit {
+  template <typename Visitor, typename Variant>
+  static void apply(Visitor const& vis, Variant const& v) {
+    flat_visit(vis, v);
+  }
+};
+
+template <typename Visit, std::size_t N>
+void dispatch(benchmark::State& state) {
+  auto const queue = make_queue<N>(1024);
+  std::uint32_t acc[4] = {};
+  handler const vis{acc};
+  for (auto _ : state) {
+    for (auto const& m : queue) {
+      Visit::apply(vis, m);
+    }
+    benchmark::DoNotOptimize(acc);
+  }
+  state.SetItemsProcessed(state.iterations() * queue.size());
+}
+
+BENCHMARK_TEMPLATE(dispatch, mpark_visit, 2);
+BENCHMARK_TEMPLATE(dispatch, embedded_flat_visit, 2);
+BENCHMARK_TEMPLATE(dispatch, mpark_visit, 6);
+BENCHMARK_TEMPLATE(dispatch, embedded_flat_visit, 6);
+BENCHMARK_TEMPLATE(dispatch, mpark_visit, 16);
+BENCHMARK_TEMPLATE(dispatch, embedded_flat_visit, 16);
+BENCHMARK_TEMPLATE(dispatch, mpark_visit, 48);
+BENCHMARK_TEMPLATE(dispatch, embedded_flat_visit, 48);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,73 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "embedded/signal/butterworth.h"
+#include "embedded/signal/denormal.h"
+#include "embedded/signal/filter.h"
+
+namespace {
+
+// Length of each measurement window in samples
+constexpr size_t Window = 20000;
+
+// Number of windows, the first one contains a burst of signal
+constexpr size_t Windows = 10;
+
+template <typename Instance>
+void run(char const* name, Instance filter, std::vector<float> const& in) {
+  std::vector<float> out(Window);
+
+  std::printf("%-14s", name);
+
+  for (size_t w = 0; w < Windows; ++w) {
+    auto t1 = std::chrono::steady_clock::now();
+    filter.process(in.data() + w * Window, out.data(), Window);
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::printf(" %6.2f",
+                1e9 * std::chrono::duration<double>(t2 - t1).count() / Window);
+  }
+
+  std::printf("  ns/sample\n");
+}
+
+} // namespace
+
+int main() {
+  using namespace embedded::signal;
+
+  // Design the IIR filter:
+  // - 8th-order Butterworth lowpass filter
+  // - Using double-precision for filter design
+  // - Using single-precision for filter implementation
+  //
+  // The design is fully determined at compile time.
+  constexpr double fs{48000.0}; // sample rate
+  constexpr double fc{1000.0};  // cutoff frequency
+  constexpr auto base = iirfilter<double>(fs).lowpass(butterworth<8>(), fc);
+  constexpr auto plain = base.sos<float>();
+  constexpr auto safe = base.sos<float, sos_structure::denormal_safe<>>();
+
+  // A short burst of noise followed by silence. Without protection, the
+  // filter state decays into the subnormal range during the silence.
+  std::vector<float> in(Window * Windows);
+  unsigned seed = 1;
+  for (size_t i = 0; i < 1000; ++i) {
+    seed = seed * 1103515245 + 12345;
+    in[i] = static_cast<float>(seed >> 16 & 0x7fff) / 16384.0f - 1.0f;
+  }
+
+  std::printf("time per window of %zu samples, signal in first window only\n",
+              Window);
+
+  run("df2t", plain.instance(), in);
+  run("denormal_safe", safe.instance(), in);
+
+  if (denormal_guard::supported) {
+    denormal_guard guard;
+    run("denormal_guard", plain.instance(), in);
+  }
+
+  return 0;
+}
@@ -9,6 +9,7 @@
 #include "embedded/ostream_ops.h"
 #include "embedded/signal/butterworth.h"
 #include "embedded/signal/filter.h"
+#include "embedded/signal/fpm.h"
 
 int main() {
   using namespace embedded::signal;
@@ -27,13 +28,16 @@ int main() {
   // - Using double-precision for filter design
   // - Using fixed-point for filter implementation
   // - Using a Second Order System (SOS) implementation
+  // - Using Direct Form I with a wide accumulator, so each section only
+  //   rounds once
   //
   // The design is fully determined at compile time.
   constexpr double fs{1000.0}; // sample rate
   constexpr double fc{40.0};   // cutoff frequency
   constexpr auto design = iirfilter<double>(fs)
                               .highpass(butterworth<20>(), fc)
-                              .sos<value_type>(sos_gain::distribute);
+                              .sos<value_type, sos_structure::df1_wide<>>(
+                                  sos_gain::distribute);
 
   // Set up input and output signal vectors
   std::vector<int16_t> vec;
@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "utility/integer_sequence.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace embedded {
+
+namespace detail {
+
+inline std::uint32_t bp_load32(std::uint8_t const* p) {
+  return static_cast<std::uint32_t>(p[0]) |
+         static_cast<std::uint32_t>(p[1]) << 8 |
+         static_cast<std::uint32_t>(p[2]) << 16 |
+         static_cast<std::uint32_t>(p[3]) << 24;
+}
+
+inline void bp_store32(std::uint8_t* p, std::uint32_t v) {
+  p[0] = static_cast<std::uint8_t>(v);
+  p[1] = static_cast<std::uint8_t>(v >> 8);
+  p[2] = static_cast<std::uint8_t>(v >> 16);
+  p[3] = static_cast<std::uint8_t>(v >> 24);
+}
+
+// Location of value `J` of each lane in a block packed with `B` bits. The
+// value starts at bit `shift` of word `word` and continues in the next
+// word if `spans` is set.
+template <unsigned B, std::size_t J>
+struct bp_slot {
+  static constexpr unsigned word = J * B / 32;
+  static constexpr unsigned shift = J * B % 32;
+  static constexpr unsigned rshift = (32 - shift) % 32;
+  static constexpr bool spans = shift + B > 32;
+  static constexpr std::uint32_t mask = B == 32 ? ~0u : (1u << B) - 1;
+};
+
+template <unsigned B, std::size_t J>
+inline std::uint32_t bp_extract(std::uint8_t const* in, unsigned lane) {
+  using slot = bp_slot<B, J>;
+  auto v = bp_load32(in + 4 * (4 * slot::word + lane)) >> slot::shift;
+  if (slot::spans) {
+    v |= bp_load32(in + 4 * (4 * (slot::word + 1) + lane)) << slot::rshift;
+  }
+  return v & slot::mask;
+}
+
+#if defined(__SSE2__)
+
+template <unsigned B, std::size_t J>
+inline __m128i bp_extract(__m128i const* in) {
+  using slot = bp_slot<B, J>;
+  auto v = _mm_srli_epi32(_mm_loadu_si128(in + slot::word), slot::shift);
+  if (slot::spans) {
+    v = _mm_or_si128(v, _mm_slli_epi32(_mm_loadu_si128(in + slot::word + 1),
+                                       slot::rshift));
+  }
+  return _mm_and_si128(v, _mm_set1_epi32(static_cast<int>(slot::mask)));
+}
+
+template <unsigned B, std::size_t... J>
+inline void bp_unpack(std::uint8_t const* in, std::uint32_t ref,
+                      std::uint32_t* out, index_sequence<J...>) {
+  using expand = int[];
+  auto const vin = reinterpret_cast<__m128i const*>(in);
+  auto const vout = reinterpret_cast<__m128i*>(out);
+  auto const vref = _mm_set1_epi32(static_cast<int>(ref));
+  static_cast<void>(expand{
+      0, (_mm_storeu_si128(vout + J,
+                           _mm_add_epi32(bp_extract<B, J>(vin), vref)),
+          0)...});
+}
+
+#elif defined(__ARM_NEON)
+
+// little-endian only, the data isn't necessarily 32-bit aligned
+inline uint32x4_t bp_load128(std::uint8_t const* p) {
+  return vreinterpretq_u32_u8(vld1q_u8(p));
+}
+
+template <unsigned B, std::size_t J>
+inline uint32x4_t bp_extract(std::uint8_t const* in) {
+  using slot = bp_slot<B, J>;
+  auto v = vshlq_u32(bp_load128(in + 16 * slot::word),
+                     vdupq_n_s32(-static_cast<int>(slot::shift)));
+  if (slot::spans) {
+    v = vorrq_u32(v, vshlq_u32(bp_load128(in + 16 * (slot::word + 1)),
+                               vdupq_n_s32(static_cast<int>(slot::rshift))));
+  }
+  return vandq_u32(v, vdupq_n_u32(slot::mask));
+}
+
+template <unsigned B, std::size_t... J>
+inline void bp_unpack(std::uint8_t const* in, std::uint32_t ref,
+                      std::uint32_t* out, index_sequence<J...>) {
+  using expand = int[];
+  auto const vref = vdupq_n_u32(ref);
+  static_cast<void>(expand{
+      0, (vst1q_u32(out + 4 * J, vaddq_u32(bp_extract<B, J>(in), vref)),
+          0)...});
+}
+
+#else
+
+template <unsigned B, std::size_t... J>
+inline void bp_unpack(std::uint8_t const* in, std::uint32_t ref,
+                      std::uint32_t* out, index_sequence<J...>) {
+  using expand = int[];
+  for (unsigned lane = 0; lane < 4; ++lane) {
+    static_cast<void>(expand{
+        0, (out[4 * J + lane] = ref + bp_extract<B, J>(in, lane), 0)...});
+  }
+}
+
+#endif
+
+template <unsigned B>
+void bp_unpack_block(std::uint8_t const* in, std::uint32_t ref,
+                     std::uint32_t* out) {
+  bp_unpack<B>(in, ref, out, make_index_sequence<32>{});
+}
+
+template <>
+inline void bp_unpack_block<0>(std::uint8_t const*, std::uint32_t ref,
+                               std::uint32_t* out) {
+  for (std::size_t i = 0; i < 128; ++i) {
+    out[i] = ref;
+  }
+}
+
+using bp_unpack_kernel = void (*)(std::uint8_t const*, std::uint32_t,
+                                  std::uint32_t*);
+
+// unpack kernels for all bit widths from 0 to 32
+template <std::size_t... B>
+struct bp_kernels {
+  static constexpr bp_unpack_kernel unpack[sizeof...(B)] = {
+      &bp_unpack_block<B>...};
+};
+
+template <std::size_t... B>
+constexpr bp_unpack_kernel bp_kernels<B...>::unpack[sizeof...(B)];
+
+template <std::size_t... B>
+bp_kernels<B...> bp_make_kernels(index_sequence<B...>);
+
+using bp_kernel_table = decltype(bp_make_kernels(make_index_sequence<33>{}));
+
+} // namespace detail
+
+/**
+ * Frame-of-reference bit-packing of 32-bit integers
+ *
+ * The values are split into blocks of 128. For each block, the minimum
+ * value is stored as a reference, followed by the bit width of the
+ * largest difference to the reference, and the differences, packed
+ * using exactly that many bits. So a block of 12-bit ADC samples takes
+ * at most 197 bytes, where `varint` would need 256 bytes.
+ *
+ * Block layout:
+ *
+ *     reference  (4 bytes, little-endian)
+ *     width      (1 byte, 0 to 32)
+ *     data       (16 * width bytes)
+ *
+ * The data consists of 32-bit little-endian words. Value `i` of the block
+ * is stored in lane `i % 4`, where the words of lane `l` are at positions
+ * `l`, `l + 4`, `l + 8` etc. This way, four values can be unpacked at the
+ * same time with SSE2 or NEON. The unpack kernels for all bit widths are
+ * generated at compile time, with all shifts and masks being constants.
+ * The last block is padded to 128 values.
+ *
+ * Signed values are stored relative to the signed minimum, so they don't
+ * need to be zig-zag encoded.
+ */
+class bitpack {
+ public:
+  static constexpr std::size_t block_size = 128;
+  static constexpr std::size_t header_size = 5;
+
+  /**
+   * Upper bound of the encoded size of `count` values
+   */
+  static constexpr std::size_t max_size(std::size_t count) {
+    return blocks(count) * (header_size + 16 * 32);
+  }
+
+  /**
+   * Return the number of bytes required to encode `count` values
+   */
+  template <typename T>
+  static std::size_t size(T const* in, std::size_t count) {
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < count; i += block_size) {
+      auto const n = block_length(count, i);
+      total += header_size + 16 * width(in + i, n, minimum(in + i, n));
+    }
+    return total;
+  }
+
+  /**
+   * Encode `count` values
+   *
+   * \param in       Pointer to the values to encode.
+   *
+   * \param count    Number of values to encode.
+   *
+   * \param out      Pointer to the encoding buffer, which must have room
+   *                 for `size(in, count)` or `max_size(count)` bytes.
+   *
+   * \returns Pointer to end of encoding.
+   */
+  static std::uint8_t*
+  encode(std::uint32_t const* in, std::size_t count, std::uint8_t* out) {
+    return encode_impl(in, count, out);
+  }
+
+  static std::uint8_t*
+  encode(std::int32_t const* in, std::size_t count, std::uint8_t* out) {
+    return encode_impl(in, count, out);
+  }
+
+  /**
+   * Decode `count` values
+   *
+   * \param begin    Pointer to start of encoding buffer.
+   *
+   * \param end      Pointer to end of encoding buffer.
+   *
+   * \param out      Pointer to the decoded output values.
+   *
+   * \param count    Number of values to decode.
+   *
+   * \returns Pointer to end of encoding, or `begin` if the encoding is
+   *          invalid or continues past the end of the encoding buffer.
+   */
+  static std::uint8_t const* decode(std::uint8_t const* begin,
+                                    std::uint8_t const* end,
+                                    std::uint32_t* out, std::size_t count) {
+    auto it = begin;
+
+    for (std::size_t i = 0; i < count; i += block_size) {
+      if (end - it < static_cast<std::ptrdiff_t>(header_size)) {
+        return begin;
+      }
+
+      auto const ref = detail::bp_load32(it);
+      auto const bits = it[4];
+      auto const data = it + header_size;
+
+      if (bits > 32 || end - data < 16 * bits) {
+        return begin;
+      }
+
+      auto const unpack = detail::bp_kernel_table::unpack[bits];
+
+      if (count - i >= block_size) {
+        unpack(data, ref, out + i);
+      } else {
+        std::uint32_t tmp[block_size];
+        unpack(data, ref, tmp);
+        for (std::size_t k = 0; k < count - i; ++k) {
+          out[i + k] = tmp[k];
+        }
+      }
+
+      it = data + 16 * bits;
+    }
+
+    return it;
+  }
+
+  // signed integer version
+  static std::uint8_t const* decode(std::uint8_t const* begin,
+                                    std::uint8_t const* end, std::int32_t* out,
+                                    std::size_t count) {
+    return decode(begin, end, reinterpret_cast<std::uint32_t*>(out), count);
+  }
+
+ private:
+  static constexpr std::size_t blocks(std::size_t count) {
+    return (count + block_size - 1) / block_size;
+  }
+
+  static std::size_t block_length(std::size_t count, std::size_t i) {
+    return count - i < block_size ? count - i : std::size_t{block_size};
+  }
+
+  template <typename T>
+  static T minimum(T const* in, std::size_t n) {
+    T min = in[0];
+    for (std::size_t k = 1; k < n; ++k) {
+      if (in[k] < min) {
+        min = in[k];
+      }
+    }
+    return min;
+  }
+
+  template <typename T>
+  static std::uint32_t delta(T value, T min) {
+    return static_cast<std::uint32_t>(value) - static_cast<std::uint32_t>(min);
+  }
+
+  template <typename T>
+  static unsigned width(T const* in, std::size_t n, T min) {
+    std::uint32_t bits = 0;
+    for (std::size_t k = 0; k < n; ++k) {
+      bits |= delta(in[k], min);
+    }
+    unsigned w = 0;
+    for (; bits != 0; bits >>= 1) {
+      ++w;
+    }
+    return w;
+  }
+
+  template <typename T>
+  static std::uint8_t*
+  encode_impl(T const* in, std::size_t count, std::uint8_t* out) {
+    for (std::size_t i = 0; i < count; i += block_size) {
+      auto const n = block_length(count, i);
+      auto const min = minimum(in + i, n);
+      auto const bits = width(in + i, n, min);
+
+      detail::bp_store32(out, static_cast<std::uint32_t>(min));
+      out[4] = static_cast<std::uint8_t>(bits);
+      out += header_size;
+
+      if (bits > 0) {
+        for (unsigned lane = 0; lane < 4; ++lane) {
+          std::uint64_t acc = 0;
+          unsigned filled = 0;
+          auto word = out + 4 * lane;
+
+          for (std::size_t k = lane; k < block_size; k += 4) {
+            auto const v = k < n ? delta(in[i + k], min) : 0;
+            acc |= static_cast<std::uint64_t>(v) << filled;
+            filled += bits;
+            if (filled >= 32) {
+              detail::bp_store32(word, static_cast<std::uint32_t>(acc));
+              word += 16;
+              acc >>= 32;
+              filled -= 32;
+            }
+          }
+        }
+
+        out += 16 * bits;
+      }
+    }
+
+    return out;
+  }
+};
+
+} // namespace embedded
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace embedded {
+
+/**
+ * A static pool of fixed-size memory blocks
+ *
+ * All state lives in static storage, so a pool is identified by its
+ * type; use `Tag` to create distinct pools with the same geometry. The
+ * pool never calls `malloc` and needs no initialization, so it can be
+ * used from static constructors.
+ *
+ * `allocate()` and `deallocate()` are lock-free (a Treiber stack with a
+ * generation counter to avoid ABA issues) as long as 32-bit atomics are,
+ * which is the case on all cores with exclusive load/store instructions
+ * (e.g. Cortex-M3 and up). On cores without them (e.g. Cortex-M0), the
+ * toolchain's `__atomic_*` library functions are used instead.
+ *
+ * Blocks are handed out in address order until the pool has been used up
+ * once, and in LIFO order after that. `allocate()` returns `nullptr` if
+ * no block is available.
+ *
+ * This is e.g. suitable as the `Pool` argument of `embedded::function`.
+ */
+template <std::size_t BlockSize, std::size_t Blocks,
+          std::size_t Alignment = alignof(std::max_align_t),
+          typename Tag = void>
+class static_block_pool {
+ public:
+  static_assert(Blocks > 0 && Blocks < 0xFFFF, "invalid number of blocks");
+  static_assert((Alignment & (Alignment - 1)) == 0,
+                "alignment must be a power of two");
+
+  static constexpr std::size_t block_size =
+      (BlockSize + Alignment - 1) & ~(Alignment - 1);
+  static constexpr std::size_t block_alignment = Alignment;
+  static constexpr std::size_t blocks = Blocks;
+
+  static auto allocate() noexcept -> void* {
+    auto head = head_.load(std::memory_order_acquire);
+
+    while (head & index_mask) {
+      auto const i = (head & index_mask) - 1;
+      auto const next = next_generation(head) |
+                        next_[i].load(std::memory_order_relaxed);
+      if (head_.compare_exchange_weak(head, next, std::memory_order_acquire,
+                                      std::memory_order_acquire)) {
+        return storage_[i];
+      }
+    }
+
+    auto fresh = fresh_.load(std::memory_order_relaxed);
+
+    while (fresh < Blocks) {
+      if (fresh_.compare_exchange_weak(fresh, fresh + 1,
+                                       std::memory_order_relaxed)) {
+        return storage_[fresh];
+      }
+    }
+
+    return nullptr;
+  }
+
+  static void deallocate(void* p) noexcept {
+    auto const i = static_cast<std::uint32_t>(
+        (static_cast<unsigned char*>(p) - storage_[0]) / block_size);
+    auto head = head_.load(std::memory_order_relaxed);
+    std::uint32_t next;
+
+    do {
+      next_[i].store(static_cast<std::uint16_t>(head & index_mask),
+                     std::memory_order_relaxed);
+      next = next_generation(head) | (i + 1);
+    } while (!head_.compare_exchange_weak(
+        head, next, std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  static auto owns(void const* p) noexcept -> bool {
+    auto const q = static_cast<unsigned char const*>(p);
+    return q >= storage_[0] && q < storage_[0] + sizeof(storage_);
+  }
+
+ private:
+  // The free list head holds a generation counter in the upper and the
+  // block index plus one in the lower 16 bits, zero meaning empty.
+  static constexpr std::uint32_t index_mask = 0xFFFF;
+
+  static constexpr auto next_generation(std::uint32_t head) noexcept
+      -> std::uint32_t {
+    return (head & ~index_mask) + (index_mask + 1);
+  }
+
+  static std::atomic<std::uint32_t> head_;
+  static std::atomic<std::uint32_t> fresh_;
+  static std::atomic<std::uint16_t> next_[Blocks];
+  alignas(Alignment) static unsigned char storage_[Blocks][block_size];
+};
+
+template <std::size_t B, std::size_t N, std::size_t A, typename T>
+constexpr std::size_t static_block_pool<B, N, A, T>::block_size;
+
+template <std::size_t B, std::size_t N, std::size_t A, typename T>
+constexpr std::size_t static_block_pool<B, N, A, T>::block_alignment;
+
+template <std::size_t B, std::size_t N, std::size_t A, typename T>
+constexpr std::size_t static_block_pool<B, N, A, T>::blocks;
+
+template <std::size_t B, std::size_t N, std::size_t A, typename T>
+constexpr std::uint32_t static_block_pool<B, N, A, T>::index_mask;
+
+template <std::size_t B, std::size_t N, std::size_t A, typename T>
+std::atomic<std::uint32_t> static_block_pool<B, N, A, T>::head_{0};
+
+template <std::size_t B, std::size_t N, std::size_t A, typename T>
+std::atomic<std::uint32_t> static_block_pool<B, N, A, T>::fresh_{0};
+
+template <std::size_t B, std::size_t N, std::size_t A, typename T>
+std::atomic<std::uint16_t> static_block_pool<B, N, A, T>::next_[N];
+
+template <std::size_t B, std::size_t N, std::size_t A, typename T>
+alignas(A) unsigned char static_block_pool<B, N, A, T>::storage_
+    [N][static_block_pool<B, N, A, T>::block_size];
+
+} // namespace embedded
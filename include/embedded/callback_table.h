@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "function.h"
+
+namespace embedded {
+
+/**
+ * A fixed-capacity table of heterogeneous callbacks
+ *
+ * Callables of different types and sizes are stored back to back in a
+ * single in-place arena of `Bytes` bytes, grouped by type. `invoke_all()`
+ * walks each group linearly and calls all of its callables through the
+ * same call pointer, which is friendly to both caches and branch
+ * predictors, e.g. for tick or interrupt handlers.
+ *
+ * Callables must be trivially copyable, as entries are relocated with
+ * `memmove` when the arena is compacted. This covers lambdas capturing
+ * pointers and values, which is what these callbacks usually are.
+ *
+ * `add()` returns a handle for `remove()`, or `invalid_handle` if there
+ * is no space left for the callable. This happens if the arena is full,
+ * or if all `MaxEntries` handles or all `MaxGroups` types are in use.
+ *
+ * Removal is O(1): the last callable of the same group is moved into the
+ * removed slot. The slot that becomes free is reused by the next callable
+ * of the same type. Any unused space is reclaimed when `add()` runs out
+ * of space, or by an explicit `compact()`.
+ *
+ * The table doesn't synchronize access, so e.g. adding callbacks that
+ * are invoked from an interrupt must be done with that interrupt masked.
+ */
+template <typename Signature, std::size_t Bytes, std::size_t MaxEntries = 32,
+          std::size_t MaxGroups = 8, std::size_t Alignment = alignof(void*)>
+class callback_table;
+
+template <typename Return, typename... Args, std::size_t Bytes,
+          std::size_t MaxEntries, std::size_t MaxGroups, std::size_t Alignment>
+class callback_table<Return(Args...), Bytes, MaxEntries, MaxGroups,
+                     Alignment> {
+ public:
+  using signature = Return(Args...);
+  using size_type = std::size_t;
+  using handle = std::uint16_t;
+
+  static constexpr handle invalid_handle{0xFFFF};
+
+  static_assert(MaxEntries < invalid_handle, "too many entries");
+  static_assert(MaxGroups < 0xFFFF, "too many groups");
+  static_assert(Alignment % alignof(handle) == 0, "alignment too small");
+
+  callback_table() = default;
+
+  callback_table(callback_table const&) = delete;
+  callback_table& operator=(callback_table const&) = delete;
+
+  template <typename T, typename C = typename std::decay<T>::type,
+            typename = typename std::enable_if<
+                is_invocable_r<Return, C&, Args...>::value>::type>
+  auto add(T&& fun) -> handle {
+    static_assert(std::is_trivially_copyable<C>::value,
+                  "callback_table<> can only be used with trivially copyable "
+                  "types");
+    static_assert(Alignment % alignof(C) == 0,
+                  "callback_table<> alignment too small for this type");
+
+    constexpr size_type stride = stride_of(sizeof(C));
+    static_assert(stride <= Bytes,
+                  "callback_table<> arena too small for this type");
+
+    auto const h = free_handle();
+    if (h == invalid_handle) {
+      return invalid_handle;
+    }
+
+    auto const call = detail::typed_vtbl<signature, C>::value.call;
+    auto g = find_group(call, stride);
+
+    if (g != MaxGroups && groups_[g].count == 0 &&
+        groups_[g].capacity == 0) {
+      groups_[g] = group{};
+      g = MaxGroups;
+    }
+
+    if (g == MaxGroups) {
+      g = new_group(call, stride);
+    } else if (!reserve(groups_[g])) {
+      g = MaxGroups;
+    }
+
+    if (g == MaxGroups) {
+      return invalid_handle;
+    }
+
+    auto& grp = groups_[g];
+    auto const index = grp.count++;
+    auto const p = entry(grp, index);
+    ::new (p) C{std::forward<T>(fun)};
+    set_id(grp, p, h);
+    refs_[h].group = static_cast<std::uint16_t>(g);
+    refs_[h].index = static_cast<std::uint16_t>(index);
+    ++size_;
+
+    return h;
+  }
+
+  /**
+   * Remove a callback
+   *
+   * Returns `false` if the handle doesn't refer to a callback.
+   */
+  auto remove(handle h) -> bool {
+    if (h >= MaxEntries || refs_[h].group == free_group) {
+      return false;
+    }
+
+    auto& grp = groups_[refs_[h].group];
+    auto const index = refs_[h].index;
+    auto const last = grp.count - 1;
+
+    if (index != last) {
+      auto const dst = entry(grp, index);
+      auto const src = entry(grp, last);
+      std::memcpy(dst, src, grp.stride);
+      refs_[get_id(grp, dst)].index = index;
+    }
+
+    --grp.count;
+    refs_[h] = ref{};
+    --size_;
+
+    // trailing space can be given back right away
+    if (grp.offset + grp.capacity * grp.stride == end_) {
+      end_ -= (grp.capacity - grp.count) * grp.stride;
+      grp.capacity = grp.count;
+    }
+
+    if (grp.count == 0 && grp.capacity == 0) {
+      grp = group{};
+    }
+
+    return true;
+  }
+
+  /**
+   * Invoke all callbacks, grouped by type
+   *
+   * The order of the groups is unspecified, and so is the order within a
+   * group, as `remove()` moves the last callback of the group into the
+   * removed slot. The arguments are passed to each callback in turn, so
+   * they must not be consumed (e.g. moved from) by a callback.
+   */
+  void invoke_all(Args... args) {
+    for (auto const& grp : groups_) {
+      // copies, as the callables could otherwise modify the group
+      auto const call = grp.call;
+      auto const stride = grp.stride;
+      auto p = arena_ + grp.offset;
+      for (auto const end = p + grp.count * stride; p != end; p += stride) {
+        call(p, static_cast<Args>(args)...);
+      }
+    }
+  }
+
+  /**
+   * Close all gaps left by removed callbacks
+   */
+  void compact() {
+    size_type order[MaxGroups];
+    size_type n = 0;
+
+    for (size_type g = 0; g < MaxGroups; ++g) {
+      if (groups_[g].call) {
+        if (groups_[g].count == 0) {
+          groups_[g] = group{};
+        } else {
+          order[n++] = g;
+        }
+      }
+    }
+
+    // insertion sort by offset, there are only a few groups
+    for (size_type i = 1; i < n; ++i) {
+      auto const g = order[i];
+      auto j = i;
+      for (; j > 0 && groups_[order[j - 1]].offset > groups_[g].offset; --j) {
+        order[j] = order[j - 1];
+      }
+      order[j] = g;
+    }
+
+    size_type pos = 0;
+    for (size_type i = 0; i < n; ++i) {
+      auto& grp = groups_[order[i]];
+      if (grp.offset != pos) {
+        std::memmove(arena_ + pos, arena_ + grp.offset,
+                     grp.count * grp.stride);
+        grp.offset = pos;
+      }
+      grp.capacity = grp.count;
+      pos += grp.count * grp.stride;
+    }
+
+    end_ = pos;
+  }
+
+  void clear() {
+    for (auto& grp : groups_) {
+      grp = group{};
+    }
+    for (auto& r : refs_) {
+      r = ref{};
+    }
+    end_ = 0;
+    size_ = 0;
+  }
+
+  auto size() const noexcept -> size_type { return size_; }
+  auto empty() const noexcept -> bool { return size_ == 0; }
+
+  static constexpr auto max_size() noexcept -> size_type { return MaxEntries; }
+  static constexpr auto arena_size() noexcept -> size_type { return Bytes; }
+
+  // Bytes of the arena in use, including space of removed callbacks that
+  // hasn't been reclaimed yet
+  auto arena_used() const noexcept -> size_type { return end_; }
+
+ private:
+  using call_t = typename detail::vtbl<signature>::call_t;
+
+  static constexpr std::uint16_t free_group{0xFFFF};
+
+  // Each entry is the callable followed by the handle referring to it,
+  // padded to a multiple of `Alignment`.
+  static constexpr auto stride_of(size_type size) noexcept -> size_type {
+    return (size + sizeof(handle) + Alignment - 1) / Alignment * Alignment;
+  }
+
+  struct group {
+    call_t call{nullptr};
+    size_type offset{0};
+    size_type stride{0};
+    size_type count{0};
+    size_type capacity{0};
+  };
+
+  struct ref {
+    std::uint16_t group{free_group};
+    std::uint16_t index{0};
+  };
+
+  auto entry(group const& grp, size_type index) -> unsigned char* {
+    return arena_ + grp.offset + index * grp.stride;
+  }
+
+  static void set_id(group const& grp, unsigned char* p, handle h) {
+    std::memcpy(p + grp.stride - sizeof(handle), &h, sizeof(handle));
+  }
+
+  static auto get_id(group const& grp, unsigned char const* p) -> handle {
+    handle h;
+    std::memcpy(&h, p + grp.stride - sizeof(handle), sizeof(handle));
+    return h;
+  }
+
+  auto free_handle() const -> handle {
+    for (size_type h = 0; h < MaxEntries; ++h) {
+      if (refs_[h].group == free_group) {
+        return static_cast<handle>(h);
+      }
+    }
+    return invalid_handle;
+  }
+
+  // The call pointer identifies the type, except where identical code
+  // folding merged the calls of two types, which then still differ in
+  // size or behave identically.
+  auto find_group(call_t call, size_type stride) const -> size_type {
+    for (size_type g = 0; g < MaxGroups; ++g) {
+      if (groups_[g].call == call && groups_[g].stride == stride) {
+        return g;
+      }
+    }
+    return MaxGroups;
+  }
+
+  // Create a group with room for one callable
+  auto new_group(call_t call, size_type stride) -> size_type {
+    auto g = unused_group();
+
+    if (g == MaxGroups || end_ + stride > Bytes) {
+      // releases the slots of empty groups, too
+      compact();
+      g = unused_group();
+    }
+
+    if (g == MaxGroups || end_ + stride > Bytes) {
+      return MaxGroups;
+    }
+
+    groups_[g].call = call;
+    groups_[g].offset = end_;
+    groups_[g].stride = stride;
+    groups_[g].capacity = 1;
+    end_ += stride;
+
+    return g;
+  }
+
+  auto unused_group() const -> size_type {
+    for (size_type g = 0; g < MaxGroups; ++g) {
+      if (!groups_[g].call) {
+        return g;
+      }
+    }
+    return MaxGroups;
+  }
+
+  auto is_last(group const& grp) const -> bool {
+    return grp.offset + grp.capacity * grp.stride == end_;
+  }
+
+  // Make room for one more callable in `grp`. Unless there's a free slot
+  // left by a removed callable, this needs trailing space in the arena,
+  // so the group is moved to the end if necessary. Without free slots,
+  // the group isn't empty, so it survives compaction.
+  auto reserve(group& grp) -> bool {
+    if (grp.count < grp.capacity) {
+      return true;
+    }
+
+    if (!is_last(grp) || end_ + grp.stride > Bytes) {
+      compact();
+
+      if (!is_last(grp)) {
+        // move the group to the end of the arena
+        auto const first = arena_ + grp.offset;
+        auto const bytes = grp.count * grp.stride;
+        std::rotate(first, first + bytes, arena_ + end_);
+        for (auto& other : groups_) {
+          if (other.call && other.offset > grp.offset) {
+            other.offset -= bytes;
+          }
+        }
+        grp.offset = end_ - bytes;
+      }
+
+      if (end_ + grp.stride > Bytes) {
+        return false;
+      }
+    }
+
+    ++grp.capacity;
+    end_ += grp.stride;
+
+    return true;
+  }
+
+  alignas(Alignment) unsigned char arena_[Bytes];
+  group groups_[MaxGroups]{};
+  ref refs_[MaxEntries]{};
+  size_type end_{0};
+  size_type size_{0};
+};
+
+template <typename Return, typename... Args, std::size_t Bytes,
+          std::size_t MaxEntries, std::size_t MaxGroups, std::size_t Alignment>
+constexpr typename callback_table<Return(Args...), Bytes, MaxEntries,
+                                  MaxGroups, Alignment>::handle
+    callback_table<Return(Args...), Bytes, MaxEntries, MaxGroups,
+                   Alignment>::invalid_handle;
+
+} // namespace embedded
@@ -22,7 +22,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <cstring>
 
 #include "config.h"
@@ -35,6 +37,71 @@
 
 namespace embedded {
 
+/**
+ * Occupancy statistics of a circular buffer
+ *
+ * `high_water` is the largest number of items the buffer has held.
+ * `overflows` counts items that didn't fit: items dropped from the front
+ * by the `_overwrite` operations, and attempts to add items to a full
+ * buffer (which also trip an assertion). `underflows` counts attempts to
+ * remove items from an empty buffer. `pushed` and `popped` are the total
+ * numbers of items added and removed, modulo 2^32; `clear()` doesn't
+ * count as removing items. Comparing `high_water` with the capacity over
+ * a long run shows how much memory a buffer really needs.
+ */
+struct cba_statistics {
+  std::size_t high_water{0};
+  std::uint32_t overflows{0};
+  std::uint32_t underflows{0};
+  std::uint32_t pushed{0};
+  std::uint32_t popped{0};
+};
+
+namespace detail {
+
+template <typename Instrumentation>
+class cba_instrumented;
+
+template <>
+class cba_instrumented<cba_instrumentation::none> {
+ protected:
+  void record_push(std::size_t, std::size_t) {}
+  void record_pop(std::size_t) {}
+  void record_overflow(std::size_t) {}
+  void record_underflow() {}
+};
+
+template <>
+class cba_instrumented<cba_instrumentation::statistics> {
+ public:
+  cba_statistics const& statistics() const { return stats_; }
+
+  void reset_statistics() { stats_ = cba_statistics{}; }
+
+ protected:
+  void record_push(std::size_t count, std::size_t size) {
+    stats_.pushed += static_cast<std::uint32_t>(count);
+    if (stats_.high_water < size) {
+      stats_.high_water = size;
+    }
+  }
+
+  void record_pop(std::size_t count) {
+    stats_.popped += static_cast<std::uint32_t>(count);
+  }
+
+  void record_overflow(std::size_t count) {
+    stats_.overflows += static_cast<std::uint32_t>(count);
+  }
+
+  void record_underflow() { ++stats_.underflows; }
+
+ private:
+  cba_statistics stats_{};
+};
+
+} // namespace detail
+
 /**
  * An adapter to use arbitrary memory as a circular buffer
  *
@@ -52,9 +119,24 @@ namespace embedded {
  * dispose of any instances that still exist in the managed memory when it is
  * itself destroyed. It will, however, properly manage objects of non-trivial
  * type during its lifetime.
+ *
+ * By default, the capacity is determined at run-time. If `Capacity` is
+ * non-zero, it must be a power of two and match the capacity passed to
+ * the constructor. Wrapping around the end of the memory is then done by
+ * masking offsets instead of branching, which speeds up iteration and
+ * indexed access.
+ *
+ * With `cba_instrumentation::statistics`, the adapter also provides
+ * `statistics()` and `reset_statistics()` to track its occupancy (see
+ * `cba_statistics`). The default, `cba_instrumentation::none`, adds
+ * neither code nor data.
  */
-template <typename T>
-class circular_buffer_adapter {
+template <typename T, std::size_t Capacity, typename Instrumentation>
+class circular_buffer_adapter
+    : public detail::cba_instrumented<Instrumentation> {
+  static_assert((Capacity & (Capacity - 1)) == 0,
+                "Capacity must be zero or a power of two");
+
  public:
   using value_type = typename std::remove_const<T>::type;
   using reference = T&;
@@ -64,16 +146,23 @@ class circular_buffer_adapter {
   using size_type = std::size_t;
   using difference_type = std::ptrdiff_t;
 
-  using iterator =
-      detail::cba_iterator<T, detail::cba_mutable_iterator_traits<T>>;
-  using const_iterator =
-      detail::cba_iterator<T, detail::cba_const_iterator_traits<T>>;
+  using iterator = typename detail::cba_iterator_type<
+      T, detail::cba_mutable_iterator_traits<T>, circular_buffer_adapter,
+      Capacity>::type;
+  using const_iterator = typename detail::cba_iterator_type<
+      T, detail::cba_const_iterator_traits<T>, circular_buffer_adapter,
+      Capacity>::type;
 
   using reverse_iterator = std::reverse_iterator<iterator>;
   using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
+  using array_range = detail::cba_array_range<T>;
+  using array_ranges = detail::cba_array_ranges<T>;
+
   friend iterator;
   friend const_iterator;
+  friend struct detail::cba_segments<iterator>;
+  friend struct detail::cba_segments<const_iterator>;
 
   circular_buffer_adapter() = default;
 
@@ -100,14 +189,16 @@ class circular_buffer_adapter {
       , size_{item_count} {
     assert(begin <= first);
     assert(first <= end);
+    assert(Capacity == 0 || end - begin == Capacity);
     assert(size_ <= capacity());
+    this->record_push(0, size_);
   }
 
-  iterator begin() const { return iterator(this, first_iter()); }
-  iterator end() const { return iterator(this, nullptr); }
+  iterator begin() const { return iterator::first(this); }
+  iterator end() const { return iterator::last(this); }
 
-  const_iterator cbegin() const { return const_iterator(this, first_iter()); }
-  const_iterator cend() const { return const_iterator(this, nullptr); }
+  const_iterator cbegin() const { return const_iterator::first(this); }
+  const_iterator cend() const { return const_iterator::last(this); }
 
   reverse_iterator rbegin() const { return reverse_iterator(end()); }
   reverse_iterator rend() const { return reverse_iterator(begin()); }
@@ -128,7 +219,9 @@ class circular_buffer_adapter {
   bool empty() const { return size_ == 0; }
   bool full() const { return size_ == capacity(); }
 
-  size_type capacity() const { return std::distance(begin_, end_); }
+  size_type capacity() const {
+    return Capacity != 0 ? Capacity : std::distance(begin_, end_);
+  }
   size_type size() const { return size_; }
   size_type remaining() const { return capacity() - size_; }
 
@@ -157,82 +250,171 @@ class circular_buffer_adapter {
   }
 
   void push_front(const value_type& value) {
-    assert(!full());
+    check_push(1);
     new (prev(first_)) value_type(value);
     dec(first_);
     ++size_;
+    this->record_push(1, size_);
   }
 
   void push_front(value_type&& value) {
-    assert(!full());
+    check_push(1);
     new (prev(first_)) value_type(std::move(value));
     dec(first_);
     ++size_;
+    this->record_push(1, size_);
   }
 
   template <typename... Args>
   reference emplace_front(Args&&... args) {
-    assert(!full());
+    check_push(1);
     auto p = new (prev(first_)) value_type(std::forward<Args>(args)...);
     dec(first_);
     ++size_;
+    this->record_push(1, size_);
     return *p;
   }
 
   void pop_front() {
-    assert(!empty());
+    check_pop(1);
     destroy(first_);
     inc(first_);
     --size_;
+    this->record_pop(1);
   }
 
   void pop_front(size_type count) {
-    assert(count <= size());
+    check_pop(count);
     destroy<T>(first_, count);
     first_ = add(first_, count);
     size_ -= count;
+    this->record_pop(count);
   }
 
   void push_back(const value_type& value) {
-    assert(!full());
+    check_push(1);
     new (last_) value_type(value);
     inc(last_);
     ++size_;
+    this->record_push(1, size_);
   }
 
   void push_back(value_type&& value) {
-    assert(!full());
+    check_push(1);
     new (last_) value_type(std::move(value));
     inc(last_);
     ++size_;
+    this->record_push(1, size_);
   }
 
   template <typename... Args>
   reference emplace_back(Args&&... args) {
-    assert(!full());
+    check_push(1);
     auto p = new (last_) value_type(std::forward<Args>(args)...);
     inc(last_);
     ++size_;
+    this->record_push(1, size_);
     return *p;
   }
 
+  /**
+   * Add an item at the back, removing the front item if the buffer is full
+   *
+   * The arguments may refer to items in the buffer, including the front
+   * item. If constructing the new item throws, the buffer is unchanged.
+   * If moving it into the buffer throws, the front item is gone anyway.
+   */
+  void push_back_overwrite(const value_type& value) {
+    emplace_back_overwrite(value);
+  }
+
+  void push_back_overwrite(value_type&& value) {
+    emplace_back_overwrite(std::move(value));
+  }
+
+  template <typename... Args>
+  reference emplace_back_overwrite(Args&&... args) {
+    if (full()) {
+      // the arguments may refer to the front item, so build the new
+      // item before dropping it
+      value_type tmp(std::forward<Args>(args)...);
+      destroy(first_);
+      inc(first_);
+      --size_;
+      this->record_overflow(1);
+      return emplace_back(std::move(tmp));
+    }
+    return emplace_back(std::forward<Args>(args)...);
+  }
+
   void pop_back() {
-    assert(!empty());
+    check_pop(1);
     dec(last_);
     destroy(last_);
     --size_;
+    this->record_pop(1);
   }
 
   void pop_back(size_type count) {
-    assert(count <= size());
+    check_pop(count);
     last_ = sub(last_, count);
     destroy<T>(last_, count);
     size_ -= count;
+    this->record_pop(count);
+  }
+
+  /**
+   * The first contiguous run of items, starting at the front
+   */
+  array_range array_one() const {
+    return {first_, size_ < contiguous(first_) ? size_ : contiguous(first_)};
+  }
+
+  /**
+   * The remaining items after `array_one()`, starting at the beginning of
+   * the memory, or an empty range if all items are contiguous
+   */
+  array_range array_two() const {
+    auto const one = contiguous(first_);
+    return {begin_, size_ > one ? size_ - one : 0};
   }
 
-  template <typename Traits>
-  size_type raw_index(detail::cba_iterator<T, Traits> const& it) const {
-    return std::distance(begin_, it.realiter());
+  /**
+   * Up to `count` items at the front, in at most two contiguous runs
+   */
+  array_ranges peek_front(size_type count) const {
+    return ranges(first_, count < size_ ? count : size_);
+  }
+
+  /**
+   * Up to `count` free slots at the back, in at most two contiguous runs
+   *
+   * This allows writing directly into the memory (e.g. with DMA). The
+   * items only become part of the buffer with `commit_back()`. For a
+   * non-trivial type, objects must have been constructed in the slots.
+   */
+  array_ranges reserve_back(size_type count) const {
+    return ranges(last_, count < remaining() ? count : remaining());
+  }
+
+  /**
+   * Append `count` items previously written to the `reserve_back()` slots
+   */
+  void commit_back(size_type count) {
+    check_push(count);
+    last_ = add(last_, count);
+    size_ += count;
+    this->record_push(count, size_);
+  }
+
+  /**
+   * Remove `count` items from the front, e.g. after processing them in
+   * place through `array_one()` and `array_two()`
+   */
+  void consume_front(size_type count) { pop_front(count); }
+
+  size_type raw_index(const_iterator const& it) const {
+    return std::distance(const_cast<const_pointer>(begin_), it.realiter());
   }
 
   template <typename U,
@@ -240,10 +422,11 @@ class circular_buffer_adapter {
                                         std::is_same<U, value_type>::value,
                                     bool>::type = true>
   void copy_in_front(U const* data, size_type count) {
-    assert(count <= remaining());
+    check_push(count);
     auto new_first = sub(first_, count);
     copy_in(new_first, data, count);
     size_ += count;
+    this->record_push(count, size_);
     first_ = new_first;
   }
 
@@ -252,10 +435,37 @@ class circular_buffer_adapter {
                                         std::is_same<U, value_type>::value,
                                     bool>::type = true>
   void copy_in_back(U const* data, size_type count) {
-    assert(count <= remaining());
+    check_push(count);
     copy_in(last_, data, count);
     last_ = add(last_, count);
     size_ += count;
+    this->record_push(count, size_);
+  }
+
+  /**
+   * Append `count` items, removing as many items from the front as
+   * necessary to make room
+   *
+   * If `count` exceeds the capacity, only the last `capacity()` items
+   * are kept.
+   */
+  template <typename U,
+            typename std::enable_if<std::is_trivial<U>::value &&
+                                        std::is_same<U, value_type>::value,
+                                    bool>::type = true>
+  void copy_in_back_overwrite(U const* data, size_type count) {
+    auto const total = count;
+    if (count > capacity()) {
+      data += count - capacity();
+      count = capacity();
+    }
+    auto const overflow = count > remaining() ? count - remaining() : 0;
+    copy_in(last_, data, count);
+    last_ = add(last_, count);
+    first_ = add(first_, overflow);
+    size_ += count - overflow;
+    this->record_overflow(total - count + overflow);
+    this->record_push(total, size_);
   }
 
   template <typename U,
@@ -263,10 +473,11 @@ class circular_buffer_adapter {
                                         std::is_same<U, value_type>::value,
                                     bool>::type = true>
   void copy_out_front(U* data, size_type count) {
-    assert(count <= size());
+    check_pop(count);
     copy_out(data, first_, count);
     first_ = add(first_, count);
     size_ -= count;
+    this->record_pop(count);
   }
 
   template <typename U,
@@ -274,11 +485,46 @@ class circular_buffer_adapter {
                                         std::is_same<U, value_type>::value,
                                     bool>::type = true>
   void copy_out_back(U* data, size_type count) {
-    assert(count <= size());
+    check_pop(count);
     auto new_last = sub(last_, count);
     copy_out(data, new_last, count);
     size_ -= count;
     last_ = new_last;
+    this->record_pop(count);
+  }
+
+  /**
+   * Move-construct `count` items from `data` at the back
+   *
+   * Unlike `copy_in_back()`, this works for any type, and uses `memcpy`
+   * for trivially copyable types. If a constructor throws, the items
+   * constructed so far are destroyed and the buffer is left unchanged.
+   */
+  template <typename U,
+            typename std::enable_if<std::is_same<U, value_type>::value,
+                                    bool>::type = true>
+  void move_in_back(U* data, size_type count) {
+    check_push(count);
+    move_in<U>(ranges(last_, count), data);
+    last_ = add(last_, count);
+    size_ += count;
+    this->record_push(count, size_);
+  }
+
+  /**
+   * Move-assign `count` items from the front to `data`, then remove them
+   *
+   * Unlike `copy_out_front()`, this works for any type, and uses `memcpy`
+   * for trivially copyable types. If an assignment throws, the buffer is
+   * left unchanged.
+   */
+  template <typename U,
+            typename std::enable_if<std::is_same<U, value_type>::value,
+                                    bool>::type = true>
+  void move_out_front(U* data, size_type count) {
+    assert(count <= size());
+    move_out<U>(data, ranges(first_, count));
+    pop_front(count);
   }
 
   template <typename U,
@@ -289,7 +535,7 @@ class circular_buffer_adapter {
     assert(begin() <= first);
     assert(first <= last);
     assert(last <= end());
-    copy_in(first.it_, data, last - first);
+    copy_in(first.realiter(), data, last - first);
   }
 
   template <typename U,
@@ -300,10 +546,24 @@ class circular_buffer_adapter {
     assert(begin() <= first);
     assert(first <= last);
     assert(last <= end());
-    copy_out(data, first.it_, last - first);
+    copy_out(data, first.realiter(), last - first);
   }
 
  private:
+  void check_push(size_type count) {
+    if (count > remaining()) {
+      this->record_overflow(count - remaining());
+    }
+    assert(count <= remaining());
+  }
+
+  void check_pop(size_type count) {
+    if (count > size_) {
+      this->record_underflow();
+    }
+    assert(count <= size());
+  }
+
   template <typename Func>
   void copy_in_impl(pointer dest, value_type const* src, size_type count,
                     Func const& copy_fn) {
@@ -345,12 +605,65 @@ class circular_buffer_adapter {
                   });
   }
 
-  template <typename U, typename std::enable_if<std::is_trivial<U>::value,
-                                                bool>::type = true>
+  template <typename U,
+            typename std::enable_if<std::is_trivially_copyable<U>::value,
+                                    bool>::type = true>
+  void move_in(array_ranges const& r, value_type* src) {
+    std::memcpy(r.first.data, src, sizeof(*src) * r.first.size);
+    std::memcpy(r.second.data, src + r.first.size,
+                sizeof(*src) * r.second.size);
+  }
+
+  template <typename U,
+            typename std::enable_if<!std::is_trivially_copyable<U>::value,
+                                    bool>::type = true>
+  void move_in(array_ranges const& r, value_type* src) {
+    construct_guard guard{this, r.first.data, 0};
+    for (auto& dest : r.first) {
+      new (&dest) value_type(std::move(*src++));
+      ++guard.count;
+    }
+    for (auto& dest : r.second) {
+      new (&dest) value_type(std::move(*src++));
+      ++guard.count;
+    }
+    guard.count = 0;
+  }
+
+  template <typename U,
+            typename std::enable_if<std::is_trivially_copyable<U>::value,
+                                    bool>::type = true>
+  void move_out(value_type* dest, array_ranges const& r) const {
+    std::memcpy(dest, r.first.data, sizeof(*dest) * r.first.size);
+    std::memcpy(dest + r.first.size, r.second.data,
+                sizeof(*dest) * r.second.size);
+  }
+
+  template <typename U,
+            typename std::enable_if<!std::is_trivially_copyable<U>::value,
+                                    bool>::type = true>
+  void move_out(value_type* dest, array_ranges const& r) const {
+    dest = std::move(r.first.begin(), r.first.end(), dest);
+    std::move(r.second.begin(), r.second.end(), dest);
+  }
+
+  // destroys the first `count` items constructed at `first` on unwinding
+  struct construct_guard {
+    circular_buffer_adapter* self;
+    pointer first;
+    size_type count;
+
+    ~construct_guard() { self->template destroy<T>(first, count); }
+  };
+
+  template <typename U,
+            typename std::enable_if<std::is_trivially_destructible<U>::value,
+                                    bool>::type = true>
   void destroy(pointer, size_type) {}
 
-  template <typename U, typename std::enable_if<!std::is_trivial<U>::value,
-                                                bool>::type = true>
+  template <typename U,
+            typename std::enable_if<!std::is_trivially_destructible<U>::value,
+                                    bool>::type = true>
   void destroy(pointer first, size_type count) {
     while (count > 0) {
       destroy(first);
@@ -363,6 +676,22 @@ class circular_buffer_adapter {
 
   pointer first_iter() const { return size_ != 0 ? first_ : 0; }
 
+  // number of slots from `p` to the end of the memory
+  size_type contiguous(const_pointer p) const {
+    return std::distance(p, const_cast<const_pointer>(end_));
+  }
+
+  array_ranges ranges(pointer p, size_type count) const {
+    auto const one = contiguous(p);
+    if (count <= one) {
+      return {{p, count}, {begin_, 0}};
+    }
+    return {{p, one}, {begin_, count - one}};
+  }
+
+  // Single steps keep the branch, as it is well predicted (or turned
+  // into a conditional move) and has a shorter dependency chain than
+  // masking the offset.
   void inc(pointer& p) const {
     assert(p != nullptr);
     if (++p == end_) {
@@ -378,6 +707,11 @@ class circular_buffer_adapter {
     --p;
   }
 
+  // only used with a static capacity
+  pointer masked(difference_type offset) const {
+    return begin_ + (static_cast<size_type>(offset) & (Capacity - 1));
+  }
+
   pointer prev(pointer p) const {
     dec(p);
     return p;
@@ -390,18 +724,28 @@ class circular_buffer_adapter {
   pointer add(pointer p, difference_type n) const {
     assert(p != nullptr);
     assert(n >= 0);
+    if (Capacity != 0) {
+      return masked(std::distance(begin_, p) + n);
+    }
     return p + (n < std::distance(p, end_) ? n : wrap_around(n));
   }
 
   pointer sub(pointer p, difference_type n) const {
     assert(p != nullptr);
     assert(n >= 0);
+    if (Capacity != 0) {
+      return masked(std::distance(begin_, p) - n);
+    }
     return p - (n <= std::distance(begin_, p) ? n : wrap_around(n));
   }
 
   difference_type index(const_pointer cp) const {
     assert(cp != nullptr);
     auto p = const_cast<pointer>(cp);
+    if (Capacity != 0) {
+      return static_cast<difference_type>(
+          static_cast<size_type>(std::distance(first_, p)) & (Capacity - 1));
+    }
     return p < first_ ? std::distance(first_, end_) + std::distance(begin_, p)
                       : std::distance(first_, p);
   }
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
+
+#include "circular_buffer_adapter.h"
+
+namespace embedded {
+
+/**
+ * Segment-aware algorithms for `circular_buffer_adapter` iterators
+ *
+ * Stepping through a circular buffer item by item has to deal with the
+ * wrap-around at the end of the memory, which keeps compilers from
+ * unrolling or vectorizing loops. The algorithms in this file split an
+ * iterator range into at most two contiguous pointer ranges and run the
+ * corresponding standard algorithm on each of them.
+ *
+ * They only participate in overload resolution for adapter iterators, so
+ * they can be called as e.g. `embedded::accumulate(cb.begin(), cb.end(),
+ * 0)` without ambiguity.
+ */
+
+namespace detail {
+
+template <typename Iterator, typename R>
+using enable_if_cba_iterator =
+    typename std::enable_if<is_cba_iterator<Iterator>::value, R>::type;
+
+} // namespace detail
+
+/**
+ * Call `fn(begin, end)` for each contiguous pointer range in the range
+ * from `first` to `last`
+ */
+template <typename Iterator, typename Function>
+auto for_each_segment(Iterator first, Iterator last, Function fn)
+    -> detail::enable_if_cba_iterator<Iterator, Function> {
+  auto const r = detail::cba_segments<Iterator>::get(first, last);
+  if (!r.first.empty()) {
+    fn(r.first.begin(), r.first.end());
+  }
+  if (!r.second.empty()) {
+    fn(r.second.begin(), r.second.end());
+  }
+  return fn;
+}
+
+template <typename Iterator, typename OutputIt>
+auto copy(Iterator first, Iterator last, OutputIt out)
+    -> detail::enable_if_cba_iterator<Iterator, OutputIt> {
+  auto const r = detail::cba_segments<Iterator>::get(first, last);
+  out = std::copy(r.first.begin(), r.first.end(), out);
+  return std::copy(r.second.begin(), r.second.end(), out);
+}
+
+template <typename InputIt, typename Iterator>
+auto copy(InputIt first, InputIt last, Iterator out) -> typename std::enable_if<
+    !detail::is_cba_iterator<InputIt>::value &&
+        detail::is_cba_iterator<Iterator>::value,
+    Iterator>::type {
+  auto const n = std::distance(first, last);
+  auto const r = detail::cba_segments<Iterator>::get(out, out + n);
+  auto mid = first;
+  std::advance(mid, r.first.size);
+  std::copy(first, mid, r.first.begin());
+  std::copy(mid, last, r.second.begin());
+  return out + n;
+}
+
+template <typename Iterator, typename T>
+auto fill(Iterator first, Iterator last, T const& value)
+    -> detail::enable_if_cba_iterator<Iterator, void> {
+  auto const r = detail::cba_segments<Iterator>::get(first, last);
+  std::fill(r.first.begin(), r.first.end(), value);
+  std::fill(r.second.begin(), r.second.end(), value);
+}
+
+template <typename Iterator, typename T>
+auto accumulate(Iterator first, Iterator last, T init)
+    -> detail::enable_if_cba_iterator<Iterator, T> {
+  auto const r = detail::cba_segments<Iterator>::get(first, last);
+  init = std::accumulate(r.first.begin(), r.first.end(), init);
+  return std::accumulate(r.second.begin(), r.second.end(), init);
+}
+
+template <typename Iterator, typename T, typename BinaryOp>
+auto accumulate(Iterator first, Iterator last, T init, BinaryOp op)
+    -> detail::enable_if_cba_iterator<Iterator, T> {
+  auto const r = detail::cba_segments<Iterator>::get(first, last);
+  init = std::accumulate(r.first.begin(), r.first.end(), init, op);
+  return std::accumulate(r.second.begin(), r.second.end(), init, op);
+}
+
+/**
+ * Dot product of the range from `first1` to `last1` and the range
+ * starting at `first2`, e.g. a FIR delay line and its coefficients
+ */
+template <typename Iterator, typename InputIt, typename T>
+auto inner_product(Iterator first1, Iterator last1, InputIt first2, T init)
+    -> detail::enable_if_cba_iterator<Iterator, T> {
+  auto const r = detail::cba_segments<Iterator>::get(first1, last1);
+  init = std::inner_product(r.first.begin(), r.first.end(), first2, init);
+  std::advance(first2, r.first.size);
+  return std::inner_product(r.second.begin(), r.second.end(), first2, init);
+}
+
+template <typename Iterator, typename Compare>
+auto min_element(Iterator first, Iterator last, Compare comp)
+    -> detail::enable_if_cba_iterator<Iterator, Iterator> {
+  auto const r = detail::cba_segments<Iterator>::get(first, last);
+  if (r.empty()) {
+    return last;
+  }
+  auto const a = std::min_element(r.first.begin(), r.first.end(), comp);
+  auto const b = std::min_element(r.second.begin(), r.second.end(), comp);
+  // `a` wins ties, as it comes first
+  if (b != r.second.end() && comp(*b, *a)) {
+    return first + (r.first.size + (b - r.second.begin()));
+  }
+  return first + (a - r.first.begin());
+}
+
+template <typename Iterator>
+auto min_element(Iterator first, Iterator last)
+    -> detail::enable_if_cba_iterator<Iterator, Iterator> {
+  using value_type = typename std::iterator_traits<Iterator>::value_type;
+  return embedded::min_element(first, last, std::less<value_type>());
+}
+
+template <typename Iterator, typename Compare>
+auto max_element(Iterator first, Iterator last, Compare comp)
+    -> detail::enable_if_cba_iterator<Iterator, Iterator> {
+  auto const r = detail::cba_segments<Iterator>::get(first, last);
+  if (r.empty()) {
+    return last;
+  }
+  auto const a = std::max_element(r.first.begin(), r.first.end(), comp);
+  auto const b = std::max_element(r.second.begin(), r.second.end(), comp);
+  // `a` wins ties, as it comes first
+  if (b != r.second.end() && comp(*a, *b)) {
+    return first + (r.first.size + (b - r.second.begin()));
+  }
+  return first + (a - r.first.begin());
+}
+
+template <typename Iterator>
+auto max_element(Iterator first, Iterator last)
+    -> detail::enable_if_cba_iterator<Iterator, Iterator> {
+  using value_type = typename std::iterator_traits<Iterator>::value_type;
+  return embedded::max_element(first, last, std::less<value_type>());
+}
+
+} // namespace embedded
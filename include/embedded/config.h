@@ -33,3 +33,79 @@
 #else
 #define LIBEMB_HAS_RTTI 0
 #endif
+
+// Width in bytes of the SIMD registers used by vectorized kernels, or 0
+// if only the scalar fallback should be used. This relies on the GNU
+// vector extensions, which are lowered to SSE/AVX on x86 and NEON/Helium
+// on ARM. Define LIBEMB_SIMD_BYTES to override the detection.
+#if !defined(LIBEMB_SIMD_BYTES)
+#if defined(__GNUC__) && !defined(__IAR_SYSTEMS_ICC__)
+#if defined(__AVX__)
+#define LIBEMB_SIMD_BYTES 32
+#elif defined(__SSE2__) || defined(__ARM_NEON) || defined(__ARM_FEATURE_MVE)
+#define LIBEMB_SIMD_BYTES 16
+#else
+#define LIBEMB_SIMD_BYTES 0
+#endif
+#else
+#define LIBEMB_SIMD_BYTES 0
+#endif
+#endif
+
+// Size in bytes of the cache lines that data written from different
+// cores should be kept apart by, or 0 on single-core targets where this
+// would only waste memory. Define LIBEMB_CACHE_LINE_SIZE to override.
+#if !defined(LIBEMB_CACHE_LINE_SIZE)
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__) ||        \
+    defined(_M_X64) || defined(_M_IX86) || defined(_M_ARM64)
+#define LIBEMB_CACHE_LINE_SIZE 64
+#else
+#define LIBEMB_CACHE_LINE_SIZE 0
+#endif
+#endif
+
+// Whether `varint::decode` uses 64-bit word loads for contiguous input.
+// This pays off on targets with 64-bit registers, while on 32-bit MCUs
+// the byte-wise loop is faster. Define LIBEMB_VARINT_WORD_DECODE to 0 or
+// 1 to override.
+#if !defined(LIBEMB_VARINT_WORD_DECODE)
+#if defined(__x86_64__) || defined(__aarch64__) || defined(_M_X64) ||          \
+    defined(_M_ARM64)
+#define LIBEMB_VARINT_WORD_DECODE 1
+#else
+#define LIBEMB_VARINT_WORD_DECODE 0
+#endif
+#endif
+
+// Whether C++14 relaxed constexpr (loops and local variables) can be used.
+// The compile-time math library then uses iterative algorithms instead of
+// recursive templates, which is a lot faster to compile for high orders.
+// Define LIBEMB_RELAXED_CONSTEXPR to 0 to force the C++11 implementation.
+#if !defined(LIBEMB_RELAXED_CONSTEXPR)
+#if defined(__cpp_constexpr) && __cpp_constexpr >= 201304L
+#define LIBEMB_RELAXED_CONSTEXPR 1
+#else
+#define LIBEMB_RELAXED_CONSTEXPR 0
+#endif
+#endif
+
+// Compiler builtin used to generate integer sequences without recursion:
+// 1 for `__make_integer_seq` (Clang, MSVC), 2 for `__integer_pack` (GCC 8
+// and later), or 0 for the portable implementation, which recurses with
+// logarithmic depth. Define LIBEMB_INTEGER_SEQUENCE_BUILTIN to override.
+#if !defined(LIBEMB_INTEGER_SEQUENCE_BUILTIN)
+#if defined(__has_builtin) && !defined(__IAR_SYSTEMS_ICC__)
+#if __has_builtin(__make_integer_seq)
+#define LIBEMB_INTEGER_SEQUENCE_BUILTIN 1
+#elif __has_builtin(__integer_pack)
+#define LIBEMB_INTEGER_SEQUENCE_BUILTIN 2
+#endif
+#elif defined(_MSC_VER) && !defined(__clang__)
+#define LIBEMB_INTEGER_SEQUENCE_BUILTIN 1
+#elif defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 8
+#define LIBEMB_INTEGER_SEQUENCE_BUILTIN 2
+#endif
+#if !defined(LIBEMB_INTEGER_SEQUENCE_BUILTIN)
+#define LIBEMB_INTEGER_SEQUENCE_BUILTIN 0
+#endif
+#endif
@@ -25,6 +25,8 @@
 #include "constexpr_math/complex.h"
 #include "constexpr_math/constants.h"
 #include "constexpr_math/convolve.h"
+#include "constexpr_math/elliptic.h"
 #include "constexpr_math/functions.h"
+#include "constexpr_math/lut.h"
 #include "constexpr_math/poly.h"
 #include "constexpr_math/vector.h"
@@ -22,8 +22,12 @@
 
 #pragma once
 
+#include <cassert>
 #include <cstddef>
 
+#include "../config.h"
+#include "../detail/circular_buffer_adapter.h"
+#include "../signal/detail/simd.h"
 #include "../utility/integer_sequence.h"
 #include "vector.h"
 
@@ -38,6 +42,24 @@ namespace cmath {
 
 namespace detail {
 
+#if LIBEMB_RELAXED_CONSTEXPR
+
+// sums up the products from the last to the first, like the recursive
+// implementation, to produce identical results
+template <typename T, std::size_t S1, std::size_t S2, typename I>
+constexpr auto convolve_single(vector<T, S1> const& a, vector<T, S2> const& b,
+                               I n) noexcept -> T {
+  T sum{};
+  for (I m = n + 1; m-- > 0;) {
+    sum = (m < I(a.size()) ? a[m] : T{}) *
+              (n < I(b.size()) + m ? b[n - m] : T{}) +
+          sum;
+  }
+  return sum;
+}
+
+#else
+
 template <typename T, std::size_t S1, std::size_t S2, typename I>
 constexpr auto convolve_single(vector<T, S1> const& a, vector<T, S2> const& b,
                                I n, I m = 0) noexcept -> T {
@@ -46,11 +68,175 @@ constexpr auto convolve_single(vector<T, S1> const& a, vector<T, S2> const& b,
          (m < n ? convolve_single(a, b, n, m + 1) : T{});
 }
 
+#endif
+
+// computes the outputs `Ints...` of the full convolution
 template <typename T, std::size_t S1, std::size_t S2, std::size_t... Ints>
 constexpr auto
-convolve_full_impl(vector<T, S1> const& a, vector<T, S2> const& b,
-                   index_sequence<Ints...>) noexcept -> vector<T, S1 + S2 - 1> {
-  return vector<T, S1 + S2 - 1>{convolve_single(a, b, Ints)...};
+convolve_impl(vector<T, S1> const& a, vector<T, S2> const& b,
+              index_sequence<Ints...>) noexcept -> vector<T, sizeof...(Ints)> {
+  return vector<T, sizeof...(Ints)>{convolve_single(a, b, Ints)...};
+}
+
+constexpr std::size_t convolve_min(std::size_t a, std::size_t b) noexcept {
+  return a < b ? a : b;
+}
+
+constexpr std::size_t convolve_max(std::size_t a, std::size_t b) noexcept {
+  return a < b ? b : a;
+}
+
+// Output `n` of the full convolution at run time. The products are added
+// up from the last to the first, exactly like `convolve_single()`.
+template <typename A, typename T>
+T convolve_at(A const& a, std::size_t na, T const* b, std::size_t nb,
+              std::size_t n) {
+  auto const hi = n < na ? n : na - 1;
+  auto const lo = n + 1 > nb ? n + 1 - nb : 0;
+  T sum{};
+  for (auto m = hi + 1; m-- > lo;) {
+    sum += a[m] * b[n - m];
+  }
+  return sum;
+}
+
+// Computes `y[i] = sum(c[k * cs] * x[i + k * xs])` for `i` from 0 to
+// `n - 1`, adding up the products in order of increasing `k`. Outputs
+// are computed in groups of `U` independent accumulators, so each
+// coefficient is only loaded once per group. With SIMD support, each
+// accumulator is a vector of consecutive outputs. The accumulators are
+// expanded from an index sequence rather than looped over, so they are
+// kept in registers even if the compiler doesn't unroll small loops.
+template <typename T, std::size_t U,
+          std::size_t W = signal::detail::simd<T>::width>
+struct convolve_kernel {
+  using vec = signal::detail::simd<T>;
+  using vector_type = typename vec::type;
+
+  static auto run(T const* c, std::ptrdiff_t cs, std::size_t taps,
+                  T const* x, std::ptrdiff_t xs, T* y, std::size_t n)
+      -> std::size_t {
+    std::size_t i = 0;
+    for (; i + U * W <= n; i += U * W) {
+      block(c, cs, taps, x + i, xs, y + i, make_index_sequence<U>{});
+    }
+    return i;
+  }
+
+ private:
+  template <std::size_t... Us>
+  static void block(T const* c, std::ptrdiff_t cs, std::size_t taps,
+                    T const* x, std::ptrdiff_t xs, T* y,
+                    index_sequence<Us...>) {
+    using expand = int[];
+    vector_type acc[U];
+    static_cast<void>(expand{0, (acc[Us] = vec::broadcast(T{0}), 0)...});
+    for (std::size_t k = 0; k < taps; ++k) {
+      auto const ik = static_cast<std::ptrdiff_t>(k);
+      vector_type const ck = vec::broadcast(c[ik * cs]);
+      T const* xk = x + ik * xs;
+      static_cast<void>(
+          expand{0, (acc[Us] += ck * vec::load(xk + Us * W), 0)...});
+    }
+    static_cast<void>(expand{0, (vec::store(y + Us * W, acc[Us]), 0)...});
+  }
+};
+
+template <typename T, std::size_t U>
+struct convolve_kernel<T, U, 1> {
+  static auto run(T const* c, std::ptrdiff_t cs, std::size_t taps,
+                  T const* x, std::ptrdiff_t xs, T* y, std::size_t n)
+      -> std::size_t {
+    std::size_t i = 0;
+    for (; i + U <= n; i += U) {
+      block(c, cs, taps, x + i, xs, y + i, make_index_sequence<U>{});
+    }
+    return i;
+  }
+
+ private:
+  template <std::size_t... Us>
+  static void block(T const* c, std::ptrdiff_t cs, std::size_t taps,
+                    T const* x, std::ptrdiff_t xs, T* y,
+                    index_sequence<Us...>) {
+    using expand = int[];
+    T acc[U]{};
+    for (std::size_t k = 0; k < taps; ++k) {
+      auto const ik = static_cast<std::ptrdiff_t>(k);
+      T const ck = c[ik * cs];
+      T const* xk = x + ik * xs;
+      static_cast<void>(expand{0, (acc[Us] += ck * xk[Us], 0)...});
+    }
+    static_cast<void>(expand{0, (y[Us] = acc[Us], 0)...});
+  }
+};
+
+// Computes the outputs `first` to `last - 1` of the full convolution.
+// Outputs that cover all of the shorter input go through the blocked
+// kernels, the ones at both ends are computed one by one.
+template <typename T>
+T* convolve_range(T const* a, std::size_t na, T const* b, std::size_t nb,
+                  T* out, std::size_t first, std::size_t last) {
+  auto const lo = convolve_min(na, nb) - 1;
+  auto const hi = convolve_min(convolve_max(na, nb), last);
+  auto n = first;
+
+  for (; n < last && n < lo; ++n) {
+    *out++ = convolve_at(a, na, b, nb, n);
+  }
+
+  if (n < hi) {
+    // For na >= nb, the products for output n are a[n - k] * b[k],
+    // otherwise a[na - 1 - k] * b[n - (na - 1) + k].
+    auto const count = hi - n;
+    auto const off = static_cast<std::ptrdiff_t>(n);
+    auto const done =
+        na >= nb
+            ? convolve_kernel<T, 4>::run(b, 1, nb, a + off, -1, out, count)
+            : convolve_kernel<T, 4>::run(a + (na - 1), -1, na,
+                                         b + (off - (na - 1)), 1, out, count);
+    out += done;
+    n += done;
+  }
+
+  for (; n < last; ++n) {
+    *out++ = convolve_at(a, na, b, nb, n);
+  }
+
+  return out;
+}
+
+// Same as above for the items of a circular buffer, which consist of up
+// to two contiguous runs. Only the outputs that depend on items from both
+// runs are computed one by one.
+template <typename T, std::size_t Capacity, typename Instrumentation>
+T* convolve_range(
+    circular_buffer_adapter<T, Capacity, Instrumentation> const& a,
+    T const* b, std::size_t nb, T* out, std::size_t first, std::size_t last) {
+  auto const one = a.array_one();
+  auto const two = a.array_two();
+
+  if (two.empty()) {
+    return convolve_range<T>(one.data, one.size, b, nb, out, first, last);
+  }
+
+  auto const seam = one.size;
+  auto const seam_first = convolve_min(last, convolve_max(first, seam));
+  auto const seam_last =
+      convolve_min(last, convolve_max(seam_first, seam + nb - 1));
+
+  out = convolve_range<T>(one.data, seam, b, nb, out, first, seam_first);
+
+  for (auto n = seam_first; n < seam_last; ++n) {
+    *out++ = convolve_at(a, a.size(), b, nb, n);
+  }
+
+  if (seam_last < last) {
+    out = convolve_range<T>(two.data, two.size, b, nb, out, seam_last - seam,
+                            last - seam);
+  }
+
+  return out;
 }
 
 } // namespace detail
@@ -59,7 +245,91 @@ template <typename T, std::size_t S1, std::size_t S2>
 constexpr auto
 convolve_full(vector<T, S1> const& a, vector<T, S2> const& b) noexcept
     -> vector<T, S1 + S2 - 1> {
-  return detail::convolve_full_impl(a, b, make_index_sequence<S1 + S2 - 1>{});
+  return detail::convolve_impl(a, b, make_index_sequence<S1 + S2 - 1>{});
+}
+
+/**
+ * The part of the full convolution where `a` and `b` overlap completely
+ */
+template <typename T, std::size_t S1, std::size_t S2>
+constexpr auto
+convolve_valid(vector<T, S1> const& a, vector<T, S2> const& b) noexcept
+    -> vector<T, (S1 < S2 ? S2 - S1 : S1 - S2) + 1> {
+  return detail::convolve_impl(
+      a, b, make_index_range<(S1 < S2 ? S1 : S2) - 1, (S1 < S2 ? S2 : S1)>{});
+}
+
+/**
+ * The central part of the full convolution with the same size as `a`
+ */
+template <typename T, std::size_t S1, std::size_t S2>
+constexpr auto
+convolve_same(vector<T, S1> const& a, vector<T, S2> const& b) noexcept
+    -> vector<T, S1> {
+  return detail::convolve_impl(
+      a, b, make_index_range<(S2 - 1) / 2, (S2 - 1) / 2 + S1>{});
+}
+
+/**
+ * Run-time versions of `convolve_full()`, `convolve_valid()` and
+ * `convolve_same()`
+ *
+ * These write the result to `out` and return a pointer past the last
+ * output. Both inputs must not be empty. The input `a` can also be a
+ * `circular_buffer_adapter`, e.g. a history of captured samples.
+ *
+ * Each output is the sum of the products in the same order as in the
+ * compile-time versions, so the results are identical unless the compiler
+ * contracts the multiplications and additions (e.g. `-ffp-contract=fast`
+ * on targets with FMA).
+ */
+template <typename T>
+T* convolve_full(T const* a, std::size_t na, T const* b, std::size_t nb,
+                 T* out) {
+  assert(na > 0 && nb > 0);
+  return detail::convolve_range(a, na, b, nb, out, 0, na + nb - 1);
+}
+
+template <typename T>
+T* convolve_valid(T const* a, std::size_t na, T const* b, std::size_t nb,
+                  T* out) {
+  assert(na > 0 && nb > 0);
+  return detail::convolve_range(a, na, b, nb, out,
+                                detail::convolve_min(na, nb) - 1,
+                                detail::convolve_max(na, nb));
+}
+
+template <typename T>
+T* convolve_same(T const* a, std::size_t na, T const* b, std::size_t nb,
+                 T* out) {
+  assert(na > 0 && nb > 0);
+  return detail::convolve_range(a, na, b, nb, out, (nb - 1) / 2,
+                                (nb - 1) / 2 + na);
+}
+
+template <typename T, std::size_t Capacity, typename Instrumentation>
+T* convolve_full(circular_buffer_adapter<T, Capacity, Instrumentation> const& a,
+                 T const* b, std::size_t nb, T* out) {
+  assert(!a.empty() && nb > 0);
+  return detail::convolve_range(a, b, nb, out, 0, a.size() + nb - 1);
+}
+
+template <typename T, std::size_t Capacity, typename Instrumentation>
+T* convolve_valid(
+    circular_buffer_adapter<T, Capacity, Instrumentation> const& a,
+    T const* b, std::size_t nb, T* out) {
+  assert(!a.empty() && nb > 0);
+  return detail::convolve_range(a, b, nb, out,
+                                detail::convolve_min(a.size(), nb) - 1,
+                                detail::convolve_max(a.size(), nb));
+}
+
+template <typename T, std::size_t Capacity, typename Instrumentation>
+T* convolve_same(circular_buffer_adapter<T, Capacity, Instrumentation> const& a,
+                 T const* b, std::size_t nb, T* out) {
+  assert(!a.empty() && nb > 0);
+  return detail::convolve_range(a, b, nb, out, (nb - 1) / 2,
+                                (nb - 1) / 2 + a.size());
 }
 
 } // namespace cmath
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <limits>
+
+#include "constants.h"
+#include "functions.h"
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace cmath {
+
+template <typename T>
+struct jacobi_elliptic {
+  T sn, cn, dn;
+};
+
+namespace detail {
+
+template <typename T>
+constexpr auto agm(T a, T b) noexcept -> T {
+  return a - b <= std::numeric_limits<T>::epsilon() * a
+             ? (a + b) / T{2}
+             : agm((a + b) / T{2}, cmath::sqrt(a * b));
+}
+
+template <typename T>
+constexpr auto jacobi_am_back(T phi, T ratio) noexcept -> T {
+  return (phi + cmath::asin(ratio * cmath::sin(phi))) / T{2};
+}
+
+// Amplitude am(u | m) by the descending Landen transformation, starting
+// from a = 1, b = sqrt(1 - m), c = sqrt(m) (Abramowitz & Stegun 16.4)
+template <typename T>
+constexpr auto jacobi_am(T u, T a, T b, T c, T scale) noexcept -> T {
+  return c <= std::numeric_limits<T>::epsilon() * a
+             ? scale * a * u
+             : jacobi_am_back(jacobi_am(u, (a + b) / T{2}, cmath::sqrt(a * b),
+                                        (a - b) / T{2}, T{2} * scale),
+                              (a - b) / (a + b));
+}
+
+template <typename T>
+constexpr auto jacobi_from_am(T sn, T cn, T m) noexcept -> jacobi_elliptic<T> {
+  return jacobi_elliptic<T>{sn, cn, cmath::sqrt(T{1} - m * sn * sn)};
+}
+
+template <typename T>
+constexpr auto jacobi_from_am(T phi, T m) noexcept -> jacobi_elliptic<T> {
+  return jacobi_from_am(cmath::sin(phi), cmath::cos(phi), m);
+}
+
+// Takes the complementary parameter 1 - m separately so that callers can
+// keep its precision as m approaches 1
+template <typename T>
+constexpr auto ellipj(T u, T m, T mc) noexcept -> jacobi_elliptic<T> {
+  return jacobi_from_am(
+      jacobi_am(u, T{1}, cmath::sqrt(mc), cmath::sqrt(m), T{1}), m);
+}
+
+template <typename T>
+constexpr auto carlson_rf_series(T dx, T dy, T dz, T a) noexcept -> T {
+  return (T{1} + ((T{1} / T{24}) * (dx * dy - dz * dz) - T{1} / T{10} -
+                  (T{3} / T{44}) * (dx * dy * dz)) *
+                     (dx * dy - dz * dz) +
+          (T{1} / T{14}) * (dx * dy * dz)) /
+         cmath::sqrt(a);
+}
+
+template <typename T>
+constexpr auto carlson_rf(T x, T y, T z, T tol) noexcept -> T;
+
+template <typename T>
+constexpr auto
+carlson_rf_step(T x, T y, T z, T lambda, T tol) noexcept -> T {
+  return carlson_rf((x + lambda) / T{4}, (y + lambda) / T{4},
+                    (z + lambda) / T{4}, tol);
+}
+
+template <typename T>
+constexpr auto carlson_rf_eval(T x, T y, T z, T a, T tol) noexcept -> T {
+  return cmath::abs(a - x) <= tol * a && cmath::abs(a - y) <= tol * a &&
+                 cmath::abs(a - z) <= tol * a
+             ? carlson_rf_series((a - x) / a, (a - y) / a, (a - z) / a, a)
+             : carlson_rf_step(x, y, z,
+                               cmath::sqrt(x) * cmath::sqrt(y) +
+                                   cmath::sqrt(x) * cmath::sqrt(z) +
+                                   cmath::sqrt(y) * cmath::sqrt(z),
+                               tol);
+}
+
+// Carlson's symmetric integral R_F(x, y, z) by duplication, the
+// truncation error of the series is about tol^6 / 4
+template <typename T>
+constexpr auto carlson_rf(T x, T y, T z, T tol) noexcept -> T {
+  return carlson_rf_eval(x, y, z, (x + y + z) / T{3}, tol);
+}
+
+} // namespace detail
+
+/**
+ * Complete elliptic integral of the first kind K(m), 0 <= m < 1
+ *
+ * Note that this uses the parameter m = k^2, like scipy.special.ellipk.
+ */
+template <typename T>
+constexpr auto ellipk(T m) noexcept -> T {
+  return pi<T>() / (T{2} * detail::agm(T{1}, cmath::sqrt(T{1} - m)));
+}
+
+/**
+ * Complete elliptic integral of the first kind K(1 - p), 0 < p <= 1
+ *
+ * Accurate for small p, where computing 1 - p first would lose precision.
+ */
+template <typename T>
+constexpr auto ellipkm1(T p) noexcept -> T {
+  return pi<T>() / (T{2} * detail::agm(T{1}, cmath::sqrt(p)));
+}
+
+/**
+ * Incomplete elliptic integral of the first kind F(phi | m),
+ * |phi| <= pi / 2, 0 <= m <= 1
+ */
+template <typename T>
+constexpr auto ellipf(T phi, T m) noexcept -> T {
+  return cmath::sin(phi) *
+         detail::carlson_rf(
+             cmath::cos(phi) * cmath::cos(phi),
+             T{1} - m * cmath::sin(phi) * cmath::sin(phi), T{1},
+             cmath::pow(std::numeric_limits<T>::epsilon(), T{1} / T{6}));
+}
+
+/**
+ * Jacobi elliptic functions sn(u | m), cn(u | m) and dn(u | m),
+ * 0 <= m < 1
+ */
+template <typename T>
+constexpr auto ellipj(T u, T m) noexcept -> jacobi_elliptic<T> {
+  return detail::ellipj(u, m, T{1} - m);
+}
+
+} // namespace cmath
+} // namespace embedded
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
@@ -0,0 +1,405 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "../utility/integer_sequence.h"
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace cmath {
+
+namespace detail {
+
+// Rounds to nearest for integral table types
+template <typename T>
+constexpr T lut_convert(double v) {
+  return std::is_integral<T>::value
+             ? static_cast<T>(v < 0 ? v - 0.5 : v + 0.5)
+             : static_cast<T>(v);
+}
+
+constexpr unsigned lut_log2(std::size_t n) {
+  return n > 1 ? 1 + lut_log2(n / 2) : 0;
+}
+
+// Interpolation kernels, `y` points to the sample before the interval
+// (`y[1]` and `y[2]` are the interval bounds). The fraction `t` is either
+// an unsigned fixed point value with `F` fractional bits or a floating
+// point value in `[0, 1]`.
+template <typename T, bool = std::is_integral<T>::value>
+struct lut_interp {
+  static_assert(sizeof(T) <= 4, "integral table type is too wide");
+
+  using wide = std::int64_t;
+
+  template <unsigned F>
+  static T linear(T const* y, std::uint32_t t) {
+    auto const y0 = static_cast<wide>(y[1]);
+    auto const d = static_cast<wide>(y[2]) - y0;
+    return static_cast<T>(y0 + ((d * t + (wide{1} << (F - 1))) >> F));
+  }
+
+  template <unsigned F>
+  static T cubic(T const* y, std::uint32_t t) {
+    auto const ym = static_cast<wide>(y[0]);
+    auto const y0 = static_cast<wide>(y[1]);
+    auto const y1 = static_cast<wide>(y[2]);
+    auto const y2 = static_cast<wide>(y[3]);
+    auto const c1 = y1 - ym;
+    auto const c2 = 2 * ym - 5 * y0 + 4 * y1 - y2;
+    auto const c3 = 3 * (y0 - y1) + y2 - ym;
+    auto r = (c3 * t) >> F;
+    r = ((r + c2) * t) >> F;
+    r = (r + c1) * t;
+    return static_cast<T>(y0 + ((r + (wide{1} << F)) >> (F + 1)));
+  }
+
+  template <typename D>
+  static T linear(T const* y, D t) {
+    return linear<16>(y, static_cast<std::uint32_t>(t * D(65536)));
+  }
+
+  template <typename D>
+  static T cubic(T const* y, D t) {
+    return cubic<16>(y, static_cast<std::uint32_t>(t * D(65536)));
+  }
+};
+
+template <typename T>
+struct lut_interp<T, false> {
+  template <unsigned F>
+  static T linear(T const* y, std::uint32_t t) {
+    return linear(y, fraction<F>(t));
+  }
+
+  template <unsigned F>
+  static T cubic(T const* y, std::uint32_t t) {
+    return cubic(y, fraction<F>(t));
+  }
+
+  template <typename D>
+  static T linear(T const* y, D t) {
+    return y[1] + static_cast<T>(t) * (y[2] - y[1]);
+  }
+
+  template <typename D>
+  static T cubic(T const* y, D t) {
+    auto const u = static_cast<T>(t);
+    T const c1 = y[2] - y[0];
+    T const c2 = T(2) * y[0] - T(5) * y[1] + T(4) * y[2] - y[3];
+    T const c3 = T(3) * (y[1] - y[2]) + y[3] - y[0];
+    return y[1] + T(0.5) * u * (c1 + u * (c2 + u * c3));
+  }
+
+ private:
+  template <unsigned F>
+  static T fraction(std::uint32_t t) {
+    return static_cast<T>(t) * (T(1) / static_cast<T>(std::uint32_t{1} << F));
+  }
+};
+
+} // namespace detail
+
+/**
+ * Lookup table of a function sampled at compile time
+ *
+ * Holds `N` samples of a function at equidistant positions from `lo` to
+ * `hi`, both inclusive, see `make_lut()`. The table is evaluated with
+ * nearest neighbour, linear or cubic (Catmull-Rom) interpolation. None
+ * of the evaluators contain branches, arguments outside of `[lo, hi]`
+ * are clamped using min/max operations.
+ *
+ * The table type `T` can be a floating point type or an integral type
+ * holding scaled values. For integral types, all interpolation is done
+ * in integer arithmetic with rounding. Note that cubic interpolation may
+ * overshoot between samples, so leave some headroom.
+ *
+ * There are two flavours of evaluators: one takes the argument in the
+ * domain of the function as `domain_type`, the other (`*_fixed()`) takes
+ * a position in units of samples as unsigned fixed point value with
+ * `FracBits` fractional bits, so no floating point arithmetic at all is
+ * needed at runtime.
+ */
+template <typename T, std::size_t N,
+          typename D = typename std::conditional<
+              std::is_floating_point<T>::value, T, float>::type>
+class lut {
+  static_assert(N >= 2, "a lookup table needs at least two samples");
+  static_assert(std::is_floating_point<D>::value,
+                "domain type must be a floating point type");
+
+ public:
+  using value_type = T;
+  using domain_type = D;
+
+  /**
+   * Number of samples plus one guard sample before and two after
+   */
+  static constexpr std::size_t storage_size = N + 3;
+
+  constexpr lut(D lo, D hi, std::array<T, storage_size> const& samples)
+      : lo_{lo}
+      , scale_{static_cast<D>(N - 1) / (hi - lo)}
+      , samples_(samples) {}
+
+  static constexpr std::size_t size() { return N; }
+
+  /**
+   * Sample `i`, for `0 <= i < N`
+   */
+  T operator[](std::size_t i) const { return samples_[i + 1]; }
+
+  T nearest(D x) const {
+    return samples_[static_cast<std::size_t>(position(x) + D(0.5)) + 1];
+  }
+
+  T linear(D x) const {
+    auto const p = position(x);
+    auto const i = static_cast<std::size_t>(p);
+    return interp::linear(&samples_[i], p - static_cast<D>(i));
+  }
+
+  T cubic(D x) const {
+    auto const p = position(x);
+    auto const i = static_cast<std::size_t>(p);
+    return interp::cubic(&samples_[i], p - static_cast<D>(i));
+  }
+
+  template <unsigned FracBits>
+  T nearest_fixed(std::uint32_t pos) const {
+    static_assert(FracBits > 0, "FracBits must be positive");
+    auto const p = clamp<FracBits>(pos) + (std::uint32_t{1} << (FracBits - 1));
+    return samples_[(p >> FracBits) + 1];
+  }
+
+  template <unsigned FracBits>
+  T linear_fixed(std::uint32_t pos) const {
+    auto const p = clamp<FracBits>(pos);
+    return interp::template linear<FracBits>(&samples_[p >> FracBits],
+                                             p & mask<FracBits>());
+  }
+
+  template <unsigned FracBits>
+  T cubic_fixed(std::uint32_t pos) const {
+    auto const p = clamp<FracBits>(pos);
+    return interp::template cubic<FracBits>(&samples_[p >> FracBits],
+                                            p & mask<FracBits>());
+  }
+
+ private:
+  using interp = detail::lut_interp<T>;
+
+  D position(D x) const {
+    auto const p = (x - lo_) * scale_;
+    auto const q = p > D(0) ? p : D(0); // also maps NaN to zero
+    return q < static_cast<D>(N - 1) ? q : static_cast<D>(N - 1);
+  }
+
+  template <unsigned FracBits>
+  static constexpr std::uint32_t mask() {
+    return (std::uint32_t{1} << FracBits) - 1;
+  }
+
+  template <unsigned FracBits>
+  static std::uint32_t clamp(std::uint32_t pos) {
+    static_assert(FracBits < 32 && N <= (UINT32_MAX >> FracBits),
+                  "FracBits too large for table size");
+    static_assert(!std::is_integral<T>::value ||
+                      std::numeric_limits<T>::digits + FracBits <= 58,
+                  "FracBits too large for table type");
+    auto const max = static_cast<std::uint32_t>(N - 1) << FracBits;
+    return pos < max ? pos : max;
+  }
+
+  D lo_;
+  D scale_;
+  std::array<T, storage_size> samples_;
+};
+
+/**
+ * Lookup table of a periodic function sampled at compile time
+ *
+ * Holds `N` samples of one period, starting at `lo`, see
+ * `make_periodic_lut()`. `N` must be a power of two. The evaluators
+ * take a 32-bit phase, where the full range corresponds to one period,
+ * so a phase accumulator wraps around for free. This makes it a good
+ * fit for oscillators. See `lut` for details on the evaluators.
+ */
+template <typename T, std::size_t N>
+class periodic_lut {
+  static_assert(N >= 2 && N <= 65536 && (N & (N - 1)) == 0,
+                "N must be a power of two between 2 and 65536");
+
+ public:
+  using value_type = T;
+
+  static constexpr std::size_t storage_size = N + 3;
+
+  constexpr explicit periodic_lut(
+      std::array<T, storage_size> const& samples)
+      : samples_(samples) {}
+
+  static constexpr std::size_t size() { return N; }
+
+  /**
+   * Convert a fraction of the period in `[0, 1)` to a phase value
+   *
+   * Useful to compute phase increments at compile time.
+   */
+  static constexpr std::uint32_t phase(double fraction) {
+    return static_cast<std::uint32_t>(fraction * 4294967296.0 + 0.5);
+  }
+
+  /**
+   * Sample `i`, for `0 <= i < N`
+   */
+  T operator[](std::size_t i) const { return samples_[i + 1]; }
+
+  T nearest(std::uint32_t phase) const {
+    return samples_[((phase + (std::uint32_t{1} << (31 - bits))) >>
+                     (32 - bits)) +
+                    1];
+  }
+
+  T linear(std::uint32_t phase) const {
+    return interp::template linear<16>(&samples_[phase >> (32 - bits)],
+                                       fraction(phase));
+  }
+
+  T cubic(std::uint32_t phase) const {
+    return interp::template cubic<16>(&samples_[phase >> (32 - bits)],
+                                      fraction(phase));
+  }
+
+ private:
+  using interp = detail::lut_interp<T>;
+
+  static constexpr unsigned bits = detail::lut_log2(N);
+
+  static std::uint32_t fraction(std::uint32_t phase) {
+    return static_cast<std::uint32_t>(phase << bits) >> 16;
+  }
+
+  std::array<T, storage_size> samples_;
+};
+
+namespace detail {
+
+template <typename F>
+constexpr double lut_at(F const& f, double lo, double hi, std::size_t n,
+                        double k) {
+  return f(lo + (hi - lo) * k / static_cast<double>(n - 1));
+}
+
+// Samples outside of the range are linearly extrapolated, as the function
+// may not be defined there.
+template <typename T, typename F>
+constexpr T lut_sample(F const& f, double lo, double hi, std::size_t n,
+                       std::size_t i) {
+  return lut_convert<T>(
+      i == 0 ? 2 * lut_at(f, lo, hi, n, 0) - lut_at(f, lo, hi, n, 1)
+      : i <= n
+          ? lut_at(f, lo, hi, n, static_cast<double>(i - 1))
+          : lut_at(f, lo, hi, n, static_cast<double>(n - 1)) +
+                static_cast<double>(i - n) *
+                    (lut_at(f, lo, hi, n, static_cast<double>(n - 1)) -
+                     lut_at(f, lo, hi, n, static_cast<double>(n - 2))));
+}
+
+template <typename T, std::size_t N, typename D, typename F,
+          std::size_t... I>
+constexpr lut<T, N, D>
+make_lut(F const& f, double lo, double hi, index_sequence<I...>) {
+  return lut<T, N, D>(
+      static_cast<D>(lo), static_cast<D>(hi),
+      std::array<T, N + 3>{{lut_sample<T>(f, lo, hi, N, I)...}});
+}
+
+template <typename T, std::size_t N, typename F, std::size_t... I>
+constexpr periodic_lut<T, N>
+make_periodic_lut(F const& f, double lo, double period, index_sequence<I...>) {
+  return periodic_lut<T, N>(std::array<T, N + 3>{{lut_convert<T>(
+      f(lo + period * static_cast<double>((I + N - 1) % N) /
+                 static_cast<double>(N)))...}});
+}
+
+} // namespace detail
+
+/**
+ * Sample `f` at `N` equidistant positions from `lo` to `hi`
+ *
+ * `f` must be callable at compile time, i.e. a literal type with a
+ * `constexpr` call operator, which takes and returns `double`. Results
+ * are converted to `T`, with rounding for integral types.
+ *
+ * Example:
+ *
+ *     struct soft_clip {
+ *       constexpr double operator()(double x) const {
+ *         return 32767 * cmath::tanh(x);
+ *       }
+ *     };
+ *
+ *     constexpr auto clip = cmath::make_lut<int16_t, 64>(soft_clip{}, -4, 4);
+ *
+ *     int16_t y = clip.cubic(x);
+ */
+template <typename T, std::size_t N,
+          typename D = typename std::conditional<
+              std::is_floating_point<T>::value, T, float>::type,
+          typename F>
+constexpr lut<T, N, D> make_lut(F const& f, double lo, double hi) {
+  return detail::make_lut<T, N, D>(f, lo, hi,
+                                   make_index_sequence<N + 3>{});
+}
+
+/**
+ * Sample one period of `f`, starting at `lo`, at `N` equidistant positions
+ */
+template <typename T, std::size_t N, typename F>
+constexpr periodic_lut<T, N>
+make_periodic_lut(F const& f, double lo, double period) {
+  return detail::make_periodic_lut<T, N>(f, lo, period,
+                                         make_index_sequence<N + 3>{});
+}
+
+} // namespace cmath
+} // namespace embedded
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
@@ -24,6 +24,7 @@
 
 #include <cstddef>
 
+#include "../config.h"
 #include "convolve.h"
 
 // clang-format off
@@ -37,6 +38,43 @@ namespace cmath {
 
 namespace detail {
 
+#if LIBEMB_RELAXED_CONSTEXPR
+
+template <typename T, std::size_t S>
+struct poly_coefs {
+  T c[S + 1];
+};
+
+// Multiplies out the linear factors in a single buffer. Each coefficient
+// is summed up exactly like `convolve_single()` does, so the result is
+// identical to the recursive implementation below.
+template <typename T, std::size_t S>
+constexpr auto poly_iter(vector<T, S> const& zeros) noexcept
+    -> poly_coefs<T, S> {
+  poly_coefs<T, S> r{};
+  r.c[0] = T{1};
+  for (std::size_t k = 0; k < S; ++k) {
+    T const b[2] = {T{1}, -zeros[k]};
+    for (std::size_t n = k + 2; n-- > 0;) {
+      T sum{};
+      for (std::size_t m = n + 1; m-- > 0;) {
+        sum = (m <= k ? r.c[m] : T{}) * (n - m < 2 ? b[n - m] : T{}) + sum;
+      }
+      r.c[n] = sum;
+    }
+  }
+  return r;
+}
+
+template <typename T, std::size_t S, std::size_t... Ints>
+constexpr auto poly_vector(poly_coefs<T, S> const& r,
+                           index_sequence<Ints...>) noexcept
+    -> vector<T, S + 1> {
+  return vector<T, S + 1>{r.c[Ints]...};
+}
+
+#else
+
 template <std::size_t N>
 struct poly_rec {
   template <typename T, std::size_t S1, std::size_t S2>
@@ -58,11 +96,18 @@ struct poly_rec<0> {
   }
 };
 
+#endif
+
 } // namespace detail
 
 template <typename T, std::size_t S>
 constexpr auto poly(vector<T, S> const& zeros) noexcept -> vector<T, S + 1> {
+#if LIBEMB_RELAXED_CONSTEXPR
+  return detail::poly_vector(detail::poly_iter(zeros),
+                             make_index_sequence<S + 1>{});
+#else
   return detail::poly_rec<S>()(vector<T, 1>{T{1}}, zeros);
+#endif
 }
 
 } // namespace cmath
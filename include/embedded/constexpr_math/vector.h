@@ -25,6 +25,7 @@
 #include <cstddef>
 #include <type_traits>
 
+#include "../config.h"
 #include "../type_traits/conjunction.h"
 #include "../utility/integer_sequence.h"
 
@@ -126,6 +127,106 @@ class prod_reducer {
   }
 };
 
+class sum_reducer {
+ public:
+  template <typename F>
+  constexpr auto operator()(F const& a, F const& v) const noexcept -> F {
+    return a + v;
+  }
+};
+
+#if LIBEMB_RELAXED_CONSTEXPR
+
+template <typename T, std::size_t Size>
+struct compare {
+  constexpr int operator()(T const& a, T const& b) const noexcept {
+    for (std::size_t i = 0; i < Size; ++i) {
+      if (a[i] < b[i]) {
+        return -1;
+      }
+      if (a[i] > b[i]) {
+        return 1;
+      }
+    }
+    return 0;
+  }
+};
+
+template <typename T, std::size_t Size, typename Pred>
+struct argmin {
+  constexpr std::size_t
+  operator()(T const& a, Pred const& pred) const noexcept {
+    std::size_t min_index = 0;
+    for (std::size_t i = 0; i < Size; ++i) {
+      if (pred(a[i], a[min_index])) {
+        min_index = i;
+      }
+    }
+    return min_index;
+  }
+};
+
+template <typename T, std::size_t Size, typename Pred>
+struct count {
+  constexpr std::size_t
+  operator()(T const& a, Pred const& pred) const noexcept {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < Size; ++i) {
+      n += pred(a[i]);
+    }
+    return n;
+  }
+};
+
+template <std::size_t Size>
+struct permutation {
+  std::size_t index[Size > 0 ? Size : 1];
+};
+
+// Selection sort on a permutation of the indices. This picks the same
+// element in each step as the recursive implementation below, so both
+// produce the same order for equivalent elements.
+template <typename T, std::size_t Size, typename Pred>
+struct sort {
+  constexpr auto
+  operator()(vector<T, Size> const& a, Pred const& pred) const noexcept
+      -> vector<T, Size> {
+    return apply(a, sorted(a, pred), make_index_sequence<Size>{});
+  }
+
+ private:
+  static constexpr auto
+  sorted(vector<T, Size> const& a, Pred const& pred) noexcept
+      -> permutation<Size> {
+    permutation<Size> p{};
+    for (std::size_t i = 0; i < Size; ++i) {
+      p.index[i] = i;
+    }
+    for (std::size_t s = 0; s < Size; ++s) {
+      auto min = s;
+      for (std::size_t i = s; i < Size; ++i) {
+        if (pred(a[p.index[i]], a[p.index[min]])) {
+          min = i;
+        }
+      }
+      auto const tmp = p.index[s];
+      p.index[s] = p.index[min];
+      p.index[min] = tmp;
+    }
+    return p;
+  }
+
+  template <std::size_t... Ints>
+  static constexpr auto apply(vector<T, Size> const& a,
+                              permutation<Size> const& p,
+                              index_sequence<Ints...>) noexcept
+      -> vector<T, Size> {
+    return vector<T, Size>{a[p.index[Ints]]...};
+  }
+};
+
+#else
+
 template <typename T, std::size_t Size, std::size_t I = 0>
 struct compare {
   constexpr int operator()(T const& a, T const& b) const noexcept {
@@ -195,6 +296,8 @@ struct sort<T, Size, Pred, Size> {
   }
 };
 
+#endif
+
 template <typename T>
 class constant {
  public:
@@ -279,7 +382,14 @@ class vector {
   constexpr auto
   reduce(Fn const& fn, value_type initial = value_type{1}) const noexcept
       -> value_type {
+#if LIBEMB_RELAXED_CONSTEXPR
+    for (std::size_t i = Size; i-- > 0;) {
+      initial = fn(initial, (*this)[i]);
+    }
+    return initial;
+#else
     return Size > 0 ? reduce_impl(initial, fn, Size - 1) : initial;
+#endif
   }
 
   template <std::size_t S2>
@@ -324,6 +434,10 @@ class vector {
     return swap(i, 0).template erase<0>();
   }
 
+  constexpr auto reverse() const noexcept -> vector {
+    return reverse_impl(make_index_sequence<Size>{});
+  }
+
   template <typename Pred>
   constexpr auto sort(Pred const& pred) const noexcept -> vector {
     return detail::sort<value_type, Size, Pred>{}(*this, pred);
@@ -348,6 +462,12 @@ class vector {
     return vector{(*this)[swap_idx(a, b, Ints)]...};
   }
 
+  template <std::size_t... Ints>
+  constexpr auto reverse_impl(index_sequence<Ints...>) const noexcept
+      -> vector {
+    return vector{(*this)[Size - 1 - Ints]...};
+  }
+
   template <std::size_t Count, std::size_t... Ints>
   constexpr auto subvector_impl(index_sequence<Ints...>) const noexcept
       -> vector<value_type, Count> {
@@ -368,6 +488,7 @@ class vector {
     return vector<value_type, Size + S2>{(*this)[Ints1]..., other[Ints2]...};
   }
 
+#if !LIBEMB_RELAXED_CONSTEXPR
   template <typename Fn>
   constexpr auto
   reduce_impl(value_type value, Fn const& fn, std::size_t i) const noexcept
@@ -375,6 +496,7 @@ class vector {
     return i > 0 ? reduce_impl(fn(value, (*this)[i]), fn, i - 1)
                  : fn(value, (*this)[i]);
   }
+#endif
 
   template <typename T2, typename Fn, std::size_t... Ints>
   constexpr auto
@@ -431,6 +553,11 @@ constexpr auto prod(cmath::vector<F, Size> const& a) noexcept -> F {
   return a.reduce(detail::prod_reducer());
 }
 
+template <typename F, std::size_t Size>
+constexpr auto sum(cmath::vector<F, Size> const& a) noexcept -> F {
+  return a.reduce(detail::sum_reducer(), F{0});
+}
+
 } // namespace cmath
 } // namespace embedded
 
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+#include "function.h"
+#include "spsc_circular_buffer_adapter.h"
+
+namespace embedded {
+
+/**
+ * Fixed-capacity queue of deferred calls, e.g. from interrupt handlers
+ * to the main loop
+ *
+ * Each of the `Priorities` levels is a lock-free single-producer,
+ * single-consumer ring (see `spsc_circular_buffer_adapter`) of up to
+ * `Capacity` objects of type `Function`. `post()` constructs the
+ * `Function` directly in its slot from the callable, so the callable is
+ * only constructed once and a `Function` is never moved, neither when
+ * posting nor when running it. Nothing is allocated and no locks are
+ * taken, so posting takes a short, bounded time.
+ *
+ * `drain()` runs pending calls, highest priority (lowest level) first,
+ * and checks for higher priority calls again after each call. It can be
+ * given a budget to limit the number of calls per main loop pass:
+ *
+ *     deferred_queue<16, 2> deferred;
+ *
+ *     void uart_isr() {
+ *       auto const c = UART->DR;
+ *       deferred.post(1, [c] { handle_rx(c); });
+ *     }
+ *
+ *     for (;;) {
+ *       deferred.drain(4);
+ *       if (deferred.empty()) {
+ *         wait_for_interrupt();
+ *       }
+ *     }
+ *
+ * Each level may only be posted to from a single context at a time, i.e.
+ * the producers of a level must not preempt each other. Using one level
+ * per interrupt priority satisfies this. `drain()`, `clear()` and
+ * `size()` may only be called from the consumer.
+ */
+template <std::size_t Capacity, std::size_t Priorities = 1,
+          typename Function = function<void()>>
+class deferred_queue {
+  static_assert(Capacity > 0, "Capacity must not be zero");
+  static_assert(Priorities > 0, "Priorities must not be zero");
+
+ public:
+  using function_type = Function;
+  using size_type = std::size_t;
+
+  deferred_queue() = default;
+
+  deferred_queue(deferred_queue const&) = delete;
+  deferred_queue& operator=(deferred_queue const&) = delete;
+
+  ~deferred_queue() { clear(); }
+
+  static constexpr size_type capacity() { return Capacity; }
+  static constexpr size_type priorities() { return Priorities; }
+
+  /**
+   * Post a call at priority level 0
+   *
+   * \returns `false` if the level is full. In this case, `fun` is left
+   *          untouched.
+   */
+  template <typename F>
+  bool post(F&& fun) {
+    return post(0, std::forward<F>(fun));
+  }
+
+  /**
+   * Post a call at the given priority level, 0 being the highest
+   *
+   * \returns `false` if the level is full. In this case, `fun` is left
+   *          untouched.
+   */
+  template <typename F>
+  bool post(size_type priority, F&& fun) {
+    assert(priority < Priorities);
+    return levels_[priority].queue.try_emplace_back(std::forward<F>(fun));
+  }
+
+  /**
+   * Run up to `budget` pending calls
+   *
+   * Calls posted while draining are run as part of the same budget.
+   *
+   * \returns Number of calls that were run.
+   */
+  size_type drain(size_type budget = static_cast<size_type>(-1)) {
+    size_type count = 0;
+    while (count < budget) {
+      auto const q = next();
+      if (!q) {
+        break;
+      }
+      q->front()();
+      q->pop_front();
+      ++count;
+    }
+    return count;
+  }
+
+  /**
+   * Discard all pending calls without running them
+   */
+  void clear() {
+    for (auto& l : levels_) {
+      while (!l.queue.empty()) {
+        l.queue.pop_front();
+      }
+    }
+  }
+
+  bool empty() const {
+    for (auto const& l : levels_) {
+      if (!l.queue.empty()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  size_type size() const {
+    size_type total = 0;
+    for (auto const& l : levels_) {
+      total += l.queue.size();
+    }
+    return total;
+  }
+
+  size_type size(size_type priority) const {
+    assert(priority < Priorities);
+    return levels_[priority].queue.size();
+  }
+
+ private:
+  using queue_type = spsc_circular_buffer_adapter<Function>;
+
+  struct level {
+    level()
+        : queue(reinterpret_cast<Function*>(storage), Capacity) {}
+
+    alignas(Function) unsigned char storage[Capacity * sizeof(Function)];
+    queue_type queue;
+  };
+
+  queue_type* next() {
+    for (auto& l : levels_) {
+      if (!l.queue.empty()) {
+        return &l.queue;
+      }
+    }
+    return nullptr;
+  }
+
+  level levels_[Priorities];
+};
+
+} // namespace embedded
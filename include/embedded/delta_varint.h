@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+#include "varint.h"
+
+namespace embedded {
+
+namespace detail {
+
+template <typename T, unsigned Order>
+class delta_varint_state {
+  static_assert(std::is_integral<T>::value && std::is_signed<T>::value,
+                "T must be a signed integral type");
+  static_assert(Order == 1 || Order == 2, "Order must be 1 or 2");
+
+ public:
+  using value_type = T;
+
+  explicit delta_varint_state(std::size_t sync_interval)
+      : interval_{sync_interval} {
+    assert(interval_ > 0);
+  }
+
+  std::size_t sync_interval() const { return interval_; }
+
+  /**
+   * True if the next value starts a new sync interval
+   */
+  bool at_sync_point() const { return pos_ == 0; }
+
+  /**
+   * Start a new sync interval with the next value
+   */
+  void reset() { pos_ = 0; }
+
+ protected:
+  using unsigned_type = typename std::make_unsigned<T>::type;
+
+  // Prediction of the next value, computed modulo 2^N so that any residual
+  // can be represented as T. The first value of an interval is predicted
+  // as zero and the second one from the first value only.
+  unsigned_type predict() const {
+    auto const x1 = static_cast<unsigned_type>(hist_[0]);
+    auto const x2 = static_cast<unsigned_type>(hist_[1]);
+    return pos_ == 0 ? 0
+           : Order == 1 || pos_ == 1
+               ? x1
+               : static_cast<unsigned_type>(x1 + x1 - x2);
+  }
+
+  void update(T value) {
+    hist_[1] = hist_[0];
+    hist_[0] = value;
+    if (++pos_ == interval_) {
+      pos_ = 0;
+    }
+  }
+
+ private:
+  std::size_t interval_;
+  std::size_t pos_{0};
+  T hist_[2]{};
+};
+
+} // namespace detail
+
+/**
+ * Delta + zig-zag + varint encoder for slowly changing integer samples
+ *
+ * Each value is predicted from the previous one (`Order == 1`) or from a
+ * linear extrapolation of the previous two (`Order == 2`). The residual is
+ * zig-zag encoded and stored as a `varint`, so small changes take a single
+ * byte, no matter the width of `T`.
+ *
+ * Every `sync_interval` values, the prediction starts from scratch. The
+ * first value of each interval is stored verbatim, so decoding can start
+ * at any of these sync points (see `delta_varint_decoder::seek()`).
+ *
+ * The encoding is written directly to the back of a byte buffer such as
+ * `circular_buffer_adapter<uint8_t>`, which needs `push_back()` and
+ * `remaining()`.
+ */
+template <typename T, unsigned Order = 1>
+class delta_varint_encoder : public detail::delta_varint_state<T, Order> {
+  using base = detail::delta_varint_state<T, Order>;
+
+ public:
+  explicit delta_varint_encoder(std::size_t sync_interval)
+      : base(sync_interval) {}
+
+  /**
+   * Append the encoding of `value` to `out`
+   *
+   * \returns `false` if there was not enough space left in `out`. In this
+   *          case, neither `out` nor the encoder state is modified.
+   */
+  template <typename Buffer>
+  bool encode(T value, Buffer& out) {
+    using utype = typename base::unsigned_type;
+    auto const residual = static_cast<T>(
+        static_cast<utype>(static_cast<utype>(value) - this->predict()));
+    if (varint::size(residual) > out.remaining()) {
+      return false;
+    }
+    varint::encode(residual, std::back_inserter(out));
+    this->update(value);
+    return true;
+  }
+};
+
+/**
+ * Decoder for the output of `delta_varint_encoder`
+ *
+ * The decoder must use the same `T`, `Order` and `sync_interval` as the
+ * encoder and decoding must start at a sync point.
+ */
+template <typename T, unsigned Order = 1>
+class delta_varint_decoder : public detail::delta_varint_state<T, Order> {
+  using base = detail::delta_varint_state<T, Order>;
+
+ public:
+  explicit delta_varint_decoder(std::size_t sync_interval)
+      : base(sync_interval) {}
+
+  /**
+   * Decode the next value
+   *
+   * \param value    Reference to decoded output value.
+   *
+   * \param begin    Iterator to start of encoding buffer.
+   *
+   * \param end      Iterator to end of encoding buffer.
+   *
+   * \returns Iterator to end of encoding, or `begin` if there was an error
+   *          (see `varint::decode()`). In this case, the decoder state is
+   *          not modified.
+   */
+  template <typename It>
+  It decode(T& value, It begin, It end) {
+    T residual{};
+    auto const it = varint::decode(residual, begin, end);
+    if (it != begin) {
+      using utype = typename base::unsigned_type;
+      value = static_cast<T>(
+          static_cast<utype>(this->predict() + static_cast<utype>(residual)));
+      this->update(value);
+    }
+    return it;
+  }
+
+  /**
+   * Skip `intervals` complete sync intervals
+   *
+   * This doesn't decode any values, it only counts the final bytes of the
+   * varints. `begin` must be at a sync point.
+   *
+   * \returns Iterator to the sync point, or `begin` if the encoding buffer
+   *          ends before. The decoder is reset to start at the returned
+   *          sync point.
+   */
+  template <typename It>
+  It seek(It begin, It end, std::size_t intervals) {
+    auto count = intervals * this->sync_interval();
+    auto it = begin;
+    for (; count > 0 && it != end; ++it) {
+      if ((*it & 0x80) == 0) {
+        --count;
+      }
+    }
+    this->reset();
+    return count == 0 ? it : begin;
+  }
+};
+
+} // namespace embedded
@@ -23,16 +23,57 @@
 #pragma once
 
 #include <cassert>
+#include <cstddef>
 #include <iterator>
 #include <type_traits>
 
 namespace embedded {
 
-template <typename T>
+namespace cba_instrumentation {
+
+/**
+ * No instrumentation, this is the default and costs nothing
+ */
+struct none {};
+
+/**
+ * Occupancy statistics, see `cba_statistics`
+ */
+struct statistics {};
+
+} // namespace cba_instrumentation
+
+template <typename T, std::size_t Capacity = 0,
+          typename Instrumentation = cba_instrumentation::none>
 class circular_buffer_adapter;
 
 namespace detail {
 
+template <typename Iterator>
+struct cba_segments;
+
+// A contiguous run of items in the memory managed by an adapter
+template <typename T>
+struct cba_array_range {
+  T* data;
+  std::size_t size;
+
+  T* begin() const { return data; }
+  T* end() const { return data + size; }
+  bool empty() const { return size == 0; }
+};
+
+// Up to two contiguous runs, `second` continuing where `first` wraps
+// around the end of the memory
+template <typename T>
+struct cba_array_ranges {
+  cba_array_range<T> first;
+  cba_array_range<T> second;
+
+  std::size_t size() const { return first.size + second.size; }
+  bool empty() const { return size() == 0; }
+};
+
 template <typename T>
 struct cba_const_iterator_traits {
   using value_type = typename std::remove_const<T>::type;
@@ -51,12 +92,13 @@ struct cba_mutable_iterator_traits {
   using difference_type = std::ptrdiff_t;
 };
 
-template <typename T, typename Traits>
+template <typename T, typename Traits, typename Adapter>
 class cba_iterator {
  public:
-  friend class circular_buffer_adapter<T>;
-  friend class cba_iterator<T, cba_const_iterator_traits<T>>;
-  friend class cba_iterator<T, cba_mutable_iterator_traits<T>>;
+  friend Adapter;
+  friend struct cba_segments<cba_iterator>;
+  friend class cba_iterator<T, cba_const_iterator_traits<T>, Adapter>;
+  friend class cba_iterator<T, cba_mutable_iterator_traits<T>, Adapter>;
 
   using iterator_category = std::random_access_iterator_tag;
   using value_type = typename Traits::value_type;
@@ -67,7 +109,8 @@ class cba_iterator {
 
   cba_iterator() = default;
 
-  cba_iterator(cba_iterator<T, cba_mutable_iterator_traits<T>> const& other)
+  cba_iterator(
+      cba_iterator<T, cba_mutable_iterator_traits<T>, Adapter> const& other)
       : adapter_{other.adapter_}
       , it_{other.it_} {}
 
@@ -88,32 +131,32 @@ class cba_iterator {
   }
 
   template <typename Tr>
-  bool operator==(const cba_iterator<T, Tr>& other) const {
+  bool operator==(const cba_iterator<T, Tr, Adapter>& other) const {
     return it_ == other.it_;
   }
 
   template <typename Tr>
-  bool operator!=(const cba_iterator<T, Tr>& other) const {
+  bool operator!=(const cba_iterator<T, Tr, Adapter>& other) const {
     return !(*this == other);
   }
 
   template <typename Tr>
-  bool operator<(const cba_iterator<T, Tr>& other) const {
+  bool operator<(const cba_iterator<T, Tr, Adapter>& other) const {
     return index() < other.index();
   }
 
   template <typename Tr>
-  bool operator>(const cba_iterator<T, Tr>& other) const {
+  bool operator>(const cba_iterator<T, Tr, Adapter>& other) const {
     return other < *this;
   }
 
   template <typename Tr>
-  bool operator<=(const cba_iterator<T, Tr>& other) const {
+  bool operator<=(const cba_iterator<T, Tr, Adapter>& other) const {
     return !(other < *this);
   }
 
   template <typename Tr>
-  bool operator>=(const cba_iterator<T, Tr>& other) const {
+  bool operator>=(const cba_iterator<T, Tr, Adapter>& other) const {
     return !(*this < other);
   }
 
@@ -183,26 +226,243 @@ class cba_iterator {
   }
 
  private:
-  cba_iterator(circular_buffer_adapter<T> const* adapter, pointer it)
+  cba_iterator(Adapter const* adapter, pointer it)
       : adapter_{adapter}
       , it_{it} {}
 
+  static cba_iterator first(Adapter const* adapter) {
+    return cba_iterator(adapter, adapter->first_iter());
+  }
+
+  static cba_iterator last(Adapter const* adapter) {
+    return cba_iterator(adapter, nullptr);
+  }
+
   difference_type index() const {
     return it_ ? adapter_->index(it_) : adapter_->size();
   }
 
   pointer realiter() const { return it_ ? it_ : adapter_->last_; }
 
-  circular_buffer_adapter<T> const* adapter_{nullptr};
+  Adapter const* adapter_{nullptr};
   pointer it_{nullptr};
 };
 
-template <typename T, typename Traits>
-cba_iterator<T, Traits> operator+(typename Traits::difference_type n,
-                                  cba_iterator<T, Traits> const& iter) {
+template <typename T, typename Traits, typename Adapter>
+cba_iterator<T, Traits, Adapter>
+operator+(typename Traits::difference_type n,
+          cba_iterator<T, Traits, Adapter> const& iter) {
+  return iter + n;
+}
+
+/**
+ * Iterator for adapters with a static power-of-two capacity
+ *
+ * Like `cba_iterator`, this refers to a slot of the memory, so it keeps
+ * referring to the same item when items are added or removed at either
+ * end. The slot is stored as an offset, so stepping just masks it
+ * instead of checking for wrap-around.
+ */
+template <typename T, typename Traits, typename Adapter>
+class cba_masked_iterator {
+ public:
+  friend Adapter;
+  friend struct cba_segments<cba_masked_iterator>;
+  friend class cba_masked_iterator<T, cba_const_iterator_traits<T>, Adapter>;
+  friend class cba_masked_iterator<T, cba_mutable_iterator_traits<T>,
+                                   Adapter>;
+
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = typename Traits::value_type;
+  using reference = typename Traits::reference;
+  using pointer = typename Traits::pointer;
+  using size_type = typename Traits::size_type;
+  using difference_type = typename Traits::difference_type;
+
+  cba_masked_iterator() = default;
+
+  cba_masked_iterator(
+      cba_masked_iterator<T, cba_mutable_iterator_traits<T>, Adapter> const&
+          other)
+      : adapter_{other.adapter_}
+      , slot_{other.slot_} {}
+
+  cba_masked_iterator(cba_masked_iterator&&) = default;
+  cba_masked_iterator& operator=(cba_masked_iterator const&) = default;
+  cba_masked_iterator& operator=(cba_masked_iterator&&) = default;
+
+  pointer operator->() const { return realiter(); }
+
+  reference operator*() const {
+    assert(slot_ != npos);
+    return *realiter();
+  }
+
+  reference operator[](difference_type n) const {
+    assert(index() + n < static_cast<difference_type>(adapter_->size()));
+    return *adapter_->masked(offset() + n);
+  }
+
+  template <typename Tr>
+  bool operator==(const cba_masked_iterator<T, Tr, Adapter>& other) const {
+    return slot_ == other.slot_;
+  }
+
+  template <typename Tr>
+  bool operator!=(const cba_masked_iterator<T, Tr, Adapter>& other) const {
+    return slot_ != other.slot_;
+  }
+
+  template <typename Tr>
+  bool operator<(const cba_masked_iterator<T, Tr, Adapter>& other) const {
+    return index() < other.index();
+  }
+
+  template <typename Tr>
+  bool operator>(const cba_masked_iterator<T, Tr, Adapter>& other) const {
+    return index() > other.index();
+  }
+
+  template <typename Tr>
+  bool operator<=(const cba_masked_iterator<T, Tr, Adapter>& other) const {
+    return index() <= other.index();
+  }
+
+  template <typename Tr>
+  bool operator>=(const cba_masked_iterator<T, Tr, Adapter>& other) const {
+    return index() >= other.index();
+  }
+
+  cba_masked_iterator& operator++() { return *this += 1; }
+
+  cba_masked_iterator& operator--() { return *this -= 1; }
+
+  cba_masked_iterator operator++(int) {
+    auto tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+  cba_masked_iterator operator--(int) {
+    auto tmp = *this;
+    --*this;
+    return tmp;
+  }
+
+  cba_masked_iterator& operator+=(difference_type n) {
+    assert(index() + n >= 0);
+    assert(index() + n <= static_cast<difference_type>(adapter_->size()));
+    if (n != 0) {
+      slot_ = std::distance(adapter_->begin_, adapter_->masked(offset() + n));
+      // only stepping forward can reach the end, and as the result is
+      // past the current item, it can't be the front of a full buffer
+      if (n > 0 && slot_ == std::distance(adapter_->begin_, adapter_->last_)) {
+        slot_ = npos;
+      }
+    }
+    return *this;
+  }
+
+  cba_masked_iterator& operator-=(difference_type n) { return *this += -n; }
+
+  cba_masked_iterator operator+(difference_type n) const {
+    return cba_masked_iterator(*this) += n;
+  }
+
+  cba_masked_iterator operator-(difference_type n) const {
+    return cba_masked_iterator(*this) -= n;
+  }
+
+  difference_type operator-(cba_masked_iterator const& other) const {
+    return index() - other.index();
+  }
+
+ private:
+  // the past-the-end iterator doesn't refer to a slot, so it stays at
+  // the end when items are added
+  static constexpr difference_type npos = -1;
+
+  cba_masked_iterator(Adapter const* adapter, difference_type slot)
+      : adapter_{adapter}
+      , slot_{slot} {}
+
+  static cba_masked_iterator first(Adapter const* adapter) {
+    return cba_masked_iterator(
+        adapter, adapter->size() != 0
+                     ? std::distance(adapter->begin_, adapter->first_)
+                     : npos);
+  }
+
+  static cba_masked_iterator last(Adapter const* adapter) {
+    return cba_masked_iterator(adapter, npos);
+  }
+
+  // offset of the slot, which for the end is the slot after the back
+  difference_type offset() const {
+    return slot_ != npos ? slot_
+                         : std::distance(adapter_->begin_, adapter_->last_);
+  }
+
+  difference_type index() const {
+    return slot_ != npos ? adapter_->index(adapter_->begin_ + slot_)
+                         : static_cast<difference_type>(adapter_->size());
+  }
+
+  pointer realiter() const { return adapter_->begin_ + offset(); }
+
+  Adapter const* adapter_{nullptr};
+  difference_type slot_{npos};
+};
+
+template <typename T, typename Traits, typename Adapter>
+constexpr typename Traits::difference_type
+    cba_masked_iterator<T, Traits, Adapter>::npos;
+
+template <typename T, typename Traits, typename Adapter>
+cba_masked_iterator<T, Traits, Adapter>
+operator+(typename Traits::difference_type n,
+          cba_masked_iterator<T, Traits, Adapter> const& iter) {
   return iter + n;
 }
 
+template <typename>
+struct is_cba_iterator : std::false_type {};
+
+template <typename T, typename Traits, typename Adapter>
+struct is_cba_iterator<cba_iterator<T, Traits, Adapter>> : std::true_type {};
+
+template <typename T, typename Traits, typename Adapter>
+struct is_cba_iterator<cba_masked_iterator<T, Traits, Adapter>>
+    : std::true_type {};
+
+// Splits an iterator range into (at most) two contiguous pointer ranges
+template <typename Iterator>
+struct cba_segments {
+  using value_type = typename std::remove_pointer<
+      typename std::iterator_traits<Iterator>::pointer>::type;
+  using ranges = cba_array_ranges<value_type>;
+
+  static ranges get(Iterator const& first, Iterator const& last) {
+    assert(first <= last);
+    auto const r = first.adapter_->ranges(
+        const_cast<typename std::remove_const<value_type>::type*>(
+            first.realiter()),
+        static_cast<std::size_t>(last - first));
+    return {{r.first.data, r.first.size}, {r.second.data, r.second.size}};
+  }
+};
+
+// Selects the iterator type for an adapter
+template <typename T, typename Traits, typename Adapter, std::size_t Capacity>
+struct cba_iterator_type {
+  using type = cba_masked_iterator<T, Traits, Adapter>;
+};
+
+template <typename T, typename Traits, typename Adapter>
+struct cba_iterator_type<T, Traits, Adapter, 0> {
+  using type = cba_iterator<T, Traits, Adapter>;
+};
+
 } // namespace detail
 
 } // namespace embedded
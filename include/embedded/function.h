@@ -23,6 +23,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstring>
 #include <exception>
 #include <functional>
 #include <new>
@@ -39,8 +40,26 @@
 
 namespace embedded {
 
+/**
+ * Object layouts for `function`
+ *
+ * With `compact`, a function object only stores a pointer to its vtable
+ * next to the callable, so each call first loads the call pointer from
+ * the vtable. With `inline_call`, the call pointer is also stored in the
+ * object itself (like in `folly::Function`), so a call only needs a
+ * single indirection at the cost of another pointer per object. Move and
+ * destroy operations still go through the vtable.
+ */
+namespace function_layout {
+
+struct compact {};
+struct inline_call {};
+
+} // namespace function_layout
+
 template <typename Signature, size_t Capacity = 3 * sizeof(void*),
-          size_t Alignment = alignof(void*)>
+          size_t Alignment = alignof(void*),
+          typename Layout = function_layout::compact, typename Pool = void>
 class function;
 
 namespace detail {
@@ -59,13 +78,15 @@ template <typename Return, typename... Args>
 class vtbl<Return(Args...)> {
  public:
   using storage_t = void*;
+  using call_t = Return (*)(storage_t, Args&&...);
 
   constexpr vtbl() noexcept {}
 
   template <typename T>
   explicit constexpr vtbl(wrap<T>) noexcept
       : call{&vt_call<T>}
-      , proc{&vt_proc<T>} {}
+      , proc{&vt_proc<T>}
+      , trivial{std::is_trivially_copyable<T>::value} {}
 
  private:
   static Return empty_call(storage_t, Args&&...) {
@@ -98,6 +119,10 @@ class vtbl<Return(Args...)> {
  public:
   decltype(&empty_call) const call{&empty_call};
   decltype(&empty_proc) const proc{&empty_proc};
+  // Trivially copyable callables (which are also trivially destructible)
+  // are relocated by copying the storage and never destroyed, so `proc`
+  // isn't used for them.
+  bool const trivial{true};
 };
 
 template <typename Signature>
@@ -118,35 +143,108 @@ constexpr vtbl<Signature> typed_vtbl<Signature, T>::value;
 
 template <typename>
 struct is_function : std::false_type {};
-template <typename S, size_t C, size_t A>
-struct is_function<function<S, C, A>> : std::true_type {};
+template <typename S, size_t C, size_t A, typename L, typename P>
+struct is_function<function<S, C, A, L, P>> : std::true_type {};
+
+// Owns a callable stored in a block of `Pool`, so only this pointer
+// needs to fit into the in-place storage of a function
+template <typename T, typename Pool>
+class pooled {
+ public:
+  explicit pooled(T* p) noexcept
+      : p_{p} {}
+
+  pooled(pooled&& other) noexcept
+      : p_{other.p_} {
+    other.p_ = nullptr;
+  }
+
+  pooled(pooled const&) = delete;
+  pooled& operator=(pooled const&) = delete;
+
+  ~pooled() {
+    if (p_) {
+      p_->~T();
+      Pool::deallocate(p_);
+    }
+  }
+
+  template <typename... Args>
+  auto operator()(Args&&... args)
+      -> decltype(std::declval<T&>()(std::declval<Args>()...)) {
+    return (*p_)(std::forward<Args>(args)...);
+  }
+
+ private:
+  T* p_;
+};
+
+template <typename Layout, typename Signature>
+class function_dispatch;
 
 template <typename Signature>
+class function_dispatch<function_layout::compact, Signature> {
+ public:
+  using vtbl_t = vtbl<Signature>;
+
+  explicit function_dispatch(vtbl_t const* vt) noexcept
+      : vtbl_{vt} {}
+
+  auto table() const noexcept -> vtbl_t const* { return vtbl_; }
+  auto call() const noexcept -> typename vtbl_t::call_t { return vtbl_->call; }
+
+ private:
+  vtbl_t const* vtbl_;
+};
+
+template <typename Signature>
+class function_dispatch<function_layout::inline_call, Signature> {
+ public:
+  using vtbl_t = vtbl<Signature>;
+
+  explicit function_dispatch(vtbl_t const* vt) noexcept
+      : call_{vt->call}
+      , vtbl_{vt} {}
+
+  auto table() const noexcept -> vtbl_t const* { return vtbl_; }
+  auto call() const noexcept -> typename vtbl_t::call_t { return call_; }
+
+ private:
+  typename vtbl_t::call_t call_;
+  vtbl_t const* vtbl_;
+};
+
+// Provides the (const-correct) call operator for `Function`, which must
+// implement `caller()` and `target()`, returning the call pointer and its
+// first argument
+template <typename Signature, typename Function>
 struct function_traits;
 
-template <typename Return, typename... Args>
-struct function_traits<Return(Args...)> {
+template <typename Function, typename Return, typename... Args>
+struct function_traits<Return(Args...), Function> {
   template <typename T>
   using is_invocable = is_invocable_r<Return, T&, Args...>;
+  template <typename T>
+  using target_type = T;
   using signature = Return(Args...);
 
   Return operator()(Args... args) {
-    auto fn = static_cast<function<Return(Args...)>*>(this);
-    return fn->vtbl_->call(std::addressof(fn->storage_),
-                           std::forward<Args>(args)...);
+    auto fn = static_cast<Function*>(this);
+    return fn->caller()(fn->target(), std::forward<Args>(args)...);
   }
 };
 
-template <typename Return, typename... Args>
-struct function_traits<Return(Args...) const> {
+template <typename Function, typename Return, typename... Args>
+struct function_traits<Return(Args...) const, Function> {
   template <typename T>
   using is_invocable = is_invocable_r<Return, const T&, Args...>;
+  template <typename T>
+  using target_type = T const;
   using signature = Return(Args...);
 
   Return operator()(Args... args) const {
-    auto fn = static_cast<function<Return(Args...) const> const*>(this);
-    return fn->vtbl_->call(std::addressof(fn->storage_),
-                           std::forward<Args>(args)...);
+    auto fn = static_cast<Function const*>(this);
+    return fn->caller()(fn->target(), std::forward<Args>(args)...);
   }
 };
 
@@ -168,17 +266,41 @@ struct function_traits<Return(Args...) const> {
  * The implementation only requires C++11 to build. Also, by default,
  * objects are a lot smaller than `folly::Function` objects, and they
  * only use a single pointer internally instead of two, at the cost of
- * another level of indirection.
+ * another level of indirection. Use `function_layout::inline_call` to
+ * trade the extra pointer for a single indirection on hot call paths.
+ *
+ * By default, callables must fit into the in-place storage. If `Pool`
+ * is not `void`, callables that don't fit are instead placed in a block
+ * allocated from `Pool` (e.g. a `static_block_pool`), and only a pointer
+ * to the block is stored in-place. This allows sizing `Capacity` for the
+ * common case. `Pool` must provide `block_size` and `block_alignment`
+ * constants and static `allocate()` and `deallocate(void*)` functions,
+ * with `allocate()` returning `nullptr` if the pool is exhausted. As
+ * construction cannot fail, `std::terminate()` is called in that case.
  *
  * [1] https://github.com/facebook/folly/blob/master/folly/docs/Function.md
  * [2]
  * https://github.com/WG21-SG14/SG14/blob/master/Docs/Proposals/NonAllocatingStandardFunction.pdf
  */
-template <typename Signature, size_t Capacity, size_t Alignment>
-class function final : private detail::function_traits<Signature> {
+template <typename Signature, size_t Capacity, size_t Alignment,
+          typename Layout, typename Pool>
+class function final
+    : private detail::function_traits<
+          Signature, function<Signature, Capacity, Alignment, Layout, Pool>> {
+  template <typename C>
+  using fits_inline = std::integral_constant<
+      bool, std::is_void<Pool>::value ||
+                (sizeof(C) <= Capacity && Alignment % alignof(C) == 0)>;
+
+  template <typename C>
+  using stored_type = typename std::conditional<fits_inline<C>::value, C,
+                                                detail::pooled<C, Pool>>::type;
+
  public:
-  using traits = detail::function_traits<Signature>;
+  using traits = detail::function_traits<Signature, function>;
   using signature = typename traits::signature;
+  using layout = Layout;
+  using pool = Pool;
   using vtbl_t = detail::vtbl<signature>;
   using empty_vtbl = detail::empty_vtbl<signature>;
   template <typename T>
@@ -187,7 +309,7 @@ class function final : private detail::function_traits<Signature> {
   friend traits;
 
   function() noexcept
-      : vtbl_{&empty_vtbl::value} {}
+      : dispatch_{&empty_vtbl::value} {}
 
   function(std::nullptr_t) noexcept
       : function() {}
@@ -196,7 +318,10 @@ class function final : private detail::function_traits<Signature> {
   function& operator=(function const&) = delete;
 
   ~function() {
-    vtbl_->proc(detail::oper::destroy, std::addressof(storage_), nullptr);
+    auto const vt = dispatch_.table();
+    if (!vt->trivial) {
+      vt->proc(detail::oper::destroy, std::addressof(storage_), nullptr);
+    }
   }
 
   template <typename T, typename C = typename std::decay<T>::type,
@@ -204,23 +329,20 @@ class function final : private detail::function_traits<Signature> {
                 !detail::is_function<C>::value &&
                 traits::template is_invocable<C>::value>::type>
   function(T&& fun) noexcept
-      : vtbl_{&typed_vtbl<C>::value} {
-    static_assert(
-        std::is_nothrow_move_constructible<C>::value,
-        "function<> can only be used with nothrow move-constructible types");
-    static_assert(sizeof(C) <= Capacity,
-                  "function<> storage too small for this type");
-    static_assert(Alignment % alignof(C) == 0,
-                  "function<> alignment too small for this type");
-
-    ::new (std::addressof(storage_)) C{std::forward<T>(fun)};
+      : dispatch_{&typed_vtbl<stored_type<C>>::value} {
+    emplace<C>(std::forward<T>(fun), fits_inline<C>{});
   }
 
   function(function&& other) noexcept
-      : vtbl_(other.vtbl_) {
-    other.vtbl_ = &empty_vtbl::value;
-    vtbl_->proc(detail::oper::move, std::addressof(other.storage_),
-                std::addressof(storage_));
+      : dispatch_(other.dispatch_) {
+    other.dispatch_ = dispatch_type{&empty_vtbl::value};
+    auto const vt = dispatch_.table();
+    if (vt->trivial) {
+      std::memcpy(storage_, other.storage_, Capacity);
+    } else {
+      vt->proc(detail::oper::move, std::addressof(other.storage_),
+               std::addressof(storage_));
+    }
   }
 
   function& operator=(function&& other) noexcept {
@@ -254,13 +376,56 @@ class function final : private detail::function_traits<Signature> {
   }
 
   explicit operator bool() const noexcept {
-    return vtbl_ != &empty_vtbl::value;
+    return dispatch_.table() != &empty_vtbl::value;
   }
 
   using traits::operator();
 
  private:
-  vtbl_t const* vtbl_;
+  using dispatch_type = detail::function_dispatch<Layout, signature>;
+
+  template <typename C, typename T>
+  void emplace(T&& fun, std::true_type) noexcept {
+    static_assert(
+        std::is_nothrow_move_constructible<C>::value,
+        "function<> can only be used with nothrow move-constructible types");
+    static_assert(sizeof(C) <= Capacity,
+                  "function<> storage too small for this type");
+    static_assert(Alignment % alignof(C) == 0,
+                  "function<> alignment too small for this type");
+
+    ::new (std::addressof(storage_)) C{std::forward<T>(fun)};
+  }
+
+  template <typename C, typename T>
+  void emplace(T&& fun, std::false_type) noexcept {
+    using pooled_type = detail::pooled<C, Pool>;
+
+    static_assert(sizeof(pooled_type) <= Capacity &&
+                      Alignment % alignof(pooled_type) == 0,
+                  "function<> storage too small for a pool pointer");
+    static_assert(sizeof(C) <= Pool::block_size,
+                  "function<> pool blocks too small for this type");
+    static_assert(Pool::block_alignment % alignof(C) == 0,
+                  "function<> pool alignment too small for this type");
+
+    auto const block = Pool::allocate();
+
+    if (!block) {
+      std::terminate();
+    }
+
+    ::new (std::addressof(storage_))
+        pooled_type{::new (block) C{std::forward<T>(fun)}};
+  }
+
+  auto caller() const noexcept -> typename vtbl_t::call_t {
+    return dispatch_.call();
+  }
+
+  auto target() const noexcept -> void* { return std::addressof(storage_); }
+
+  dispatch_type dispatch_;
   alignas(Alignment) char mutable storage_[Capacity];
 };
 
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "function.h"
+
+namespace embedded {
+
+template <typename Signature>
+class function_ref;
+
+namespace detail {
+
+template <typename>
+struct is_function_ref : std::false_type {};
+template <typename S>
+struct is_function_ref<function_ref<S>> : std::true_type {};
+
+// Either an object or a function pointer, converting a function pointer
+// to `void*` is only conditionally supported
+union function_ref_target {
+  void* obj;
+  void (*fun)();
+};
+
+template <typename Signature>
+struct function_ref_call;
+
+template <typename Return, typename... Args>
+struct function_ref_call<Return(Args...)> {
+  using type = Return (*)(function_ref_target, Args&&...);
+
+  template <typename T>
+  static Return object(function_ref_target t, Args&&... args) {
+    return (*static_cast<T*>(t.obj))(static_cast<Args&&>(args)...);
+  }
+
+  template <typename P>
+  static Return pointer(function_ref_target t, Args&&... args) {
+    return reinterpret_cast<P>(t.fun)(static_cast<Args&&>(args)...);
+  }
+};
+
+} // namespace detail
+
+/**
+ * A const-correct, non-owning reference to a callable
+ *
+ * This is for callbacks that are only used for the duration of a call,
+ * e.g. visitors. A `function_ref` is two pointers in size, trivially
+ * copyable and never allocates or copies the callable, so, just like
+ * with any other reference, the callable must outlive it.
+ *
+ * It can be built from function objects (including lambdas and
+ * `embedded::function`) and free functions. As with `function`, a
+ * `function_ref<R(Args...) const>` can only refer to callables that are
+ * invocable as `const`.
+ */
+template <typename Signature>
+class function_ref final
+    : private detail::function_traits<Signature, function_ref<Signature>> {
+ public:
+  using traits = detail::function_traits<Signature, function_ref>;
+  using signature = typename traits::signature;
+
+  friend traits;
+
+  template <typename T, typename C = typename std::remove_reference<T>::type,
+            typename = typename std::enable_if<
+                !detail::is_function_ref<typename std::remove_cv<C>::type>::
+                    value &&
+                !std::is_function<C>::value &&
+                traits::template is_invocable<C>::value>::type>
+  function_ref(T&& fun) noexcept
+      : call_{&call_type::template object<
+              typename traits::template target_type<C>>} {
+    target_.obj = const_cast<void*>(
+        static_cast<void const*>(std::addressof(fun)));
+  }
+
+  template <typename R, typename... A,
+            typename = typename std::enable_if<
+                traits::template is_invocable<R (*)(A...)>::value>::type>
+  function_ref(R (*fun)(A...)) noexcept
+      : call_{&call_type::template pointer<R (*)(A...)>} {
+    target_.fun = reinterpret_cast<void (*)()>(fun);
+  }
+
+  function_ref(function_ref const&) noexcept = default;
+  function_ref& operator=(function_ref const&) noexcept = default;
+
+  using traits::operator();
+
+ private:
+  using call_type = detail::function_ref_call<signature>;
+
+  auto caller() const noexcept -> typename call_type::type { return call_; }
+  auto target() const noexcept -> detail::function_ref_target {
+    return target_;
+  }
+
+  detail::function_ref_target target_;
+  typename call_type::type call_;
+};
+
+} // namespace embedded
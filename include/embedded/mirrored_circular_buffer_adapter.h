@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace embedded {
+
+/**
+ * A circular buffer whose items are always contiguous in memory
+ *
+ * The adapter manages memory for twice the capacity and writes each item
+ * to both halves, so the items starting at any slot of the first half
+ * continue in the second half instead of wrapping around. `data()`
+ * therefore always points to all items, oldest first, and `window(k)` to
+ * the most recent `k` items. This is useful for sliding-window kernels,
+ * e.g. an FIR filter with `Taps` taps can compute `n` outputs from
+ * `window(Taps - 1 + n)` with `fir_design::filter()`, without copying
+ * or splitting the input at the wrap-around.
+ *
+ * The price is a second write for every item added, so this pays off
+ * when each item is read more than once. `T` must be trivially copyable.
+ */
+template <typename T>
+class mirrored_circular_buffer_adapter {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "T must be trivially copyable");
+
+ public:
+  using value_type = T;
+  using reference = T&;
+  using const_reference = T const&;
+  using pointer = T*;
+  using const_pointer = T const*;
+  using size_type = std::size_t;
+
+  /**
+   * `data` must have room for `2 * capacity` items
+   */
+  mirrored_circular_buffer_adapter(pointer data, size_type capacity)
+      : begin_{data}
+      , capacity_{capacity} {
+    assert(capacity_ > 0);
+  }
+
+  bool empty() const { return size_ == 0; }
+  bool full() const { return size_ == capacity_; }
+
+  size_type capacity() const { return capacity_; }
+  size_type size() const { return size_; }
+  size_type remaining() const { return capacity_ - size_; }
+
+  void clear() {
+    first_ = 0;
+    size_ = 0;
+  }
+
+  /**
+   * All items, oldest first, contiguous up to `data() + size()`
+   */
+  const_pointer data() const { return begin_ + first_; }
+
+  /**
+   * The most recent `count` items, oldest first
+   */
+  const_pointer window(size_type count) const {
+    assert(count <= size_);
+    return data() + (size_ - count);
+  }
+
+  const_reference front() const {
+    assert(!empty());
+    return data()[0];
+  }
+
+  const_reference back() const {
+    assert(!empty());
+    return data()[size_ - 1];
+  }
+
+  const_reference operator[](size_type pos) const {
+    assert(pos < size_);
+    return data()[pos];
+  }
+
+  void push_back(value_type const& value) {
+    assert(!full());
+    auto const slot = last();
+    begin_[slot] = value;
+    begin_[slot + capacity_] = value;
+    ++size_;
+  }
+
+  /**
+   * Add an item at the back, removing the front item if the buffer is full
+   */
+  void push_back_overwrite(value_type const& value) {
+    if (full()) {
+      pop_front();
+    }
+    push_back(value);
+  }
+
+  void pop_front() {
+    assert(!empty());
+    pop_front(1);
+  }
+
+  void pop_front(size_type count) {
+    assert(count <= size_);
+    first_ = wrap(first_ + count);
+    size_ -= count;
+  }
+
+  void copy_in_back(value_type const* data, size_type count) {
+    assert(count <= remaining());
+    write(last(), data, count);
+    size_ += count;
+  }
+
+  /**
+   * Append `count` items, removing as many items from the front as
+   * necessary to make room
+   *
+   * If `count` exceeds the capacity, only the last `capacity()` items
+   * are kept.
+   */
+  void copy_in_back_overwrite(value_type const* data, size_type count) {
+    if (count > capacity_) {
+      data += count - capacity_;
+      count = capacity_;
+    }
+    auto const overflow = count > remaining() ? count - remaining() : 0;
+    write(last(), data, count);
+    first_ = wrap(first_ + overflow);
+    size_ += count - overflow;
+  }
+
+  void copy_out_front(value_type* data, size_type count) {
+    assert(count <= size_);
+    std::memcpy(data, this->data(), sizeof(*data) * count);
+    pop_front(count);
+  }
+
+ private:
+  size_type wrap(size_type index) const {
+    return index < capacity_ ? index : index - capacity_;
+  }
+
+  size_type last() const { return wrap(first_ + size_); }
+
+  // Writes `count` items to the slots from `slot` in both halves. The
+  // part that wraps around the end of the second half goes to the start
+  // of the first half.
+  void write(size_type slot, value_type const* src, size_type count) {
+    auto const count_a = count < capacity_ - slot ? count : capacity_ - slot;
+    auto const count_b = count - count_a;
+    auto const bytes_a = sizeof(*src) * count_a;
+    auto const bytes_b = sizeof(*src) * count_b;
+    std::memcpy(begin_ + slot, src, bytes_a);
+    std::memcpy(begin_ + slot + capacity_, src, bytes_a);
+    std::memcpy(begin_, src + count_a, bytes_b);
+    std::memcpy(begin_ + capacity_, src + count_a, bytes_b);
+  }
+
+  pointer begin_;
+  size_type capacity_;
+  size_type first_{0};
+  size_type size_{0};
+};
+
+} // namespace embedded
@@ -22,8 +22,79 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+
+#if defined(__GNUC__) && defined(__ARM_ARCH_PROFILE) &&                       \
+    __ARM_ARCH_PROFILE == 'M'
+#define LIBEMB_MUTEX_PRIMASK
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) ||                   \
+    defined(__ARM_ARCH_8M_MAIN__) || defined(__ARM_ARCH_8_1M_MAIN__)
+#define LIBEMB_MUTEX_BASEPRI
+#endif
+#endif
+
 namespace embedded {
 
+namespace detail {
+
+// Hint to the CPU that we're busy waiting, which saves power and frees
+// resources for the other hardware thread, if any.
+inline void cpu_relax() noexcept {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  __builtin_ia32_pause();
+#elif defined(__GNUC__) && (defined(__arm__) || defined(__aarch64__))
+  __asm__ __volatile__("yield");
+#endif
+}
+
+#if defined(LIBEMB_MUTEX_PRIMASK)
+// Masks all configurable interrupts.
+struct primask_policy {
+  using state_type = std::uint32_t;
+
+  static state_type save_and_mask() noexcept {
+    state_type primask;
+    __asm__ __volatile__("mrs %0, primask\n\tcpsid i"
+                         : "=r"(primask)
+                         :
+                         : "memory");
+    return primask;
+  }
+
+  static void restore(state_type primask) noexcept {
+    __asm__ __volatile__("msr primask, %0" : : "r"(primask) : "memory");
+  }
+};
+#endif
+
+#if defined(LIBEMB_MUTEX_BASEPRI)
+// Masks all interrupts with a raw priority value of `Level` or above,
+// i.e. of the same or lower urgency. `basepri_max` only ever raises the
+// masking level, so locking never unmasks anything.
+template <std::uint8_t Level>
+struct basepri_policy {
+  static_assert(Level != 0, "A BASEPRI of 0 doesn't mask anything");
+
+  using state_type = std::uint32_t;
+
+  static state_type save_and_mask() noexcept {
+    state_type basepri;
+    __asm__ __volatile__("mrs %0, basepri\n\tmsr basepri_max, %1"
+                         : "=&r"(basepri)
+                         : "r"(state_type{Level})
+                         : "memory");
+    return basepri;
+  }
+
+  static void restore(state_type basepri) noexcept {
+    __asm__ __volatile__("msr basepri, %0" : : "r"(basepri) : "memory");
+  }
+};
+#endif
+
+} // namespace detail
+
 template <typename Mutex>
 class lock_guard {
  public:
@@ -39,4 +110,138 @@ class lock_guard {
   Mutex& m_;
 };
 
+/**
+ * Lock that does nothing
+ *
+ * For code that takes a `Mutex` parameter, but is built for a single
+ * execution context.
+ */
+class null_mutex {
+ public:
+  void lock() noexcept {}
+  bool try_lock() noexcept { return true; }
+  void unlock() noexcept {}
+};
+
+/**
+ * Critical section that masks interrupts
+ *
+ * `Policy` provides `save_and_mask()`, which returns the current masking
+ * state of type `state_type` and then masks interrupts, and `restore()`.
+ * The state is saved by the outermost `lock()` and restored by the
+ * matching `unlock()`, so nested locks of the same instance never unmask
+ * interrupts early, and interrupts that were already masked before the
+ * outermost `lock()` stay masked. The same instance can be used from the
+ * main loop and from interrupt handlers.
+ *
+ * This only protects against code running on the same core.
+ */
+template <typename Policy>
+class basic_interrupt_mutex {
+ public:
+  void lock() noexcept {
+    auto const state = Policy::save_and_mask();
+    if (depth_++ == 0) {
+      saved_ = state;
+    }
+  }
+
+  void unlock() noexcept {
+    if (--depth_ == 0) {
+      Policy::restore(saved_);
+    }
+  }
+
+ private:
+  typename Policy::state_type saved_{};
+  unsigned depth_{0};
+};
+
+#if defined(LIBEMB_MUTEX_PRIMASK)
+/**
+ * Critical section masking all configurable interrupts (Cortex-M PRIMASK)
+ */
+using interrupt_mutex = basic_interrupt_mutex<detail::primask_policy>;
+#endif
+
+#if defined(LIBEMB_MUTEX_BASEPRI)
+/**
+ * Critical section masking interrupts up to a priority (Cortex-M BASEPRI)
+ *
+ * Masks all interrupts with a priority value of `Priority` or above,
+ * which have the same or a lower urgency. Interrupts with a lower value
+ * keep running with their usual latency, but must not use this lock.
+ * `PriorityBits` is the number of implemented priority bits of the NVIC
+ * (`__NVIC_PRIO_BITS`).
+ */
+template <unsigned Priority, unsigned PriorityBits = 4>
+using priority_mutex = basic_interrupt_mutex<detail::basepri_policy<
+    static_cast<std::uint8_t>((Priority << (8 - PriorityBits)) & 0xFF)>>;
+#endif
+
+/**
+ * Test-and-set spinlock
+ *
+ * Waiting is done with plain loads, so the cache line is only written
+ * when the lock has been released. Needs lock-free atomics, so this is
+ * unsuitable for cores without atomic read-modify-write instructions
+ * (e.g. Cortex-M0/M0+), and must never be taken from an interrupt
+ * handler that may have interrupted the current owner.
+ */
+class spin_mutex {
+ public:
+  void lock() noexcept {
+    while (locked_.exchange(true, std::memory_order_acquire)) {
+      while (locked_.load(std::memory_order_relaxed)) {
+        detail::cpu_relax();
+      }
+    }
+  }
+
+  bool try_lock() noexcept {
+    return !locked_.load(std::memory_order_relaxed) &&
+           !locked_.exchange(true, std::memory_order_acquire);
+  }
+
+  void unlock() noexcept { locked_.store(false, std::memory_order_release); }
+
+ private:
+  std::atomic<bool> locked_{false};
+};
+
+/**
+ * Ticket spinlock
+ *
+ * Like `spin_mutex`, but waiters acquire the lock in the order they
+ * arrived, so no core can starve under contention.
+ */
+class ticket_mutex {
+ public:
+  void lock() noexcept {
+    auto const ticket = next_.fetch_add(1, std::memory_order_relaxed);
+    while (serving_.load(std::memory_order_acquire) != ticket) {
+      detail::cpu_relax();
+    }
+  }
+
+  bool try_lock() noexcept {
+    auto ticket = serving_.load(std::memory_order_acquire);
+    return next_.compare_exchange_strong(ticket, ticket + 1,
+                                         std::memory_order_acquire,
+                                         std::memory_order_relaxed);
+  }
+
+  void unlock() noexcept {
+    serving_.store(serving_.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_release);
+  }
+
+ private:
+  std::atomic<std::uint32_t> next_{0};
+  std::atomic<std::uint32_t> serving_{0};
+};
+
 } // namespace embedded
+
+#undef LIBEMB_MUTEX_PRIMASK
+#undef LIBEMB_MUTEX_BASEPRI
@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace embedded {
+
+/**
+ * A storage backend for `persistent_circular_buffer` on top of plain memory
+ *
+ * This is useful for memory-mapped EEPROM that can be written like RAM,
+ * and for testing. A backend for other non-volatile memory must provide
+ * the same interface:
+ *
+ *  - `page_size`, the size in bytes of a page that can be programmed in
+ *    a single cycle;
+ *  - `size()`, the size of the storage in bytes;
+ *  - `read(offset, data, count)`, which reads `count` bytes at `offset`;
+ *  - `program(offset, data, count)`, which writes `count` bytes at
+ *    `offset`. The range never crosses a page boundary. If the memory
+ *    must be erased before it can be written, this is up to `program()`.
+ */
+template <std::size_t PageSize>
+class memory_storage {
+ public:
+  static constexpr std::size_t page_size = PageSize;
+
+  memory_storage(void* data, std::size_t size)
+      : data_{static_cast<unsigned char*>(data)}
+      , size_{size} {}
+
+  std::size_t size() const { return size_; }
+
+  void read(std::size_t offset, void* data, std::size_t count) const {
+    assert(offset + count <= size_);
+    std::memcpy(data, data_ + offset, count);
+  }
+
+  void program(std::size_t offset, void const* data, std::size_t count) {
+    assert(offset + count <= size_);
+    assert(offset / page_size == (offset + count - 1) / page_size);
+    std::memcpy(data_ + offset, data, count);
+  }
+
+ private:
+  unsigned char* data_;
+  std::size_t size_;
+};
+
+/**
+ * A circular buffer in non-volatile memory with page-batched writes
+ *
+ * Unlike `circular_buffer_adapter`, which writes each item straight to the
+ * memory it manages, this keeps the page at the back of the buffer in a
+ * RAM window. Items added with `push_back()` and `copy_in_back()` are
+ * collected there, and each page is programmed once it is complete (or
+ * on `flush()`). Pages completely covered by `copy_in_back()` are
+ * programmed straight from the source.
+ *
+ * The position of the front and the number of items are kept in a
+ * separate journal storage, which `flush()` appends a record to. The
+ * records rotate through all slots of the journal, so the metadata writes
+ * are spread evenly. A record is only written after the data it refers to
+ * has been programmed, and it carries a checksum, so if power fails
+ * while writing, the previous record remains valid. On construction, the
+ * buffer is restored from the newest valid record instead of scanning the
+ * data. Items added or removed after the last `flush()` are lost when
+ * power fails.
+ *
+ * Until `flush()` has recorded a `pop_front()`, the journal still refers
+ * to the removed items, so their slots are not reused before then. This
+ * means that after removing items, `remaining()` only grows on the next
+ * `flush()`.
+ *
+ * As the storage cannot necessarily be accessed through pointers, items
+ * are returned by value. `T` must be trivially copyable and the page size
+ * must be a multiple of its size as well as of the 16-byte journal record.
+ * The data storage must be a multiple of the page size, and the journal
+ * must have room for at least two records.
+ */
+template <typename T, typename Storage>
+class persistent_circular_buffer {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "T must be trivially copyable");
+  static_assert(Storage::page_size % sizeof(T) == 0,
+                "page size must be a multiple of the item size");
+
+ public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using storage_type = Storage;
+
+  persistent_circular_buffer(Storage data, Storage journal)
+      : data_{data}
+      , journal_{journal}
+      , capacity_{data_.size() / sizeof(T)} {
+    assert(data_.size() % page_size == 0);
+    assert(capacity_ > 0);
+    assert(slots() >= 2);
+    restore();
+  }
+
+  persistent_circular_buffer(persistent_circular_buffer const&) = delete;
+  persistent_circular_buffer&
+  operator=(persistent_circular_buffer const&) = delete;
+
+  bool empty() const { return size_ == 0; }
+  bool full() const { return remaining() == 0; }
+
+  size_type capacity() const { return capacity_; }
+  size_type size() const { return size_; }
+
+  /**
+   * Number of items that can be added, not counting the slots of removed
+   * items that have not been flushed yet
+   */
+  size_type remaining() const { return capacity_ - size_ - popped_; }
+
+  /**
+   * Index of the front item in the data storage
+   */
+  size_type first_index() const { return first_; }
+
+  /**
+   * Whether there are changes that have not been persisted by `flush()`
+   */
+  bool dirty() const { return page_dirty_ || meta_dirty_; }
+
+  value_type front() const {
+    assert(!empty());
+    return (*this)[0];
+  }
+
+  value_type back() const {
+    assert(!empty());
+    return (*this)[size_ - 1];
+  }
+
+  value_type operator[](size_type pos) const {
+    assert(pos < size_);
+    value_type value;
+    read(add(first_, pos), &value, 1);
+    return value;
+  }
+
+  void push_back(value_type const& value) {
+    assert(!full());
+    write(add(first_, size_), &value, 1);
+    ++size_;
+    meta_dirty_ = true;
+  }
+
+  void copy_in_back(value_type const* data, size_type count) {
+    assert(count <= remaining());
+    auto const last = add(first_, size_);
+    auto const count_a = count < capacity_ - last ? count : capacity_ - last;
+    write(last, data, count_a);
+    write(0, data + count_a, count - count_a);
+    size_ += count;
+    meta_dirty_ = meta_dirty_ || count > 0;
+  }
+
+  void pop_front() {
+    assert(!empty());
+    pop_front(1);
+  }
+
+  void pop_front(size_type count) {
+    assert(count <= size_);
+    first_ = add(first_, count);
+    size_ -= count;
+    popped_ += count;
+    meta_dirty_ = meta_dirty_ || count > 0;
+  }
+
+  void copy_out_front(value_type* data, size_type count) {
+    assert(count <= size_);
+    auto const count_a =
+        count < capacity_ - first_ ? count : capacity_ - first_;
+    read(first_, data, count_a);
+    read(0, data + count_a, count - count_a);
+    pop_front(count);
+  }
+
+  void clear() { pop_front(size_); }
+
+  /**
+   * Program the page in the RAM window if it has been modified, then
+   * append a journal record if the front or size have changed. This also
+   * releases the slots of removed items for reuse.
+   */
+  void flush() {
+    if (page_dirty_) {
+      data_.program(window_ * page_size, window_data_, page_size);
+      page_dirty_ = false;
+    }
+    if (meta_dirty_) {
+      record r{seq_ + 1, static_cast<std::uint32_t>(first_),
+               static_cast<std::uint32_t>(size_), 0};
+      r.check = checksum(r);
+      journal_.program(slot_ * sizeof(record), &r, sizeof(record));
+      seq_ = r.seq;
+      slot_ = (slot_ + 1) % slots();
+      popped_ = 0;
+      meta_dirty_ = false;
+    }
+  }
+
+ private:
+  static constexpr size_type page_size = Storage::page_size;
+  static constexpr size_type items_per_page = page_size / sizeof(T);
+  static constexpr size_type no_window = static_cast<size_type>(-1);
+
+  struct record {
+    std::uint32_t seq;
+    std::uint32_t first;
+    std::uint32_t size;
+    std::uint32_t check;
+  };
+
+  // FNV-1a over everything but the checksum itself
+  static std::uint32_t checksum(record const& r) {
+    std::uint32_t const words[] = {r.seq, r.first, r.size};
+    std::uint32_t h = 2166136261u;
+    for (auto w : words) {
+      for (int i = 0; i < 4; ++i) {
+        h = (h ^ ((w >> (8 * i)) & 0xFFu)) * 16777619u;
+      }
+    }
+    return h;
+  }
+
+  static_assert(page_size % sizeof(record) == 0,
+                "page size must be a multiple of the journal record size");
+
+  size_type slots() const { return journal_.size() / sizeof(record); }
+
+  void restore() {
+    bool found = false;
+
+    for (size_type i = 0; i < slots(); ++i) {
+      record r;
+      journal_.read(i * sizeof(record), &r, sizeof(record));
+      if (r.check != checksum(r) || r.first >= capacity_ ||
+          r.size > capacity_) {
+        continue;
+      }
+      if (!found || static_cast<std::int32_t>(r.seq - seq_) > 0) {
+        first_ = r.first;
+        size_ = r.size;
+        seq_ = r.seq;
+        slot_ = (i + 1) % slots();
+        found = true;
+      }
+    }
+  }
+
+  size_type add(size_type index, size_type n) const {
+    return index + n < capacity_ ? index + n : index + n - capacity_;
+  }
+
+  // Make `page` the page in the RAM window, programming the previous one
+  // if necessary. Reading the page first preserves items at the front
+  // that share it with the back.
+  void load(size_type page) {
+    if (page == window_) {
+      return;
+    }
+    if (page_dirty_) {
+      data_.program(window_ * page_size, window_data_, page_size);
+      page_dirty_ = false;
+    }
+    data_.read(page * page_size, window_data_, page_size);
+    window_ = page;
+  }
+
+  // write items to a contiguous range of slots
+  void write(size_type index, value_type const* src, size_type count) {
+    while (count > 0) {
+      auto const page = index / items_per_page;
+      auto const offset = index % items_per_page;
+      auto const n =
+          count < items_per_page - offset ? count : items_per_page - offset;
+
+      if (n == items_per_page) {
+        // whole page, no need to go through the window
+        if (page == window_) {
+          window_ = no_window;
+          page_dirty_ = false;
+        }
+        data_.program(page * page_size, src, page_size);
+      } else {
+        load(page);
+        std::memcpy(window_data_ + offset * sizeof(T), src, n * sizeof(T));
+        page_dirty_ = true;
+        if (offset + n == items_per_page) {
+          data_.program(window_ * page_size, window_data_, page_size);
+          page_dirty_ = false;
+        }
+      }
+
+      index += n;
+      src += n;
+      count -= n;
+    }
+  }
+
+  // read items from a contiguous range of slots
+  void read(size_type index, value_type* dest, size_type count) const {
+    while (count > 0) {
+      auto const page = index / items_per_page;
+      auto const offset = index % items_per_page;
+      auto const n =
+          count < items_per_page - offset ? count : items_per_page - offset;
+
+      if (page == window_) {
+        std::memcpy(dest, window_data_ + offset * sizeof(T), n * sizeof(T));
+      } else {
+        data_.read(index * sizeof(T), dest, n * sizeof(T));
+      }
+
+      index += n;
+      dest += n;
+      count -= n;
+    }
+  }
+
+  Storage data_;
+  Storage journal_;
+  size_type const capacity_;
+  size_type first_{0};
+  size_type size_{0};
+  size_type popped_{0}; // removed since the last journal record
+  std::uint32_t seq_{0};
+  size_type slot_{0};
+  size_type window_{no_window};
+  bool page_dirty_{false};
+  bool meta_dirty_{false};
+  alignas(T) unsigned char window_data_[page_size];
+};
+
+} // namespace embedded
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "circular_buffer_adapter.h"
+#include "varint.h"
+
+namespace embedded {
+
+/**
+ * Description of how to serialize a `T`, see `serialize()`
+ *
+ * A specialization must provide a `kind` constant that identifies the
+ * record type to the decoder and a static `write(Sink&, T const&)`
+ * function that writes the payload using the functions of
+ * `serialize_sink`. Specializations exist for `cba_statistics` here and
+ * for filter designs, filter states and filter statistics in
+ * `signal/serialize.h`.
+ */
+template <typename T>
+struct serialize_traits;
+
+/**
+ * Record kinds used by the specializations in this library
+ *
+ * `scripts/decode-diagnostics.py` decodes records of these kinds.
+ * Custom specializations should use kinds of at least `user`.
+ */
+namespace serialize_kind {
+
+constexpr std::uint32_t sos_design = 1;
+constexpr std::uint32_t poly_design = 2;
+constexpr std::uint32_t sos_state = 3;
+constexpr std::uint32_t sos_statistics = 4;
+constexpr std::uint32_t cba_statistics = 5;
+constexpr std::uint32_t user = 64;
+
+} // namespace serialize_kind
+
+namespace detail {
+
+// Computes the size of a payload without writing it
+class serialize_counter {
+ public:
+  void put(std::uint8_t const*, std::size_t n) { size_ += n; }
+
+  std::size_t size() const { return size_; }
+
+ private:
+  std::size_t size_{0};
+};
+
+template <typename It>
+class serialize_writer {
+ public:
+  explicit serialize_writer(It it)
+      : it_{it} {}
+
+  void put(std::uint8_t const* p, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+      *it_++ = p[i];
+    }
+  }
+
+  It end() const { return it_; }
+
+ private:
+  It it_;
+};
+
+template <typename Buffer>
+class serialize_buffer_writer {
+ public:
+  explicit serialize_buffer_writer(Buffer& out)
+      : out_{out} {}
+
+  void put(std::uint8_t const* p, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+      out_.push_back(p[i]);
+    }
+  }
+
+ private:
+  Buffer& out_;
+};
+
+} // namespace detail
+
+/**
+ * Encoding primitives for the payload of a record
+ *
+ * Integers are stored as `varint`s, signed integers zig-zag encoded.
+ * Floating point values are stored as their IEEE 754 bit pattern, least
+ * significant byte first, independent of the byte order of the target.
+ */
+template <typename Out>
+class serialize_sink {
+ public:
+  explicit serialize_sink(Out& out)
+      : out_(out) {}
+
+  void byte(std::uint8_t b) { out_.put(&b, 1); }
+
+  template <typename T, typename std::enable_if<std::is_integral<T>::value,
+                                                bool>::type = true>
+  void value(T v) {
+    std::uint8_t tmp[(sizeof(T) * 8 + 6) / 7];
+    auto const end = varint::encode(v, &tmp[0]);
+    out_.put(tmp, static_cast<std::size_t>(end - tmp));
+  }
+
+  void value(float v) {
+    static_assert(sizeof(float) == sizeof(std::uint32_t),
+                  "float must be 32 bits");
+    std::uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    raw(bits);
+  }
+
+  void value(double v) {
+    static_assert(sizeof(double) == sizeof(std::uint64_t),
+                  "double must be 64 bits");
+    std::uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    raw(bits);
+  }
+
+ private:
+  template <typename U>
+  void raw(U bits) {
+    std::uint8_t tmp[sizeof(U)];
+    for (std::size_t i = 0; i < sizeof(U); ++i) {
+      tmp[i] = static_cast<std::uint8_t>(bits >> (8 * i));
+    }
+    out_.put(tmp, sizeof(U));
+  }
+
+  Out& out_;
+};
+
+namespace detail {
+
+template <typename T>
+std::size_t serialize_payload_size(T const& obj) {
+  serialize_counter counter;
+  serialize_sink<serialize_counter> sink(counter);
+  serialize_traits<T>::write(sink, obj);
+  return counter.size();
+}
+
+template <typename T>
+std::size_t serialize_record_size(std::uint32_t id, std::size_t length) {
+  return varint::size(serialize_traits<T>::kind) + varint::size(id) +
+         varint::size(length) + length;
+}
+
+template <typename T, typename Out>
+void serialize_record(Out& out, T const& obj, std::uint32_t id,
+                      std::size_t length) {
+  serialize_sink<Out> sink(out);
+  sink.value(serialize_traits<T>::kind);
+  sink.value(id);
+  sink.value(length);
+  serialize_traits<T>::write(sink, obj);
+}
+
+} // namespace detail
+
+/**
+ * Number of bytes required by `serialize(obj, ..., id)`
+ */
+template <typename T>
+std::size_t serialized_size(T const& obj, std::uint32_t id = 0) {
+  return detail::serialize_record_size<T>(id,
+                                          detail::serialize_payload_size(obj));
+}
+
+/**
+ * Serialize `obj` into a byte buffer
+ *
+ * A record consists of the `kind` of the record, the caller-defined `id`
+ * (e.g. to tell several filters apart) and the size of the payload in
+ * bytes, all as `varint`s, followed by the payload. Records can be
+ * concatenated and unknown kinds can be skipped by the decoder. Nothing
+ * is allocated and no formatting is done on the target, see
+ * `scripts/decode-diagnostics.py` for a decoder.
+ *
+ * \param obj      The object to serialize.
+ *
+ * \param begin    Pointer to start of the buffer.
+ *
+ * \param end      Pointer to end of the buffer.
+ *
+ * \param id       Identifier stored with the record.
+ *
+ * \returns Pointer to end of the record, or `begin` if there was not
+ *          enough space. In this case, the buffer is not modified.
+ */
+template <typename T>
+std::uint8_t* serialize(T const& obj, std::uint8_t* begin, std::uint8_t* end,
+                        std::uint32_t id = 0) {
+  auto const length = detail::serialize_payload_size(obj);
+  if (static_cast<std::size_t>(end - begin) <
+      detail::serialize_record_size<T>(id, length)) {
+    return begin;
+  }
+  detail::serialize_writer<std::uint8_t*> writer(begin);
+  detail::serialize_record(writer, obj, id, length);
+  return writer.end();
+}
+
+/**
+ * Append the serialization of `obj` to a byte buffer
+ *
+ * `out` needs `push_back()` and `remaining()`, e.g. a
+ * `circular_buffer_adapter<std::uint8_t>` drained by a UART.
+ *
+ * \returns `false` if there was not enough space left in `out`. In this
+ *          case, `out` is not modified.
+ */
+template <typename T, typename Buffer>
+bool serialize(T const& obj, Buffer& out, std::uint32_t id = 0) {
+  auto const length = detail::serialize_payload_size(obj);
+  if (out.remaining() < detail::serialize_record_size<T>(id, length)) {
+    return false;
+  }
+  detail::serialize_buffer_writer<Buffer> writer(out);
+  detail::serialize_record(writer, obj, id, length);
+  return true;
+}
+
+template <>
+struct serialize_traits<cba_statistics> {
+  static constexpr std::uint32_t kind = serialize_kind::cba_statistics;
+
+  template <typename Sink>
+  static void write(Sink& sink, cba_statistics const& s) {
+    sink.value(s.high_water);
+    sink.value(s.overflows);
+    sink.value(s.underflows);
+    sink.value(s.pushed);
+    sink.value(s.popped);
+  }
+};
+
+} // namespace embedded
@@ -24,7 +24,7 @@
 
 #include <cstddef>
 
-#include "detail/bessel_poles.h"
+#include "detail/bessel.h"
 #include "detail/filter.h"
 
 // clang-format off
@@ -36,6 +36,13 @@
 namespace embedded {
 namespace signal {
 
+/**
+ * Bessel (phase normalized) filter prototype
+ *
+ * The poles are computed by the compiler for orders up to 16. Higher
+ * orders (up to 100) need the precomputed poles from
+ * "embedded/signal/bessel_table.h".
+ */
 template <std::size_t Order>
 class bessel {
  public:
@@ -56,7 +63,7 @@ class bessel {
     constexpr auto zeros() const noexcept -> carray<0> { return carray<0>{}; }
 
     constexpr auto poles() const noexcept -> carray<Order> {
-      return detail::bessel_poles<value_type, Order>::value;
+      return detail::bessel_poles<value_type, Order>();
     }
 
     constexpr auto gain() const noexcept -> value_type { return value_type{1}; }
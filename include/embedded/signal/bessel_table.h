@@ -24,250 +24,14 @@
 
 #include <cstddef>
 
-#include "../../constexpr_math/complex.h"
-#include "../../constexpr_math/vector.h"
+#include "bessel.h"
 
 namespace embedded {
 namespace signal {
 namespace detail {
 
-template <typename F, std::size_t Order>
-struct bessel_poles;
-
-template <typename F>
-struct bessel_poles<F, 1> {
-  static constexpr cmath::vector<cmath::complex<F>, 1> value{
-      cmath::complex<F>{-0.9999999999999998l, -0.0l},
-  };
-};
-
-template <typename F>
-struct bessel_poles<F, 2> {
-  static constexpr cmath::vector<cmath::complex<F>, 2> value{
-      cmath::complex<F>{-0.8660254037844386l, 0.49999999999999994l},
-      cmath::complex<F>{-0.8660254037844386l, -0.49999999999999994l},
-  };
-};
-
-template <typename F>
-struct bessel_poles<F, 3> {
-  static constexpr cmath::vector<cmath::complex<F>, 3> value{
-      cmath::complex<F>{-0.7456403858480765l, 0.7113666249728352l},
-      cmath::complex<F>{-0.9416000265332067l, -0.0l},
-      cmath::complex<F>{-0.7456403858480765l, -0.7113666249728352l},
-  };
-};
-
-template <typename F>
-struct bessel_poles<F, 4> {
-  static constexpr cmath::vector<cmath::complex<F>, 4> value{
-      cmath::complex<F>{-0.6572111716718828l, 0.830161435004873l},
-      cmath::complex<F>{-0.904758796788245l, 0.27091873300387465l},
-      cmath::complex<F>{-0.904758796788245l, -0.27091873300387465l},
-      cmath::complex<F>{-0.6572111716718828l, -0.830161435004873l},
-  };
-};
-
-template <typename F>
-struct bessel_poles<F, 5> {
-  static constexpr cmath::vector<cmath::complex<F>, 5> value{
-      cmath::complex<F>{-0.5905759446119191l, 0.9072067564574549l},
-      cmath::complex<F>{-0.8515536193688396l, 0.44271746394433276l},
-      cmath::complex<F>{-0.9264420773877602l, -0.0l},
-      cmath::complex<F>{-0.8515536193688396l, -0.44271746394433276l},
-      cmath::complex<F>{-0.5905759446119191l, -0.9072067564574549l},
-  };
-};
-
-template <typename F>
-struct bessel_poles<F, 6> {
-  static constexpr cmath::vector<cmath::complex<F>, 6> value{
-      cmath::complex<F>{-0.5385526816693113l, 0.9616876881954278l},
-      cmath::complex<F>{-0.799654185832829l, 0.5621717346937318l},
-      cmath::complex<F>{-0.909390683047227l, 0.18569643967930471l},
-      cmath::complex<F>{-0.909390683047227l, -0.18569643967930471l},
-      cmath::complex<F>{-0.799654185832829l, -0.5621717346937318l},
-      cmath::complex<F>{-0.5385526816693113l, -0.9616876881954278l},
-  };
-};
-
-template <typename F>
-struct bessel_poles<F, 7> {
-  static constexpr cmath::vector<cmath::complex<F>, 7> value{
-      cmath::complex<F>{-0.496691725667232l, 1.0025085084544205l},
-      cmath::complex<F>{-0.7527355434093216l, 0.6504696305522549l},
-      cmath::complex<F>{-0.8800029341523375l, 0.32166527623077396l},
-      cmath::complex<F>{-0.919487155649029l, -0.0l},
-      cmath::complex<F>{-0.8800029341523375l, -0.32166527623077396l},
-      cmath::complex<F>{-0.7527355434093216l, -0.6504696305522549l},
-      cmath::complex<F>{-0.496691725667232l, -1.0025085084544205l},
-  };
-};
-
-template <typename F>
-struct bessel_poles<F, 8> {
-  static constexpr cmath::vector<cmath::complex<F>, 8> value{
-      cmath::complex<F>{-0.46217404125321226l, 1.0343886811269012l},
-      cmath::complex<F>{-0.7111381808485397l, 0.7186517314108402l},
-      cmath::complex<F>{-0.8473250802359334l, 0.4259017538272935l},
-      cmath::complex<F>{-0.9096831546652911l, 0.14124379766714226l},
-      cmath::complex<F>{-0.9096831546652911l, -0.14124379766714226l},
-      cmath::complex<F>{-0.8473250802359334l, -0.4259017538272935l},
-      cmath::complex<F>{-0.7111381808485397l, -0.7186517314108402l},
-      cmath::complex<F>{-0.46217404125321226l, -1.0343886811269012l},
-  };
-};
-
-template <typename F>
-struct bessel_poles<F, 9> {
-  static constexpr cmath::vector<cmath::complex<F>, 9> value{
-      cmath::complex<F>{-0.4331415561553623l, 1.0600736701359301l},
-      cmath::complex<F>{-0.6743622686854766l, 0.7730546212691185l},
-      cmath::complex<F>{-0.8148021112269013l, 0.50858156896315l},
-      cmath::complex<F>{-0.8911217017079759l, 0.2526580934582164l},
-      cmath::complex<F>{-0.9154957797499037l, -0.0l},
-      cmath::complex<F>{-0.8911217017079759l, -0.2526580934582164l},
-      cmath::complex<F>{-0.8148021112269013l, -0.50858156896315l},
-      cmath::complex<F>{-0.6743622686854766l, -0.7730546212691185l},
-      cmath::complex<F>{-0.4331415561553623l, -1.0600736701359301l},
-  };
-};
-
-template <typename F>
-struct bessel_poles<F, 10> {
-  static constexpr cmath::vector<cmath::complex<F>, 10> value{
-      cmath::complex<F>{-0.40832207328688647l, 1.0812748428191246l},
-      cmath::complex<F>{-0.6417513866988321l, 0.8175836167191021l},
-      cmath::complex<F>{-0.7837694413101445l, 0.5759147538499949l},
-      cmath::complex<F>{-0.8688459641284763l, 0.343000823376631l},
-      cmath::complex<F>{-0.9091347320900505l, 0.11395831373355114l},
-      cmath::complex<F>{-0.9091347320900505l, -0.11395831373355114l},
-      cmath::complex<F>{-0.8688459641284763l, -0.343000823376631l},
-      cmath::complex<F>{-0.7837694413101445l, -0.5759147538499949l},
-      cmath::complex<F>{-0.6417513866988321l, -0.8175836167191021l},
-      cmath::complex<F>{-0.40832207328688647l, -1.0812748428191246l},
-  };
-};
-
-template <typename F>
-struct bessel_poles<F, 11> {
-  static constexpr cmath::vector<cmath::complex<F>, 11> value{
-      cmath::complex<F>{-0.3868149510055096l, 1.0991174667631216l},
-      cmath::complex<F>{-0.6126871554915198l, 0.8547813893314768l},
-      cmath::complex<F>{-0.7546938934722305l, 0.6319150050721849l},
-      cmath::complex<F>{-0.8453044014712964l, 0.4178696917801248l},
-      cmath::complex<F>{-0.8963656705721169l, 0.20804803750710324l},
-      cmath::complex<F>{-0.9129067244518985l, -0.0l},
-      cmath::complex<F>{-0.8963656705721169l, -0.20804803750710324l},
-      cmath::complex<F>{-0.8453044014712964l, -0.4178696917801248l},
-      cmath::complex<F>{-0.7546938934722305l, -0.6319150050721849l},
-      cmath::complex<F>{-0.6126871554915198l, -0.8547813893314768l},
-      cmath::complex<F>{-0.3868149510055096l, -1.0991174667631216l},
-  };
-};
-
-template <typename F>
-struct bessel_poles<F, 12> {
-  static constexpr cmath::vector<cmath::complex<F>, 12> value{
-      cmath::complex<F>{-0.36796400855263156l, 1.1143735756415465l},
-      cmath::complex<F>{-0.5866369321861477l, 0.8863772751320727l},
-      cmath::complex<F>{-0.7276681615395162l, 0.6792961178764695l},
-      cmath::complex<F>{-0.8217296939939076l, 0.48102121151006766l},
-      cmath::complex<F>{-0.8802534342016832l, 0.2871779503524228l},
-      cmath::complex<F>{-0.9084478234140686l, 0.09550636521345039l},
-      cmath::complex<F>{-0.9084478234140686l, -0.09550636521345039l},
-      cmath::complex<F>{-0.8802534342016832l, -0.2871779503524228l},
-      cmath::complex<F>{-0.8217296939939076l, -0.48102121151006766l},
-      cmath::complex<F>{-0.7276681615395162l, -0.6792961178764695l},
-      cmath::complex<F>{-0.5866369321861477l, -0.8863772751320727l},
-      cmath::complex<F>{-0.36796400855263156l, -1.1143735756415465l},
-  };
-};
-
-template <typename F>
-struct bessel_poles<F, 13> {
-  static constexpr cmath::vector<cmath::complex<F>, 13> value{
-      cmath::complex<F>{-0.3512792323389817l, 1.1275915483177046l},
-      cmath::complex<F>{-0.5631559842430193l, 0.9135900338325103l},
-      cmath::complex<F>{-0.7026234675721276l, 0.7199611890171304l},
-      cmath::complex<F>{-0.7987460692470972l, 0.5350752120696801l},
-      cmath::complex<F>{-0.862509419826055l, 0.3547413731172989l},
-      cmath::complex<F>{-0.8991314665475196l, 0.17683429561610436l},
-      cmath::complex<F>{-0.9110914665984182l, -0.0l},
-      cmath::complex<F>{-0.8991314665475196l, -0.17683429561610436l},
-      cmath::complex<F>{-0.862509419826055l, -0.3547413731172989l},
-      cmath::complex<F>{-0.7987460692470972l, -0.5350752120696801l},
-      cmath::complex<F>{-0.7026234675721276l, -0.7199611890171304l},
-      cmath::complex<F>{-0.5631559842430193l, -0.9135900338325103l},
-      cmath::complex<F>{-0.3512792323389817l, -1.1275915483177046l},
-  };
-};
-
-template <typename F>
-struct bessel_poles<F, 14> {
-  static constexpr cmath::vector<cmath::complex<F>, 14> value{
-      cmath::complex<F>{-0.3363868224902029l, 1.1391722978398593l},
-      cmath::complex<F>{-0.5418766775112303l, 0.9373043683516924l},
-      cmath::complex<F>{-0.6794256425119226l, 0.7552857305042031l},
-      cmath::complex<F>{-0.7766591387063624l, 0.581917067737761l},
-      cmath::complex<F>{-0.8441199160909854l, 0.41316538251026935l},
-      cmath::complex<F>{-0.8869506674916445l, 0.24700791787653328l},
-      cmath::complex<F>{-0.9077932138396491l, 0.08219639941940153l},
-      cmath::complex<F>{-0.9077932138396491l, -0.08219639941940153l},
-      cmath::complex<F>{-0.8869506674916445l, -0.24700791787653328l},
-      cmath::complex<F>{-0.8441199160909854l, -0.41316538251026935l},
-      cmath::complex<F>{-0.7766591387063624l, -0.581917067737761l},
-      cmath::complex<F>{-0.6794256425119226l, -0.7552857305042031l},
-      cmath::complex<F>{-0.5418766775112303l, -0.9373043683516924l},
-      cmath::complex<F>{-0.3363868224902029l, -1.1391722978398593l},
-  };
-};
-
-template <typename F>
-struct bessel_poles<F, 15> {
-  static constexpr cmath::vector<cmath::complex<F>, 15> value{
-      cmath::complex<F>{-0.32299630597664475l, 1.1494161545836301l},
-      cmath::complex<F>{-0.5224954069658334l, 0.9581787261092526l},
-      cmath::complex<F>{-0.6579196593111004l, 0.7862895503722519l},
-      cmath::complex<F>{-0.7556027168970723l, 0.6229396358758263l},
-      cmath::complex<F>{-0.8256631452587149l, 0.46423487527343266l},
-      cmath::complex<F>{-0.8731264620834984l, 0.3082352470564267l},
-      cmath::complex<F>{-0.9006981694176978l, 0.1537681197278439l},
-      cmath::complex<F>{-0.9097482363849062l, -0.0l},
-      cmath::complex<F>{-0.9006981694176978l, -0.1537681197278439l},
-      cmath::complex<F>{-0.8731264620834984l, -0.3082352470564267l},
-      cmath::complex<F>{-0.8256631452587149l, -0.46423487527343266l},
-      cmath::complex<F>{-0.7556027168970723l, -0.6229396358758263l},
-      cmath::complex<F>{-0.6579196593111004l, -0.7862895503722519l},
-      cmath::complex<F>{-0.5224954069658334l, -0.9581787261092526l},
-      cmath::complex<F>{-0.32299630597664475l, -1.1494161545836301l},
-  };
-};
-
-template <typename F>
-struct bessel_poles<F, 16> {
-  static constexpr cmath::vector<cmath::complex<F>, 16> value{
-      cmath::complex<F>{-0.3108782755645385l, 1.1585528411993304l},
-      cmath::complex<F>{-0.5047606444424759l, 0.9767137477799085l},
-      cmath::complex<F>{-0.6379502514039067l, 0.8137453537108762l},
-      cmath::complex<F>{-0.735616630471312l, 0.6591950877860395l},
-      cmath::complex<F>{-0.8074790293236004l, 0.5092933751171799l},
-      cmath::complex<F>{-0.8584264231521322l, 0.3621697271802063l},
-      cmath::complex<F>{-0.8911723070323643l, 0.2167089659900576l},
-      cmath::complex<F>{-0.9072099595087002l, 0.07214211304111731l},
-      cmath::complex<F>{-0.9072099595087002l, -0.07214211304111731l},
-      cmath::complex<F>{-0.8911723070323643l, -0.2167089659900576l},
-      cmath::complex<F>{-0.8584264231521322l, -0.3621697271802063l},
-      cmath::complex<F>{-0.8074790293236004l, -0.5092933751171799l},
-      cmath::complex<F>{-0.735616630471312l, -0.6591950877860395l},
-      cmath::complex<F>{-0.6379502514039067l, -0.8137453537108762l},
-      cmath::complex<F>{-0.5047606444424759l, -0.9767137477799085l},
-      cmath::complex<F>{-0.3108782755645385l, -1.1585528411993304l},
-  };
-};
-
 template <typename F>
-struct bessel_poles<F, 17> {
+struct bessel_pole_table<F, 17> {
   static constexpr cmath::vector<cmath::complex<F>, 17> value{
       cmath::complex<F>{-0.29984894599900763l, 1.1667612729256676l},
       cmath::complex<F>{-0.48846293376727057l, 0.9932971956316782l},
@@ -290,7 +54,7 @@ struct bessel_poles<F, 17> {
 };
 
 template <typename F>
-struct bessel_poles<F, 18> {
+struct bessel_pole_table<F, 18> {
   static constexpr cmath::vector<cmath::complex<F>, 18> value{
       cmath::complex<F>{-0.28975920298804836l, 1.1741830106000584l},
       cmath::complex<F>{-0.47342680699161505l, 1.0082343003148009l},
@@ -314,7 +78,7 @@ struct bessel_poles<F, 18> {
 };
 
 template <typename F>
-struct bessel_poles<F, 19> {
+struct bessel_pole_table<F, 19> {
   static constexpr cmath::vector<cmath::complex<F>, 19> value{
       cmath::complex<F>{-0.2804866851439362l, 1.1809316284532905l},
       cmath::complex<F>{-0.4595043449730983l, 1.0217687769126707l},
@@ -339,7 +103,7 @@ struct bessel_poles<F, 19> {
 };
 
 template <typename F>
-struct bessel_poles<F, 20> {
+struct bessel_pole_table<F, 20> {
   static constexpr cmath::vector<cmath::complex<F>, 20> value{
       cmath::complex<F>{-0.27192995802516556l, 1.187099379810886l},
       cmath::complex<F>{-0.4465700698205147l, 1.0340977025608424l},
@@ -365,7 +129,7 @@ struct bessel_poles<F, 20> {
 };
 
 template <typename F>
-struct bessel_poles<F, 21> {
+struct bessel_pole_table<F, 21> {
   static constexpr cmath::vector<cmath::complex<F>, 21> value{
       cmath::complex<F>{-0.2640041595834025l, 1.192762031948052l},
       cmath::complex<F>{-0.4345168906815266l, 1.045382255856986l},
@@ -392,7 +156,7 @@ struct bessel_poles<F, 21> {
 };
 
 template <typename F>
-struct bessel_poles<F, 22> {
+struct bessel_pole_table<F, 22> {
   static constexpr cmath::vector<cmath::complex<F>, 22> value{
       cmath::complex<F>{-0.2566376987939322l, 1.1979824335552132l},
       cmath::complex<F>{-0.4232528745642631l, 1.0557556052275463l},
@@ -420,7 +184,7 @@ struct bessel_poles<F, 22> {
 };
 
 template <typename F>
-struct bessel_poles<F, 23> {
+struct bessel_pole_table<F, 23> {
   static constexpr cmath::vector<cmath::complex<F>, 23> value{
       cmath::complex<F>{-0.2497697202208956l, 1.202813187870698l},
       cmath::complex<F>{-0.4126986617510148l, 1.0653287944755134l},
@@ -449,7 +213,7 @@ struct bessel_poles<F, 23> {
 };
 
 template <typename F>
-struct bessel_poles<F, 24> {
+struct bessel_pole_table<F, 24> {
   static constexpr cmath::vector<cmath::complex<F>, 24> value{
       cmath::complex<F>{-0.24334813375248746l, 1.2072986837319728l},
       cmath::complex<F>{-0.40278538551975174l, 1.074195196518675l},
@@ -479,7 +243,7 @@ struct bessel_poles<F, 24> {
 };
 
 template <typename F>
-struct bessel_poles<F, 25> {
+struct bessel_pole_table<F, 25> {
   static constexpr cmath::vector<cmath::complex<F>, 25> value{
       cmath::complex<F>{-0.2373280669322028l, 1.2114766583825656l},
       cmath::complex<F>{-0.3934529878191078l, 1.0824339271738321l},
@@ -510,7 +274,7 @@ struct bessel_poles<F, 25> {
 };
 
 template <typename F>
-struct bessel_poles<F, 26> {
+struct bessel_pole_table<F, 26> {
   static constexpr cmath::vector<cmath::complex<F>, 26> value{
       cmath::complex<F>{-0.23167063714688232l, 1.2153794139151286l},
       cmath::complex<F>{-0.38464884730308185l, 1.0901124926279406l},
@@ -542,7 +306,7 @@ struct bessel_poles<F, 26> {
 };
 
 template <typename F>
-struct bessel_poles<F, 27> {
+struct bessel_pole_table<F, 27> {
   static constexpr cmath::vector<cmath::complex<F>, 27> value{
       cmath::complex<F>{-0.2263419686360484l, 1.2190347741551808l},
       cmath::complex<F>{-0.37632665511385666l, 1.0972888647452546l},
@@ -575,7 +339,7 @@ struct bessel_poles<F, 27> {
 };
 
 template <typename F>
-struct bessel_poles<F, 28> {
+struct bessel_pole_table<F, 28> {
   static constexpr cmath::vector<cmath::complex<F>, 28> value{
       cmath::complex<F>{-0.22131239883740744l, 1.2224668447029985l},
       cmath::complex<F>{-0.3684454882916625l, 1.1040131239766855l},
@@ -609,7 +373,7 @@ struct bessel_poles<F, 28> {
 };
 
 template <typename F>
-struct bessel_poles<F, 29> {
+struct bessel_pole_table<F, 29> {
   static constexpr cmath::vector<cmath::complex<F>, 29> value{
       cmath::complex<F>{-0.21655583256707506l, 1.2256966220496446l},
       cmath::complex<F>{-0.36096904175041644l, 1.1103287718402053l},
@@ -644,7 +408,7 @@ struct bessel_poles<F, 29> {
 };
 
 template <typename F>
-struct bessel_poles<F, 30> {
+struct bessel_pole_table<F, 30> {
   static constexpr cmath::vector<cmath::complex<F>, 30> value{
       cmath::complex<F>{-0.21204921266088392l, 1.2287424857938203l},
       cmath::complex<F>{-0.35386498821811985l, 1.116273788286472l},
@@ -680,7 +444,7 @@ struct bessel_poles<F, 30> {
 };
 
 template <typename F>
-struct bessel_poles<F, 31> {
+struct bessel_pole_table<F, 31> {
   static constexpr cmath::vector<cmath::complex<F>, 31> value{
       cmath::complex<F>{-0.20777208312384857l, 1.2316205994607297l},
       cmath::complex<F>{-0.34710444203657825l, 1.121881490213518l},
@@ -717,7 +481,7 @@ struct bessel_poles<F, 31> {
 };
 
 template <typename F>
-struct bessel_poles<F, 32> {
+struct bessel_pole_table<F, 32> {
   static constexpr cmath::vector<cmath::complex<F>, 32> value{
       cmath::complex<F>{-0.20370622633112748l, 1.234345239234997l},
       cmath::complex<F>{-0.3406615077248932l, 1.1271812336086013l},
@@ -755,7 +519,7 @@ struct bessel_poles<F, 32> {
 };
 
 template <typename F>
-struct bessel_poles<F, 33> {
+struct bessel_pole_table<F, 33> {
   static constexpr cmath::vector<cmath::complex<F>, 33> value{
       cmath::complex<F>{-0.19983535993597867l, 1.2369290653752876l},
       cmath::complex<F>{-0.3345128980946692l, 1.1321989917038677l},
@@ -794,7 +558,7 @@ struct bessel_poles<F, 33> {
 };
 
 template <typename F>
-struct bessel_poles<F, 34> {
+struct bessel_pole_table<F, 34> {
   static constexpr cmath::vector<cmath::complex<F>, 34> value{
       cmath::complex<F>{-0.19614488224594984l, 1.239383347705793l},
       cmath::complex<F>{-0.3286376097312739l, 1.1369578340654376l},
@@ -834,7 +598,7 @@ struct bessel_poles<F, 34> {
 };
 
 template <typename F>
-struct bessel_poles<F, 35> {
+struct bessel_pole_table<F, 35> {
   static constexpr cmath::vector<cmath::complex<F>, 35> value{
       cmath::complex<F>{-0.19262165719506377l, 1.241718154052108l},
       cmath::complex<F>{-0.3230166460267242l, 1.1414783259549262l},
@@ -875,7 +639,7 @@ struct bessel_poles<F, 35> {
 };
 
 template <typename F>
-struct bessel_poles<F, 36> {
+struct bessel_pole_table<F, 36> {
   static constexpr cmath::vector<cmath::complex<F>, 36> value{
       cmath::complex<F>{-0.18925383185793884l, 1.24394250857694l},
       cmath::complex<F>{-0.3176327798178523l, 1.1457788630923278l},
@@ -917,7 +681,7 @@ struct bessel_poles<F, 36> {
 };
 
 template <typename F>
-struct bessel_poles<F, 37> {
+struct bessel_pole_table<F, 37> {
   static constexpr cmath::vector<cmath::complex<F>, 37> value{
       cmath::complex<F>{-0.1860306808597922l, 1.2460645255119622l},
       cmath::complex<F>{-0.3124703491629042l, 1.1498759537450152l},
@@ -960,7 +724,7 @@ struct bessel_poles<F, 37> {
 };
 
 template <typename F>
-struct bessel_poles<F, 38> {
+struct bessel_pole_table<F, 38> {
   static constexpr cmath::vector<cmath::complex<F>, 38> value{
       cmath::complex<F>{-0.18294247313448525l, 1.2480915226596485l},
       cmath::complex<F>{-0.30751508096782315l, 1.1537844576088416l},
@@ -1004,7 +768,7 @@ struct bessel_poles<F, 38> {
 };
 
 template <typename F>
-struct bessel_poles<F, 39> {
+struct bessel_pole_table<F, 39> {
   static constexpr cmath::vector<cmath::complex<F>, 39> value{
       cmath::complex<F>{-0.17998035734558399l, 1.25003011816862l},
       cmath::complex<F>{-0.30275393811625906l, 1.1575177890458277l},
@@ -1049,7 +813,7 @@ struct bessel_poles<F, 39> {
 };
 
 template <typename F>
-struct bessel_poles<F, 40> {
+struct bessel_pole_table<F, 40> {
   static constexpr cmath::vector<cmath::complex<F>, 40> value{
       cmath::complex<F>{-0.17713626296751078l, 1.251886313406471l},
       cmath::complex<F>{-0.29817498651573215l, 1.1610880907615195l},
@@ -1095,7 +859,7 @@ struct bessel_poles<F, 40> {
 };
 
 template <typename F>
-struct bessel_poles<F, 41> {
+struct bessel_pole_table<F, 41> {
   static constexpr cmath::vector<cmath::complex<F>, 41> value{
       cmath::complex<F>{-0.17440281456661402l, 1.2536655642196644l},
       cmath::complex<F>{-0.29376727908533057l, 1.1645063828430662l},
@@ -1142,7 +906,7 @@ struct bessel_poles<F, 41> {
 };
 
 template <typename F>
-struct bessel_poles<F, 42> {
+struct bessel_pole_table<F, 42> {
   static constexpr cmath::vector<cmath::complex<F>, 42> value{
       cmath::complex<F>{-0.17177325725640386l, 1.2553728424472204l},
       cmath::complex<F>{-0.28952075420807055l, 1.16778269116148l},
@@ -1190,7 +954,7 @@ struct bessel_poles<F, 42> {
 };
 
 template <typename F>
-struct bessel_poles<F, 43> {
+struct bessel_pole_table<F, 43> {
   static constexpr cmath::vector<cmath::complex<F>, 43> value{
       cmath::complex<F>{-0.16924139165078197l, 1.2570126892182276l},
       cmath::complex<F>{-0.28542614657709814l, 1.1709261584125321l},
@@ -1239,7 +1003,7 @@ struct bessel_poles<F, 43> {
 };
 
 template <typename F>
-struct bessel_poles<F, 44> {
+struct bessel_pole_table<F, 44> {
   static constexpr cmath::vector<cmath::complex<F>, 44> value{
       cmath::complex<F>{-0.16680151692199152l, 1.2585892612935021l},
       cmath::complex<F>{-0.2814749086976235l, 1.1739451404880785l},
@@ -1289,7 +1053,7 @@ struct bessel_poles<F, 44> {
 };
 
 template <typename F>
-struct bessel_poles<F, 45> {
+struct bessel_pole_table<F, 45> {
   static constexpr cmath::vector<cmath::complex<F>, 45> value{
       cmath::complex<F>{-0.16444838080012356l, 1.2601063714945306l},
       cmath::complex<F>{-0.27765914158019844l, 1.1768472904013405l},
@@ -1340,7 +1104,7 @@ struct bessel_poles<F, 45> {
 };
 
 template <typename F>
-struct bessel_poles<F, 46> {
+struct bessel_pole_table<F, 46> {
   static constexpr cmath::vector<cmath::complex<F>, 46> value{
       cmath::complex<F>{-0.16217713553897403l, 1.2615675240870485l},
       cmath::complex<F>{-0.27397153338710156l, 1.1796396316113442l},
@@ -1392,7 +1156,7 @@ struct bessel_poles<F, 46> {
 };
 
 template <typename F>
-struct bessel_poles<F, 47> {
+struct bessel_pole_table<F, 47> {
   static constexpr cmath::vector<cmath::complex<F>, 47> value{
       cmath::complex<F>{-0.15998329902743308l, 1.26297594584349l},
       cmath::complex<F>{-0.2704053049812071l, 1.1823286222844438l},
@@ -1445,7 +1209,7 @@ struct bessel_poles<F, 47> {
 };
 
 template <typename F>
-struct bessel_poles<F, 48> {
+struct bessel_pole_table<F, 48> {
   static constexpr cmath::vector<cmath::complex<F>, 48> value{
       cmath::complex<F>{-0.15786272035290969l, 1.2643346133915971l},
       cmath::complex<F>{-0.2669541614828403l, 1.184920211780145l},
@@ -1499,7 +1263,7 @@ struct bessel_poles<F, 48> {
 };
 
 template <typename F>
-struct bessel_poles<F, 49> {
+struct bessel_pole_table<F, 49> {
   static constexpr cmath::vector<cmath::complex<F>, 49> value{
       cmath::complex<F>{-0.15581154922864485l, 1.2656462773604342l},
       cmath::complex<F>{-0.26361224907063946l, 1.18741989044292l},
@@ -1554,7 +1318,7 @@ struct bessel_poles<F, 49> {
 };
 
 template <typename F>
-struct bessel_poles<F, 50> {
+struct bessel_pole_table<F, 50> {
   static constexpr cmath::vector<cmath::complex<F>, 50> value{
       cmath::complex<F>{-0.1538262087844792l, 1.2669134837557618l},
       cmath::complex<F>{-0.26037411637189645l, 1.1898327336124412l},
@@ -1610,7 +1374,7 @@ struct bessel_poles<F, 50> {
 };
 
 template <typename F>
-struct bessel_poles<F, 51> {
+struct bessel_pole_table<F, 51> {
   static constexpr cmath::vector<cmath::complex<F>, 51> value{
       cmath::complex<F>{-0.1519033712937262l, 1.2681385929311322l},
       cmath::complex<F>{-0.25723467987986137l, 1.192163440624719l},
@@ -1667,7 +1431,7 @@ struct bessel_poles<F, 51> {
 };
 
 template <typename F>
-struct bessel_poles<F, 52> {
+struct bessel_pole_table<F, 52> {
   static constexpr cmath::vector<cmath::complex<F>, 52> value{
       cmath::complex<F>{-0.15003993647019506l, 1.2693237964664594l},
       cmath::complex<F>{-0.2541891929133072l, 1.194416369460479l},
@@ -1725,7 +1489,7 @@ struct bessel_poles<F, 52> {
 };
 
 template <typename F>
-struct bessel_poles<F, 53> {
+struct bessel_pole_table<F, 53> {
   static constexpr cmath::vector<cmath::complex<F>, 53> value{
       cmath::complex<F>{-0.14823301202080638l, 1.2704711322202387l},
       cmath::complex<F>{-0.25123321769939644l, 1.1965955676002094l},
@@ -1784,7 +1548,7 @@ struct bessel_poles<F, 53> {
 };
 
 template <typename F>
-struct bessel_poles<F, 54> {
+struct bessel_pole_table<F, 54> {
   static constexpr cmath::vector<cmath::complex<F>, 54> value{
       cmath::complex<F>{-0.1464798961828605l, 1.2715824977833918l},
       cmath::complex<F>{-0.24836260021684542l, 1.198704799564353l},
@@ -1844,7 +1608,7 @@ struct bessel_poles<F, 54> {
 };
 
 template <typename F>
-struct bessel_poles<F, 55> {
+struct bessel_pole_table<F, 55> {
   static constexpr cmath::vector<cmath::complex<F>, 55> value{
       cmath::complex<F>{-0.14477806201168725l, 1.27265966253066l},
       cmath::complex<F>{-0.2455734474840295l, 1.2007475715491003l},
@@ -1905,7 +1669,7 @@ struct bessel_poles<F, 55> {
 };
 
 template <typename F>
-struct bessel_poles<F, 56> {
+struct bessel_pole_table<F, 56> {
   static constexpr cmath::vector<cmath::complex<F>, 56> value{
       cmath::complex<F>{-0.14312514321576988l, 1.273704278438288l},
       cmath::complex<F>{-0.24286210701731314l, 1.2027271535109114l},
@@ -1967,7 +1731,7 @@ struct bessel_poles<F, 56> {
 };
 
 template <typename F>
-struct bessel_poles<F, 57> {
+struct bessel_pole_table<F, 57> {
   static constexpr cmath::vector<cmath::complex<F>, 57> value{
       cmath::complex<F>{-0.14151892136296818l, 1.2747178898138702l},
       cmath::complex<F>{-0.24022514821981955l, 1.204646599004497l},
@@ -2030,7 +1794,7 @@ struct bessel_poles<F, 57> {
 };
 
 template <typename F>
-struct bessel_poles<F, 58> {
+struct bessel_pole_table<F, 58> {
   static constexpr cmath::vector<cmath::complex<F>, 58> value{
       cmath::complex<F>{-0.13995731430420855l, 1.2757019420647562l},
       cmath::complex<F>{-0.2376593454907709l, 1.2065087630379339l},
@@ -2094,7 +1858,7 @@ struct bessel_poles<F, 58> {
 };
 
 template <typename F>
-struct bessel_poles<F, 59> {
+struct bessel_pole_table<F, 59> {
   static constexpr cmath::vector<cmath::complex<F>, 59> value{
       cmath::complex<F>{-0.1384383656805517l, 1.2766577896147755l},
       cmath::complex<F>{-0.23516166287132215l, 1.208316318173641l},
@@ -2159,7 +1923,7 @@ struct bessel_poles<F, 59> {
 };
 
 template <typename F>
-struct bessel_poles<F, 60> {
+struct bessel_pole_table<F, 60> {
   static constexpr cmath::vector<cmath::complex<F>, 60> value{
       cmath::complex<F>{-0.13696023539617477l, 1.2775867030649235l},
       cmath::complex<F>{-0.23272924006512707l, 1.2100717690741678l},
@@ -2225,7 +1989,7 @@ struct bessel_poles<F, 60> {
 };
 
 template <typename F>
-struct bessel_poles<F, 61> {
+struct bessel_pole_table<F, 61> {
   static constexpr cmath::vector<cmath::complex<F>, 61> value{
       cmath::complex<F>{-0.13552119095428594l, 1.2784898756815077l},
       cmath::complex<F>{-0.23035937969106995l, 1.2117774656662923l},
@@ -2292,7 +2056,7 @@ struct bessel_poles<F, 61> {
 };
 
 template <typename F>
-struct bessel_poles<F, 62> {
+struct bessel_pole_table<F, 62> {
   static constexpr cmath::vector<cmath::complex<F>, 62> value{
       cmath::complex<F>{-0.13411959956541755l, 1.2793684292847842l},
       cmath::complex<F>{-0.2280495356424083l, 1.2134356150750076l},
@@ -2360,7 +2124,7 @@ struct bessel_poles<F, 62> {
 };
 
 template <typename F>
-struct bessel_poles<F, 63> {
+struct bessel_pole_table<F, 63> {
   static constexpr cmath::vector<cmath::complex<F>, 63> value{
       cmath::complex<F>{-0.13275392094826358l, 1.280223419602211l},
       cmath::complex<F>{-0.22579730244105561l, 1.2150482924602495l},
@@ -2429,7 +2193,7 @@ struct bessel_poles<F, 63> {
 };
 
 template <typename F>
-struct bessel_poles<F, 64> {
+struct bessel_pole_table<F, 64> {
   static constexpr cmath::vector<cmath::complex<F>, 64> value{
       cmath::complex<F>{-0.13142270075263418l, 1.2810558411426196l},
       cmath::complex<F>{-0.22360040548840068l, 1.2166174508729535l},
@@ -2499,7 +2263,7 @@ struct bessel_poles<F, 64> {
 };
 
 template <typename F>
-struct bessel_poles<F, 65> {
+struct bessel_pole_table<F, 65> {
   static constexpr cmath::vector<cmath::complex<F>, 65> value{
       cmath::complex<F>{-0.13012456454217103l, 1.2818666316409497l},
       cmath::complex<F>{-0.22145669212516603l, 1.2181449302330543l},
@@ -2570,7 +2334,7 @@ struct bessel_poles<F, 65> {
 };
 
 template <typename F>
-struct bessel_poles<F, 66> {
+struct bessel_pole_table<F, 66> {
   static constexpr cmath::vector<cmath::complex<F>, 66> value{
       cmath::complex<F>{-0.12885821228159983l, 1.282656676117358l},
       cmath::complex<F>{-0.21936412342243436l, 1.2196324655198878l},
@@ -2642,7 +2406,7 @@ struct bessel_poles<F, 66> {
 };
 
 template <typename F>
-struct bessel_poles<F, 67> {
+struct bessel_pole_table<F, 67> {
   static constexpr cmath::vector<cmath::complex<F>, 67> value{
       cmath::complex<F>{-0.12762241327938956l, 1.2834268105894426l},
       cmath::complex<F>{-0.21732076663451824l, 1.221081694254918l},
@@ -2715,7 +2479,7 @@ struct bessel_poles<F, 67> {
 };
 
 template <typename F>
-struct bessel_poles<F, 68> {
+struct bessel_pole_table<F, 68> {
   static constexpr cmath::vector<cmath::complex<F>, 68> value{
       cmath::complex<F>{-0.12641600154223265l, 1.2841778254719192l},
       cmath::complex<F>{-0.2153247882517308l, 1.2224941633475317l},
@@ -2789,7 +2553,7 @@ struct bessel_poles<F, 68> {
 };
 
 template <typename F>
-struct bessel_poles<F, 69> {
+struct bessel_pole_table<F, 69> {
   static constexpr cmath::vector<cmath::complex<F>, 69> value{
       cmath::complex<F>{-0.1252378715023849l, 1.2849104686942516l},
       cmath::complex<F>{-0.21337444759776952l, 1.2238713353666506l},
@@ -2864,7 +2628,7 @@ struct bessel_poles<F, 69> {
 };
 
 template <typename F>
-struct bessel_poles<F, 70> {
+struct bessel_pole_table<F, 70> {
   static constexpr cmath::vector<cmath::complex<F>, 70> value{
       cmath::complex<F>{-0.1240869740831371l, 1.285625448563346l},
       cmath::complex<F>{-0.2114680909221503l, 1.2252145942939066l},
@@ -2940,7 +2704,7 @@ struct bessel_poles<F, 70> {
 };
 
 template <typename F>
-struct bessel_poles<F, 71> {
+struct bessel_pole_table<F, 71> {
   static constexpr cmath::vector<cmath::complex<F>, 71> value{
       cmath::complex<F>{-0.12296231307134332l, 1.2863234363954779l},
       cmath::complex<F>{-0.20960414594323643l, 1.2265252508079962l},
@@ -3017,7 +2781,7 @@ struct bessel_poles<F, 71> {
 };
 
 template <typename F>
-struct bessel_poles<F, 72> {
+struct bessel_pole_table<F, 72> {
   static constexpr cmath::vector<cmath::complex<F>, 72> value{
       cmath::complex<F>{-0.12186294176921468l, 1.287005068939014l},
       cmath::complex<F>{-0.20778111680198777l, 1.2278045471444665l},
@@ -3095,7 +2859,7 @@ struct bessel_poles<F, 72> {
 };
 
 template <typename F>
-struct bessel_poles<F, 73> {
+struct bessel_pole_table<F, 73> {
   static constexpr cmath::vector<cmath::complex<F>, 73> value{
       cmath::complex<F>{-0.12078795990035751l, 1.2876709506072288l},
       cmath::complex<F>{-0.20599757939051955l, 1.229053661570434l},
@@ -3174,7 +2938,7 @@ struct bessel_poles<F, 73> {
 };
 
 template <typename F>
-struct bessel_poles<F, 74> {
+struct bessel_pole_table<F, 74> {
   static constexpr cmath::vector<cmath::complex<F>, 74> value{
       cmath::complex<F>{-0.11973651074766051l, 1.2883216555384573l},
       cmath::complex<F>{-0.20425217702313375l, 1.2302737125095935l},
@@ -3254,7 +3018,7 @@ struct bessel_poles<F, 74> {
 };
 
 template <typename F>
-struct bessel_poles<F, 75> {
+struct bessel_pole_table<F, 75> {
   static constexpr cmath::vector<cmath::complex<F>, 75> value{
       cmath::complex<F>{-0.11870777850284626l, 1.288957729499099l},
       cmath::complex<F>{-0.20254361642064272l, 1.231465762349187l},
@@ -3335,7 +3099,7 @@ struct bessel_poles<F, 75> {
 };
 
 template <typename F>
-struct bessel_poles<F, 76> {
+struct bessel_pole_table<F, 76> {
   static constexpr cmath::vector<cmath::complex<F>, 76> value{
       cmath::complex<F>{-0.11770098580948715l, 1.289579691643369l},
       cmath::complex<F>{-0.20087066398167203l, 1.2326308209573564l},
@@ -3417,7 +3181,7 @@ struct bessel_poles<F, 76> {
 };
 
 template <typename F>
-struct bessel_poles<F, 77> {
+struct bessel_pole_table<F, 77> {
   static constexpr cmath::vector<cmath::complex<F>, 77> value{
       cmath::complex<F>{-0.11671539148306603l, 1.2901880361423075l},
       cmath::complex<F>{-0.1992321423170708l, 1.2337698489364042l},
@@ -3500,7 +3264,7 @@ struct bessel_poles<F, 77> {
 };
 
 template <typename F>
-struct bessel_poles<F, 78> {
+struct bessel_pole_table<F, 78> {
   static constexpr cmath::vector<cmath::complex<F>, 78> value{
       cmath::complex<F>{-0.1157502883932797l, 1.2907832336933402l},
       cmath::complex<F>{-0.19762692702587703l, 1.2348837606349872l},
@@ -3584,7 +3348,7 @@ struct bessel_poles<F, 78> {
 };
 
 template <typename F>
-struct bessel_poles<F, 79> {
+struct bessel_pole_table<F, 79> {
   static constexpr cmath::vector<cmath::complex<F>, 79> value{
       cmath::complex<F>{-0.11480500149514465l, 1.2913657329205281l},
       cmath::complex<F>{-0.1960539436932385l, 1.2359734269399136l},
@@ -3669,7 +3433,7 @@ struct bessel_poles<F, 79> {
 };
 
 template <typename F>
-struct bessel_poles<F, 80> {
+struct bessel_pole_table<F, 80> {
   static constexpr cmath::vector<cmath::complex<F>, 80> value{
       cmath::complex<F>{-0.11387888599670797l, 1.291935961674746l},
       cmath::complex<F>{-0.19451216509255187l, 1.2370396778663009l},
@@ -3755,7 +3519,7 @@ struct bessel_poles<F, 80> {
 };
 
 template <typename F>
-struct bessel_poles<F, 81> {
+struct bessel_pole_table<F, 81> {
   static constexpr cmath::vector<cmath::complex<F>, 81> value{
       cmath::complex<F>{-0.11297132565246291l, 1.29249432824203l},
       cmath::complex<F>{-0.1930006085756338l, 1.2380833049629318l},
@@ -3842,7 +3606,7 @@ struct bessel_poles<F, 81> {
 };
 
 template <typename F>
-struct bessel_poles<F, 82> {
+struct bessel_pole_table<F, 82> {
   static constexpr cmath::vector<cmath::complex<F>, 82> value{
       cmath::complex<F>{-0.11208173117226786l, 1.2930412224676946l},
       cmath::complex<F>{-0.1915183336362569l, 1.2391050635481615l},
@@ -3930,7 +3694,7 @@ struct bessel_poles<F, 82> {
 };
 
 template <typename F>
-struct bessel_poles<F, 83> {
+struct bessel_pole_table<F, 83> {
   static constexpr cmath::vector<cmath::complex<F>, 83> value{
       cmath::complex<F>{-0.11120953873681776l, 1.293577016802991l},
       cmath::complex<F>{-0.19006443963361885l, 1.2401056747901924l},
@@ -4019,7 +3783,7 @@ struct bessel_poles<F, 83> {
 };
 
 template <typename F>
-struct bessel_poles<F, 84> {
+struct bessel_pole_table<F, 84> {
   static constexpr cmath::vector<cmath::complex<F>, 84> value{
       cmath::complex<F>{-0.11035420861131205l, 1.294102067280532l},
       cmath::complex<F>{-0.1886380636635588l, 1.241085827644299l},
@@ -4109,7 +3873,7 @@ struct bessel_poles<F, 84> {
 };
 
 template <typename F>
-struct bessel_poles<F, 85> {
+struct bessel_pole_table<F, 85> {
   static constexpr cmath::vector<cmath::complex<F>, 85> value{
       cmath::complex<F>{-0.10951522384972344l, 1.2946167144241116l},
       cmath::complex<F>{-0.18723837856634704l, 1.2420461806584318l},
@@ -4200,7 +3964,7 @@ struct bessel_poles<F, 85> {
 };
 
 template <typename F>
-struct bessel_poles<F, 86> {
+struct bessel_pole_table<F, 86> {
   static constexpr cmath::vector<cmath::complex<F>, 86> value{
       cmath::complex<F>{-0.10869208908286235l, 1.295121284098048l},
       cmath::complex<F>{-0.1858645910608703l, 1.2429873636575712l},
@@ -4292,7 +4056,7 @@ struct bessel_poles<F, 86> {
 };
 
 template <typename F>
-struct bessel_poles<F, 87> {
+struct bessel_pole_table<F, 87> {
   static constexpr cmath::vector<cmath::complex<F>, 87> value{
       cmath::complex<F>{-0.10788432938385828l, 1.2956160883007204l},
       cmath::complex<F>{-0.18451593999583343l, 1.243909979316296l},
@@ -4385,7 +4149,7 @@ struct bessel_poles<F, 87> {
 };
 
 template <typename F>
-struct bessel_poles<F, 88> {
+struct bessel_pole_table<F, 88> {
   static constexpr cmath::vector<cmath::complex<F>, 88> value{
       cmath::complex<F>{-0.10709148920531619l, 1.296101425906569l},
       cmath::complex<F>{-0.1831916947095009l, 1.2448146046281692l},
@@ -4479,7 +4243,7 @@ struct bessel_poles<F, 88> {
 };
 
 template <typename F>
-struct bessel_poles<F, 89> {
+struct bessel_pole_table<F, 89> {
   static constexpr cmath::vector<cmath::complex<F>, 89> value{
       cmath::complex<F>{-0.10631313138290914l, 1.296577583360435l},
       cmath::complex<F>{-0.18189115349007368l, 1.245701792279819l},
@@ -4574,7 +4338,7 @@ struct bessel_poles<F, 89> {
 };
 
 template <typename F>
-struct bessel_poles<F, 90> {
+struct bessel_pole_table<F, 90> {
   static constexpr cmath::vector<cmath::complex<F>, 90> value{
       cmath::complex<F>{-0.10554883620053249l, 1.2970448353278272l},
       cmath::complex<F>{-0.18061364212954997l, 1.2465720719368933l},
@@ -4670,7 +4434,7 @@ struct bessel_poles<F, 90> {
 };
 
 template <typename F>
-struct bessel_poles<F, 91> {
+struct bessel_pole_table<F, 91> {
   static constexpr cmath::vector<cmath::complex<F>, 91> value{
       cmath::complex<F>{-0.10479820051261604l, 1.2975034453043357l},
       cmath::complex<F>{-0.1793585125644381l, 1.2474259514484403l},
@@ -4767,7 +4531,7 @@ struct bessel_poles<F, 91> {
 };
 
 template <typename F>
-struct bessel_poles<F, 92> {
+struct bessel_pole_table<F, 92> {
   static constexpr cmath::vector<cmath::complex<F>, 92> value{
       cmath::complex<F>{-0.10406083691950756l, 1.29795366618721l},
       cmath::complex<F>{-0.17812514159726242l, 1.2482639179757529l},
@@ -4865,7 +4629,7 @@ struct bessel_poles<F, 92> {
 };
 
 template <typename F>
-struct bessel_poles<F, 93> {
+struct bessel_pole_table<F, 93> {
   static constexpr cmath::vector<cmath::complex<F>, 93> value{
       cmath::complex<F>{-0.10333637299220559l, 1.298395740811804l},
       cmath::complex<F>{-0.17691292969325717l, 1.249086439051162l},
@@ -4964,7 +4728,7 @@ struct bessel_poles<F, 93> {
 };
 
 template <typename F>
-struct bessel_poles<F, 94> {
+struct bessel_pole_table<F, 94> {
   static constexpr cmath::vector<cmath::complex<F>, 94> value{
       cmath::complex<F>{-0.10262445054298368l, 1.29882990245543l},
       cmath::complex<F>{-0.2331969826333843l, 1.2084597736671572l},
@@ -5064,7 +4828,7 @@ struct bessel_poles<F, 94> {
 };
 
 template <typename F>
-struct bessel_poles<F, 95> {
+struct bessel_pole_table<F, 95> {
   static constexpr cmath::vector<cmath::complex<F>, 95> value{
       cmath::complex<F>{-0.10192472493876321l, 1.2992563753109014l},
       cmath::complex<F>{-0.23167224342507817l, 1.2095719172104604l},
@@ -5165,7 +4929,7 @@ struct bessel_poles<F, 95> {
 };
 
 template <typename F>
-struct bessel_poles<F, 96> {
+struct bessel_pole_table<F, 96> {
   static constexpr cmath::vector<cmath::complex<F>, 96> value{
       cmath::complex<F>{-0.10123686445428852l, 1.299675374931902l},
       cmath::complex<F>{-0.23017243344176982l, 1.2106639799715102l},
@@ -5267,7 +5031,7 @@ struct bessel_poles<F, 96> {
 };
 
 template <typename F>
-struct bessel_poles<F, 97> {
+struct bessel_pole_table<F, 97> {
   static constexpr cmath::vector<cmath::complex<F>, 97> value{
       cmath::complex<F>{-0.1005605496624501l, 1.3000871086521206l},
       cmath::complex<F>{-0.22869690418162647l, 1.21173653253195l},
@@ -5370,7 +5134,7 @@ struct bessel_poles<F, 97> {
 };
 
 template <typename F>
-struct bessel_poles<F, 98> {
+struct bessel_pole_table<F, 98> {
   static constexpr cmath::vector<cmath::complex<F>, 98> value{
       cmath::complex<F>{-0.09989547285922697l, 1.3004917759799621l},
       cmath::complex<F>{-0.2272450301620587l, 1.2127901235001528l},
@@ -5474,7 +5238,7 @@ struct bessel_poles<F, 98> {
 };
 
 template <typename F>
-struct bessel_poles<F, 99> {
+struct bessel_pole_table<F, 99> {
   static constexpr cmath::vector<cmath::complex<F>, 99> value{
       cmath::complex<F>{-0.09924133752100169l, 1.3008895689704847l},
       cmath::complex<F>{-0.2258162078887399l, 1.213825280574056l},
@@ -5579,7 +5343,7 @@ struct bessel_poles<F, 99> {
 };
 
 template <typename F>
-struct bessel_poles<F, 100> {
+struct bessel_pole_table<F, 100> {
   static constexpr cmath::vector<cmath::complex<F>, 100> value{
       cmath::complex<F>{-0.09859785779209441l, 1.3012806725760844l},
       cmath::complex<F>{-0.2244098548801938l, 1.214842511542333l},
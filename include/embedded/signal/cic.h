@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+#include "../utility/integer_sequence.h"
+#include "detail/cic.h"
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace signal {
+
+namespace detail {
+
+template <typename T, std::size_t Order, std::size_t Rate, std::size_t Delay,
+          std::size_t Div>
+class cic_base {
+ protected:
+  using traits = cic_traits<T, Order, Rate, Delay, Div>;
+  using unsigned_type = typename traits::unsigned_type;
+
+ public:
+  using value_type = T;
+  using output_type = typename traits::value_type;
+
+  static constexpr std::size_t order() noexcept { return Order; }
+  static constexpr std::size_t rate() noexcept { return Rate; }
+  static constexpr std::size_t delay() noexcept { return Delay; }
+
+  /**
+   * DC gain of the filter
+   */
+  static constexpr cic_gain_type gain() noexcept { return traits::gain; }
+
+  /**
+   * Number of bits the output is wider than the input
+   */
+  static constexpr unsigned bit_growth() noexcept {
+    return traits::bit_growth;
+  }
+
+  /**
+   * Number of significant bits of `output_type`
+   */
+  static constexpr unsigned output_bits() noexcept {
+    return traits::output_bits;
+  }
+
+  void reset() {
+    std::fill(&integrator_[0], &integrator_[0] + Order, unsigned_type{0});
+    std::fill(&comb_[0][0], &comb_[0][0] + Order * Delay, unsigned_type{0});
+    pos_ = 0;
+  }
+
+ protected:
+  static auto to_unsigned(T x) -> unsigned_type {
+    return static_cast<unsigned_type>(x);
+  }
+
+  static void emit(output_type*& out, unsigned_type x) {
+    *out++ = static_cast<output_type>(x);
+  }
+
+  // normalized to unity DC gain
+  template <typename F>
+  static void emit(F*& out, unsigned_type x) {
+    *out++ = static_cast<F>(static_cast<output_type>(x)) *
+             (F{1} / static_cast<F>(gain()));
+  }
+
+  // One step of the integrator cascade, returns the last integrator. The
+  // stages are expanded, so the state can be kept in registers.
+  static auto integrate(unsigned_type (&s)[Order], unsigned_type x)
+      -> unsigned_type {
+    return integrate(s, x, make_index_sequence<Order>{});
+  }
+
+  // One step of the comb cascade, each stage `x[n] - x[n - Delay]`.
+  auto comb(unsigned_type x) -> unsigned_type {
+    for (std::size_t k = 0; k < Order; ++k) {
+      auto const y = x - comb_[k][pos_];
+      comb_[k][pos_] = x;
+      x = y;
+    }
+    if (++pos_ == Delay) {
+      pos_ = 0;
+    }
+    return x;
+  }
+
+  template <std::size_t... Ks>
+  static auto integrate(unsigned_type (&s)[Order], unsigned_type x,
+                        index_sequence<Ks...>) -> unsigned_type {
+    using expand = int[];
+    static_cast<void>(expand{0, (x = s[Ks] += x, 0)...});
+    return x;
+  }
+
+  unsigned_type integrator_[Order]{};
+  unsigned_type comb_[Order][Delay]{};
+  std::size_t pos_{0};
+};
+
+} // namespace detail
+
+/**
+ * Cascaded integrator-comb (CIC) decimator
+ *
+ * Decimates integral samples of type `T` by `Rate` using `Order`
+ * integrators at the input rate followed by `Order` combs with a
+ * differential delay of `Delay` at the output rate. This is equivalent
+ * to `Order` moving sums over `Rate * Delay` samples, but only needs
+ * additions and subtractions, which makes it suitable for the high
+ * decimation factors of PDM microphones or sigma-delta ADCs.
+ *
+ * The bit growth is computed at compile time and `output_type` is the
+ * smallest of `int32_t` and `int64_t` that can hold the full precision
+ * result. The integrators are allowed to wrap around.
+ *
+ * The outputs can be passed on in full precision, or as floating point
+ * values normalized to unity DC gain, e.g. to feed an `sos_instance`
+ * running at the output rate. The passband droop can be corrected with
+ * `firfilter::cic_compensator()`.
+ *
+ *     signal::cic_decimator<std::int16_t, 4, 32> cic;
+ *     float tmp[cic.max_output(256)];
+ *
+ *     auto n = cic.process(pdm_block, tmp, 256);
+ *     filter.process(tmp, n);
+ */
+template <typename T, std::size_t Order, std::size_t Rate,
+          std::size_t Delay = 1>
+class cic_decimator : public detail::cic_base<T, Order, Rate, Delay, 1> {
+  using base = detail::cic_base<T, Order, Rate, Delay, 1>;
+  using typename base::unsigned_type;
+
+ public:
+  using typename base::output_type;
+  using typename base::value_type;
+
+  /**
+   * Upper bound of the number of outputs for `n` input samples
+   */
+  static constexpr std::size_t max_output(std::size_t n) noexcept {
+    return (n + Rate - 1) / Rate;
+  }
+
+  /**
+   * Decimate `n` input samples
+   *
+   * \returns Number of output samples.
+   */
+  std::size_t process(value_type const* in, output_type* out, std::size_t n) {
+    return run(in, out, n);
+  }
+
+  template <typename F>
+  auto process(value_type const* in, F* out, std::size_t n) ->
+      typename std::enable_if<std::is_floating_point<F>::value,
+                              std::size_t>::type {
+    return run(in, out, n);
+  }
+
+  void reset() {
+    base::reset();
+    phase_ = 0;
+  }
+
+ private:
+  template <typename Out>
+  std::size_t run(value_type const* in, Out* out, std::size_t n) {
+    auto const first = out;
+    while (n > 0) {
+      std::size_t const count = std::min(n, Rate - phase_);
+      integrate(in, count);
+      in += count;
+      n -= count;
+      phase_ += count;
+      if (phase_ == Rate) {
+        base::emit(out, this->comb(this->integrator_[Order - 1]));
+        phase_ = 0;
+      }
+    }
+    return static_cast<std::size_t>(out - first);
+  }
+
+  // The integrator state is kept in locals, so it can stay in registers.
+  void integrate(value_type const* in, std::size_t count) {
+    unsigned_type s[Order];
+    std::copy(this->integrator_, this->integrator_ + Order, s);
+    for (std::size_t i = 0; i < count; ++i) {
+      base::integrate(s, base::to_unsigned(in[i]));
+    }
+    std::copy(s, s + Order, this->integrator_);
+  }
+
+  std::size_t phase_{0};
+};
+
+/**
+ * Cascaded integrator-comb (CIC) interpolator
+ *
+ * Interpolates integral samples of type `T` by `Rate`, running `Order`
+ * combs at the input rate and `Order` integrators at the output rate.
+ * Each input sample produces `Rate` output samples. The DC gain is
+ * `(Rate * Delay)^Order / Rate`.
+ */
+template <typename T, std::size_t Order, std::size_t Rate,
+          std::size_t Delay = 1>
+class cic_interpolator : public detail::cic_base<T, Order, Rate, Delay, Rate> {
+  using base = detail::cic_base<T, Order, Rate, Delay, Rate>;
+  using typename base::unsigned_type;
+
+ public:
+  using typename base::output_type;
+  using typename base::value_type;
+
+  /**
+   * Number of outputs for `n` input samples
+   */
+  static constexpr std::size_t max_output(std::size_t n) noexcept {
+    return n * Rate;
+  }
+
+  /**
+   * Interpolate `n` input samples
+   *
+   * \returns Number of output samples, always `n * Rate`.
+   */
+  std::size_t process(value_type const* in, output_type* out, std::size_t n) {
+    return run(in, out, n);
+  }
+
+  template <typename F>
+  auto process(value_type const* in, F* out, std::size_t n) ->
+      typename std::enable_if<std::is_floating_point<F>::value,
+                              std::size_t>::type {
+    return run(in, out, n);
+  }
+
+ private:
+  template <typename Out>
+  std::size_t run(value_type const* in, Out* out, std::size_t n) {
+    unsigned_type s[Order];
+    std::copy(this->integrator_, this->integrator_ + Order, s);
+    for (std::size_t i = 0; i < n; ++i) {
+      auto const x = this->comb(base::to_unsigned(in[i]));
+      base::emit(out, base::integrate(s, x));
+      for (std::size_t r = 1; r < Rate; ++r) {
+        base::emit(out, base::integrate(s, unsigned_type{0}));
+      }
+    }
+    std::copy(s, s + Order, this->integrator_);
+    return n * Rate;
+  }
+};
+
+} // namespace signal
+} // namespace embedded
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
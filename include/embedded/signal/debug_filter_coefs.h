@@ -39,3 +39,19 @@
 #define LIBEMB_DEBUG_FILTER_COEFS(design)                                      \
   LIBEMB_DEBUG_FILTER_COEFS_NAME(                                              \
       design, #design " (" __FILE__ ":" LIBEMB_STRINGIFY(__LINE__) ")")
+
+// Debug record for a design placed with `LIBEMB_FILTER_DESIGN`, which
+// only points at the design's coefficients instead of copying them. The
+// pointer is only resolved by the linker, so parse-filter-coefs.py needs
+// a linked ELF file to decode these records.
+#define LIBEMB_DEBUG_FILTER_COEFS_REF_NAME(design, name)                       \
+  extern "C" ::embedded::signal::detail::filter_design_debug_ref<              \
+      std::decay<decltype(design)>::type> const                                \
+      __attribute__((section(LIBEMB_DEBUG_FILTER_COEFS_SECTION)))              \
+      LIBEMB_UNIQUE_NAME(design) {                                             \
+    design, name                                                               \
+  }
+
+#define LIBEMB_DEBUG_FILTER_COEFS_REF(design)                                  \
+  LIBEMB_DEBUG_FILTER_COEFS_REF_NAME(                                          \
+      design, #design " (" __FILE__ ":" LIBEMB_STRINGIFY(__LINE__) ")")
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "sos.h"
+
+#if defined(__SSE__) || defined(_M_X64) ||                                     \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define LIBEMB_DENORMAL_GUARD_SSE
+#elif defined(__GNUC__) && defined(__aarch64__)
+#define LIBEMB_DENORMAL_GUARD_FPCR
+#elif defined(__GNUC__) && defined(__arm__) && defined(__ARM_FP)
+#define LIBEMB_DENORMAL_GUARD_FPSCR
+#endif
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace signal {
+
+template <typename State, typename F>
+struct sos_denormal_safe_state : State {
+  F offset{cmath::sqrt(std::numeric_limits<F>::min())};
+  F next{cmath::sqrt(std::numeric_limits<F>::min())};
+};
+
+template <typename State, typename F>
+struct sos_state_peak<sos_denormal_safe_state<State, F>>
+    : sos_state_peak<State> {};
+
+/**
+ * Section that keeps its state out of the subnormal range
+ *
+ * When the input of a floating point IIR filter goes silent, the state
+ * decays towards zero and eventually becomes subnormal, which is very
+ * slow on many FPUs. This section adds a tiny offset to each input
+ * sample, so the state settles at a small normal value instead. The
+ * offset is sqrt(min()), about 1e-19 for `float`, which is far below the
+ * rounding error of any normal signal.
+ *
+ * The sign of the offset follows + + - -, i.e. a tone at a quarter of the
+ * sample rate. A constant or simply alternating offset would be cancelled
+ * exactly by the zeros at DC or Nyquist of highpass or lowpass sections,
+ * leaving a direct form I output state to decay as before.
+ */
+template <typename F, typename Section>
+class sos_denormal_safe_section : public Section {
+ public:
+  static_assert(std::is_floating_point<F>::value,
+                "denormal protection is only needed for floating point");
+
+  using value_type = F;
+  using state_type =
+      sos_denormal_safe_state<typename Section::state_type, value_type>;
+
+  using Section::Section;
+
+  value_type filter(state_type& state, value_type x) const {
+    value_type const offset = state.offset;
+    state.offset = state.next;
+    state.next = -offset;
+    return Section::filter(state, x + offset);
+  }
+
+  void filter(state_type& state, value_type const* in, value_type* out,
+              std::size_t n) const {
+    value_type offset = state.offset;
+    value_type next = state.next;
+    for (std::size_t i = 0; i < n; ++i) {
+      value_type const o = offset;
+      offset = next;
+      next = -o;
+      out[i] = Section::filter(state, in[i] + o);
+    }
+    state.offset = offset;
+    state.next = next;
+  }
+};
+
+namespace sos_structure {
+
+/**
+ * Denormal protection for any floating point structure `Base`
+ *
+ *   design.sos<float, sos_structure::denormal_safe<>>()
+ */
+template <typename Base = df2t>
+struct denormal_safe {
+  template <typename F>
+  using section =
+      sos_denormal_safe_section<F, typename Base::template section<F>>;
+};
+
+} // namespace sos_structure
+
+/**
+ * Flush subnormals to zero for the lifetime of this object
+ *
+ * Sets the flush-to-zero (and on x86 also the denormals-are-zero) mode of
+ * the FPU and restores the previous mode on destruction. This works for
+ * any code, including `poly_design`, but only affects the current thread
+ * and is a no-op where `supported` is false. Supported are x86 with SSE,
+ * AArch64, and 32-bit ARM with a VFP unit (e.g. Cortex-A and Cortex-M4F
+ * or M7) when compiling with GCC or Clang.
+ */
+class denormal_guard {
+ public:
+#if defined(LIBEMB_DENORMAL_GUARD_SSE)
+  static constexpr bool supported = true;
+
+  denormal_guard() noexcept
+      : saved_{_mm_getcsr()} {
+    _mm_setcsr(saved_ | 0x8040); // FTZ | DAZ
+  }
+
+  ~denormal_guard() { _mm_setcsr(saved_); }
+
+ private:
+  unsigned int const saved_;
+#elif defined(LIBEMB_DENORMAL_GUARD_FPCR)
+  static constexpr bool supported = true;
+
+  denormal_guard() noexcept
+      : saved_{get()} {
+    set(saved_ | (std::uint64_t{1} << 24)); // FZ
+  }
+
+  ~denormal_guard() { set(saved_); }
+
+ private:
+  static std::uint64_t get() noexcept {
+    std::uint64_t fpcr;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+    return fpcr;
+  }
+
+  static void set(std::uint64_t fpcr) noexcept {
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr));
+  }
+
+  std::uint64_t const saved_;
+#elif defined(LIBEMB_DENORMAL_GUARD_FPSCR)
+  static constexpr bool supported = true;
+
+  denormal_guard() noexcept
+      : saved_{get()} {
+    set(saved_ | (std::uint32_t{1} << 24)); // FZ
+  }
+
+  ~denormal_guard() { set(saved_); }
+
+ private:
+  static std::uint32_t get() noexcept {
+    std::uint32_t fpscr;
+    __asm__ __volatile__("vmrs %0, fpscr" : "=r"(fpscr));
+    return fpscr;
+  }
+
+  static void set(std::uint32_t fpscr) noexcept {
+    __asm__ __volatile__("vmsr fpscr, %0" : : "r"(fpscr));
+  }
+
+  std::uint32_t const saved_;
+#else
+  static constexpr bool supported = false;
+
+  denormal_guard() noexcept = default;
+#endif
+
+ public:
+  denormal_guard(denormal_guard const&) = delete;
+  denormal_guard& operator=(denormal_guard const&) = delete;
+};
+
+} // namespace signal
+} // namespace embedded
+
+#undef LIBEMB_DENORMAL_GUARD_SSE
+#undef LIBEMB_DENORMAL_GUARD_FPCR
+#undef LIBEMB_DENORMAL_GUARD_FPSCR
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
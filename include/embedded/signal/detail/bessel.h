@@ -0,0 +1,417 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+#include "../../constexpr_math.h"
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace signal {
+namespace detail {
+
+// Double-double arithmetic (Dekker, 1971), only used to evaluate the
+// Bessel polynomials, whose roots are too ill-conditioned for plain
+// floating point at moderate orders already.
+template <typename T>
+struct ddouble {
+  T hi, lo;
+};
+
+template <typename T>
+constexpr auto dd_pow2(int e) noexcept -> T {
+  return e == 0 ? T{1} : T{2} * dd_pow2<T>(e - 1);
+}
+
+template <typename T>
+struct dd_constants {
+  static constexpr T splitter{
+      dd_pow2<T>((std::numeric_limits<T>::digits + 1) / 2) + T{1}};
+};
+
+template <typename T>
+constexpr auto dd_split(T a, T hi) noexcept -> ddouble<T> {
+  return ddouble<T>{hi, a - hi};
+}
+
+template <typename T>
+constexpr auto dd_split(T a, T c, int) noexcept -> ddouble<T> {
+  return dd_split(a, c - (c - a));
+}
+
+template <typename T>
+constexpr auto dd_split(T a) noexcept -> ddouble<T> {
+  return dd_split(a, dd_constants<T>::splitter * a, 0);
+}
+
+template <typename T>
+constexpr auto fast_two_sum(T a, T b) noexcept -> ddouble<T> {
+  return ddouble<T>{a + b, b - ((a + b) - a)};
+}
+
+template <typename T>
+constexpr auto two_sum(T a, T b, T x, T z) noexcept -> ddouble<T> {
+  return ddouble<T>{x, (a - (x - z)) + (b - z)};
+}
+
+template <typename T>
+constexpr auto two_sum(T a, T b) noexcept -> ddouble<T> {
+  return two_sum(a, b, a + b, (a + b) - a);
+}
+
+template <typename T>
+constexpr auto two_prod(T x, ddouble<T> const& a,
+                        ddouble<T> const& b) noexcept -> ddouble<T> {
+  return ddouble<T>{x, a.lo * b.lo - (((x - a.hi * b.hi) - a.lo * b.hi) -
+                                      a.hi * b.lo)};
+}
+
+template <typename T>
+constexpr auto two_prod(T a, T b) noexcept -> ddouble<T> {
+  return two_prod(a * b, dd_split(a), dd_split(b));
+}
+
+template <typename T>
+constexpr auto dd_add(ddouble<T> const& s, T e) noexcept -> ddouble<T> {
+  return fast_two_sum(s.hi, s.lo + e);
+}
+
+template <typename T>
+constexpr auto
+operator+(ddouble<T> const& a, ddouble<T> const& b) noexcept -> ddouble<T> {
+  return dd_add(two_sum(a.hi, b.hi), a.lo + b.lo);
+}
+
+template <typename T>
+constexpr auto operator-(ddouble<T> const& a) noexcept -> ddouble<T> {
+  return ddouble<T>{-a.hi, -a.lo};
+}
+
+template <typename T>
+constexpr auto
+operator*(ddouble<T> const& a, ddouble<T> const& b) noexcept -> ddouble<T> {
+  return dd_add(two_prod(a.hi, b.hi), a.hi * b.lo + a.lo * b.hi);
+}
+
+template <typename T>
+struct ddcomplex {
+  ddouble<T> re, im;
+
+  constexpr auto value() const noexcept -> cmath::complex<T> {
+    return cmath::complex<T>(re.hi + re.lo, im.hi + im.lo);
+  }
+};
+
+template <typename T>
+constexpr auto dd_complex(cmath::complex<T> const& z) noexcept
+    -> ddcomplex<T> {
+  return ddcomplex<T>{ddouble<T>{z.real(), T{0}}, ddouble<T>{z.imag(), T{0}}};
+}
+
+template <typename T>
+constexpr auto
+operator+(ddcomplex<T> const& a, ddcomplex<T> const& b) noexcept
+    -> ddcomplex<T> {
+  return ddcomplex<T>{a.re + b.re, a.im + b.im};
+}
+
+template <typename T>
+constexpr auto
+operator*(ddcomplex<T> const& a, ddcomplex<T> const& b) noexcept
+    -> ddcomplex<T> {
+  return ddcomplex<T>{a.re * b.re + -(a.im * b.im),
+                      a.re * b.im + a.im * b.re};
+}
+
+template <typename T>
+constexpr auto operator*(T k, ddcomplex<T> const& a) noexcept
+    -> ddcomplex<T> {
+  return ddcomplex<T>{ddouble<T>{k, T{0}} * a.re, ddouble<T>{k, T{0}} * a.im};
+}
+
+// Reverse Bessel polynomial and its derivative, evaluated in double-double
+// precision using
+//
+//   theta_m(s) = (2m - 1) theta_{m-1}(s) + s^2 theta_{m-2}(s)
+//
+// which is much better conditioned than the monomial coefficients.
+template <typename T>
+class bessel_theta {
+ public:
+  using complex_type = cmath::complex<T>;
+
+  constexpr bessel_theta(complex_type const& s) noexcept
+      : bessel_theta(dd_complex(s)) {}
+
+  // theta_n(s) / theta_n'(s)
+  constexpr auto newton(std::size_t n) const noexcept -> complex_type {
+    return m_ > n ? t1_.value() / d1_.value() : step().newton(n);
+  }
+
+ private:
+  constexpr bessel_theta(ddcomplex<T> const& s) noexcept
+      : bessel_theta(s * s, T{2} * s, dd_complex(complex_type(T{1})),
+                     s + dd_complex(complex_type(T{1})),
+                     dd_complex(complex_type()),
+                     dd_complex(complex_type(T{1})), 2) {}
+
+  constexpr bessel_theta(ddcomplex<T> const& s2, ddcomplex<T> const& s2x,
+                         ddcomplex<T> const& t0, ddcomplex<T> const& t1,
+                         ddcomplex<T> const& d0, ddcomplex<T> const& d1,
+                         std::size_t m) noexcept
+      : s2_{s2}
+      , s2x_{s2x}
+      , t0_{t0}
+      , t1_{t1}
+      , d0_{d0}
+      , d1_{d1}
+      , m_{m} {}
+
+  constexpr auto step() const noexcept -> bessel_theta {
+    return bessel_theta(s2_, s2x_, t1_, coef() * t1_ + s2_ * t0_, d1_,
+                        coef() * d1_ + s2x_ * t0_ + s2_ * d0_, m_ + 1);
+  }
+
+  constexpr auto coef() const noexcept -> T {
+    return static_cast<T>(2 * m_ - 1);
+  }
+
+  ddcomplex<T> s2_, s2x_, t0_, t1_, d0_, d1_;
+  std::size_t m_;
+};
+
+// Initial guesses for the roots of the Bessel polynomial y_n, after
+// Campos and Calderon (2011). Only the first (n + 1) / 2 of them are
+// needed, they are all in the lower half plane, with the real root
+// last for odd n.
+template <typename T, std::size_t N>
+class bessel_initial_roots {
+ public:
+  constexpr auto operator()(std::size_t i) const noexcept
+      -> cmath::complex<T> {
+    return N == 1 ? cmath::complex<T>(T{-1})
+                  : T{1} / guess(static_cast<T>(i + 1),
+                                 N % 2 == 1 && i == N / 2);
+  }
+
+ private:
+  static constexpr auto n() noexcept -> T { return static_cast<T>(N); }
+
+  static constexpr auto guess(T k, bool real) noexcept -> cmath::complex<T> {
+    return cmath::complex<T>(k * (a1() + a2() * k),
+                             real ? T{0}
+                                  : b0() + k * (b1() + k * (b2() + k * b3())));
+  }
+
+  static constexpr auto s() noexcept -> T {
+    return n() * n() * (T{2} + n() * n() * (n() - T{3}));
+  }
+
+  static constexpr auto r() noexcept -> T { return n() * n() * (T{2} + n()); }
+
+  static constexpr auto a1() noexcept -> T {
+    return (-T{6} - T{6} * n()) / r();
+  }
+
+  static constexpr auto a2() noexcept -> T { return T{6} / r(); }
+
+  static constexpr auto b0() noexcept -> T {
+    return n() * (-T{6} + n() * n() * (T{5} - n())) / s();
+  }
+
+  static constexpr auto b1() noexcept -> T {
+    return (T{8} + n() * (T{24} + n() * (-T{12} - T{2} * n()))) / s();
+  }
+
+  static constexpr auto b2() noexcept -> T {
+    return (-T{24} + n() * (-T{12} + T{12} * n())) / s();
+  }
+
+  static constexpr auto b3() noexcept -> T {
+    return (T{16} - T{8} * n()) / s();
+  }
+};
+
+// One Aberth-Ehrlich step for the roots of theta_n. Only one root of each
+// conjugate pair is iterated, the other one is accounted for as
+// conj(z_j), which keeps the result exactly symmetric. For odd n, the last
+// root is real and stays real.
+template <typename T, std::size_t N>
+class bessel_aberth_step {
+ public:
+  static constexpr std::size_t count{(N + 1) / 2};
+  using roots_type = cmath::vector<cmath::complex<T>, count>;
+
+  constexpr bessel_aberth_step(roots_type const& z) noexcept
+      : z_{z} {}
+
+  constexpr auto operator()(std::size_t k) const noexcept
+      -> cmath::complex<T> {
+    return z_[k] - correction(bessel_theta<T>(z_[k]).newton(N), k);
+  }
+
+ private:
+  constexpr auto correction(cmath::complex<T> const& w,
+                            std::size_t k) const noexcept
+      -> cmath::complex<T> {
+    return w / (T{1} - w * repulsion(k, 0));
+  }
+
+  constexpr auto repulsion(std::size_t k, std::size_t j) const noexcept
+      -> cmath::complex<T> {
+    return j == count ? cmath::complex<T>()
+                      : (j == k ? cmath::complex<T>()
+                                : T{1} / (z_[k] - z_[j])) +
+                            (N % 2 == 1 && j == count - 1
+                                 ? cmath::complex<T>()
+                                 : T{1} / (z_[k] - z_[j].conj())) +
+                            repulsion(k, j + 1);
+  }
+
+  roots_type const z_;
+};
+
+template <typename T, std::size_t N>
+class bessel_roots {
+ public:
+  static constexpr std::size_t count{(N + 1) / 2};
+  using roots_type = cmath::vector<cmath::complex<T>, count>;
+
+  constexpr auto operator()() const noexcept -> roots_type {
+    return iterate(roots_type::create(bessel_initial_roots<T, N>{}), 64);
+  }
+
+ private:
+  static constexpr auto
+  iterate(roots_type const& z, int max_iter) noexcept -> roots_type {
+    return iterate(z, roots_type::create(bessel_aberth_step<T, N>{z}),
+                   max_iter - 1);
+  }
+
+  static constexpr auto iterate(roots_type const& z, roots_type const& next,
+                                int max_iter) noexcept -> roots_type {
+    return max_iter == 0 || converged(z, next, 0) ? next
+                                                  : iterate(next, max_iter);
+  }
+
+  static constexpr bool converged(roots_type const& z, roots_type const& next,
+                                  std::size_t k) noexcept {
+    return k == count ||
+           ((next[k] - z[k]).norm() <= tolerance() * z[k].norm() &&
+            converged(z, next, k + 1));
+  }
+
+  // The steps shrink cubically close to the roots, so stopping at double
+  // precision steps still gives roots accurate to the working precision.
+  static constexpr auto tolerance() noexcept -> T {
+    return static_cast<T>(std::numeric_limits<double>::epsilon() *
+                          std::numeric_limits<double>::epsilon());
+  }
+};
+
+// Scales the roots of theta_n such that their product is one, i.e. the
+// phase normalization used for the analog prototype.
+template <typename F, typename T, std::size_t N>
+class bessel_pole_transform {
+ public:
+  using roots_type = typename bessel_roots<T, N>::roots_type;
+
+  constexpr bessel_pole_transform(roots_type const& z) noexcept
+      : z_{z}
+      , scale_{cmath::exp(-log_a0(1) / T{N})} {}
+
+  constexpr auto operator()(std::size_t i) const noexcept
+      -> cmath::complex<F> {
+    return convert(i < bessel_roots<T, N>::count ? z_[i]
+                                                 : z_[N - 1 - i].conj());
+  }
+
+ private:
+  // log((2n)! / (2^n n!)), the constant coefficient of theta_n
+  static constexpr auto log_a0(std::size_t j) noexcept -> T {
+    return j > N ? T{0}
+                 : cmath::log(static_cast<T>(N + j) / T{2}) + log_a0(j + 1);
+  }
+
+  constexpr auto convert(cmath::complex<T> const& z) const noexcept
+      -> cmath::complex<F> {
+    return cmath::complex<F>(static_cast<F>(scale_ * z.real()),
+                             static_cast<F>(scale_ * z.imag()));
+  }
+
+  roots_type const z_;
+  T const scale_;
+};
+
+// Highest order for which the poles are computed by the compiler. Above
+// this order, the root finder gets too slow and runs into the constexpr
+// evaluation limits, so the poles are taken from a precomputed table.
+constexpr std::size_t bessel_max_computed_order{16};
+
+// Specialized for higher orders in "embedded/signal/bessel_table.h"
+template <typename F, std::size_t Order>
+struct bessel_pole_table {
+  static_assert(sizeof(F) == 0,
+                "Bessel filters above order 16 require "
+                "embedded/signal/bessel_table.h");
+};
+
+template <typename F, std::size_t N>
+constexpr auto bessel_poles(std::true_type) noexcept
+    -> cmath::vector<cmath::complex<F>, N> {
+  return cmath::vector<cmath::complex<F>, N>::create(
+      bessel_pole_transform<F, long double, N>{
+          bessel_roots<long double, N>{}()});
+}
+
+template <typename F, std::size_t N>
+constexpr auto bessel_poles(std::false_type) noexcept
+    -> cmath::vector<cmath::complex<F>, N> {
+  return bessel_pole_table<F, N>::value;
+}
+
+// Poles of the phase normalized Bessel prototype of order N
+template <typename F, std::size_t N>
+constexpr auto bessel_poles() noexcept -> cmath::vector<cmath::complex<F>, N> {
+  return bessel_poles<F, N>(
+      std::integral_constant<bool, (N <= bessel_max_computed_order)>{});
+}
+
+} // namespace detail
+} // namespace signal
+} // namespace embedded
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace signal {
+namespace detail {
+
+using cic_gain_type = unsigned long long;
+
+// `x^n <= limit`, without overflowing
+constexpr auto
+cic_pow_fits(cic_gain_type x, std::size_t n, cic_gain_type limit) noexcept
+    -> bool {
+  return n == 0 || (x <= limit && cic_pow_fits(x, n - 1, limit / x));
+}
+
+constexpr auto cic_pow(cic_gain_type x, std::size_t n) noexcept
+    -> cic_gain_type {
+  return n == 0 ? 1 : x * cic_pow(x, n - 1);
+}
+
+constexpr auto cic_ceil_log2(cic_gain_type x, unsigned bits = 0) noexcept
+    -> unsigned {
+  return (cic_gain_type{1} << bits) >= x ? bits : cic_ceil_log2(x, bits + 1);
+}
+
+// The smallest register type is 32 bits, which is the native width on
+// all targets of interest and keeps the arithmetic free of promotions.
+template <unsigned Bits, bool Narrow = (Bits <= 32)>
+struct cic_register {
+  static_assert(Bits <= 64, "CIC bit growth exceeds 64-bit registers");
+
+  using type = std::int64_t;
+  using unsigned_type = std::uint64_t;
+};
+
+template <unsigned Bits>
+struct cic_register<Bits, true> {
+  using type = std::int32_t;
+  using unsigned_type = std::uint32_t;
+};
+
+// Hogenauer's register width for a gain of `(Rate * Delay)^Order / Div`:
+// the input width plus the bit growth, plus a sign bit for unsigned input.
+// All stages use this width and wrap around modulo 2^width, which is fine
+// as the final result is known to fit.
+template <typename T, std::size_t Order, std::size_t Rate, std::size_t Delay,
+          std::size_t Div>
+struct cic_traits {
+  static_assert(std::numeric_limits<T>::is_integer,
+                "CIC filters need integral input");
+  static_assert(Order > 0, "CIC order must be non-zero");
+  static_assert(Rate > 0 && Delay > 0,
+                "CIC rate and differential delay must be non-zero");
+  static_assert(cic_pow_fits(Rate * Delay, Order, cic_gain_type{1} << 62),
+                "CIC gain too large");
+
+  static constexpr cic_gain_type gain{cic_pow(Rate * Delay, Order) / Div};
+  static constexpr unsigned bit_growth{cic_ceil_log2(gain)};
+  static constexpr unsigned output_bits{
+      static_cast<unsigned>(std::numeric_limits<T>::digits) + bit_growth + 1};
+
+  using register_type = cic_register<output_bits>;
+  using value_type = typename register_type::type;
+  using unsigned_type = typename register_type::unsigned_type;
+};
+
+template <typename T, std::size_t Order, std::size_t Rate, std::size_t Delay,
+          std::size_t Div>
+constexpr cic_gain_type cic_traits<T, Order, Rate, Delay, Div>::gain;
+
+template <typename T, std::size_t Order, std::size_t Rate, std::size_t Delay,
+          std::size_t Div>
+constexpr unsigned cic_traits<T, Order, Rate, Delay, Div>::bit_growth;
+
+template <typename T, std::size_t Order, std::size_t Rate, std::size_t Delay,
+          std::size_t Div>
+constexpr unsigned cic_traits<T, Order, Rate, Delay, Div>::output_bits;
+
+} // namespace detail
+} // namespace signal
+} // namespace embedded
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
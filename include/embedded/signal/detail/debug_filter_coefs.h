@@ -43,6 +43,7 @@ namespace detail {
 enum class filter_debug_structure : uint8_t {
   SOS = 0,
   POLY = 1,
+  SOS_COUPLED = 2,
 };
 
 enum class filter_debug_value_type : uint8_t {
@@ -51,21 +52,29 @@ enum class filter_debug_value_type : uint8_t {
   LONG_DOUBLE = 2,
 };
 
+// Version 0 records contain a copy of the coefficients, version 1
+// records refer to the coefficients of a placed design (see
+// `placement.h`) through a pointer, followed by their size in bytes.
+enum class filter_debug_version : uint8_t {
+  COPY = 0,
+  REFERENCE = 1,
+};
+
 struct filter_debug_header {
   uint32_t magic{0x544C4946};
   uint16_t length;
-  uint8_t version{0};
+  filter_debug_version version;
   filter_debug_structure structure;
   filter_debug_value_type valtype;
   char name[119];
 
   template <size_t S>
-  constexpr filter_debug_header(uint16_t length,
-                                filter_debug_structure structure,
-                                filter_debug_value_type valtype,
-                                char const (&name)[S]) noexcept
+  constexpr filter_debug_header(
+      uint16_t length, filter_debug_structure structure,
+      filter_debug_value_type valtype, char const (&name)[S],
+      filter_debug_version version = filter_debug_version::COPY) noexcept
       : filter_debug_header(
-            length, structure, valtype, name,
+            length, structure, valtype, name, version,
             make_index_sequence<cmath::min(sizeof(name) - 1, S)>{}) {}
 
   template <size_t S, std::size_t... Ints>
@@ -73,8 +82,10 @@ struct filter_debug_header {
                                 filter_debug_structure structure_,
                                 filter_debug_value_type valtype_,
                                 char const (&name_)[S],
+                                filter_debug_version version_,
                                 index_sequence<Ints...>) noexcept
       : length{length_}
+      , version{version_}
       , structure{structure_}
       , valtype{valtype_}
       , name{name_[Ints]...} {}
@@ -101,12 +112,23 @@ struct filter_debug_value_type_of<long double> {
   static constexpr auto value{filter_debug_value_type::LONG_DOUBLE};
 };
 
+// All direct form structures share the same coefficient layout.
+template <typename Structure>
+struct filter_debug_structure_of {
+  static constexpr auto value{filter_debug_structure::SOS};
+};
+
+template <>
+struct filter_debug_structure_of<::embedded::signal::sos_structure::coupled> {
+  static constexpr auto value{filter_debug_structure::SOS_COUPLED};
+};
+
 template <typename T>
 struct filter_design_debug;
 
-template <typename F, std::size_t N>
-struct filter_design_debug<::embedded::signal::sos_design<F, N>> {
-  using Design = ::embedded::signal::sos_design<F, N>;
+template <typename F, std::size_t N, typename Structure>
+struct filter_design_debug<::embedded::signal::sos_design<F, N, Structure>> {
+  using Design = ::embedded::signal::sos_design<F, N, Structure>;
   static constexpr uint16_t size =
       sizeof(filter_debug_header) + sizeof(typename Design::sos_array);
 
@@ -115,7 +137,7 @@ struct filter_design_debug<::embedded::signal::sos_design<F, N>> {
 
   template <size_t S>
   constexpr filter_design_debug(Design const& d, char const (&name)[S]) noexcept
-      : header{size, filter_debug_structure::SOS,
+      : header{size, filter_debug_structure_of<Structure>::value,
                filter_debug_value_type_of<F>::value, name}
       , coef{d.sos()} {}
 };
@@ -138,6 +160,30 @@ struct filter_design_debug<::embedded::signal::poly_design<F, N>> {
       , a{d.a()} {}
 };
 
+template <typename T>
+struct filter_design_debug_ref;
+
+template <typename F, std::size_t N, typename Structure>
+struct filter_design_debug_ref<
+    ::embedded::signal::sos_design<F, N, Structure>> {
+  using Design = ::embedded::signal::sos_design<F, N, Structure>;
+  using sos_array = typename Design::sos_array;
+  static constexpr uint16_t size = sizeof(filter_debug_header) +
+                                   sizeof(sos_array const*) + sizeof(uint32_t);
+
+  filter_debug_header header;
+  sos_array const* coef;
+  uint32_t coef_size{sizeof(sos_array)};
+
+  template <size_t S>
+  constexpr filter_design_debug_ref(Design const& d,
+                                    char const (&name)[S]) noexcept
+      : header{size, filter_debug_structure_of<Structure>::value,
+               filter_debug_value_type_of<F>::value, name,
+               filter_debug_version::REFERENCE}
+      , coef{&d.sos()} {}
+};
+
 } // namespace detail
 } // namespace signal
 } // namespace embedded
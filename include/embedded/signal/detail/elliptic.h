@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+
+#include "../../constexpr_math.h"
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace signal {
+
+namespace detail {
+
+// sum of term * ratio^k * q2^(k(k-1)/2) for k >= 0, the partial sums of
+// the Jacobi theta functions; all terms are relative to a sum >= 1
+template <typename T>
+constexpr auto theta_series(T term, T ratio, T q2) noexcept -> T {
+  return term <= std::numeric_limits<T>::epsilon()
+             ? term
+             : term + theta_series(term * ratio, ratio * q2, q2);
+}
+
+template <typename T>
+constexpr auto theta2(T q) noexcept -> T {
+  return T{2} * cmath::sqrt(cmath::sqrt(q)) * theta_series(T{1}, q * q, q * q);
+}
+
+template <typename T>
+constexpr auto theta3(T q) noexcept -> T {
+  return T{1} + T{2} * theta_series(q, q * q * q, q * q);
+}
+
+template <typename T>
+constexpr auto pow4(T x) noexcept -> T {
+  return (x * x) * (x * x);
+}
+
+/**
+ * Normalized elliptic (Cauer) lowpass prototype
+ *
+ * Follows the construction in scipy.signal.ellipap. The selectivity
+ * parameter m is obtained from the degree equation through the nomes
+ * q = exp(-pi K'(m) / K(m)) and q' = exp(-pi K(m) / K'(m)), which yields
+ * both m and 1 - m at full precision, and K(m) = pi / 2 * theta3(q)^2.
+ */
+template <typename T, std::size_t Order>
+class elliptic_prototype {
+ public:
+  static constexpr std::size_t Zn = Order - Order % 2;
+
+  constexpr elliptic_prototype(T eps2, T m1) noexcept
+      : elliptic_prototype(
+            eps2,
+            cmath::ellipf(cmath::atan(T{1} / cmath::sqrt(eps2)), T{1} - m1) /
+                (T{Order} * cmath::ellipk(m1)),
+            T{Order} * cmath::ellipk(m1) / cmath::ellipkm1(m1)) {}
+
+  constexpr auto zero(std::size_t i) const noexcept -> cmath::complex<T> {
+    return i < Zn / 2 ? zero_at(2 * i + 1 + Order % 2)
+                      : zero_at(2 * (i - Zn / 2) + 1 + Order % 2).conj();
+  }
+
+  constexpr auto pole(std::size_t i) const noexcept -> cmath::complex<T> {
+    return Order % 2 != 0 && i == 0
+               ? pole_at(0)
+               : i < (Order + 1) / 2
+                     ? pole_at(2 * i + 1 - Order % 2)
+                     : pole_at(2 * (i - (Order + 1) / 2) + 1 + Order % 2)
+                           .conj();
+  }
+
+  constexpr auto gain_correction() const noexcept -> T {
+    return Order % 2 == 0 ? T{1} / cmath::sqrt(T{1} + eps2_) : T{1};
+  }
+
+  constexpr auto m() const noexcept -> T { return m_; }
+
+ private:
+  constexpr elliptic_prototype(T eps2, T v, T krat) noexcept
+      : elliptic_prototype(eps2, v, cmath::exp(-cmath::pi<T>() / krat),
+                           cmath::exp(-cmath::pi<T>() * krat)) {}
+
+  constexpr elliptic_prototype(T eps2, T v, T q, T qc) noexcept
+      : elliptic_prototype(eps2, pow4(theta2(q) / theta3(q)),
+                           pow4(theta2(qc) / theta3(qc)),
+                           cmath::pi<T>() / T{2} * theta3(q) * theta3(q), v) {}
+
+  constexpr elliptic_prototype(T eps2, T m, T mc, T k, T v) noexcept
+      : eps2_{eps2}
+      , m_{m}
+      , mc_{mc}
+      , k_{k}
+      , v_{cmath::detail::ellipj(k * v, mc, m)} {}
+
+  constexpr auto zero_at(std::size_t j) const noexcept -> cmath::complex<T> {
+    return cmath::complex<T>{
+        T{0}, T{1} / (cmath::sqrt(m_) * cmath::detail::ellipj(
+                                            k_ * T(j) / T{Order}, m_, mc_)
+                                            .sn)};
+  }
+
+  constexpr auto pole_at(std::size_t j) const noexcept -> cmath::complex<T> {
+    return pole_at(cmath::detail::ellipj(k_ * T(j) / T{Order}, m_, mc_));
+  }
+
+  constexpr auto pole_at(cmath::jacobi_elliptic<T> const& u) const noexcept
+      -> cmath::complex<T> {
+    return cmath::complex<T>{-u.cn * u.dn * v_.sn * v_.cn, -u.sn * v_.dn} /
+           (T{1} - (u.dn * v_.sn) * (u.dn * v_.sn));
+  }
+
+  T const eps2_;
+  T const m_;
+  T const mc_;
+  T const k_;
+  cmath::jacobi_elliptic<T> const v_;
+};
+
+template <typename T, std::size_t Order>
+class elliptic_zero {
+ public:
+  constexpr elliptic_zero(elliptic_prototype<T, Order> const& proto) noexcept
+      : proto_{proto} {}
+
+  constexpr auto
+  operator()(std::size_t i) const noexcept -> cmath::complex<T> {
+    return proto_.zero(i);
+  }
+
+ private:
+  elliptic_prototype<T, Order> const proto_;
+};
+
+template <typename T, std::size_t Order>
+class elliptic_pole {
+ public:
+  constexpr elliptic_pole(elliptic_prototype<T, Order> const& proto) noexcept
+      : proto_{proto} {}
+
+  constexpr auto
+  operator()(std::size_t i) const noexcept -> cmath::complex<T> {
+    return proto_.pole(i);
+  }
+
+ private:
+  elliptic_prototype<T, Order> const proto_;
+};
+
+} // namespace detail
+
+} // namespace signal
+} // namespace embedded
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "../../constexpr_math.h"
+#include "../../utility/integer_sequence.h"
+#include "../fixed_point.h"
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace signal {
+namespace detail {
+
+// Arithmetic for floating point types, `scale()` does nothing
+template <typename F, bool = std::is_floating_point<F>::value>
+struct fft_arith {
+  using value_type = F;
+  using coef_type = F;
+
+  static constexpr coef_type coef(double v) noexcept {
+    return static_cast<coef_type>(v);
+  }
+
+  static value_type load(F x) noexcept { return x; }
+  static F store(value_type x) noexcept { return x; }
+
+  static value_type mul(value_type a, coef_type w) noexcept { return a * w; }
+
+  static value_type half(value_type x) noexcept { return x * F(0.5); }
+
+  template <unsigned Shift>
+  static value_type scale(value_type x) noexcept {
+    return x;
+  }
+};
+
+// Arithmetic on the raw values of fixed point types, see
+// `fixed_point_traits`. Sums are formed in the intermediate type and
+// scaled by 1/2 per radix-2 stage, so the results can't overflow.
+template <typename F>
+struct fft_arith<F, false> {
+  using traits = fixed_point_traits<F>;
+  using value_type = typename traits::intermediate_type;
+  using coef_type = typename traits::base_type;
+
+  static constexpr coef_type coef(double v) noexcept {
+    return clamp(v * static_cast<double>(value_type{1}
+                                         << traits::fraction_bits));
+  }
+
+  static value_type load(F x) noexcept { return traits::raw(x); }
+
+  static F store(value_type x) noexcept {
+    return traits::from_raw(static_cast<coef_type>(x));
+  }
+
+  static value_type mul(value_type a, coef_type w) noexcept {
+    return round<traits::fraction_bits>(a * w);
+  }
+
+  static value_type half(value_type x) noexcept { return round<1>(x); }
+
+  template <unsigned Shift>
+  static value_type scale(value_type x) noexcept {
+    return round<Shift>(x);
+  }
+
+ private:
+  template <unsigned Shift>
+  static value_type round(value_type x) noexcept {
+    return (x + (value_type{1} << (Shift - 1))) >> Shift;
+  }
+
+  // 1.0 isn't representable if all bits are fraction bits
+  static constexpr coef_type clamp(double v) noexcept {
+    return v >= static_cast<double>(std::numeric_limits<coef_type>::max())
+               ? std::numeric_limits<coef_type>::max()
+               : static_cast<coef_type>(v < 0 ? v - 0.5 : v + 0.5);
+  }
+};
+
+constexpr unsigned fft_log2(std::size_t n) {
+  return n > 1 ? 1 + fft_log2(n / 2) : 0;
+}
+
+constexpr std::size_t fft_reverse(std::size_t i, unsigned bits) {
+  return bits == 0 ? 0
+                   : ((i & 1) << (bits - 1)) | fft_reverse(i >> 1, bits - 1);
+}
+
+constexpr auto
+fft_twiddle(std::size_t e, std::size_t n) -> cmath::complex<double> {
+  return cmath::complex<double>(
+      cmath::cos(2 * cmath::pi<double>() * e / n),
+      -cmath::sin(2 * cmath::pi<double>() * e / n));
+}
+
+// Twiddle factors `exp(-2 * pi * j * I / N)`
+template <typename Arith, std::size_t N, std::size_t... I>
+struct fft_twiddles {
+  using coef_type = typename Arith::coef_type;
+
+  static constexpr coef_type re[sizeof...(I)] = {
+      Arith::coef(fft_twiddle(I, N).real())...};
+  static constexpr coef_type im[sizeof...(I)] = {
+      Arith::coef(fft_twiddle(I, N).imag())...};
+};
+
+template <typename Arith, std::size_t N, std::size_t... I>
+constexpr typename Arith::coef_type
+    fft_twiddles<Arith, N, I...>::re[sizeof...(I)];
+
+template <typename Arith, std::size_t N, std::size_t... I>
+constexpr typename Arith::coef_type
+    fft_twiddles<Arith, N, I...>::im[sizeof...(I)];
+
+template <typename Arith, std::size_t N, std::size_t... I>
+fft_twiddles<Arith, N, I...> fft_make_twiddles(index_sequence<I...>);
+
+template <typename Arith, std::size_t N, std::size_t Count>
+using fft_twiddle_table = decltype(fft_make_twiddles<Arith, N>(
+    make_index_sequence<Count>{}));
+
+template <unsigned Bits, std::size_t... I>
+struct fft_bitrev {
+  static constexpr std::uint16_t index[sizeof...(I)] = {
+      static_cast<std::uint16_t>(fft_reverse(I, Bits))...};
+};
+
+template <unsigned Bits, std::size_t... I>
+constexpr std::uint16_t fft_bitrev<Bits, I...>::index[sizeof...(I)];
+
+template <unsigned Bits, std::size_t... I>
+fft_bitrev<Bits, I...> fft_make_bitrev(index_sequence<I...>);
+
+template <std::size_t N>
+using fft_bitrev_table =
+    decltype(fft_make_bitrev<fft_log2(N)>(make_index_sequence<N>{}));
+
+// In-place decimation in time FFT of `N` complex values, stored as
+// interleaved real and imaginary parts. After the bit reversal, pairs
+// of radix-2 stages are merged into radix-4 stages, with a single
+// radix-2 stage first if `N` is not a power of four.
+template <typename F, std::size_t N>
+struct fft_kernel {
+  static_assert(N >= 2 && N <= 65536 && (N & (N - 1)) == 0,
+                "N must be a power of two between 2 and 65536");
+
+  using arith = fft_arith<F>;
+  using value_type = typename arith::value_type;
+  using twiddles = fft_twiddle_table<arith, N, 3 * N / 4>;
+  using bitrev = fft_bitrev_table<N>;
+
+  static void run(F* d) {
+    permute(d);
+    std::size_t len = 1;
+    if (fft_log2(N) % 2 != 0) {
+      radix2(d);
+      len = 2;
+    }
+    for (; len < N; len *= 4) {
+      radix4(d, len);
+    }
+  }
+
+ private:
+  static void permute(F* d) {
+    for (std::size_t i = 0; i < N; ++i) {
+      std::size_t const j = bitrev::index[i];
+      if (i < j) {
+        F const re = d[2 * i];
+        F const im = d[2 * i + 1];
+        d[2 * i] = d[2 * j];
+        d[2 * i + 1] = d[2 * j + 1];
+        d[2 * j] = re;
+        d[2 * j + 1] = im;
+      }
+    }
+  }
+
+  static void radix2(F* d) {
+    for (std::size_t i = 0; i < 2 * N; i += 4) {
+      value_type const ar = arith::load(d[i]);
+      value_type const ai = arith::load(d[i + 1]);
+      value_type const br = arith::load(d[i + 2]);
+      value_type const bi = arith::load(d[i + 3]);
+      d[i] = arith::store(arith::template scale<1>(ar + br));
+      d[i + 1] = arith::store(arith::template scale<1>(ai + bi));
+      d[i + 2] = arith::store(arith::template scale<1>(ar - br));
+      d[i + 3] = arith::store(arith::template scale<1>(ai - bi));
+    }
+  }
+
+  static void load_rotated(F const* p, std::size_t e, value_type& re,
+                           value_type& im) {
+    value_type const xr = arith::load(p[0]);
+    value_type const xi = arith::load(p[1]);
+    auto const wr = twiddles::re[e];
+    auto const wi = twiddles::im[e];
+    re = arith::mul(xr, wr) - arith::mul(xi, wi);
+    im = arith::mul(xr, wi) + arith::mul(xi, wr);
+  }
+
+  // Combines four DFTs of length `h` into one of length `4 * h`. Due to
+  // the bit reversal, the blocks at offsets `h` and `2 * h` hold the
+  // DFTs of the samples at `4 * m + 2` and `4 * m + 1`, respectively.
+  static void radix4(F* d, std::size_t h) {
+    std::size_t const stride = N / (4 * h);
+    for (std::size_t base = 0; base < N; base += 4 * h) {
+      for (std::size_t k = 0; k < h; ++k) {
+        F* p0 = d + 2 * (base + k);
+        F* p1 = p0 + 2 * h;
+        F* p2 = p1 + 2 * h;
+        F* p3 = p2 + 2 * h;
+        value_type b0r = arith::load(p0[0]);
+        value_type b0i = arith::load(p0[1]);
+        value_type b1r, b1i, b2r, b2i, b3r, b3i;
+        load_rotated(p2, k * stride, b1r, b1i);
+        load_rotated(p1, 2 * k * stride, b2r, b2i);
+        load_rotated(p3, 3 * k * stride, b3r, b3i);
+        value_type const s02r = b0r + b2r, s02i = b0i + b2i;
+        value_type const d02r = b0r - b2r, d02i = b0i - b2i;
+        value_type const s13r = b1r + b3r, s13i = b1i + b3i;
+        value_type const d13r = b1r - b3r, d13i = b1i - b3i;
+        p0[0] = arith::store(arith::template scale<2>(s02r + s13r));
+        p0[1] = arith::store(arith::template scale<2>(s02i + s13i));
+        p1[0] = arith::store(arith::template scale<2>(d02r + d13i));
+        p1[1] = arith::store(arith::template scale<2>(d02i - d13r));
+        p2[0] = arith::store(arith::template scale<2>(s02r - s13r));
+        p2[1] = arith::store(arith::template scale<2>(s02i - s13i));
+        p3[0] = arith::store(arith::template scale<2>(d02r - d13i));
+        p3[1] = arith::store(arith::template scale<2>(d02i + d13r));
+      }
+    }
+  }
+};
+
+// Turns the FFT of the `N / 2` complex values formed by pairs of real
+// samples into the first half of the spectrum of the `N` real samples.
+template <typename F, std::size_t N>
+struct real_fft_kernel {
+  static_assert(N >= 4, "N must be at least 4");
+
+  using arith = fft_arith<F>;
+  using value_type = typename arith::value_type;
+  using twiddles = fft_twiddle_table<arith, N, N / 4 + 1>;
+
+  static void run(F* d) {
+    fft_kernel<F, N / 2>::run(d);
+
+    // DC and Nyquist are real, they are packed into the first bin
+    value_type const zr = arith::load(d[0]);
+    value_type const zi = arith::load(d[1]);
+    d[0] = arith::store(arith::template scale<1>(zr + zi));
+    d[1] = arith::store(arith::template scale<1>(zr - zi));
+
+    for (std::size_t k = 1; k <= N / 4; ++k) {
+      F* p = d + 2 * k;
+      F* q = d + 2 * (N / 2 - k);
+      value_type const ar = arith::load(p[0]);
+      value_type const ai = arith::load(p[1]);
+      value_type const br = arith::load(q[0]);
+      value_type const bi = -arith::load(q[1]);
+      // even and odd parts: e = (a + b) / 2, o = -j * (a - b) / 2
+      value_type const er = arith::half(arith::template scale<1>(ar + br));
+      value_type const ei = arith::half(arith::template scale<1>(ai + bi));
+      value_type const o_r = arith::half(arith::template scale<1>(ai - bi));
+      value_type const o_i = arith::half(arith::template scale<1>(br - ar));
+      auto const wr = twiddles::re[k];
+      auto const wi = twiddles::im[k];
+      value_type const tr = arith::mul(o_r, wr) - arith::mul(o_i, wi);
+      value_type const ti = arith::mul(o_r, wi) + arith::mul(o_i, wr);
+      // X[k] = e + w * o, X[N / 2 - k] = conj(e - w * o)
+      p[0] = arith::store(er + tr);
+      p[1] = arith::store(ei + ti);
+      q[0] = arith::store(er - tr);
+      q[1] = arith::store(ti - ei);
+    }
+  }
+};
+
+} // namespace detail
+} // namespace signal
+} // namespace embedded
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
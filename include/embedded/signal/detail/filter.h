@@ -27,6 +27,7 @@
 
 #include "../../constexpr_math.h"
 #include "../../utility/integer_sequence.h"
+#include "simd.h"
 
 // clang-format off
 #ifdef __IAR_SYSTEMS_ICC__
@@ -37,12 +38,6 @@
 namespace embedded {
 namespace signal {
 
-template <typename F>
-struct sos_state;
-
-template <typename F>
-class sos_section;
-
 namespace detail {
 
 template <std::size_t Zn, std::size_t Pn, typename F>
@@ -111,6 +106,11 @@ constexpr auto warp_frequency(F freq, F fs) noexcept -> F {
   return F{2} * fs * cmath::tan(cmath::pi<F>() * freq / fs);
 }
 
+template <typename F>
+constexpr auto unwarp_frequency(F w, F fs) noexcept -> F {
+  return fs / cmath::pi<F>() * cmath::atan(w / (F{2} * fs));
+}
+
 template <typename F, std::size_t Zn, std::size_t Pn>
 constexpr auto lowpass_zpk(zpk_value<Zn, Pn, F> const& zpk, F f) noexcept
     -> zpk_value<Zn, Pn, F> {
@@ -235,8 +235,8 @@ struct unit_circle_distance_real_less {
   template <typename F>
   constexpr bool operator()(cmath::complex<F> const& a,
                             cmath::complex<F> const& b) const noexcept {
-    return a.is_real() < b.is_real() ||
-           (a.is_real() == a.is_real() && unit_distance(a) < unit_distance(b));
+    return a.is_real() > b.is_real() ||
+           (a.is_real() == b.is_real() && unit_distance(a) < unit_distance(b));
   }
 };
 
@@ -287,11 +287,11 @@ class distance_complex_less {
   cmath::complex<F> const z_;
 };
 
-template <typename FO, typename F, std::size_t Stages>
+template <typename Section, typename F, std::size_t Stages>
 class zpk_to_sos {
  public:
   using value_type = F;
-  using output_type = FO;
+  using section_type = Section;
 
   using cnum = cmath::complex<value_type>;
 
@@ -299,13 +299,26 @@ class zpk_to_sos {
   using carray = cmath::vector<cnum, N>;
 
   template <std::size_t N>
-  using sos_array = cmath::vector<sos_section<output_type>, N>;
+  using sos_array = cmath::vector<section_type, N>;
+
+  using garray = cmath::vector<value_type, Stages>;
 
   constexpr auto
   operator()(carray<2 * Stages> const& z, carray<2 * Stages> const& p,
              value_type gain, bool distribute_gain) const noexcept
       -> sos_array<Stages> {
-    return step0(next_pole_index(p), z, p, check_gain(gain), distribute_gain);
+    return (*this)(z, p,
+                   distribute_gain
+                       ? garray::full(check_gain(gain))
+                       : cmath::vector<value_type, 1>{check_gain(gain)}.append(
+                             cmath::vector<value_type, Stages - 1>::ones()));
+  }
+
+  // Uses `gains[i]` as the gain of the i-th section.
+  constexpr auto
+  operator()(carray<2 * Stages> const& z, carray<2 * Stages> const& p,
+             garray const& gains) const noexcept -> sos_array<Stages> {
+    return step0(next_pole_index(p), z, p, gains);
   }
 
  private:
@@ -318,102 +331,101 @@ class zpk_to_sos {
     return gain != value_type{0} ? gain : value_type{1} / gain;
   }
 
-  constexpr auto
-  step0(std::size_t p1, carray<2 * Stages> const& z,
-        carray<2 * Stages> const& p, value_type gain,
-        bool distribute_gain) const noexcept -> sos_array<Stages> {
-    return step1(p[p1], z, p.swappop(p1), gain, distribute_gain);
+  constexpr auto step0(std::size_t p1, carray<2 * Stages> const& z,
+                       carray<2 * Stages> const& p,
+                       garray const& gains) const noexcept
+      -> sos_array<Stages> {
+    return step1(p[p1], z, p.swappop(p1), gains);
   }
 
-  constexpr auto
-  step1(cnum p1, carray<2 * Stages> const& z, carray<2 * Stages - 1> const& p,
-        value_type gain, bool distribute_gain) const noexcept
+  constexpr auto step1(cnum p1, carray<2 * Stages> const& z,
+                       carray<2 * Stages - 1> const& p,
+                       garray const& gains) const noexcept
       -> sos_array<Stages> {
     return !p1.is_real() && z.count(is_real{}) == 1 && p.count(is_real{}) == 1
-               ? step2a(nearest_complex_index(z, p1), p1, z, p, gain,
-                        distribute_gain)
+               ? step2a(nearest_complex_index(z, p1), p1, z, p, gains)
                : step2b(p1,
                         p1.is_real() ? next_real_pole_index(p)
                                      : conjugate_index(p, p1),
-                        z, p, gain, distribute_gain);
+                        z, p, gains);
   }
 
   // We have a complex zero and a complex pole. We need to find and add
   // the complex conjugates.
-  constexpr auto
-  step2a(std::size_t z1, cnum p1, carray<2 * Stages> const& z,
-         carray<2 * Stages - 1> const& p, value_type gain,
-         bool distribute_gain) const noexcept -> sos_array<Stages> {
-    return step3a(z[z1], p1, z.swappop(z1), p, gain, distribute_gain);
+  constexpr auto step2a(std::size_t z1, cnum p1, carray<2 * Stages> const& z,
+                        carray<2 * Stages - 1> const& p,
+                        garray const& gains) const noexcept
+      -> sos_array<Stages> {
+    return step3a(z[z1], p1, z.swappop(z1), p, gains);
   }
 
-  constexpr auto
-  step3a(cnum z1, cnum p1, carray<2 * Stages - 1> const& z,
-         carray<2 * Stages - 1> const& p, value_type gain,
-         bool distribute_gain) const noexcept -> sos_array<Stages> {
+  constexpr auto step3a(cnum z1, cnum p1, carray<2 * Stages - 1> const& z,
+                        carray<2 * Stages - 1> const& p,
+                        garray const& gains) const noexcept
+      -> sos_array<Stages> {
     return step4a(z1, p1, conjugate_index(z, z1), conjugate_index(p, p1), z, p,
-                  gain, distribute_gain);
+                  gains);
   }
 
   constexpr auto
   step4a(cnum z1, cnum p1, std::size_t z2, std::size_t p2,
          carray<2 * Stages - 1> const& z, carray<2 * Stages - 1> const& p,
-         value_type gain, bool distribute_gain) const noexcept
-      -> sos_array<Stages> {
-    return finish(z1, p1, z[z2], p[p2], z.swappop(z2), p.swappop(p2), gain,
-                  distribute_gain);
+         garray const& gains) const noexcept -> sos_array<Stages> {
+    return finish(z1, p1, z[z2], p[p2], z.swappop(z2), p.swappop(p2), gains);
   }
 
   // We have two poles, either a conjugate pair or two real poles. We
   // need to find two zeros.
-  constexpr auto
-  step2b(cnum p1, std::size_t p2, carray<2 * Stages> const& z,
-         carray<2 * Stages - 1> const& p, value_type gain,
-         bool distribute_gain) const noexcept -> sos_array<Stages> {
-    return step3b(p1, p[p2], z, p.swappop(p2), gain, distribute_gain);
+  constexpr auto step2b(cnum p1, std::size_t p2, carray<2 * Stages> const& z,
+                        carray<2 * Stages - 1> const& p,
+                        garray const& gains) const noexcept
+      -> sos_array<Stages> {
+    return step3b(p1, p[p2], z, p.swappop(p2), gains);
   }
 
-  constexpr auto
-  step3b(cnum p1, cnum p2, carray<2 * Stages> const& z,
-         carray<2 * Stages - 2> const& p, value_type gain,
-         bool distribute_gain) const noexcept -> sos_array<Stages> {
-    return step4b(p1, p2, nearest_index(z, p1), z, p, gain, distribute_gain);
+  constexpr auto step3b(cnum p1, cnum p2, carray<2 * Stages> const& z,
+                        carray<2 * Stages - 2> const& p,
+                        garray const& gains) const noexcept
+      -> sos_array<Stages> {
+    return step4b(p1, p2, nearest_index(z, p1), z, p, gains);
   }
 
-  constexpr auto
-  step4b(cnum p1, cnum p2, std::size_t z1, carray<2 * Stages> const& z,
-         carray<2 * Stages - 2> const& p, value_type gain,
-         bool distribute_gain) const noexcept -> sos_array<Stages> {
-    return step5b(p1, p2, z[z1], z.swappop(z1), p, gain, distribute_gain);
+  constexpr auto step4b(cnum p1, cnum p2, std::size_t z1,
+                        carray<2 * Stages> const& z,
+                        carray<2 * Stages - 2> const& p,
+                        garray const& gains) const noexcept
+      -> sos_array<Stages> {
+    return step5b(p1, p2, z[z1], z.swappop(z1), p, gains);
   }
 
-  constexpr auto
-  step5b(cnum p1, cnum p2, cnum z1, carray<2 * Stages - 1> const& z,
-         carray<2 * Stages - 2> const& p, value_type gain,
-         bool distribute_gain) const noexcept -> sos_array<Stages> {
+  constexpr auto step5b(cnum p1, cnum p2, cnum z1,
+                        carray<2 * Stages - 1> const& z,
+                        carray<2 * Stages - 2> const& p,
+                        garray const& gains) const noexcept
+      -> sos_array<Stages> {
     return step6b(p1, p2, z1,
                   z1.is_real() ? nearest_real_index(z, p1)
                                : conjugate_index(z, z1),
-                  z, p, gain, distribute_gain);
+                  z, p, gains);
   }
 
   constexpr auto
   step6b(cnum p1, cnum p2, cnum z1, std::size_t z2,
          carray<2 * Stages - 1> const& z, carray<2 * Stages - 2> const& p,
-         value_type gain, bool distribute_gain) const noexcept
-      -> sos_array<Stages> {
-    return finish(z1, p1, z[z2], p2, z.swappop(z2), p, gain, distribute_gain);
+         garray const& gains) const noexcept -> sos_array<Stages> {
+    return finish(z1, p1, z[z2], p2, z.swappop(z2), p, gains);
   }
 
+  // The remaining stages end up in front of this one, so this section
+  // takes the last gain.
   constexpr auto
   finish(cnum z1, cnum p1, cnum z2, cnum p2, carray<2 * Stages - 2> const& z,
-         carray<2 * Stages - 2> const& p, value_type gain,
-         bool distribute_gain) const noexcept -> sos_array<Stages> {
-    return zpk_to_sos<output_type, value_type, Stages - 1>{}(z, p, gain,
-                                                             distribute_gain)
-        .append(sos_array<1>{sos_section<output_type>{
-            carray<2>{z1, z2}, carray<2>{p1, p2},
-            Stages == 1 || distribute_gain ? gain : value_type{1}}});
+         carray<2 * Stages - 2> const& p,
+         garray const& gains) const noexcept -> sos_array<Stages> {
+    return zpk_to_sos<section_type, value_type, Stages - 1>{}(
+               z, p, gains.template subvector<0, Stages - 1>())
+        .append(sos_array<1>{section_type{carray<2>{z1, z2}, carray<2>{p1, p2},
+                                          gains[Stages - 1]}});
   }
 
   template <std::size_t N>
@@ -456,36 +468,251 @@ class zpk_to_sos {
   }
 };
 
-template <typename FO, typename F>
-class zpk_to_sos<FO, F, 0> {
+template <typename Section, typename F>
+class zpk_to_sos<Section, F, 0> {
  public:
   using value_type = F;
-  using output_type = FO;
   using carray = cmath::vector<cmath::complex<value_type>, 0>;
-  using sos_array = cmath::vector<sos_section<output_type>, 0>;
+  using sos_array = cmath::vector<Section, 0>;
 
   constexpr auto operator()(carray const&, carray const&, value_type,
                             bool) const noexcept -> sos_array {
     return sos_array{};
   }
+
+  constexpr auto
+  operator()(carray const&, carray const&,
+             cmath::vector<value_type, 0> const&) const noexcept -> sos_array {
+    return sos_array{};
+  }
+};
+
+// Number of frequencies used to estimate the norms of partial cascades.
+constexpr std::size_t sos_norm_grid{512};
+
+// |c0 + c1 z^-1 + c2 z^-2|^2 on the unit circle, with cw = cos(w) and
+// c2w = cos(2w).
+template <typename F>
+constexpr auto sos_power(cmath::vector<F, 3> const& c, F cw, F c2w) noexcept
+    -> F {
+  return c[0] * c[0] + c[1] * c[1] + c[2] * c[2] +
+         F{2} * (c[0] * c[1] + c[1] * c[2]) * cw + F{2} * c[0] * c[2] * c2w;
+}
+
+// Computes section gains for a cascade of unit gain sections, such that
+// the output of each section but the last has unit L-infinity norm (i.e.
+// unit peak gain for any frequency) or unit L2 norm. The last section
+// takes the remaining gain. Norms are estimated on a frequency grid. The
+// power gains up to each section output are evaluated for one frequency
+// at a time and reduced over the grid by recursive splitting, which
+// keeps both the constexpr recursion depth and evaluation cost low.
+template <typename Section, std::size_t N>
+class sos_norm_gains {
+ public:
+  using value_type = typename Section::value_type;
+  using sos_array = cmath::vector<Section, N>;
+  using garray = cmath::vector<value_type, N>;
+
+  constexpr sos_norm_gains(sos_array const& sos, bool linf) noexcept
+      : sos_{sos}
+      , linf_{linf} {}
+
+  constexpr auto operator()(value_type gain) const noexcept -> garray {
+    return gains(gain, reduce(0, G), make_index_sequence<N>{});
+  }
+
+ private:
+  using F = value_type;
+  static constexpr std::size_t G = sos_norm_grid;
+
+  template <std::size_t... Ints>
+  constexpr auto gains(F gain, garray const& r,
+                       index_sequence<Ints...>) const noexcept -> garray {
+    return garray{section_gain(Ints, gain, r)...};
+  }
+
+  constexpr auto
+  section_gain(std::size_t i, F gain, garray const& r) const noexcept -> F {
+    return N == 1       ? gain
+           : i == 0     ? F{1} / norm(r[0])
+           : i == N - 1 ? gain * norm(r[N - 2])
+                        : norm(r[i - 1]) / norm(r[i]);
+  }
+
+  constexpr auto norm(F r) const noexcept -> F {
+    return cmath::sqrt(linf_ ? r : r / F(G));
+  }
+
+  constexpr auto
+  reduce(std::size_t lo, std::size_t hi) const noexcept -> garray {
+    return hi - lo == 1 ? powers(cmath::cos(cmath::pi<F>() * F(lo) / F(G - 1)))
+                        : combine(reduce(lo, lo + (hi - lo) / 2),
+                                  reduce(lo + (hi - lo) / 2, hi),
+                                  make_index_sequence<N>{});
+  }
+
+  template <std::size_t... Ints>
+  constexpr auto combine(garray const& a, garray const& b,
+                         index_sequence<Ints...>) const noexcept -> garray {
+    return garray{(linf_ ? (a[Ints] < b[Ints] ? b[Ints] : a[Ints])
+                         : a[Ints] + b[Ints])...};
+  }
+
+  // Power gains from the input to each section output at one frequency.
+  constexpr auto powers(F cw) const noexcept -> garray {
+    return prefix_products(
+        section_powers(cw, F{2} * cw * cw - F{1}, make_index_sequence<N>{}),
+        make_index_sequence<N>{});
+  }
+
+  template <std::size_t... Ints>
+  constexpr auto section_powers(F cw, F c2w,
+                                index_sequence<Ints...>) const noexcept
+      -> garray {
+    return garray{(sos_power(sos_[Ints].b(), cw, c2w) /
+                   sos_power(sos_[Ints].a(), cw, c2w))...};
+  }
+
+  template <std::size_t... Ints>
+  static constexpr auto
+  prefix_products(garray const& p, index_sequence<Ints...>) noexcept
+      -> garray {
+    return garray{prefix_product(p, Ints)...};
+  }
+
+  static constexpr auto
+  prefix_product(garray const& p, std::size_t k) noexcept -> F {
+    return k == 0 ? p[0] : p[k] * prefix_product(p, k - 1);
+  }
+
+  sos_array const sos_;
+  bool const linf_;
 };
 
-template <typename F, std::size_t N, std::size_t I = 0>
+template <typename Section, std::size_t N, std::size_t I = 0>
 struct filter_chain {
-  F operator()(cmath::vector<sos_section<F>, N> const& sos,
-               std::array<sos_state<F>, N>& state, F x) const {
-    return filter_chain<F, N, I + 1>{}(sos, state, sos[I].filter(state[I], x));
+  using value_type = typename Section::value_type;
+  using state_type = typename Section::state_type;
+
+  value_type operator()(cmath::vector<Section, N> const& sos,
+                        std::array<state_type, N>& state, value_type x) const {
+    return filter_chain<Section, N, I + 1>{}(sos, state,
+                                             sos[I].filter(state[I], x));
   }
 };
 
-template <typename F, std::size_t N>
-struct filter_chain<F, N, N> {
-  F operator()(cmath::vector<sos_section<F>, N> const&,
-               std::array<sos_state<F>, N>&, F x) const {
+template <typename Section, std::size_t N>
+struct filter_chain<Section, N, N> {
+  using value_type = typename Section::value_type;
+  using state_type = typename Section::state_type;
+
+  value_type operator()(cmath::vector<Section, N> const&,
+                        std::array<state_type, N>&, value_type x) const {
     return x;
   }
 };
 
+// One step of a software-pipelined cascade: section I consumes what
+// section I - 1 produced in the previous step. Sections are updated from
+// last to first, so all of them work on independent values.
+template <typename Section, std::size_t N, std::size_t I = N - 1>
+struct pipeline_step {
+  using value_type = typename Section::value_type;
+  using state_type = typename Section::state_type;
+
+  void operator()(cmath::vector<Section, N> const& sos,
+                  std::array<state_type, N>& state,
+                  std::array<value_type, N>& pipe, value_type x) const {
+    pipe[I] = sos[I].filter(state[I], pipe[I - 1]);
+    pipeline_step<Section, N, I - 1>{}(sos, state, pipe, x);
+  }
+};
+
+template <typename Section, std::size_t N>
+struct pipeline_step<Section, N, 0> {
+  using value_type = typename Section::value_type;
+  using state_type = typename Section::state_type;
+
+  void operator()(cmath::vector<Section, N> const& sos,
+                  std::array<state_type, N>& state,
+                  std::array<value_type, N>& pipe, value_type x) const {
+    pipe[0] = sos[0].filter(state[0], x);
+  }
+};
+
+template <typename Section, std::size_t N>
+void filter_block(cmath::vector<Section, N> const& sos,
+                  std::array<typename Section::state_type, N>& state,
+                  typename Section::value_type const* in,
+                  typename Section::value_type* out, std::size_t n) {
+  // Run the cascade section by section over the whole block, so each
+  // section's state and coefficients can stay in registers.
+  sos[0].filter(state[0], in, out, n);
+  for (std::size_t i = 1; i < N; ++i) {
+    sos[i].filter(state[i], out, out, n);
+  }
+}
+
+// Same as filter_block(), but with the section index as a template
+// parameter, so the coefficients of a constexpr cascade can be folded
+// into each section's loop.
+template <typename Section, std::size_t N, std::size_t I = 1>
+struct filter_block_chain {
+  using value_type = typename Section::value_type;
+  using state_type = typename Section::state_type;
+
+  void operator()(cmath::vector<Section, N> const& sos,
+                  std::array<state_type, N>& state, value_type* data,
+                  std::size_t n) const {
+    sos[I].filter(state[I], data, data, n);
+    filter_block_chain<Section, N, I + 1>{}(sos, state, data, n);
+  }
+};
+
+template <typename Section, std::size_t N>
+struct filter_block_chain<Section, N, N> {
+  using value_type = typename Section::value_type;
+  using state_type = typename Section::state_type;
+
+  void operator()(cmath::vector<Section, N> const&, std::array<state_type, N>&,
+                  value_type*, std::size_t) const {}
+};
+
+template <typename F, std::size_t W = simd<F>::width>
+struct sos_lanes {
+  using vec = simd<F>;
+  using vector_type = typename vec::type;
+
+  static constexpr std::size_t vectorized(std::size_t count) noexcept {
+    return count - count % W;
+  }
+
+  // Processes the first `vectorized(count)` channels in SIMD registers.
+  static void filter(F b0, F b1, F b2, F a1, F a2, F* y1, F* y2, F const* x,
+                     F* y, std::size_t count) {
+    vector_type const vb0 = vec::broadcast(b0);
+    vector_type const vb1 = vec::broadcast(b1);
+    vector_type const vb2 = vec::broadcast(b2);
+    vector_type const va1 = vec::broadcast(a1);
+    vector_type const va2 = vec::broadcast(a2);
+    std::size_t c = 0;
+    for (; c + W <= count; c += W) {
+      vector_type const xc = vec::load(x + c);
+      vector_type const yc = vb0 * xc + vec::load(y1 + c);
+      vec::store(y1 + c, vb1 * xc - va1 * yc + vec::load(y2 + c));
+      vec::store(y2 + c, vb2 * xc - va2 * yc);
+      vec::store(y + c, yc);
+    }
+  }
+};
+
+template <typename F>
+struct sos_lanes<F, 1> {
+  static constexpr std::size_t vectorized(std::size_t) noexcept { return 0; }
+
+  static void filter(F, F, F, F, F, F*, F*, F const*, F*, std::size_t) {}
+};
+
 template <typename F, std::size_t Order>
 constexpr auto
 butterworth_poles() noexcept -> cmath::vector<cmath::complex<F>, Order> {
@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+
+#include "../../constexpr_math.h"
+#include "../../utility/integer_sequence.h"
+#include "simd.h"
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace signal {
+namespace detail {
+
+template <std::size_t Taps, typename F>
+constexpr auto
+cosine_window(std::size_t n, F a0, F a1, F a2) noexcept -> F {
+  return Taps == 1
+             ? F{1}
+             : a0 - a1 * cmath::cos(F{2} * cmath::pi<F>() * n / (Taps - 1)) +
+                   a2 * cmath::cos(F{4} * cmath::pi<F>() * n / (Taps - 1));
+}
+
+template <typename F, typename Window>
+class windowed_sinc {
+ public:
+  static constexpr std::size_t Taps = Window::taps();
+
+  constexpr windowed_sinc(Window const& w, F fc) noexcept
+      : w_{w}
+      , fc_{fc} {}
+
+  // Only the first half is computed, so the result is exactly symmetric.
+  constexpr auto operator()(std::size_t n) const noexcept -> F {
+    return tap(n < Taps - 1 - n ? n : Taps - 1 - n);
+  }
+
+ private:
+  constexpr auto tap(std::size_t n) const noexcept -> F {
+    return sinc(F(n) - F(Taps - 1) / F{2}) * w_.template value<F>(n);
+  }
+
+  constexpr auto sinc(F t) const noexcept -> F {
+    return t == F{0} ? F{2} * fc_
+                     : cmath::sin(F{2} * cmath::pi<F>() * fc_ * t) /
+                           (cmath::pi<F>() * t);
+  }
+
+  Window const w_;
+  F const fc_;
+};
+
+template <typename F>
+constexpr auto cic_power(F x, std::size_t n) noexcept -> F {
+  return n == 0 ? F{1} : x * cic_power(x, n - 1);
+}
+
+// One point of the numerical integration of the inverse CIC response
+// `|sin(pi M f) / (R sin(pi M f / R))|^N` times `cos(2 pi f t)` over the
+// passband, using the midpoint rule.
+template <typename F, std::size_t Order, std::size_t Rate, std::size_t Delay,
+          std::size_t Points>
+class cic_compensation_point {
+ public:
+  constexpr cic_compensation_point(F fc, F t) noexcept
+      : fc_{fc}
+      , t_{t} {}
+
+  constexpr auto operator()(std::size_t i) const noexcept -> F {
+    return value(fc_ * (F(i) + F{0.5}) / F(Points));
+  }
+
+ private:
+  constexpr auto value(F f) const noexcept -> F {
+    return F{2} * fc_ / F(Points) * inverse(cmath::pi<F>() * F(Delay) * f) *
+           cmath::cos(F{2} * cmath::pi<F>() * f * t_);
+  }
+
+  constexpr auto inverse(F x) const noexcept -> F {
+    return cic_power(F(Rate) * cmath::sin(x / F(Rate)) / cmath::sin(x),
+                     Order);
+  }
+
+  F const fc_;
+  F const t_;
+};
+
+// Windowed frequency sampling design of the inverse CIC response up to
+// `fc` (relative to the CIC output rate) and zero above.
+template <typename F, typename Window, std::size_t Order, std::size_t Rate,
+          std::size_t Delay, std::size_t Points = 64>
+class cic_compensation {
+ public:
+  static constexpr std::size_t Taps = Window::taps();
+
+  constexpr cic_compensation(Window const& w, F fc) noexcept
+      : w_{w}
+      , fc_{fc} {}
+
+  // Only the first half is computed, so the result is exactly symmetric.
+  constexpr auto operator()(std::size_t n) const noexcept -> F {
+    return tap(n < Taps - 1 - n ? n : Taps - 1 - n);
+  }
+
+ private:
+  using point = cic_compensation_point<F, Order, Rate, Delay, Points>;
+
+  constexpr auto tap(std::size_t n) const noexcept -> F {
+    return cmath::sum(cmath::make_vector<F>(
+               point(fc_, F(n) - F(Taps - 1) / F{2}),
+               make_index_sequence<Points>{})) *
+           w_.template value<F>(n);
+  }
+
+  Window const w_;
+  F const fc_;
+};
+
+template <typename F, std::size_t Taps>
+class spectral_inversion {
+ public:
+  constexpr spectral_inversion(cmath::vector<F, Taps> const& h) noexcept
+      : h_{h} {}
+
+  constexpr auto operator()(std::size_t n) const noexcept -> F {
+    return (n == (Taps - 1) / 2 ? F{1} : F{0}) - h_[n];
+  }
+
+ private:
+  cmath::vector<F, Taps> const h_;
+};
+
+template <typename F, std::size_t Taps, std::size_t I = 0,
+          bool Done = (I >= Taps / 2)>
+struct fir_symmetric {
+  constexpr bool operator()(cmath::vector<F, Taps> const& h) const noexcept {
+    return h[I] == h[Taps - 1 - I] && fir_symmetric<F, Taps, I + 1>{}(h);
+  }
+};
+
+template <typename F, std::size_t Taps, std::size_t I>
+struct fir_symmetric<F, Taps, I, true> {
+  constexpr bool operator()(cmath::vector<F, Taps> const&) const noexcept {
+    return true;
+  }
+};
+
+// Computes `y[i] = sum(h[k] * x[i + Taps - 1 - k])`, i.e. `x` points to
+// the oldest sample of the first output's window. Outputs are computed
+// in groups of `U` independent accumulators, so each coefficient is only
+// loaded once per group and the additions don't form a single long
+// dependency chain. With SIMD support, each accumulator is a vector of
+// consecutive outputs. Symmetric taps are folded so only half of the
+// multiplications are needed.
+template <typename F, std::size_t Taps, std::size_t U,
+          std::size_t W = simd<F>::width>
+struct fir_kernel {
+  using vec = simd<F>;
+  using vector_type = typename vec::type;
+
+  template <bool Symmetric>
+  static auto filter(F const* h, F const* x, F* y, std::size_t n)
+      -> std::size_t {
+    std::size_t i = 0;
+    for (; i + U * W <= n; i += U * W) {
+      vector_type acc[U];
+      for (std::size_t u = 0; u < U; ++u) {
+        acc[u] = vec::broadcast(F{0});
+      }
+      if (Symmetric) {
+        for (std::size_t k = 0; k < Taps / 2; ++k) {
+          vector_type const hk = vec::broadcast(h[k]);
+          for (std::size_t u = 0; u < U; ++u) {
+            F const* xu = x + i + u * W;
+            acc[u] += hk * (vec::load(xu + Taps - 1 - k) + vec::load(xu + k));
+          }
+        }
+        if (Taps % 2 != 0) {
+          vector_type const hk = vec::broadcast(h[Taps / 2]);
+          for (std::size_t u = 0; u < U; ++u) {
+            acc[u] += hk * vec::load(x + i + u * W + Taps / 2);
+          }
+        }
+      } else {
+        for (std::size_t k = 0; k < Taps; ++k) {
+          vector_type const hk = vec::broadcast(h[k]);
+          for (std::size_t u = 0; u < U; ++u) {
+            acc[u] += hk * vec::load(x + i + u * W + Taps - 1 - k);
+          }
+        }
+      }
+      for (std::size_t u = 0; u < U; ++u) {
+        vec::store(y + i + u * W, acc[u]);
+      }
+    }
+    return i;
+  }
+};
+
+template <typename F, std::size_t Taps, std::size_t U>
+struct fir_kernel<F, Taps, U, 1> {
+  template <bool Symmetric>
+  static auto filter(F const* h, F const* x, F* y, std::size_t n)
+      -> std::size_t {
+    std::size_t i = 0;
+    for (; i + U <= n; i += U) {
+      F acc[U]{};
+      if (Symmetric) {
+        for (std::size_t k = 0; k < Taps / 2; ++k) {
+          for (std::size_t u = 0; u < U; ++u) {
+            acc[u] += h[k] * (x[i + u + Taps - 1 - k] + x[i + u + k]);
+          }
+        }
+        if (Taps % 2 != 0) {
+          for (std::size_t u = 0; u < U; ++u) {
+            acc[u] += h[Taps / 2] * x[i + u + Taps / 2];
+          }
+        }
+      } else {
+        for (std::size_t k = 0; k < Taps; ++k) {
+          for (std::size_t u = 0; u < U; ++u) {
+            acc[u] += h[k] * x[i + u + Taps - 1 - k];
+          }
+        }
+      }
+      for (std::size_t u = 0; u < U; ++u) {
+        y[i + u] = acc[u];
+      }
+    }
+    return i;
+  }
+};
+
+template <typename F, std::size_t Taps, bool Symmetric>
+auto fir_single(F const* h, F const* x) -> F {
+  F acc{};
+  if (Symmetric) {
+    for (std::size_t k = 0; k < Taps / 2; ++k) {
+      acc += h[k] * (x[Taps - 1 - k] + x[k]);
+    }
+    if (Taps % 2 != 0) {
+      acc += h[Taps / 2] * x[Taps / 2];
+    }
+  } else {
+    for (std::size_t k = 0; k < Taps; ++k) {
+      acc += h[k] * x[Taps - 1 - k];
+    }
+  }
+  return acc;
+}
+
+template <typename F, std::size_t Taps, bool Symmetric>
+void fir_block(F const* h, F const* x, F* y, std::size_t n) {
+  std::size_t i =
+      fir_kernel<F, Taps, 4>::template filter<Symmetric>(h, x, y, n);
+  i += fir_kernel<F, Taps, 1>::template filter<Symmetric>(h, x + i, y + i,
+                                                          n - i);
+  for (; i < n; ++i) {
+    y[i] = fir_single<F, Taps, Symmetric>(h, x + i);
+  }
+}
+
+} // namespace detail
+} // namespace signal
+} // namespace embedded
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+
+#include "../../utility/integer_sequence.h"
+#include "simd.h"
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace signal {
+namespace detail {
+
+// `simd<F>` for `Vector == true`, a single lane otherwise
+template <typename F, bool Vector = (simd<F>::width > 1)>
+struct goertzel_lanes : simd<F> {};
+
+template <typename F>
+struct goertzel_lanes<F, false> {
+  using type = F;
+
+  static constexpr std::size_t width = 1;
+
+  static type load(F const* p) noexcept { return *p; }
+  static void store(F* p, type const& v) noexcept { *p = v; }
+  static type broadcast(F x) noexcept { return x; }
+};
+
+// The bins are independent, so they are processed side by side, one bin
+// per lane. Each sample only advances the state of the bins by a single
+// step, so up to `U` vectors of bins are updated together to hide the
+// latency of the recursion. The bin state is kept in registers for the
+// whole block and the accumulators are expanded from an index sequence
+// so the compiler doesn't keep them in memory.
+template <typename F, typename Lanes>
+struct goertzel_kernel {
+  using vector_type = typename Lanes::type;
+  static constexpr std::size_t W = Lanes::width;
+
+  // Advances the state `s1`, `s2` of `bins` bins with coefficients
+  // `2 * cos(omega)` at `c` by the `n` samples at `x`.
+  template <std::size_t U>
+  static auto update(F const* c, F* s1, F* s2, std::size_t bins,
+                     F const* x, std::size_t n) -> std::size_t {
+    std::size_t b = 0;
+    for (; b + U * W <= bins; b += U * W) {
+      update_group(c + b, s1 + b, s2 + b, x, n, make_index_sequence<U>{});
+    }
+    return b;
+  }
+
+  // Advances the state `yr`, `yi` of `bins` sliding bins with rotation
+  // `z` and `z^N` by the `n` samples `x[length + i]` entering and
+  // `x[i]` leaving the window.
+  template <std::size_t U>
+  static auto slide(F const* zr, F const* zi, F const* wr, F const* wi,
+                    F* yr, F* yi, std::size_t bins, F const* x,
+                    std::size_t length, std::size_t n) -> std::size_t {
+    std::size_t b = 0;
+    for (; b + U * W <= bins; b += U * W) {
+      slide_group(zr + b, zi + b, wr + b, wi + b, yr + b, yi + b, x, length,
+                  n, make_index_sequence<U>{});
+    }
+    return b;
+  }
+
+ private:
+  static void step(vector_type& s1, vector_type& s2, vector_type const& c,
+                   vector_type const& x) {
+    vector_type const s0 = x + c * s1 - s2;
+    s2 = s1;
+    s1 = s0;
+  }
+
+  static void
+  slide_step(vector_type& yr, vector_type& yi, vector_type const& zr,
+             vector_type const& zi, vector_type const& wr,
+             vector_type const& wi, vector_type const& xn,
+             vector_type const& xo) {
+    vector_type const r = xn - wr * xo + zr * yr - zi * yi;
+    yi = zr * yi + zi * yr - wi * xo;
+    yr = r;
+  }
+
+  template <std::size_t... G>
+  static void update_group(F const* c, F* s1, F* s2, F const* x,
+                           std::size_t n, index_sequence<G...>) {
+    using expand = int[];
+    vector_type const cv[] = {Lanes::load(c + G * W)...};
+    vector_type a[] = {Lanes::load(s1 + G * W)...};
+    vector_type b[] = {Lanes::load(s2 + G * W)...};
+    for (std::size_t i = 0; i < n; ++i) {
+      vector_type const xi = Lanes::broadcast(x[i]);
+      static_cast<void>(expand{0, (step(a[G], b[G], cv[G], xi), 0)...});
+    }
+    static_cast<void>(expand{
+        0, (Lanes::store(s1 + G * W, a[G]), Lanes::store(s2 + G * W, b[G]),
+            0)...});
+  }
+
+  template <std::size_t... G>
+  static void slide_group(F const* zr, F const* zi, F const* wr,
+                          F const* wi, F* yr, F* yi, F const* x,
+                          std::size_t length, std::size_t n,
+                          index_sequence<G...>) {
+    using expand = int[];
+    vector_type const zrv[] = {Lanes::load(zr + G * W)...};
+    vector_type const ziv[] = {Lanes::load(zi + G * W)...};
+    vector_type const wrv[] = {Lanes::load(wr + G * W)...};
+    vector_type const wiv[] = {Lanes::load(wi + G * W)...};
+    vector_type re[] = {Lanes::load(yr + G * W)...};
+    vector_type im[] = {Lanes::load(yi + G * W)...};
+    for (std::size_t i = 0; i < n; ++i) {
+      vector_type const xo = Lanes::broadcast(x[i]);
+      vector_type const xn = Lanes::broadcast(x[i + length]);
+      static_cast<void>(expand{0, (slide_step(re[G], im[G], zrv[G], ziv[G],
+                                              wrv[G], wiv[G], xn, xo),
+                                   0)...});
+    }
+    static_cast<void>(expand{0, (Lanes::store(yr + G * W, re[G]),
+                                 Lanes::store(yi + G * W, im[G]), 0)...});
+  }
+};
+
+template <typename F>
+void goertzel_update(F const* c, F* s1, F* s2, std::size_t bins,
+                     F const* x, std::size_t n) {
+  using vector = goertzel_kernel<F, goertzel_lanes<F>>;
+  using scalar = goertzel_kernel<F, goertzel_lanes<F, false>>;
+  auto b = vector::template update<4>(c, s1, s2, bins, x, n);
+  b += vector::template update<2>(c + b, s1 + b, s2 + b, bins - b, x, n);
+  b += vector::template update<1>(c + b, s1 + b, s2 + b, bins - b, x, n);
+  scalar::template update<1>(c + b, s1 + b, s2 + b, bins - b, x, n);
+}
+
+template <typename F>
+void goertzel_slide(F const* zr, F const* zi, F const* wr, F const* wi,
+                    F* yr, F* yi, std::size_t bins, F const* x,
+                    std::size_t length, std::size_t n) {
+  using vector = goertzel_kernel<F, goertzel_lanes<F>>;
+  using scalar = goertzel_kernel<F, goertzel_lanes<F, false>>;
+  auto b = vector::template slide<2>(zr, zi, wr, wi, yr, yi, bins, x, length,
+                                     n);
+  b += vector::template slide<1>(zr + b, zi + b, wr + b, wi + b, yr + b,
+                                 yi + b, bins - b, x, length, n);
+  scalar::template slide<1>(zr + b, zi + b, wr + b, wi + b, yr + b, yi + b,
+                            bins - b, x, length, n);
+}
+
+} // namespace detail
+} // namespace signal
+} // namespace embedded
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
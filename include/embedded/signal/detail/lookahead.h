@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+
+#include "../../constexpr_math.h"
+#include "simd.h"
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace signal {
+namespace detail {
+
+template <typename F>
+struct mat2 {
+  F m11, m12, m21, m22;
+};
+
+template <typename F>
+constexpr auto mat2_mul(mat2<F> const& a, mat2<F> const& b) noexcept
+    -> mat2<F> {
+  return mat2<F>{a.m11 * b.m11 + a.m12 * b.m21, a.m11 * b.m12 + a.m12 * b.m22,
+                 a.m21 * b.m11 + a.m22 * b.m21, a.m21 * b.m12 + a.m22 * b.m22};
+}
+
+template <typename F>
+constexpr auto mat2_pow(mat2<F> const& a, std::size_t n) noexcept -> mat2<F> {
+  return n == 0 ? mat2<F>{F{1}, F{0}, F{0}, F{1}}
+                : mat2_mul(a, mat2_pow(a, n - 1));
+}
+
+// State space form of a transposed Direct Form II section, using the
+// same state variables as `sos_state`:
+//
+//   s[n + 1] = A s[n] + B x[n],  y[n] = C s[n] + D x[n]
+//
+// with A = [-a1 1; -a2 0], B = [b1 - a1 b0; b2 - a2 b0], C = [1 0] and
+// D = b0.
+template <typename F>
+class df2t_state_space {
+ public:
+  constexpr df2t_state_space(cmath::vector<F, 3> const& b,
+                             cmath::vector<F, 3> const& a) noexcept
+      : a_{-a[1], F{1}, -a[2], F{0}}
+      , b1_{b[1] - a[1] * b[0]}
+      , b2_{b[2] - a[2] * b[0]}
+      , d_{b[0]} {}
+
+  // h[k], the impulse response
+  constexpr auto impulse(std::size_t k) const noexcept -> F {
+    return k == 0 ? d_ : control(0, k - 1);
+  }
+
+  // (C A^i)[c], contribution of state `c` to the output after `i` steps
+  constexpr auto observe(std::size_t c, std::size_t i) const noexcept -> F {
+    return c == 0 ? mat2_pow(a_, i).m11 : mat2_pow(a_, i).m12;
+  }
+
+  // (A^i B)[r], contribution of an input to state `r` after `i` steps
+  constexpr auto control(std::size_t r, std::size_t i) const noexcept -> F {
+    return r == 0 ? mat2_pow(a_, i).m11 * b1_ + mat2_pow(a_, i).m12 * b2_
+                  : mat2_pow(a_, i).m21 * b1_ + mat2_pow(a_, i).m22 * b2_;
+  }
+
+  // (A^i)[r, c]
+  constexpr auto transition(std::size_t r, std::size_t c,
+                            std::size_t i) const noexcept -> F {
+    return r == 0 ? (c == 0 ? mat2_pow(a_, i).m11 : mat2_pow(a_, i).m12)
+                  : (c == 0 ? mat2_pow(a_, i).m21 : mat2_pow(a_, i).m22);
+  }
+
+ private:
+  mat2<F> const a_;
+  F const b1_, b2_;
+  F const d_;
+};
+
+// Lower triangular Toeplitz matrix of the impulse response, column by
+// column: element (i, j) maps input j of a block to output i.
+template <typename F, std::size_t M>
+class lookahead_toeplitz {
+ public:
+  constexpr lookahead_toeplitz(df2t_state_space<F> const& ss) noexcept
+      : ss_{ss} {}
+
+  constexpr auto operator()(std::size_t idx) const noexcept -> F {
+    return idx % M >= idx / M ? ss_.impulse(idx % M - idx / M) : F{0};
+  }
+
+ private:
+  df2t_state_space<F> const ss_;
+};
+
+// Maps the state at the start of a block to the outputs, one row of M
+// outputs per state variable.
+template <typename F, std::size_t M>
+class lookahead_observe {
+ public:
+  constexpr lookahead_observe(df2t_state_space<F> const& ss) noexcept
+      : ss_{ss} {}
+
+  constexpr auto operator()(std::size_t idx) const noexcept -> F {
+    return ss_.observe(idx / M, idx % M);
+  }
+
+ private:
+  df2t_state_space<F> const ss_;
+};
+
+// Maps the inputs of a block to the state at the end of the block, one
+// row of M inputs per state variable.
+template <typename F, std::size_t M>
+class lookahead_control {
+ public:
+  constexpr lookahead_control(df2t_state_space<F> const& ss) noexcept
+      : ss_{ss} {}
+
+  constexpr auto operator()(std::size_t idx) const noexcept -> F {
+    return ss_.control(idx / M, M - 1 - idx % M);
+  }
+
+ private:
+  df2t_state_space<F> const ss_;
+};
+
+template <typename F, std::size_t M>
+class lookahead_transition {
+ public:
+  constexpr lookahead_transition(df2t_state_space<F> const& ss) noexcept
+      : ss_{ss} {}
+
+  constexpr auto operator()(std::size_t idx) const noexcept -> F {
+    return ss_.transition(idx / 2, idx % 2, M);
+  }
+
+ private:
+  df2t_state_space<F> const ss_;
+};
+
+// y[0..M) = a[0..M) * x and y[0..M) += a[0..M) * x, using SIMD where
+// M is a multiple of the vector width.
+template <typename F, std::size_t M, std::size_t W = simd<F>::width,
+          bool Vectorize = (W > 1 && M % W == 0)>
+struct lookahead_lanes {
+  using vec = simd<F>;
+
+  static void scale(F* y, F const* a, F x) {
+    auto const vx = vec::broadcast(x);
+    for (std::size_t i = 0; i < M; i += W) {
+      vec::store(y + i, vec::load(a + i) * vx);
+    }
+  }
+
+  static void axpy(F* y, F const* a, F x) {
+    auto const vx = vec::broadcast(x);
+    for (std::size_t i = 0; i < M; i += W) {
+      vec::store(y + i, vec::load(y + i) + vec::load(a + i) * vx);
+    }
+  }
+};
+
+template <typename F, std::size_t M, std::size_t W>
+struct lookahead_lanes<F, M, W, false> {
+  static void scale(F* y, F const* a, F x) {
+    for (std::size_t i = 0; i < M; ++i) {
+      y[i] = a[i] * x;
+    }
+  }
+
+  static void axpy(F* y, F const* a, F x) {
+    for (std::size_t i = 0; i < M; ++i) {
+      y[i] += a[i] * x;
+    }
+  }
+};
+
+} // namespace detail
+} // namespace signal
+} // namespace embedded
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../../config.h"
+#include "../../function_ref.h"
+
+namespace embedded {
+namespace signal {
+namespace detail {
+
+/**
+ * Task distribution with work stealing
+ *
+ * The tasks `[0, count)` are split into one contiguous range per worker.
+ * Workers take tasks from the front of their own range. Once it is
+ * empty, they steal the back half of the largest remaining range of
+ * another worker, so neighbouring tasks tend to stay on the same worker.
+ * Each range is a single 64-bit atomic, updated by compare-and-swap.
+ */
+class work_stealing_ranges {
+ public:
+  explicit work_stealing_ranges(std::size_t workers)
+      : ranges_(new range[workers])
+      , workers_{workers} {}
+
+  void reset(std::size_t count) {
+    for (std::size_t w = 0; w < workers_; ++w) {
+      ranges_[w].bounds.store(pack(count * w / workers_,
+                                   count * (w + 1) / workers_),
+                              std::memory_order_relaxed);
+    }
+  }
+
+  bool next(std::size_t worker, std::size_t& task) {
+    auto& own = ranges_[worker].bounds;
+    auto b = own.load(std::memory_order_relaxed);
+    while (lo(b) < hi(b)) {
+      if (own.compare_exchange_weak(b, pack(lo(b) + 1, hi(b)),
+                                    std::memory_order_relaxed)) {
+        task = lo(b);
+        return true;
+      }
+    }
+    return steal(worker, task);
+  }
+
+ private:
+  using bounds_type = std::uint64_t;
+
+  struct range {
+    std::atomic<bounds_type> bounds;
+    // keep the ranges of different workers in different cache lines
+    char pad[LIBEMB_CACHE_LINE_SIZE > sizeof(bounds_type)
+                 ? LIBEMB_CACHE_LINE_SIZE - sizeof(bounds_type)
+                 : 1];
+  };
+
+  static bounds_type pack(std::size_t lo, std::size_t hi) {
+    return static_cast<bounds_type>(lo) << 32 | static_cast<bounds_type>(hi);
+  }
+
+  static std::size_t lo(bounds_type b) {
+    return static_cast<std::size_t>(b >> 32);
+  }
+
+  static std::size_t hi(bounds_type b) {
+    return static_cast<std::size_t>(b & 0xFFFFFFFFu);
+  }
+
+  bool steal(std::size_t worker, std::size_t& task) {
+    for (;;) {
+      std::size_t victim = workers_;
+      bounds_type vb = 0;
+      std::size_t most = 0;
+
+      for (std::size_t w = 0; w < workers_; ++w) {
+        if (w != worker) {
+          auto const b = ranges_[w].bounds.load(std::memory_order_relaxed);
+          if (hi(b) > lo(b) && hi(b) - lo(b) > most) {
+            victim = w;
+            vb = b;
+            most = hi(b) - lo(b);
+          }
+        }
+      }
+
+      if (victim == workers_) {
+        return false;
+      }
+
+      // take the back half, rounded up, and keep all but the first task
+      auto const split = hi(vb) - (most + 1) / 2;
+      if (ranges_[victim].bounds.compare_exchange_strong(
+              vb, pack(lo(vb), split), std::memory_order_relaxed)) {
+        ranges_[worker].bounds.store(pack(split + 1, hi(vb)),
+                                     std::memory_order_relaxed);
+        task = split;
+        return true;
+      }
+    }
+  }
+
+  std::unique_ptr<range[]> ranges_;
+  std::size_t const workers_;
+};
+
+/**
+ * Persistent pool of worker threads
+ *
+ * `run(job)` calls `job(w)` once for each worker index `w` in
+ * `[0, size())` and returns after all calls have returned. Worker 0 is
+ * the calling thread.
+ */
+class worker_pool {
+ public:
+  using job_type = function_ref<void(std::size_t)>;
+
+  explicit worker_pool(std::size_t workers) {
+    for (std::size_t w = 1; w < std::max<std::size_t>(workers, 1); ++w) {
+      threads_.emplace_back([this, w] { loop(w); });
+    }
+  }
+
+  worker_pool(worker_pool const&) = delete;
+  worker_pool& operator=(worker_pool const&) = delete;
+
+  ~worker_pool() {
+    {
+      std::lock_guard<std::mutex> lock(mx_);
+      stop_ = true;
+    }
+    start_.notify_all();
+    for (auto& t : threads_) {
+      t.join();
+    }
+  }
+
+  std::size_t size() const { return threads_.size() + 1; }
+
+  void run(job_type job) {
+    {
+      std::lock_guard<std::mutex> lock(mx_);
+      job_ = &job;
+      pending_ = threads_.size();
+      ++generation_;
+    }
+    start_.notify_all();
+
+    job(0);
+
+    std::unique_lock<std::mutex> lock(mx_);
+    done_.wait(lock, [this] { return pending_ == 0; });
+    job_ = nullptr;
+  }
+
+ private:
+  void loop(std::size_t worker) {
+    std::uint64_t seen = 0;
+    for (;;) {
+      job_type* job;
+      {
+        std::unique_lock<std::mutex> lock(mx_);
+        start_.wait(lock, [&] { return stop_ || generation_ != seen; });
+        if (stop_) {
+          return;
+        }
+        seen = generation_;
+        job = job_;
+      }
+
+      (*job)(worker);
+
+      std::lock_guard<std::mutex> lock(mx_);
+      if (--pending_ == 0) {
+        done_.notify_one();
+      }
+    }
+  }
+
+  std::vector<std::thread> threads_;
+  std::mutex mx_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  job_type* job_{nullptr};
+  std::size_t pending_{0};
+  std::uint64_t generation_{0};
+  bool stop_{false};
+};
+
+} // namespace detail
+} // namespace signal
+} // namespace embedded
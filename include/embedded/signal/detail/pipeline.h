@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "../../type_traits/void_t.h"
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace signal {
+namespace detail {
+
+template <typename S, typename = void>
+struct pipeline_output_type {
+  using type = typename S::value_type;
+};
+
+template <typename S>
+struct pipeline_output_type<
+    S, embedded::detail::void_t<typename S::output_type>> {
+  using type = typename S::output_type;
+};
+
+// Stages without `max_output()` produce one output per input.
+template <typename S, typename = void>
+struct pipeline_rate {
+  static constexpr bool changes_rate = false;
+
+  static constexpr std::size_t max_output(std::size_t n) noexcept {
+    return n;
+  }
+};
+
+template <typename S>
+struct pipeline_rate<
+    S, embedded::detail::void_t<decltype(S::max_output(std::size_t{}))>> {
+  static constexpr bool changes_rate = true;
+
+  static constexpr std::size_t max_output(std::size_t n) noexcept {
+    return S::max_output(n);
+  }
+};
+
+template <typename S, typename T, typename = void>
+struct pipeline_has_in_place : std::false_type {};
+
+template <typename S, typename T>
+struct pipeline_has_in_place<
+    S, T,
+    embedded::detail::void_t<decltype(std::declval<S&>().process(
+        std::declval<T*>(), std::size_t{}))>> : std::true_type {};
+
+/**
+ * How a pipeline uses a stage
+ *
+ * A stage provides `value_type` (its input type) and
+ * `process(value_type const* in, Out* out, std::size_t n)`, which returns
+ * either `void` for one output per input, or the number of outputs. `Out`
+ * is the `value_type` of the next stage, or `output_type` (defaulting to
+ * `value_type`) for the last one. Stages changing the rate provide a
+ * static `max_output(n)`. Stages keeping both rate and type that provide
+ * `process(value_type* data, std::size_t n)` are run in place.
+ */
+template <typename S>
+struct pipeline_stage_traits : pipeline_rate<S> {
+  using input_type = typename S::value_type;
+  using output_type = typename pipeline_output_type<S>::type;
+
+  template <typename Out>
+  using in_place = std::integral_constant<
+      bool, std::is_same<input_type, Out>::value &&
+                !pipeline_rate<S>::changes_rate &&
+                pipeline_has_in_place<S, input_type>::value>;
+
+  template <typename Out>
+  static std::size_t
+  process(S& s, input_type const* in, Out* out, std::size_t n) {
+    return call(s, in, out, n,
+                std::is_void<decltype(s.process(in, out, n))>{});
+  }
+
+  static std::size_t process(S& s, input_type* data, std::size_t n) {
+    s.process(data, n);
+    return n;
+  }
+
+ private:
+  template <typename Out>
+  static std::size_t
+  call(S& s, input_type const* in, Out* out, std::size_t n, std::true_type) {
+    s.process(in, out, n);
+    return n;
+  }
+
+  template <typename Out>
+  static std::size_t
+  call(S& s, input_type const* in, Out* out, std::size_t n, std::false_type) {
+    return s.process(in, out, n);
+  }
+};
+
+template <std::size_t I, typename... Stages>
+struct pipeline_stage_type;
+
+template <typename S, typename... Rest>
+struct pipeline_stage_type<0, S, Rest...> {
+  using type = S;
+};
+
+template <std::size_t I, typename S, typename... Rest>
+struct pipeline_stage_type<I, S, Rest...>
+    : pipeline_stage_type<I - 1, Rest...> {};
+
+template <std::size_t I>
+using pipeline_index = std::integral_constant<std::size_t, I>;
+
+// Runs the stages on at most `N` inputs. `Scratch` is true if the input
+// is a buffer owned by the pipeline, so the first stage may work in place.
+template <std::size_t N, bool Scratch, typename... Stages>
+class pipeline_chain;
+
+template <std::size_t N, bool Scratch, typename S>
+class pipeline_chain<N, Scratch, S> {
+  using traits = pipeline_stage_traits<S>;
+
+ public:
+  using input_type = typename traits::input_type;
+  using output_type = typename traits::output_type;
+
+  static constexpr std::size_t max_output() noexcept {
+    return traits::max_output(N);
+  }
+
+  static constexpr std::size_t buffer_bytes() noexcept { return 0; }
+
+  explicit pipeline_chain(S const& s)
+      : stage_(s) {}
+
+  std::size_t run(input_type const* in, std::size_t n, output_type* out) {
+    return traits::process(stage_, in, out, n);
+  }
+
+  S& get(pipeline_index<0>) { return stage_; }
+
+ private:
+  S stage_;
+};
+
+template <std::size_t N, bool Scratch, typename S, typename Next,
+          typename... Rest>
+class pipeline_chain<N, Scratch, S, Next, Rest...> {
+  using traits = pipeline_stage_traits<S>;
+  using next_input = typename pipeline_stage_traits<Next>::input_type;
+
+  static constexpr bool in_place =
+      Scratch && traits::template in_place<next_input>::value;
+  static constexpr std::size_t M = traits::max_output(N);
+
+  using next_type = pipeline_chain<M, true, Next, Rest...>;
+  using input_pointer =
+      typename std::conditional<in_place, next_input*,
+                                typename traits::input_type const*>::type;
+
+ public:
+  using input_type = typename traits::input_type;
+  using output_type = typename next_type::output_type;
+
+  static constexpr std::size_t max_output() noexcept {
+    return next_type::max_output();
+  }
+
+  static constexpr std::size_t buffer_bytes() noexcept {
+    return (in_place ? 0 : M * sizeof(next_input)) +
+           next_type::buffer_bytes();
+  }
+
+  pipeline_chain(S const& s, Next const& next, Rest const&... rest)
+      : stage_(s)
+      , next_(next, rest...) {}
+
+  std::size_t run(input_pointer in, std::size_t n, output_type* out) {
+    return run(in, n, out, std::integral_constant<bool, in_place>{});
+  }
+
+  S& get(pipeline_index<0>) { return stage_; }
+
+  template <std::size_t I>
+  auto get(pipeline_index<I>) ->
+      typename pipeline_stage_type<I, S, Next, Rest...>::type& {
+    return next_.get(pipeline_index<I - 1>{});
+  }
+
+ private:
+  std::size_t
+  run(next_input* data, std::size_t n, output_type* out, std::true_type) {
+    return next_.run(data, traits::process(stage_, data, n), out);
+  }
+
+  std::size_t run(input_type const* in, std::size_t n, output_type* out,
+                  std::false_type) {
+    return next_.run(buf_.data(), traits::process(stage_, in, buf_.data(), n),
+                     out);
+  }
+
+  S stage_;
+  std::array<next_input, in_place ? 0 : M> buf_;
+  next_type next_;
+};
+
+} // namespace detail
+} // namespace signal
+} // namespace embedded
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+
+#include "../../constexpr_math.h"
+#include "simd.h"
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace signal {
+namespace detail {
+
+// Splits the prototype `h` into `L` phases of `K` taps each, stored one
+// after another. Each phase is scaled by `L` to make up for the zeros
+// inserted when upsampling, and reversed, so it can be applied to the
+// input samples oldest first.
+template <typename T, std::size_t Taps, std::size_t L, std::size_t K>
+class polyphase {
+ public:
+  constexpr polyphase(cmath::vector<T, Taps> const& h) noexcept
+      : h_{h} {}
+
+  constexpr auto operator()(std::size_t i) const noexcept -> T {
+    return tap(i / K, K - 1 - i % K);
+  }
+
+ private:
+  constexpr auto tap(std::size_t p, std::size_t k) const noexcept -> T {
+    return p + k * L < Taps ? T(L) * h_[p + k * L] : T{0};
+  }
+
+  cmath::vector<T, Taps> const h_;
+};
+
+// Computes `sum(h[k] * x[k])`, with `W` lanes of partial sums.
+template <typename F, std::size_t K, std::size_t W = simd<F>::width>
+struct resampler_dot {
+  using vec = simd<F>;
+  using vector_type = typename vec::type;
+
+  static constexpr std::size_t body{K - K % W};
+
+  static auto run(F const* h, F const* x) -> F {
+    vector_type acc = vec::broadcast(F{0});
+    for (std::size_t k = 0; k < body; k += W) {
+      acc += vec::load(h + k) * vec::load(x + k);
+    }
+    F lanes[W];
+    vec::store(lanes, acc);
+    F sum{0};
+    for (std::size_t i = 0; i < W; ++i) {
+      sum += lanes[i];
+    }
+    for (std::size_t k = body; k < K; ++k) {
+      sum += h[k] * x[k];
+    }
+    return sum;
+  }
+};
+
+template <typename F, std::size_t K>
+struct resampler_dot<F, K, 1> {
+  static auto run(F const* h, F const* x) -> F {
+    F sum{0};
+    for (std::size_t k = 0; k < K; ++k) {
+      sum += h[k] * x[k];
+    }
+    return sum;
+  }
+};
+
+} // namespace detail
+} // namespace signal
+} // namespace embedded
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+#include "../../config.h"
+
+namespace embedded {
+namespace signal {
+namespace detail {
+
+/**
+ * Minimal portable SIMD abstraction
+ *
+ * `simd<T>::width` is the number of lanes of type `T` that fit in a
+ * SIMD register, or 1 if there's no vector support for `T`. Kernels are
+ * expected to process `width` elements at a time using `type`, and to
+ * fall back to scalar code for the remainder.
+ */
+template <typename T>
+struct simd {
+  static constexpr std::size_t width = 1;
+};
+
+#if LIBEMB_SIMD_BYTES > 0
+
+template <typename T, typename V>
+struct simd_vector {
+  using type = V;
+
+  static constexpr std::size_t width = sizeof(V) / sizeof(T);
+
+  static type load(T const* p) noexcept {
+    type v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+  }
+
+  static void store(T* p, type const& v) noexcept {
+    std::memcpy(p, &v, sizeof(v));
+  }
+
+  static type broadcast(T x) noexcept { return type{} + x; }
+};
+
+typedef float simd_float_t __attribute__((vector_size(LIBEMB_SIMD_BYTES)));
+
+template <>
+struct simd<float> : simd_vector<float, simd_float_t> {};
+
+#if defined(__SSE2__) || defined(__aarch64__)
+typedef double simd_double_t __attribute__((vector_size(LIBEMB_SIMD_BYTES)));
+
+template <>
+struct simd<double> : simd_vector<double, simd_double_t> {};
+#endif
+
+#endif
+
+} // namespace detail
+} // namespace signal
+} // namespace embedded
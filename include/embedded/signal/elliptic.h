@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+
+#include "detail/elliptic.h"
+#include "detail/filter.h"
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace signal {
+
+/**
+ * Elliptic (Cauer) filter prototype
+ *
+ * Equiripple in both bands, with a maximum passband ripple of `rp` dB and
+ * a minimum stopband attenuation of `rs` dB. The passband edge is at the
+ * cutoff frequency, like for Chebyshev type I filters.
+ */
+template <std::size_t Order, typename PF = double>
+class elliptic {
+ public:
+  static_assert(Order > 0, "Filter order must be non-zero");
+
+  static constexpr auto order() noexcept -> std::size_t { return Order; }
+
+  constexpr elliptic(PF rp, PF rs) noexcept
+      : rp_{rp}
+      , rs_{rs} {}
+
+  template <typename F>
+  class specification {
+   public:
+    using value_type = F;
+    using prototype_type = detail::elliptic_prototype<value_type, Order>;
+    static constexpr std::size_t Zn = prototype_type::Zn;
+
+    constexpr specification(PF rp, PF rs) noexcept
+        : rf_{value_type(cmath::sqrt(cmath::pow(PF{10}, PF{0.1} * rp) - PF{1}))}
+        , proto_{value_type(cmath::pow(PF{10}, PF{0.1} * rp) - PF{1}),
+                 value_type((cmath::pow(PF{10}, PF{0.1} * rp) - PF{1}) /
+                            (cmath::pow(PF{10}, PF{0.1} * rs) - PF{1}))} {}
+
+    template <std::size_t N>
+    using carray = cmath::vector<cmath::complex<value_type>, N>;
+
+    constexpr auto zeros() const noexcept -> carray<Zn> {
+      return carray<Zn>::create(
+          detail::elliptic_zero<value_type, Order>(proto_));
+    }
+
+    constexpr auto poles() const noexcept -> carray<Order> {
+      return carray<Order>::create(
+          detail::elliptic_pole<value_type, Order>(proto_));
+    }
+
+    constexpr auto gain() const noexcept -> value_type {
+      return (prod(-poles()) / prod(-zeros())).real() *
+             proto_.gain_correction();
+    }
+
+    constexpr auto
+    zpk() const noexcept -> detail::zpk_value<Zn, Order, value_type> {
+      return detail::zpk_value<Zn, Order, value_type>(zeros(), poles(), gain());
+    }
+
+    constexpr auto rf() const noexcept -> value_type { return rf_; }
+
+    /**
+     * Stopband edge of the normalized prototype
+     */
+    constexpr auto stopband() const noexcept -> value_type {
+      return value_type{1} / cmath::sqrt(proto_.m());
+    }
+
+   private:
+    value_type rf_;
+    prototype_type proto_;
+  };
+
+  template <typename F>
+  constexpr auto spec() const noexcept -> specification<F> {
+    return specification<F>(rp_, rs_);
+  }
+
+ private:
+  PF const rp_;
+  PF const rs_;
+};
+
+} // namespace signal
+} // namespace embedded
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
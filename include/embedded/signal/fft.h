@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+
+#include "detail/fft.h"
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace signal {
+
+/**
+ * Fixed-size in-place FFT
+ *
+ * Computes the forward DFT `X[k] = sum(x[n] * exp(-2 * pi * j * k * n / N))`
+ * of `N` complex values, which are stored as interleaved real and
+ * imaginary parts. `N` must be a power of two.
+ *
+ * The twiddle factors and the bit reversal permutation are computed at
+ * compile time and stored in `static constexpr` tables, so they end up
+ * in flash and there's no initialization at runtime. The transform uses
+ * radix-4 stages, plus a single radix-2 stage if `N` isn't a power of
+ * four.
+ *
+ * `F` can be a floating point type or a fixed point type with a
+ * specialization of `fixed_point_traits` (e.g. `fpm::fixed` via
+ * `fpm.h`). For fixed point types, all sums are formed in the
+ * intermediate type and each radix-2 step scales by 1/2, so the output
+ * is `X / N` and can't overflow.
+ */
+template <typename F, std::size_t N>
+class fft {
+ public:
+  using value_type = F;
+
+  static constexpr std::size_t size() noexcept { return N; }
+
+  /**
+   * Transform the `N` complex values (`2 * N` items) at `data`
+   */
+  static void forward(value_type* data) {
+    detail::fft_kernel<F, N>::run(data);
+  }
+};
+
+/**
+ * Fixed-size in-place FFT of real input
+ *
+ * Computes the first half of the spectrum of `N` real values using a
+ * complex FFT of size `N / 2` followed by a split step. The result is
+ * stored in place as `N / 2` complex values, where the real and
+ * imaginary parts of the first one hold the (purely real) DC and Nyquist
+ * bins, respectively. The remaining bins follow from symmetry.
+ *
+ * As with `fft`, fixed point output is scaled by `1 / N`.
+ */
+template <typename F, std::size_t N>
+class real_fft {
+ public:
+  using value_type = F;
+
+  static constexpr std::size_t size() noexcept { return N; }
+
+  /**
+   * Transform the `N` real values at `data`
+   */
+  static void forward(value_type* data) {
+    detail::real_fft_kernel<F, N>::run(data);
+  }
+};
+
+} // namespace signal
+} // namespace embedded
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
@@ -26,6 +26,7 @@
 #include <cstddef>
 
 #include "detail/filter.h"
+#include "lookahead.h"
 #include "poly.h"
 #include "sos.h"
 
@@ -34,9 +35,6 @@
 // - return more properties from filter spec (frequency, sample rate, ...)
 // - documentation :-)
 // - bandpass, bandstop
-// - elliptic and bessel filters
-// - filter combinations (likely by simply joining poles/zeros)
-// - SOS gain optimisation for fixed-point arithmetic
 
 // clang-format off
 #ifdef __IAR_SYSTEMS_ICC__
@@ -55,6 +53,18 @@ class iirfilter {
   constexpr iirfilter(value_type fs) noexcept
       : fs_{fs} {}
 
+ private:
+  template <typename Family, typename Mask>
+  static constexpr auto selection() noexcept
+      -> decltype(Family::select(value_type{}, value_type{}, value_type{},
+                                 value_type{}, value_type{})) {
+    return Family::select(value_type(Mask::fs), value_type(Mask::fpass),
+                          value_type(Mask::fstop), value_type(Mask::gpass),
+                          value_type(Mask::gstop));
+  }
+
+ public:
+
   template <std::size_t Order>
   class design {
    public:
@@ -63,21 +73,72 @@ class iirfilter {
     constexpr design(zpk_value const& zpk) noexcept
         : zpk_{zpk} {}
 
+    constexpr auto zpk() const noexcept -> zpk_value const& { return zpk_; }
+
+    // Runs this filter followed by `other`, which must have been designed
+    // for the same sample rate. Joining the poles and zeros means the
+    // result can be paired into a single SOS cascade.
+    template <std::size_t Order2>
+    constexpr auto cascade(design<Order2> const& other) const noexcept
+        -> design<Order + Order2> {
+      return design<Order + Order2>(detail::zpk_value<Order + Order2,
+                                                       Order + Order2,
+                                                       value_type>(
+          zpk_.zeros().append(other.zpk().zeros()),
+          zpk_.poles().append(other.zpk().poles()),
+          zpk_.gain() * other.zpk().gain()));
+    }
+
     template <typename F>
     constexpr auto poly() const noexcept -> poly_design<F, Order> {
       return poly_design<F, Order>(zpk_);
     }
 
-    template <typename F>
+    template <typename F, typename Structure = sos_structure::df2t>
     constexpr auto sos(sos_gain mode = sos_gain::first_section) const noexcept
-        -> sos_design<F, Order> {
-      return sos_design<F, Order>(zpk_, mode);
+        -> sos_design<F, Order, Structure> {
+      return sos_design<F, Order, Structure>(zpk_, mode);
+    }
+
+    template <typename F, std::size_t M>
+    constexpr auto
+    lookahead(sos_gain mode = sos_gain::first_section) const noexcept
+        -> sos_lookahead_design<F, Order, M> {
+      return sos_lookahead_design<F, Order, M>(zpk_, mode);
     }
 
    private:
     zpk_value const zpk_;
   };
 
+  // A bank of `Count` designs for cutoff frequencies evenly spaced from
+  // `fmin` to `fmax`, see `sos_design_bank`.
+  template <typename F, std::size_t Count,
+            typename Structure = sos_structure::df2t, typename C>
+  constexpr auto
+  lowpass_bank(C const& c, value_type fmin, value_type fmax,
+               sos_gain mode = sos_gain::first_section) const noexcept
+      -> sos_design_bank<F, C::order(), Count, Structure> {
+    return sos_design_bank<F, C::order(), Count, Structure>(
+        cmath::vector<sos_design<F, C::order(), Structure>, Count>::create(
+            bank_design<C, F, Structure, false, Count>{*this, c, fmin, fmax,
+                                                       mode}),
+        fmin, fmax);
+  }
+
+  template <typename F, std::size_t Count,
+            typename Structure = sos_structure::df2t, typename C>
+  constexpr auto
+  highpass_bank(C const& c, value_type fmin, value_type fmax,
+                sos_gain mode = sos_gain::first_section) const noexcept
+      -> sos_design_bank<F, C::order(), Count, Structure> {
+    return sos_design_bank<F, C::order(), Count, Structure>(
+        cmath::vector<sos_design<F, C::order(), Structure>, Count>::create(
+            bank_design<C, F, Structure, true, Count>{*this, c, fmin, fmax,
+                                                      mode}),
+        fmin, fmax);
+  }
+
   template <typename C>
   constexpr auto
   lowpass(C const& c, value_type f) const noexcept -> design<C::order()> {
@@ -92,7 +153,65 @@ class iirfilter {
         highpass_zpk(c.template spec<value_type>().zpk(), warp(f))));
   }
 
+  // Smallest design of `Family` (see `order.h`) that meets the tolerance
+  // mask `Mask`. The mask is a type with static constexpr members `fs`,
+  // `fpass`, `fstop`, `gpass` and `gstop`, in the same units as for
+  // `buttord`.
+  template <typename Family, typename Mask>
+  static constexpr auto lowpass_spec() noexcept
+      -> design<selection<Family, Mask>().order> {
+    static_assert(Mask::fpass < Mask::fstop, "lowpass mask");
+    static_assert(Mask::fstop < Mask::fs / 2, "stopband above Nyquist");
+    return iirfilter(value_type(Mask::fs))
+        .lowpass(Family::template prototype<selection<Family, Mask>().order>(
+                     value_type(Mask::gpass), value_type(Mask::gstop)),
+                 selection<Family, Mask>().frequency);
+  }
+
+  template <typename Family, typename Mask>
+  static constexpr auto highpass_spec() noexcept
+      -> design<selection<Family, Mask>().order> {
+    static_assert(Mask::fstop < Mask::fpass, "highpass mask");
+    static_assert(Mask::fpass < Mask::fs / 2, "passband above Nyquist");
+    return iirfilter(value_type(Mask::fs))
+        .highpass(Family::template prototype<selection<Family, Mask>().order>(
+                      value_type(Mask::gpass), value_type(Mask::gstop)),
+                  selection<Family, Mask>().frequency);
+  }
+
  private:
+  template <typename C, typename F, typename Structure, bool Highpass,
+            std::size_t Count>
+  class bank_design {
+   public:
+    constexpr bank_design(iirfilter const& iir, C const& c, value_type fmin,
+                          value_type fmax, sos_gain mode) noexcept
+        : iir_{iir}
+        , c_{c}
+        , fmin_{fmin}
+        , step_{(fmax - fmin) / (Count - 1)}
+        , mode_{mode} {}
+
+    constexpr auto operator()(std::size_t i) const noexcept
+        -> sos_design<F, C::order(), Structure> {
+      return Highpass ? iir_.highpass(c_, frequency(i))
+                            .template sos<F, Structure>(mode_)
+                      : iir_.lowpass(c_, frequency(i))
+                            .template sos<F, Structure>(mode_);
+    }
+
+   private:
+    constexpr auto frequency(std::size_t i) const noexcept -> value_type {
+      return fmin_ + step_ * static_cast<value_type>(i);
+    }
+
+    iirfilter const iir_;
+    C const c_;
+    value_type const fmin_;
+    value_type const step_;
+    sos_gain const mode_;
+  };
+
   constexpr value_type warp(value_type f) const noexcept {
     return detail::warp_frequency<value_type>(2.0 * f / fs_, 2.0);
   }
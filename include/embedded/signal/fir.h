@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#include "../constexpr_math.h"
+#include "../utility/integer_sequence.h"
+#include "detail/fir.h"
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace signal {
+
+template <std::size_t Taps>
+class rectangular {
+ public:
+  static_assert(Taps > 0, "Number of taps must be non-zero");
+
+  static constexpr auto taps() noexcept -> std::size_t { return Taps; }
+
+  template <typename F>
+  constexpr auto value(std::size_t) const noexcept -> F {
+    return F{1};
+  }
+};
+
+template <std::size_t Taps>
+class hann {
+ public:
+  static_assert(Taps > 0, "Number of taps must be non-zero");
+
+  static constexpr auto taps() noexcept -> std::size_t { return Taps; }
+
+  template <typename F>
+  constexpr auto value(std::size_t n) const noexcept -> F {
+    return detail::cosine_window<Taps>(n, F{0.5}, F{0.5}, F{0});
+  }
+};
+
+template <std::size_t Taps>
+class hamming {
+ public:
+  static_assert(Taps > 0, "Number of taps must be non-zero");
+
+  static constexpr auto taps() noexcept -> std::size_t { return Taps; }
+
+  template <typename F>
+  constexpr auto value(std::size_t n) const noexcept -> F {
+    return detail::cosine_window<Taps>(n, F{0.54}, F{0.46}, F{0});
+  }
+};
+
+template <std::size_t Taps>
+class blackman {
+ public:
+  static_assert(Taps > 0, "Number of taps must be non-zero");
+
+  static constexpr auto taps() noexcept -> std::size_t { return Taps; }
+
+  template <typename F>
+  constexpr auto value(std::size_t n) const noexcept -> F {
+    return detail::cosine_window<Taps>(n, F{0.42}, F{0.5}, F{0.08});
+  }
+};
+
+template <typename F, std::size_t Taps, std::size_t Block>
+class fir_instance;
+
+template <typename F, std::size_t L, std::size_t M, std::size_t K>
+class resampler_design;
+
+template <typename F, std::size_t Taps>
+class fir_design {
+ public:
+  using value_type = F;
+  using tarray = cmath::vector<F, Taps>;
+
+  template <typename F2>
+  constexpr fir_design(cmath::vector<F2, Taps> const& h) noexcept
+      : h_{h}
+      , symmetric_{detail::fir_symmetric<F, Taps>{}(h_)} {}
+
+  static constexpr std::size_t order() noexcept { return Taps - 1; }
+  static constexpr std::size_t taps() noexcept { return Taps; }
+
+  constexpr auto b() const noexcept -> tarray const& { return h_; }
+
+  constexpr bool symmetric() const noexcept { return symmetric_; }
+
+  // Computes `n` outputs from the `Taps - 1 + n` input samples at `x`,
+  // oldest first.
+  void filter(value_type const* x, value_type* y, std::size_t n) const {
+    value_type const* h = &h_[0];
+    if (symmetric_) {
+      detail::fir_block<value_type, Taps, true>(h, x, y, n);
+    } else {
+      detail::fir_block<value_type, Taps, false>(h, x, y, n);
+    }
+  }
+
+  template <std::size_t Block = 32>
+  constexpr auto instance() const noexcept -> fir_instance<F, Taps, Block> {
+    return fir_instance<F, Taps, Block>{this};
+  }
+
+ private:
+  tarray const h_;
+  bool const symmetric_;
+};
+
+/**
+ * FIR filter instance
+ *
+ * Input samples are collected in a linear buffer behind the last
+ * `Taps - 1` samples, so the convolution kernel never has to deal with
+ * wrap-around. Once `Block` samples have been collected, the history is
+ * moved back to the start of the buffer.
+ */
+template <typename F, std::size_t Taps, std::size_t Block>
+class fir_instance {
+ public:
+  static_assert(Block > 0, "Block size must be non-zero");
+
+  using value_type = F;
+
+  fir_instance(fir_design<F, Taps> const* i) noexcept
+      : impl_{i} {}
+
+  value_type operator()(value_type x) {
+    value_type y;
+    process(&x, &y, 1);
+    return y;
+  }
+
+  void process(value_type const* in, value_type* out, std::size_t n) {
+    while (n > 0) {
+      std::size_t const count = std::min(n, buf_.size() - pos_);
+      std::copy(in, in + count, buf_.begin() + pos_);
+      impl_->filter(&buf_[pos_ - history], out, count);
+      pos_ += count;
+      in += count;
+      out += count;
+      n -= count;
+      if (pos_ == buf_.size()) {
+        std::copy(buf_.end() - history, buf_.end(), buf_.begin());
+        pos_ = history;
+      }
+    }
+  }
+
+  void process(value_type* data, std::size_t n) { process(data, data, n); }
+
+ private:
+  static constexpr std::size_t history{Taps - 1};
+
+  fir_design<F, Taps> const* impl_;
+  std::array<value_type, history + Block> buf_{};
+  std::size_t pos_{history};
+};
+
+template <typename T = double>
+class firfilter {
+ public:
+  using value_type = T;
+
+  constexpr firfilter(value_type fs) noexcept
+      : fs_{fs} {}
+
+  template <std::size_t Taps>
+  class design {
+   public:
+    using tarray = cmath::vector<value_type, Taps>;
+
+    constexpr design(tarray const& h) noexcept
+        : h_{h} {}
+
+    constexpr auto taps() const noexcept -> tarray const& { return h_; }
+
+    template <typename F>
+    constexpr auto fir() const noexcept -> fir_design<F, Taps> {
+      return fir_design<F, Taps>(h_);
+    }
+
+    // Polyphase resampler by a factor of `L / M` using this filter as
+    // prototype, which must be designed for `L` times the input sample
+    // rate. Requires `resampler.h`.
+    template <typename F, std::size_t L, std::size_t M>
+    constexpr auto resampler() const noexcept
+        -> resampler_design<F, L, M, (Taps + L - 1) / L> {
+      return resampler_design<F, L, M, (Taps + L - 1) / L>(h_);
+    }
+
+    // Runs this filter followed by `other`.
+    template <std::size_t Taps2>
+    constexpr auto cascade(design<Taps2> const& other) const noexcept
+        -> design<Taps + Taps2 - 1> {
+      return design<Taps + Taps2 - 1>(cmath::convolve_full(h_, other.taps()));
+    }
+
+   private:
+    tarray const h_;
+  };
+
+  // Windowed-sinc lowpass, normalized to unity gain at DC.
+  template <typename W>
+  constexpr auto
+  lowpass(W const& w, value_type f) const noexcept -> design<W::taps()> {
+    return design<W::taps()>(normalize(cmath::make_vector<value_type>(
+        detail::windowed_sinc<value_type, W>(w, f / fs_),
+        make_index_sequence<W::taps()>{})));
+  }
+
+  // Spectral inversion of the windowed-sinc lowpass.
+  template <typename W>
+  constexpr auto
+  highpass(W const& w, value_type f) const noexcept -> design<W::taps()> {
+    static_assert(W::taps() % 2 != 0,
+                  "highpass filters need an odd number of taps");
+    return design<W::taps()>(cmath::make_vector<value_type>(
+        detail::spectral_inversion<value_type, W::taps()>(
+            lowpass(w, f).taps()),
+        make_index_sequence<W::taps()>{}));
+  }
+
+  // Lowpass compensating the passband droop of a CIC filter (see `cic.h`)
+  // with the given order, rate and differential delay, to be run at the
+  // low rate of the CIC filter. Normalized to unity gain at DC.
+  template <std::size_t Order, std::size_t Rate, std::size_t Delay = 1,
+            typename W>
+  constexpr auto cic_compensator(W const& w, value_type f) const noexcept
+      -> design<W::taps()> {
+    return design<W::taps()>(normalize(cmath::make_vector<value_type>(
+        detail::cic_compensation<value_type, W, Order, Rate, Delay>(w,
+                                                                   f / fs_),
+        make_index_sequence<W::taps()>{})));
+  }
+
+ private:
+  template <std::size_t Taps>
+  static constexpr auto
+  normalize(cmath::vector<value_type, Taps> const& h) noexcept
+      -> cmath::vector<value_type, Taps> {
+    return h / cmath::sum(h);
+  }
+
+  value_type fs_;
+};
+
+} // namespace signal
+} // namespace embedded
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "sos.h"
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace signal {
+
+/**
+ * Access to the raw representation of a fixed point type
+ *
+ * Specialize this for a fixed point type `T` to use it with the
+ * `sos_structure::df1_wide` structure. A specialization must provide:
+ *
+ * - `base_type`, the integer type of the raw value,
+ * - `intermediate_type`, a wider integer type for accumulation,
+ * - `fraction_bits`, the number of fractional bits of the raw value,
+ * - `raw(T)` and `from_raw(base_type)` to convert between both.
+ *
+ * See `fpm.h` for a specialization for `fpm::fixed`.
+ */
+template <typename T>
+struct fixed_point_traits;
+
+template <typename F>
+struct sos_df1_wide_state {
+  using base_type = typename fixed_point_traits<F>::base_type;
+  using intermediate_type = typename fixed_point_traits<F>::intermediate_type;
+
+  base_type x1{}, x2{}, y1{}, y2{};
+  intermediate_type e{};
+};
+
+template <typename F>
+struct sos_state_peak<sos_df1_wide_state<F>> {
+  static auto peak(sos_df1_wide_state<F> const& s) -> F {
+    using traits = fixed_point_traits<F>;
+    return detail::max_magnitude(traits::from_raw(s.x1), traits::from_raw(s.x2),
+                                 traits::from_raw(s.y1),
+                                 traits::from_raw(s.y2));
+  }
+};
+
+/**
+ * Direct Form I section for fixed point types
+ *
+ * All products are accumulated in `intermediate_type` at full precision
+ * and the sum is only shifted back to `base_type` once per section,
+ * which maps onto a chain of multiply-accumulate instructions (e.g.
+ * SMLAL on Cortex-M4/M7 for a 32-bit base and 64-bit intermediate
+ * type).
+ *
+ * Without error feedback, the sum is rounded to nearest. With error
+ * feedback, the bits lost in the shift are added to the next sum, which
+ * shapes the quantization noise away from low frequencies.
+ */
+template <typename F, bool ErrorFeedback = false>
+class sos_df1_wide_section : public detail::sos_coefficients<F> {
+ public:
+  using value_type = F;
+  using state_type = sos_df1_wide_state<value_type>;
+  using traits = fixed_point_traits<value_type>;
+  using base_type = typename traits::base_type;
+  using intermediate_type = typename traits::intermediate_type;
+
+  using detail::sos_coefficients<F>::sos_coefficients;
+
+  value_type filter(state_type& state, value_type x) const {
+    base_type const xr = traits::raw(x);
+    base_type const y = quantize(
+        state.e, mac(b0_, xr) + mac(b1_, state.x1) + mac(b2_, state.x2) -
+                     mac(a1_, state.y1) - mac(a2_, state.y2));
+    state.x2 = state.x1;
+    state.x1 = xr;
+    state.y2 = state.y1;
+    state.y1 = y;
+    return traits::from_raw(y);
+  }
+
+  void filter(state_type& state, value_type const* in, value_type* out,
+              std::size_t n) const {
+    base_type x1 = state.x1;
+    base_type x2 = state.x2;
+    base_type y1 = state.y1;
+    base_type y2 = state.y2;
+    intermediate_type e = state.e;
+    for (std::size_t i = 0; i < n; ++i) {
+      base_type const x = traits::raw(in[i]);
+      base_type const y = quantize(e, mac(b0_, x) + mac(b1_, x1) +
+                                          mac(b2_, x2) - mac(a1_, y1) -
+                                          mac(a2_, y2));
+      x2 = x1;
+      x1 = x;
+      y2 = y1;
+      y1 = y;
+      out[i] = traits::from_raw(y);
+    }
+    state.x1 = x1;
+    state.x2 = x2;
+    state.y1 = y1;
+    state.y2 = y2;
+    state.e = e;
+  }
+
+ private:
+  using detail::sos_coefficients<F>::b0_;
+  using detail::sos_coefficients<F>::b1_;
+  using detail::sos_coefficients<F>::b2_;
+  using detail::sos_coefficients<F>::a1_;
+  using detail::sos_coefficients<F>::a2_;
+
+  static constexpr intermediate_type one() noexcept {
+    return intermediate_type{1} << traits::fraction_bits;
+  }
+
+  static intermediate_type mac(value_type c, base_type v) {
+    return static_cast<intermediate_type>(traits::raw(c)) * v;
+  }
+
+  static base_type quantize(intermediate_type& e, intermediate_type acc) {
+    if (ErrorFeedback) {
+      acc += e;
+      // arithmetic shift, rounds towards negative infinity
+      auto const y = static_cast<base_type>(acc >> traits::fraction_bits);
+      e = acc - one() * y;
+      return y;
+    }
+    return static_cast<base_type>((acc + one() / 2) >> traits::fraction_bits);
+  }
+};
+
+namespace sos_structure {
+
+/**
+ * Direct Form I with a wide accumulator for fixed point types
+ *
+ * Requires a specialization of `fixed_point_traits` for the value type.
+ */
+template <bool ErrorFeedback = false>
+struct df1_wide {
+  template <typename F>
+  using section = sos_df1_wide_section<F, ErrorFeedback>;
+};
+
+} // namespace sos_structure
+
+} // namespace signal
+} // namespace embedded
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#include "../constexpr_math.h"
+#include "../utility/integer_sequence.h"
+#include "detail/goertzel.h"
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace signal {
+
+/**
+ * Bank of Goertzel detectors
+ *
+ * Computes the DFT of blocks of `length()` samples at `Bins` arbitrary
+ * frequencies, which is much cheaper than a full FFT if only a handful
+ * of frequencies are of interest (e.g. DTMF tones). Each bin is a
+ * second order resonator that only needs a single multiplication per
+ * sample. The state of all bins is kept in separate arrays, so `process()`
+ * updates several bins at once using SIMD where available.
+ *
+ * Feed samples using `process()` until `ready()` returns `true`, read
+ * the results using `power()` or `result()` and start the next block
+ * using `reset()`.
+ */
+template <typename F, std::size_t Bins>
+class goertzel_bank {
+ public:
+  static_assert(Bins > 0, "Number of bins must be non-zero");
+
+  using value_type = F;
+
+  template <typename T>
+  constexpr goertzel_bank(cmath::vector<T, Bins> const& omega,
+                          std::size_t length) noexcept
+      : goertzel_bank{omega, length, make_index_sequence<Bins>{}} {}
+
+  static constexpr std::size_t bins() noexcept { return Bins; }
+
+  constexpr std::size_t length() const noexcept { return length_; }
+
+  /**
+   * Number of samples processed in the current block
+   */
+  constexpr std::size_t count() const noexcept { return count_; }
+
+  constexpr bool ready() const noexcept { return count_ == length_; }
+
+  /**
+   * Process up to `n` samples, but not beyond the end of the block
+   *
+   * \returns Number of samples processed.
+   */
+  std::size_t process(value_type const* x, std::size_t n) {
+    n = std::min(n, length_ - count_);
+    detail::goertzel_update(coef_.data(), s1_.data(), s2_.data(), Bins, x,
+                            n);
+    count_ += n;
+    return n;
+  }
+
+  /**
+   * Squared magnitude of the DFT of the current block for each bin
+   *
+   * This is computed from the real and imaginary parts rather than
+   * directly from the state, which suffers from cancellation for bins
+   * close to DC.
+   */
+  void power(value_type* out) const {
+    for (std::size_t b = 0; b < Bins; ++b) {
+      value_type const re = s1_[b] - cos_[b] * s2_[b];
+      value_type const im = sin_[b] * s2_[b];
+      out[b] = re * re + im * im;
+    }
+  }
+
+  /**
+   * DFT of the current block for bin `b`
+   *
+   * The phase is relative to the last sample of the block rather than
+   * the first, i.e. the result is `exp(j * omega * (count() - 1))` times
+   * the DFT.
+   */
+  auto result(std::size_t b) const -> cmath::complex<value_type> {
+    return cmath::complex<value_type>(s1_[b] - cos_[b] * s2_[b],
+                                      sin_[b] * s2_[b]);
+  }
+
+  void reset() {
+    s1_.fill(value_type{0});
+    s2_.fill(value_type{0});
+    count_ = 0;
+  }
+
+ private:
+  using farray = std::array<value_type, Bins>;
+
+  template <typename T, std::size_t... I>
+  constexpr goertzel_bank(cmath::vector<T, Bins> const& omega,
+                          std::size_t length, index_sequence<I...>) noexcept
+      : coef_{{static_cast<value_type>(T{2} * cmath::cos(omega[I]))...}}
+      , cos_{{static_cast<value_type>(cmath::cos(omega[I]))...}}
+      , sin_{{static_cast<value_type>(cmath::sin(omega[I]))...}}
+      , length_{length} {}
+
+  farray coef_;
+  farray cos_;
+  farray sin_;
+  farray s1_{};
+  farray s2_{};
+  std::size_t length_;
+  std::size_t count_{0};
+};
+
+/**
+ * Bank of sliding Goertzel detectors (recursive DFT)
+ *
+ * Computes the DFT of the most recent `length()` samples after every
+ * sample, at a cost of four multiplications per bin and sample. Each
+ * bin keeps a complex sum that is rotated by `z = r * exp(j * omega)`
+ * for every sample, while the sample leaving the window is subtracted
+ * with a weight of `z^N`. For `r == 1` this is an exact DFT of the
+ * window, but rounding errors are never forgotten. A damping factor `r`
+ * slightly below one makes them decay, at the expense of a slightly
+ * exponentially weighted window.
+ *
+ * As with `fir_design::filter()`, the caller provides the window
+ * history, so the bank itself doesn't need a delay line.
+ */
+template <typename F, std::size_t Bins>
+class sliding_goertzel_bank {
+ public:
+  static_assert(Bins > 0, "Number of bins must be non-zero");
+
+  using value_type = F;
+
+  template <typename T>
+  constexpr sliding_goertzel_bank(cmath::vector<T, Bins> const& omega,
+                                  std::size_t length, T r) noexcept
+      : sliding_goertzel_bank{omega, length, r,
+                              make_index_sequence<Bins>{}} {}
+
+  static constexpr std::size_t bins() noexcept { return Bins; }
+
+  constexpr std::size_t length() const noexcept { return length_; }
+
+  /**
+   * Slide the window by `n` samples
+   *
+   * \param x  Pointer to `length() + n` input samples, oldest first.
+   *           The first `n` samples leave the window, the last `n`
+   *           samples enter it. Before the first call, the window is
+   *           assumed to contain only zeros.
+   */
+  void slide(value_type const* x, std::size_t n) {
+    detail::goertzel_slide(zr_.data(), zi_.data(), wr_.data(), wi_.data(),
+                           yr_.data(), yi_.data(), Bins, x, length_, n);
+  }
+
+  /**
+   * Squared magnitude of the DFT of the current window for each bin
+   */
+  void power(value_type* out) const {
+    for (std::size_t b = 0; b < Bins; ++b) {
+      out[b] = yr_[b] * yr_[b] + yi_[b] * yi_[b];
+    }
+  }
+
+  /**
+   * DFT of the current window for bin `b`
+   *
+   * As with `goertzel_bank::result()`, the phase is relative to the most
+   * recent sample.
+   */
+  auto result(std::size_t b) const -> cmath::complex<value_type> {
+    return cmath::complex<value_type>(yr_[b], yi_[b]);
+  }
+
+  void reset() {
+    yr_.fill(value_type{0});
+    yi_.fill(value_type{0});
+  }
+
+ private:
+  using farray = std::array<value_type, Bins>;
+
+  template <typename T, std::size_t... I>
+  constexpr sliding_goertzel_bank(cmath::vector<T, Bins> const& omega,
+                                  std::size_t length, T r,
+                                  index_sequence<I...>) noexcept
+      : zr_{{static_cast<value_type>(r * cmath::cos(omega[I]))...}}
+      , zi_{{static_cast<value_type>(r * cmath::sin(omega[I]))...}}
+      , wr_{{static_cast<value_type>(
+            cmath::pow(r, T(length)) * cmath::cos(T(length) * omega[I]))...}}
+      , wi_{{static_cast<value_type>(
+            cmath::pow(r, T(length)) * cmath::sin(T(length) * omega[I]))...}}
+      , length_{length} {}
+
+  farray zr_;
+  farray zi_;
+  farray wr_;
+  farray wi_;
+  farray yr_{};
+  farray yi_{};
+  std::size_t length_;
+};
+
+/**
+ * Compile-time design of Goertzel detector banks
+ *
+ * Example (DTMF detection at 8 kHz):
+ *
+ *     constexpr auto dtmf = signal::goertzel<>(8000).bins(
+ *         cmath::vector<double, 8>(697.0, 770.0, 852.0, 941.0, 1209.0,
+ *                                  1336.0, 1477.0, 1633.0),
+ *         205);
+ *
+ *     auto bank = dtmf.bank<float>();
+ */
+template <typename T = double>
+class goertzel {
+ public:
+  using value_type = T;
+
+  constexpr goertzel(value_type fs) noexcept
+      : fs_{fs} {}
+
+  template <std::size_t Bins>
+  class design {
+   public:
+    using farray = cmath::vector<value_type, Bins>;
+
+    constexpr design(farray const& omega, std::size_t length) noexcept
+        : omega_{omega}
+        , length_{length} {}
+
+    // Normalized angular frequencies in radians per sample
+    constexpr auto omega() const noexcept -> farray const& { return omega_; }
+
+    constexpr std::size_t length() const noexcept { return length_; }
+
+    template <typename F>
+    constexpr auto bank() const noexcept -> goertzel_bank<F, Bins> {
+      return goertzel_bank<F, Bins>(omega_, length_);
+    }
+
+    template <typename F>
+    constexpr auto sliding_bank(value_type r = value_type{1}) const noexcept
+        -> sliding_goertzel_bank<F, Bins> {
+      return sliding_goertzel_bank<F, Bins>(omega_, length_, r);
+    }
+
+   private:
+    farray const omega_;
+    std::size_t const length_;
+  };
+
+  // Bins at frequencies `f` for blocks (or windows) of `length` samples.
+  // The frequencies don't have to be multiples of `fs / length`.
+  template <std::size_t Bins>
+  constexpr auto
+  bins(cmath::vector<value_type, Bins> const& f,
+       std::size_t length) const noexcept -> design<Bins> {
+    return design<Bins>(
+        (value_type{2} * cmath::pi<value_type>() / fs_) * f, length);
+  }
+
+ private:
+  value_type fs_;
+};
+
+} // namespace signal
+} // namespace embedded
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
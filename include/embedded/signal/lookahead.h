@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "detail/lookahead.h"
+#include "sos.h"
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace signal {
+
+/**
+ * Block state space form of a second order section
+ *
+ * Computes `M` outputs of a transposed Direct Form II section at once
+ * from the `M` inputs and the state at the start of the block:
+ *
+ *   y = O s + T x,  s' = A^M s + K x
+ *
+ * where `T` is the lower triangular Toeplitz matrix of the impulse
+ * response. Each output block is a sum of columns scaled by a single
+ * value, which maps onto SIMD multiply-add instructions without any
+ * dependency between the lanes. This takes more operations per sample
+ * than the recursive form, so it only pays off if `M` is a multiple of
+ * the vector width.
+ *
+ * The state is the same as the state of `sos_section`.
+ */
+template <typename F, std::size_t M>
+class sos_lookahead_section {
+ public:
+  using value_type = F;
+  using state_type = sos_state<value_type>;
+
+  static_assert(M > 0, "block size must be at least one");
+
+  template <typename F2>
+  constexpr sos_lookahead_section(sos_section<F2> const& s) noexcept
+      : sos_lookahead_section(detail::df2t_state_space<F2>(s.b(), s.a())) {}
+
+  static constexpr std::size_t block_size() noexcept { return M; }
+
+  // Filter exactly M samples, `in` and `out` may be the same
+  void filter(state_type& state, value_type const* in,
+              value_type* out) const {
+    using lanes = detail::lookahead_lanes<value_type, M>;
+    value_type const s1 = state.y1;
+    value_type const s2 = state.y2;
+    value_type y[M];
+    value_type n1 = a11_ * s1 + a12_ * s2;
+    value_type n2 = a21_ * s1 + a22_ * s2;
+    lanes::scale(y, &observe_[0], s1);
+    lanes::axpy(y, &observe_[M], s2);
+    for (std::size_t j = 0; j < M; ++j) {
+      value_type const x = in[j];
+      lanes::axpy(y, &toeplitz_[j * M], x);
+      n1 += control_[j] * x;
+      n2 += control_[M + j] * x;
+    }
+    for (std::size_t i = 0; i < M; ++i) {
+      out[i] = y[i];
+    }
+    state.y1 = n1;
+    state.y2 = n2;
+  }
+
+ private:
+  template <typename F2>
+  constexpr sos_lookahead_section(
+      detail::df2t_state_space<F2> const& ss) noexcept
+      : toeplitz_{cmath::vector<F2, M * M>::create(
+            detail::lookahead_toeplitz<F2, M>{ss})}
+      , observe_{cmath::vector<F2, 2 * M>::create(
+            detail::lookahead_observe<F2, M>{ss})}
+      , control_{cmath::vector<F2, 2 * M>::create(
+            detail::lookahead_control<F2, M>{ss})}
+      , a11_(ss.transition(0, 0, M))
+      , a12_(ss.transition(0, 1, M))
+      , a21_(ss.transition(1, 0, M))
+      , a22_(ss.transition(1, 1, M)) {}
+
+  cmath::vector<value_type, M * M> const toeplitz_;
+  cmath::vector<value_type, 2 * M> const observe_;
+  cmath::vector<value_type, 2 * M> const control_;
+  value_type const a11_, a12_, a21_, a22_;
+};
+
+template <typename F, std::size_t N, std::size_t M>
+class sos_lookahead_instance;
+
+/**
+ * Look-ahead realization of an SOS design
+ *
+ * Holds the block state space form of each section (see
+ * `sos_lookahead_section`) as well as the regular transposed Direct
+ * Form II sections, which share the same state. The block matrices are
+ * derived in the design precision.
+ *
+ * A good choice for `M` is the SIMD width for `F`, or a small multiple
+ * of it, e.g. 4 or 8 for `float` with SSE or AVX.
+ */
+template <typename F, std::size_t N, std::size_t M>
+class sos_lookahead_design {
+ public:
+  static constexpr std::size_t sos_count{(N + 1) / 2};
+  using section_type = sos_section<F>;
+  using block_section_type = sos_lookahead_section<F, M>;
+  using state_type = typename section_type::state_type;
+  using sos_array = cmath::vector<section_type, sos_count>;
+  using block_array = cmath::vector<block_section_type, sos_count>;
+
+  template <typename F2>
+  constexpr sos_lookahead_design(detail::zpk_value<N, N, F2> const& zpk,
+                                 sos_gain mode) noexcept
+      : sos_{sos_design<F, N>::build_sos(zpk.even(), mode)}
+      , blocks_{sos_design<F2, N>::build_sos(zpk.even(), mode)} {}
+
+  static constexpr std::size_t order() noexcept { return N; }
+  static constexpr std::size_t size() noexcept { return sos_count; }
+  static constexpr std::size_t block_size() noexcept { return M; }
+
+  constexpr auto sos() const noexcept -> sos_array const& { return sos_; }
+
+  constexpr auto blocks() const noexcept -> block_array const& {
+    return blocks_;
+  }
+
+  constexpr auto instance() const noexcept
+      -> sos_lookahead_instance<F, N, M> {
+    return sos_lookahead_instance<F, N, M>{this};
+  }
+
+ private:
+  sos_array const sos_;
+  block_array const blocks_;
+};
+
+template <typename F, std::size_t N, std::size_t M>
+class sos_lookahead_instance {
+ public:
+  static constexpr std::size_t sos_count{(N + 1) / 2};
+  using value_type = F;
+  using design_type = sos_lookahead_design<value_type, N, M>;
+  using state_type = typename design_type::state_type;
+
+  sos_lookahead_instance(design_type const* i) noexcept
+      : impl_{i} {}
+
+  value_type operator()(value_type x) {
+    return detail::filter_chain<typename design_type::section_type,
+                                sos_count>{}(impl_->sos(), state_, x);
+  }
+
+  // Full blocks of M samples use the block form, the remaining samples
+  // are filtered one by one.
+  void process(value_type const* in, value_type* out, std::size_t n) {
+    auto const& blocks = impl_->blocks();
+    std::size_t i = 0;
+    for (; i + M <= n; i += M) {
+      blocks[0].filter(state_[0], in + i, out + i);
+      for (std::size_t k = 1; k < sos_count; ++k) {
+        blocks[k].filter(state_[k], out + i, out + i);
+      }
+    }
+    if (i < n) {
+      detail::filter_block(impl_->sos(), state_, in + i, out + i, n - i);
+    }
+  }
+
+  void process(value_type* data, std::size_t n) { process(data, data, n); }
+
+  auto state() const -> std::array<state_type, sos_count> const& {
+    return state_;
+  }
+
+ private:
+  design_type const* impl_;
+  std::array<state_type, sos_count> state_{};
+};
+
+} // namespace signal
+} // namespace embedded
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+
+#include "butterworth.h"
+#include "chebyshev.h"
+#include "detail/filter.h"
+#include "elliptic.h"
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace signal {
+
+/**
+ * Minimum filter order meeting a tolerance mask
+ *
+ * `frequency` is the cutoff frequency to pass to `iirfilter::lowpass` or
+ * `iirfilter::highpass` along with a prototype of the given order.
+ */
+template <typename T>
+struct order_selection {
+  std::size_t order;
+  T frequency;
+};
+
+namespace detail {
+
+// ratio of the prewarped stopband and passband edges, > 1 for both a
+// lowpass (fpass < fstop) and a highpass (fpass > fstop) mask
+template <typename T>
+constexpr auto selectivity(T fs, T fpass, T fstop) noexcept -> T {
+  return fpass < fstop ? warp_frequency(fstop, fs) / warp_frequency(fpass, fs)
+                       : warp_frequency(fpass, fs) / warp_frequency(fstop, fs);
+}
+
+template <typename T>
+constexpr auto attenuation_power(T g) noexcept -> T {
+  return cmath::pow(T{10}, T{0.1} * g) - T{1};
+}
+
+template <typename T>
+constexpr auto discrimination(T gpass, T gstop) noexcept -> T {
+  return attenuation_power(gstop) / attenuation_power(gpass);
+}
+
+template <typename T>
+constexpr auto ceil_order(T n) noexcept -> std::size_t {
+  return n > T{1} ? static_cast<std::size_t>(cmath::ceil(n)) : 1;
+}
+
+// scales the prewarped passband edge away from the passband by `scale`
+template <typename T>
+constexpr auto
+shift_frequency(T fs, T fpass, T fstop, T scale) noexcept -> T {
+  return unwarp_frequency(fpass < fstop ? warp_frequency(fpass, fs) * scale
+                                        : warp_frequency(fpass, fs) / scale,
+                          fs);
+}
+
+template <typename T>
+constexpr auto buttord(T fs, T fpass, T fstop, T gpass,
+                       std::size_t order) noexcept -> order_selection<T> {
+  return order_selection<T>{
+      order, shift_frequency(fs, fpass, fstop,
+                             cmath::pow(attenuation_power(gpass),
+                                        T{-1} / (T{2} * T(order))))};
+}
+
+template <typename T>
+constexpr auto cheb2ord(T fs, T fpass, T fstop, T gpass, T gstop,
+                        std::size_t order) noexcept -> order_selection<T> {
+  return order_selection<T>{
+      order,
+      shift_frequency(
+          fs, fpass, fstop,
+          cmath::cosh(cmath::acosh(cmath::sqrt(discrimination(gpass, gstop))) /
+                      T(order)))};
+}
+
+template <typename T>
+constexpr auto chebyshev_order(T fs, T fpass, T fstop, T gpass,
+                               T gstop) noexcept -> std::size_t {
+  return ceil_order(cmath::acosh(cmath::sqrt(discrimination(gpass, gstop))) /
+                    cmath::acosh(selectivity(fs, fpass, fstop)));
+}
+
+template <typename T>
+constexpr auto ellipord(T m0, T m1) noexcept -> std::size_t {
+  return ceil_order(cmath::ellipk(m0) * cmath::ellipkm1(m1) /
+                    (cmath::ellipkm1(m0) * cmath::ellipk(m1)));
+}
+
+} // namespace detail
+
+/**
+ * Minimum order Butterworth filter
+ *
+ * All frequencies are in the same unit as the sample rate `fs`. A lowpass
+ * mask has `fpass < fstop`, a highpass mask has `fpass > fstop`. The
+ * passband loses no more than `gpass` dB and the stopband is attenuated
+ * by at least `gstop` dB. The returned frequency meets the passband
+ * exactly.
+ */
+template <typename T>
+constexpr auto buttord(T fs, T fpass, T fstop, T gpass, T gstop) noexcept
+    -> order_selection<T> {
+  return detail::buttord(
+      fs, fpass, fstop, gpass,
+      detail::ceil_order(cmath::log10(detail::discrimination(gpass, gstop)) /
+                         (T{2} * cmath::log10(detail::selectivity(
+                                     fs, fpass, fstop)))));
+}
+
+/**
+ * Minimum order Chebyshev type I filter, see `buttord`
+ *
+ * The returned frequency is the passband edge.
+ */
+template <typename T>
+constexpr auto cheb1ord(T fs, T fpass, T fstop, T gpass, T gstop) noexcept
+    -> order_selection<T> {
+  return order_selection<T>{
+      detail::chebyshev_order(fs, fpass, fstop, gpass, gstop), fpass};
+}
+
+/**
+ * Minimum order Chebyshev type II filter, see `buttord`
+ *
+ * The returned frequency is the stopband edge of the minimum order filter
+ * that just meets the passband.
+ */
+template <typename T>
+constexpr auto cheb2ord(T fs, T fpass, T fstop, T gpass, T gstop) noexcept
+    -> order_selection<T> {
+  return detail::cheb2ord(
+      fs, fpass, fstop, gpass, gstop,
+      detail::chebyshev_order(fs, fpass, fstop, gpass, gstop));
+}
+
+/**
+ * Minimum order elliptic filter, see `buttord`
+ *
+ * The returned frequency is the passband edge.
+ */
+template <typename T>
+constexpr auto ellipord(T fs, T fpass, T fstop, T gpass, T gstop) noexcept
+    -> order_selection<T> {
+  return order_selection<T>{
+      detail::ellipord(T{1} / (detail::selectivity(fs, fpass, fstop) *
+                               detail::selectivity(fs, fpass, fstop)),
+                       T{1} / detail::discrimination(gpass, gstop)),
+      fpass};
+}
+
+/**
+ * Filter families for `iirfilter::lowpass_spec` and
+ * `iirfilter::highpass_spec`
+ *
+ * Each family provides `select()`, which computes the minimum order for a
+ * tolerance mask, and `prototype<Order>()`, which creates the prototype
+ * for that order from the mask's passband and stopband attenuation.
+ */
+namespace family {
+
+struct butterworth {
+  template <typename T>
+  static constexpr auto
+  select(T fs, T fpass, T fstop, T gpass, T gstop) noexcept
+      -> order_selection<T> {
+    return buttord(fs, fpass, fstop, gpass, gstop);
+  }
+
+  template <std::size_t Order, typename T>
+  static constexpr auto
+  prototype(T, T) noexcept -> signal::butterworth<Order> {
+    return signal::butterworth<Order>();
+  }
+};
+
+struct chebyshev1 {
+  template <typename T>
+  static constexpr auto
+  select(T fs, T fpass, T fstop, T gpass, T gstop) noexcept
+      -> order_selection<T> {
+    return cheb1ord(fs, fpass, fstop, gpass, gstop);
+  }
+
+  template <std::size_t Order, typename T>
+  static constexpr auto
+  prototype(T gpass, T) noexcept -> signal::chebyshev1<Order, T> {
+    return signal::chebyshev1<Order, T>(gpass);
+  }
+};
+
+struct chebyshev2 {
+  template <typename T>
+  static constexpr auto
+  select(T fs, T fpass, T fstop, T gpass, T gstop) noexcept
+      -> order_selection<T> {
+    return cheb2ord(fs, fpass, fstop, gpass, gstop);
+  }
+
+  template <std::size_t Order, typename T>
+  static constexpr auto
+  prototype(T, T gstop) noexcept -> signal::chebyshev2<Order, T> {
+    return signal::chebyshev2<Order, T>(gstop);
+  }
+};
+
+struct elliptic {
+  template <typename T>
+  static constexpr auto
+  select(T fs, T fpass, T fstop, T gpass, T gstop) noexcept
+      -> order_selection<T> {
+    return ellipord(fs, fpass, fstop, gpass, gstop);
+  }
+
+  template <std::size_t Order, typename T>
+  static constexpr auto
+  prototype(T gpass, T gstop) noexcept -> signal::elliptic<Order, T> {
+    return signal::elliptic<Order, T>(gpass, gstop);
+  }
+};
+
+} // namespace family
+
+} // namespace signal
+} // namespace embedded
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <thread>
+
+#include "detail/parallel.h"
+#include "sos.h"
+
+namespace embedded {
+namespace signal {
+
+/**
+ * Multi-threaded filtering of many channels on a host
+ *
+ * This runs an `sos_design` over a channel-major buffer, i.e. all
+ * samples of the first channel, followed by all samples of the second
+ * channel, and so on. It is meant for offline processing of recorded
+ * data with many channels and requires `std::thread`, so it's not for
+ * use on a target.
+ *
+ * The channels are split into groups of `Lanes` channels. Each group is
+ * filtered with an `sos_multichannel_instance`, so the SIMD kernel runs
+ * across the channels of the group, on blocks of frames that are
+ * transposed to and from a small interleaved buffer. Groups are
+ * distributed across a persistent pool of worker threads with work
+ * stealing, so uneven progress of the workers is balanced out.
+ *
+ * If there are fewer groups than workers, the samples can also be split
+ * into segments of `segment` samples. Each segment is then filtered with
+ * a fresh state, starting `warmup` samples earlier, and the warm-up
+ * outputs are discarded. For an IIR filter, this is only exact to within
+ * the decay of the impulse response over `warmup` samples, so it should
+ * be several times the filter's time constant. Without segments, the
+ * result is identical to running `sos_multichannel_instance` over each
+ * group.
+ *
+ *     sos_parallel_engine engine;  // one worker per core
+ *
+ *     engine.process(design, in.data(), out.data(), channels, samples);
+ */
+class sos_parallel_engine {
+ public:
+  /**
+   * Create an engine with `workers` threads, including the caller
+   */
+  explicit sos_parallel_engine(std::size_t workers = default_workers())
+      : pool_{workers}
+      , tasks_{pool_.size()} {}
+
+  static std::size_t default_workers() {
+    return std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  std::size_t workers() const { return pool_.size(); }
+
+  /**
+   * Filter `channels` channels of `samples` samples each
+   *
+   * \param in       Pointer to channel-major input samples.
+   *
+   * \param out      Pointer to channel-major output samples. May be the
+   *                 same as `in` if `segment` is zero.
+   *
+   * \param segment  Length of time segments processed independently, or
+   *                 zero to process each channel in one piece.
+   *
+   * \param warmup   Number of samples run before each segment (except
+   *                 the first) to settle the filter state.
+   */
+  template <std::size_t Lanes = 8, typename F, std::size_t N>
+  void process(sos_design<F, N> const& design, F const* in, F* out,
+               std::size_t channels, std::size_t samples,
+               std::size_t segment = 0, std::size_t warmup = 0) {
+    static_assert(Lanes > 0, "Lanes must not be zero");
+    assert(segment == 0 || in != out);
+
+    auto const groups = (channels + Lanes - 1) / Lanes;
+    auto const length =
+        segment > 0 ? segment : std::max<std::size_t>(samples, 1);
+    auto const segments = (samples + length - 1) / length;
+
+    tasks_.reset(groups * segments);
+
+    pool_.run([&](std::size_t worker) {
+      std::size_t task;
+      while (tasks_.next(worker, task)) {
+        auto const ch = task / segments * Lanes;
+        auto const t0 = task % segments * length;
+        filter_group<Lanes>(design, in + ch * samples, out + ch * samples,
+                            std::min(Lanes, channels - ch), samples, t0,
+                            std::min(t0 + length, samples), warmup);
+      }
+    });
+  }
+
+ private:
+  // frames per transposed block
+  static constexpr std::size_t block_frames = 64;
+
+  template <std::size_t Lanes, typename F, std::size_t N>
+  static void filter_group(sos_design<F, N> const& design, F const* in, F* out,
+                           std::size_t lanes, std::size_t stride,
+                           std::size_t begin, std::size_t end,
+                           std::size_t warmup) {
+    auto filter = design.template multichannel_instance<Lanes>();
+    // unused lanes stay zero
+    F buf[block_frames * Lanes] = {};
+
+    for (auto t = begin - std::min(begin, warmup); t < end;
+         t += block_frames) {
+      auto const n = end - t < block_frames ? end - t : block_frames;
+      for (std::size_t c = 0; c < lanes; ++c) {
+        auto const src = in + c * stride + t;
+        for (std::size_t i = 0; i < n; ++i) {
+          buf[i * Lanes + c] = src[i];
+        }
+      }
+
+      filter.process(buf, n);
+
+      auto const skip = t < begin ? std::min(n, begin - t) : 0;
+      for (std::size_t c = 0; c < lanes; ++c) {
+        auto const dst = out + c * stride + t;
+        for (std::size_t i = skip; i < n; ++i) {
+          dst[i] = buf[i * Lanes + c];
+        }
+      }
+    }
+  }
+
+  detail::worker_pool pool_;
+  detail::work_stealing_ranges tasks_;
+};
+
+} // namespace signal
+} // namespace embedded
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include "../typelist.h"
+#include "detail/pipeline.h"
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace signal {
+
+template <typename Stages, std::size_t Block = 64>
+class pipeline;
+
+/**
+ * Block processing chain of filter stages composed at compile time
+ *
+ * The stages are listed in an `embedded::typelist` and stored by value.
+ * Input is processed in blocks of at most `Block` samples, each block
+ * passing through all stages before the next one is started, so the
+ * intermediate data stays in the cache (or in tightly coupled memory).
+ * The buffers between the stages are sized at compile time from the
+ * stages' `max_output()` and are members of the pipeline. Stages that
+ * don't change rate or type and can work in place do so in the buffer
+ * of the previous stage and don't need a buffer of their own. All calls
+ * to the stages are resolved statically.
+ *
+ * See `detail::pipeline_stage_traits` for the requirements on a stage;
+ * `cic_decimator`, `cic_interpolator`, `sos_instance`, `fir_instance` and
+ * `resampler_instance` can be used directly. Since instances refer to
+ * their designs, the designs must outlive the pipeline.
+ *
+ *     constexpr auto sos = iirfilter<double>(fs).lowpass(...).sos<float>();
+ *
+ *     using chain = typelist<cic_decimator<std::int16_t, 4, 32>,
+ *                            decltype(sos.instance()), gain, framer>;
+ *
+ *     auto p = make_pipeline<chain>(cic_decimator<std::int16_t, 4, 32>{},
+ *                                   sos.instance(), gain{0.5f}, framer{});
+ *
+ *     std::int16_t out[p.max_output(1024)];
+ *     auto n = p.process(pdm, out, 1024);
+ */
+template <typename... Stages, std::size_t Block>
+class pipeline<typelist<Stages...>, Block> {
+  static_assert(sizeof...(Stages) > 0, "a pipeline needs at least one stage");
+  static_assert(Block > 0, "Block must not be zero");
+
+  using chain_type = detail::pipeline_chain<Block, false, Stages...>;
+
+ public:
+  using input_type = typename chain_type::input_type;
+  using output_type = typename chain_type::output_type;
+
+  static constexpr std::size_t size() noexcept { return sizeof...(Stages); }
+  static constexpr std::size_t block_size() noexcept { return Block; }
+
+  /**
+   * Total size of the intermediate buffers in bytes
+   */
+  static constexpr std::size_t buffer_bytes() noexcept {
+    return chain_type::buffer_bytes();
+  }
+
+  /**
+   * Upper bound of the number of outputs for `n` input samples
+   */
+  static constexpr std::size_t max_output(std::size_t n) noexcept {
+    return (n / Block) * chain_type::max_output() +
+           (n % Block > 0 ? chain_type::max_output() : 0);
+  }
+
+  explicit pipeline(Stages const&... stages)
+      : chain_(stages...) {}
+
+  /**
+   * Process `n` input samples
+   *
+   * \param out  Pointer to output samples, must have room for
+   *             `max_output(n)` samples.
+   *
+   * \returns Number of output samples.
+   */
+  std::size_t process(input_type const* in, output_type* out, std::size_t n) {
+    std::size_t count = 0;
+    while (n > 0) {
+      auto const len = std::min(n, Block);
+      count += chain_.run(in, len, out + count);
+      in += len;
+      n -= len;
+    }
+    return count;
+  }
+
+  /**
+   * Access to stage `I`, e.g. to reset it or switch its design
+   */
+  template <std::size_t I>
+  auto stage() -> typename detail::pipeline_stage_type<I, Stages...>::type& {
+    static_assert(I < sizeof...(Stages), "stage index out of range");
+    return chain_.get(detail::pipeline_index<I>{});
+  }
+
+ private:
+  chain_type chain_;
+};
+
+template <typename Stages, std::size_t Block = 64, typename... Args>
+auto make_pipeline(Args const&... stages) -> pipeline<Stages, Block> {
+  return pipeline<Stages, Block>(stages...);
+}
+
+} // namespace signal
+} // namespace embedded
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <type_traits>
+
+/**
+ * Placement of filter coefficients and state in named sections
+ *
+ * On parts with tightly coupled or otherwise faster memories, the
+ * location of the coefficients and state of a filter has a significant
+ * impact on its performance. These macros define a design or an instance
+ * in a named section, which the linker script can then map to the
+ * desired memory:
+ *
+ *   LIBEMB_FILTER_DESIGN(coefs,
+ *                        iirfilter<double>(fs).lowpass(...).sos<float>());
+ *   LIBEMB_FILTER_INSTANCE(filter, coefs.instance());
+ *
+ * The design is a `constexpr` object in `LIBEMB_FILTER_COEFS_SECTION`,
+ * the instance (i.e. the pointer to the design and the filter state) is
+ * constant initialized in `LIBEMB_FILTER_STATE_SECTION`. As the instance
+ * isn't all zero, its section must be initialized from a load image at
+ * startup, like `.data`. Both section names can be overridden, or the
+ * `_SECTION` variants of the macros can be used to choose the section
+ * per object.
+ *
+ * Note that if the compiler can see both the design and its use, it may
+ * still fold the coefficients into the code, like with any other
+ * `constexpr` design.
+ *
+ * Use `LIBEMB_DEBUG_FILTER_COEFS_REF` to add a debug record for a placed
+ * design that points at its coefficients instead of storing a copy.
+ */
+
+#ifndef LIBEMB_FILTER_COEFS_SECTION
+#define LIBEMB_FILTER_COEFS_SECTION ".libemb_coefs"
+#endif
+
+#ifndef LIBEMB_FILTER_STATE_SECTION
+#define LIBEMB_FILTER_STATE_SECTION ".libemb_state"
+#endif
+
+#define LIBEMB_FILTER_DESIGN_SECTION(sec, name, ...)                           \
+  constexpr std::decay<decltype(__VA_ARGS__)>::type name                       \
+      __attribute__((section(sec))) {                                          \
+    __VA_ARGS__                                                                \
+  }
+
+#define LIBEMB_FILTER_INSTANCE_SECTION(sec, name, ...)                         \
+  std::decay<decltype(__VA_ARGS__)>::type name __attribute__((section(sec))) { \
+    __VA_ARGS__                                                                \
+  }
+
+#define LIBEMB_FILTER_DESIGN(name, ...)                                        \
+  LIBEMB_FILTER_DESIGN_SECTION(LIBEMB_FILTER_COEFS_SECTION, name, __VA_ARGS__)
+
+#define LIBEMB_FILTER_INSTANCE(name, ...)                                      \
+  LIBEMB_FILTER_INSTANCE_SECTION(LIBEMB_FILTER_STATE_SECTION, name,            \
+                                 __VA_ARGS__)
@@ -24,6 +24,7 @@
 
 #include <array>
 #include <cstddef>
+#include <type_traits>
 
 #include "detail/filter.h"
 
@@ -62,6 +63,15 @@ class poly_design {
     return y;
   }
 
+  void filter(std::array<F, N>& state, F const* in, F* out,
+              std::size_t n) const {
+    std::array<F, N> s = state;
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = filter(s, in[i]);
+    }
+    state = s;
+  }
+
   constexpr auto instance() const noexcept -> poly_instance<F, N> {
     return poly_instance<F, N>(this);
   }
@@ -81,11 +91,44 @@ class poly_instance {
 
   value_type operator()(value_type x) { return impl_->filter(y_, x); }
 
+  void process(value_type const* in, value_type* out, std::size_t n) {
+    impl_->filter(y_, in, out, n);
+  }
+
+  void process(value_type* data, std::size_t n) { process(data, data, n); }
+
  private:
   poly_design<F, N> const* impl_;
   std::array<value_type, N> y_{};
 };
 
+/**
+ * Filter instance bound to a design at compile time
+ *
+ * Takes a reference to a constexpr design with static storage duration
+ * as a template argument and only holds the filter state, see
+ * `sos_static_instance`.
+ */
+template <typename Design, Design const& D>
+class poly_static_instance {
+ public:
+  using design_type = typename std::remove_const<Design>::type;
+  using value_type = typename design_type::value_type;
+
+  static constexpr auto design() noexcept -> design_type const& { return D; }
+
+  value_type operator()(value_type x) { return D.filter(y_, x); }
+
+  void process(value_type const* in, value_type* out, std::size_t n) {
+    D.filter(y_, in, out, n);
+  }
+
+  void process(value_type* data, std::size_t n) { process(data, data, n); }
+
+ private:
+  std::array<value_type, design_type::order()> y_{};
+};
+
 } // namespace signal
 } // namespace embedded
 
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#include "../circular_buffer_adapter.h"
+#include "../constexpr_math.h"
+#include "../utility/integer_sequence.h"
+#include "detail/resampler.h"
+#include "fir.h"
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace signal {
+
+template <typename F, std::size_t L, std::size_t M, std::size_t K,
+          std::size_t Block>
+class resampler_instance;
+
+/**
+ * Polyphase rational resampler design
+ *
+ * Conceptually, resampling by `L / M` inserts `L - 1` zeros after each
+ * input sample, applies a lowpass filter at `L` times the input rate and
+ * then keeps every `M`-th output. The polyphase form skips all products
+ * with the inserted zeros as well as all outputs that are discarded:
+ * each output is computed from only `K` input samples using one of the
+ * `L` phases of the prototype filter.
+ *
+ * The phases are stored one after the other in a single table, so the
+ * coefficients for an output are contiguous in memory.
+ *
+ * Use `firfilter::design::resampler()` to create a design, e.g. for
+ * converting 48 kHz to 16 kHz:
+ *
+ *     constexpr auto design = firfilter<>(48000.0)
+ *                                 .lowpass(hann<96>(), 7000.0)
+ *                                 .resampler<float, 1, 3>();
+ *
+ *     auto rs = design.instance();
+ */
+template <typename F, std::size_t L, std::size_t M, std::size_t K>
+class resampler_design {
+ public:
+  static_assert(L > 0 && M > 0, "Resampling factors must be non-zero");
+  static_assert(K > 0, "Number of taps per phase must be non-zero");
+
+  using value_type = F;
+  using tarray = cmath::vector<F, L * K>;
+
+  template <typename T, std::size_t Taps>
+  constexpr resampler_design(cmath::vector<T, Taps> const& h) noexcept
+      : h_{cmath::make_vector<T>(detail::polyphase<T, Taps, L, K>(h),
+                                 make_index_sequence<L * K>{})} {}
+
+  static constexpr std::size_t up() noexcept { return L; }
+  static constexpr std::size_t down() noexcept { return M; }
+  static constexpr std::size_t taps_per_phase() noexcept { return K; }
+
+  /**
+   * Coefficients of phase `p`, to be applied to `K` input samples,
+   * oldest first
+   */
+  value_type const* phase(std::size_t p) const { return &h_[p * K]; }
+
+  /**
+   * Upper bound of the number of outputs for `n` input samples
+   */
+  static constexpr std::size_t max_output(std::size_t n) noexcept {
+    return (n * L + M - 1) / M;
+  }
+
+  template <std::size_t Block = 32>
+  constexpr auto instance() const noexcept
+      -> resampler_instance<F, L, M, K, Block> {
+    return resampler_instance<F, L, M, K, Block>{this};
+  }
+
+ private:
+  tarray const h_;
+};
+
+/**
+ * Polyphase resampler instance
+ *
+ * As with `fir_instance`, input samples are collected in a linear buffer
+ * behind the last `K - 1` samples. Outputs are computed as soon as all
+ * of their input samples are available.
+ */
+template <typename F, std::size_t L, std::size_t M, std::size_t K,
+          std::size_t Block>
+class resampler_instance {
+ public:
+  static_assert(Block >= (M + L - 1) / L, "Block size too small");
+
+  using value_type = F;
+  using design_type = resampler_design<F, L, M, K>;
+
+  resampler_instance(design_type const* d) noexcept
+      : impl_{d} {}
+
+  static constexpr std::size_t max_output(std::size_t n) noexcept {
+    return design_type::max_output(n);
+  }
+
+  /**
+   * Resample `n` input samples
+   *
+   * \param out  Pointer to output samples, must have room for
+   *             `max_output(n)` samples.
+   *
+   * \returns Number of output samples.
+   */
+  std::size_t process(value_type const* in, value_type* out, std::size_t n) {
+    auto const first = out;
+    while (n > 0) {
+      std::size_t const count = std::min(n, buf_.size() - filled_);
+      std::copy(in, in + count, buf_.begin() + filled_);
+      filled_ += count;
+      in += count;
+      n -= count;
+      for (; next_ < filled_; ++out) {
+        *out = detail::resampler_dot<F, K>::run(impl_->phase(phase_),
+                                                &buf_[next_ - history]);
+        phase_ += M;
+        next_ += phase_ / L;
+        phase_ %= L;
+      }
+      if (filled_ == buf_.size()) {
+        std::copy(buf_.end() - history, buf_.end(), buf_.begin());
+        next_ -= filled_ - history;
+        filled_ = history;
+      }
+    }
+    return static_cast<std::size_t>(out - first);
+  }
+
+  /**
+   * Resample and remove all items of a circular buffer
+   *
+   * \param out  Pointer to output samples, must have room for
+   *             `max_output(in.size())` samples.
+   *
+   * \returns Number of output samples.
+   */
+  template <std::size_t Capacity, typename Instrumentation>
+  std::size_t
+  process(circular_buffer_adapter<F, Capacity, Instrumentation>& in,
+          value_type* out) {
+    auto const r = in.peek_front(in.size());
+    auto count = process(r.first.data, out, r.first.size);
+    count += process(r.second.data, out + count, r.second.size);
+    in.consume_front(r.size());
+    return count;
+  }
+
+ private:
+  static constexpr std::size_t history{K - 1};
+
+  design_type const* impl_;
+  std::array<value_type, history + Block> buf_{};
+  std::size_t filled_{history};
+  std::size_t next_{history};
+  std::size_t phase_{0};
+};
+
+} // namespace signal
+} // namespace embedded
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
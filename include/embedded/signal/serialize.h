@@ -0,0 +1,391 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "../serialize.h"
+#include "../type_traits/void_t.h"
+#include "denormal.h"
+#include "fixed_point.h"
+#include "poly.h"
+#include "sos.h"
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_suppress=Pe540
+#endif
+// clang-format on
+
+namespace embedded {
+namespace signal {
+namespace detail {
+
+// Value type codes, floating point codes match `filter_debug_value_type`
+enum class serialize_value_code : std::uint8_t {
+  FLOAT = 0,
+  DOUBLE = 1,
+  FIXED = 3,
+};
+
+template <typename F, typename = void>
+struct serialize_value;
+
+template <>
+struct serialize_value<float> {
+  template <typename Sink>
+  static void type(Sink& sink) {
+    sink.byte(static_cast<std::uint8_t>(serialize_value_code::FLOAT));
+  }
+
+  template <typename Sink>
+  static void write(Sink& sink, float x) {
+    sink.value(x);
+  }
+};
+
+template <>
+struct serialize_value<double> {
+  template <typename Sink>
+  static void type(Sink& sink) {
+    sink.byte(static_cast<std::uint8_t>(serialize_value_code::DOUBLE));
+  }
+
+  template <typename Sink>
+  static void write(Sink& sink, double x) {
+    sink.value(x);
+  }
+};
+
+// Fixed point values are stored as raw integers, followed by the number
+// of fraction bits and the size of the raw value in the type code
+template <typename F>
+struct serialize_value<
+    F,
+    embedded::detail::void_t<typename fixed_point_traits<F>::base_type>> {
+  using traits = fixed_point_traits<F>;
+
+  template <typename Sink>
+  static void type(Sink& sink) {
+    sink.byte(static_cast<std::uint8_t>(serialize_value_code::FIXED));
+    sink.byte(static_cast<std::uint8_t>(traits::fraction_bits));
+    sink.byte(static_cast<std::uint8_t>(sizeof(typename traits::base_type)));
+  }
+
+  template <typename Sink>
+  static void write(Sink& sink, F x) {
+    sink.value(traits::raw(x));
+  }
+};
+
+// Structure codes, which determine the layout of a state snapshot. A
+// wrapping structure is followed by the code of the wrapped structure.
+enum class serialize_structure_code : std::uint8_t {
+  DF2T = 0,
+  DF1 = 1,
+  TDF1 = 2,
+  COUPLED = 3,
+  DF1_WIDE = 4,
+  DENORMAL_SAFE = 5,
+};
+
+template <serialize_structure_code Code>
+struct serialize_structure_code_writer {
+  template <typename Sink>
+  static void write(Sink& sink) {
+    sink.byte(static_cast<std::uint8_t>(Code));
+  }
+};
+
+template <typename Structure>
+struct serialize_structure;
+
+template <>
+struct serialize_structure<sos_structure::df2t>
+    : serialize_structure_code_writer<serialize_structure_code::DF2T> {};
+
+template <>
+struct serialize_structure<sos_structure::df1>
+    : serialize_structure_code_writer<serialize_structure_code::DF1> {};
+
+template <>
+struct serialize_structure<sos_structure::tdf1>
+    : serialize_structure_code_writer<serialize_structure_code::TDF1> {};
+
+template <>
+struct serialize_structure<sos_structure::coupled>
+    : serialize_structure_code_writer<serialize_structure_code::COUPLED> {};
+
+template <bool ErrorFeedback>
+struct serialize_structure<sos_structure::df1_wide<ErrorFeedback>>
+    : serialize_structure_code_writer<serialize_structure_code::DF1_WIDE> {};
+
+template <typename Base>
+struct serialize_structure<sos_structure::denormal_safe<Base>> {
+  template <typename Sink>
+  static void write(Sink& sink) {
+    serialize_structure_code_writer<
+        serialize_structure_code::DENORMAL_SAFE>::write(sink);
+    serialize_structure<Base>::write(sink);
+  }
+};
+
+// Value type and fields of each state type
+template <typename State>
+struct serialize_state;
+
+template <typename F>
+struct serialize_state<sos_state<F>> {
+  using value_type = F;
+  using structure = serialize_structure<sos_structure::df2t>;
+
+  template <typename Sink>
+  static void write(Sink& sink, sos_state<F> const& s) {
+    serialize_value<F>::write(sink, s.y1);
+    serialize_value<F>::write(sink, s.y2);
+  }
+};
+
+template <typename F>
+struct serialize_state<sos_df1_state<F>> {
+  using value_type = F;
+  using structure = serialize_structure<sos_structure::df1>;
+
+  template <typename Sink>
+  static void write(Sink& sink, sos_df1_state<F> const& s) {
+    serialize_value<F>::write(sink, s.x1);
+    serialize_value<F>::write(sink, s.x2);
+    serialize_value<F>::write(sink, s.y1);
+    serialize_value<F>::write(sink, s.y2);
+  }
+};
+
+template <typename F>
+struct serialize_state<sos_tdf1_state<F>> {
+  using value_type = F;
+  using structure = serialize_structure<sos_structure::tdf1>;
+
+  template <typename Sink>
+  static void write(Sink& sink, sos_tdf1_state<F> const& s) {
+    serialize_value<F>::write(sink, s.p1);
+    serialize_value<F>::write(sink, s.p2);
+    serialize_value<F>::write(sink, s.z1);
+    serialize_value<F>::write(sink, s.z2);
+  }
+};
+
+template <typename F>
+struct serialize_state<sos_coupled_state<F>> {
+  using value_type = F;
+  using structure = serialize_structure<sos_structure::coupled>;
+
+  template <typename Sink>
+  static void write(Sink& sink, sos_coupled_state<F> const& s) {
+    serialize_value<F>::write(sink, s.s1);
+    serialize_value<F>::write(sink, s.s2);
+  }
+};
+
+// The raw values are stored as is, the error feedback term last
+template <typename F>
+struct serialize_state<sos_df1_wide_state<F>> {
+  using value_type = F;
+  using structure = serialize_structure<sos_structure::df1_wide<>>;
+
+  template <typename Sink>
+  static void write(Sink& sink, sos_df1_wide_state<F> const& s) {
+    sink.value(s.x1);
+    sink.value(s.x2);
+    sink.value(s.y1);
+    sink.value(s.y2);
+    sink.value(s.e);
+  }
+};
+
+// The offset of the wrapped state follows its own state variables
+template <typename State, typename F>
+struct serialize_state<sos_denormal_safe_state<State, F>> {
+  using value_type = F;
+
+  struct structure {
+    template <typename Sink>
+    static void write(Sink& sink) {
+      serialize_structure_code_writer<
+          serialize_structure_code::DENORMAL_SAFE>::write(sink);
+      serialize_state<State>::structure::write(sink);
+    }
+  };
+
+  template <typename Sink>
+  static void write(Sink& sink, sos_denormal_safe_state<State, F> const& s) {
+    serialize_state<State>::write(sink, s);
+    serialize_value<F>::write(sink, s.offset);
+    serialize_value<F>::write(sink, s.next);
+  }
+};
+
+template <typename State, std::size_t N>
+struct serialize_state_array {
+  using state_traits = serialize_state<State>;
+
+  static constexpr std::uint32_t kind = serialize_kind::sos_state;
+
+  template <typename Sink>
+  static void write(Sink& sink, std::array<State, N> const& states) {
+    state_traits::structure::write(sink);
+    serialize_value<typename state_traits::value_type>::type(sink);
+    sink.value(N);
+    for (auto const& s : states) {
+      state_traits::write(sink, s);
+    }
+  }
+};
+
+} // namespace detail
+} // namespace signal
+
+/**
+ * SOS design
+ *
+ * Payload: structure code(s), value type, filter order, followed by `b0`,
+ * `b1`, `b2`, `a1` and `a2` of each section. For the coupled form, these
+ * are the equivalent direct form coefficients.
+ */
+template <typename F, std::size_t N, typename Structure>
+struct serialize_traits<signal::sos_design<F, N, Structure>> {
+  static constexpr std::uint32_t kind = serialize_kind::sos_design;
+
+  template <typename Sink>
+  static void write(Sink& sink,
+                    signal::sos_design<F, N, Structure> const& design) {
+    using value = signal::detail::serialize_value<F>;
+    signal::detail::serialize_structure<Structure>::write(sink);
+    value::type(sink);
+    sink.value(N);
+    for (std::size_t i = 0; i < design.size(); ++i) {
+      auto const b = design.sos()[i].b();
+      auto const a = design.sos()[i].a();
+      value::write(sink, b[0]);
+      value::write(sink, b[1]);
+      value::write(sink, b[2]);
+      value::write(sink, a[1]);
+      value::write(sink, a[2]);
+    }
+  }
+};
+
+/**
+ * Transfer function design
+ *
+ * Payload: value type, filter order, followed by `b` and `a`.
+ */
+template <typename F, std::size_t N>
+struct serialize_traits<signal::poly_design<F, N>> {
+  static constexpr std::uint32_t kind = serialize_kind::poly_design;
+
+  template <typename Sink>
+  static void write(Sink& sink, signal::poly_design<F, N> const& design) {
+    using value = signal::detail::serialize_value<F>;
+    value::type(sink);
+    sink.value(N);
+    auto const b = design.b();
+    auto const a = design.a();
+    for (std::size_t i = 0; i <= N; ++i) {
+      value::write(sink, b[i]);
+    }
+    for (std::size_t i = 0; i <= N; ++i) {
+      value::write(sink, a[i]);
+    }
+  }
+};
+
+/**
+ * State snapshot of an SOS instance, as returned by `state()`
+ *
+ * Payload: structure code(s), value type, number of sections, followed by
+ * the state variables of each section in declaration order. For
+ * `denormal_safe` structures, the state of the wrapped structure is
+ * followed by `offset` and `next`.
+ */
+template <typename F, std::size_t N>
+struct serialize_traits<std::array<signal::sos_state<F>, N>>
+    : signal::detail::serialize_state_array<signal::sos_state<F>, N> {};
+
+template <typename F, std::size_t N>
+struct serialize_traits<std::array<signal::sos_df1_state<F>, N>>
+    : signal::detail::serialize_state_array<signal::sos_df1_state<F>, N> {};
+
+template <typename F, std::size_t N>
+struct serialize_traits<std::array<signal::sos_tdf1_state<F>, N>>
+    : signal::detail::serialize_state_array<signal::sos_tdf1_state<F>, N> {};
+
+template <typename F, std::size_t N>
+struct serialize_traits<std::array<signal::sos_coupled_state<F>, N>>
+    : signal::detail::serialize_state_array<signal::sos_coupled_state<F>, N> {
+};
+
+template <typename F, std::size_t N>
+struct serialize_traits<std::array<signal::sos_df1_wide_state<F>, N>>
+    : signal::detail::serialize_state_array<signal::sos_df1_wide_state<F>,
+                                            N> {};
+
+template <typename State, typename F, std::size_t N>
+struct serialize_traits<
+    std::array<signal::sos_denormal_safe_state<State, F>, N>>
+    : signal::detail::serialize_state_array<
+          signal::sos_denormal_safe_state<State, F>, N> {};
+
+/**
+ * Statistics of an SOS instance, as returned by `statistics()`
+ *
+ * Payload: value type, number of sections, followed by the peak and the
+ * number of saturations of each section.
+ */
+template <typename F, std::size_t N>
+struct serialize_traits<std::array<signal::sos_section_stats<F>, N>> {
+  static constexpr std::uint32_t kind = serialize_kind::sos_statistics;
+
+  template <typename Sink>
+  static void write(Sink& sink,
+                    std::array<signal::sos_section_stats<F>, N> const& stats) {
+    using value = signal::detail::serialize_value<F>;
+    value::type(sink);
+    sink.value(N);
+    for (auto const& s : stats) {
+      value::write(sink, s.peak);
+      sink.value(s.saturations);
+    }
+  }
+};
+
+} // namespace embedded
+
+// clang-format off
+#ifdef __IAR_SYSTEMS_ICC__
+#pragma diag_default=Pe540
+#endif
+// clang-format on
@@ -23,7 +23,11 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
 
 #include "detail/filter.h"
 
@@ -36,9 +40,27 @@
 namespace embedded {
 namespace signal {
 
+/**
+ * Distribution of the overall gain across the sections
+ *
+ * - `first_section` applies the gain in the first section.
+ * - `distribute` applies the same gain in every section.
+ * - `linf` scales each section so that the peak gain from the input to
+ *   every section output is one, which prevents overflow of the
+ *   intermediate results for any sinusoidal input.
+ * - `l2` scales each section so that the L2 norm of the transfer
+ *   function up to every section output is one. This is less strict
+ *   than `linf` and gives more room above the quantization noise.
+ *
+ * The last section always applies the remaining gain. With `l2`, the
+ * order of the sections is also reversed, so the poles closest to the
+ * unit circle come first, which minimizes the output noise.
+ */
 enum class sos_gain {
   first_section,
   distribute,
+  linf,
+  l2,
 };
 
 template <typename F>
@@ -47,23 +69,38 @@ struct sos_state {
 };
 
 template <typename F>
-class sos_section {
+struct sos_df1_state {
+  F x1{}, x2{}, y1{}, y2{};
+};
+
+template <typename F>
+struct sos_tdf1_state {
+  F p1{}, p2{}, z1{}, z2{};
+};
+
+template <typename F>
+struct sos_coupled_state {
+  F s1{}, s2{};
+};
+
+template <typename F, std::size_t Channels>
+struct sos_multichannel_state {
+  F y1[Channels]{}, y2[Channels]{};
+};
+
+namespace detail {
+
+// Coefficient storage shared by all direct form sections.
+template <typename F>
+class sos_coefficients {
  public:
   using value_type = F;
-  using state_type = sos_state<value_type>;
 
   template <typename F2>
-  constexpr sos_section(cmath::vector<cmath::complex<F2>, 2> const& zeros,
-                        cmath::vector<cmath::complex<F2>, 2> const& poles,
-                        F2 gain) noexcept
-      : sos_section(real(gain * poly(zeros)), real(poly(poles))) {}
-
-  value_type filter(state_type& state, value_type x) const {
-    value_type const y = b0_ * x + state.y1;
-    state.y1 = b1_ * x - a1_ * y + state.y2;
-    state.y2 = b2_ * x - a2_ * y;
-    return y;
-  }
+  constexpr sos_coefficients(cmath::vector<cmath::complex<F2>, 2> const& zeros,
+                             cmath::vector<cmath::complex<F2>, 2> const& poles,
+                             F2 gain) noexcept
+      : sos_coefficients(real(gain * poly(zeros)), real(poly(poles))) {}
 
   constexpr auto b() const noexcept -> cmath::vector<value_type, 3> {
     return cmath::vector<value_type, 3>{b0_, b1_, b2_};
@@ -73,10 +110,10 @@ class sos_section {
     return cmath::vector<value_type, 3>{value_type{1}, a1_, a2_};
   }
 
- private:
+ protected:
   template <typename F2>
-  constexpr sos_section(cmath::vector<F2, 3> const& b,
-                        cmath::vector<F2, 3> const& a) noexcept
+  constexpr sos_coefficients(cmath::vector<F2, 3> const& b,
+                             cmath::vector<F2, 3> const& a) noexcept
       : b0_{static_cast<value_type>(b[0])}
       , b1_{static_cast<value_type>(b[1])}
       , b2_{static_cast<value_type>(b[2])}
@@ -87,24 +124,495 @@ class sos_section {
   value_type const a1_, a2_;
 };
 
-template <typename F, std::size_t N>
+} // namespace detail
+
+/**
+ * Transposed Direct Form II section
+ *
+ * This is the default structure. It only needs two state variables and
+ * has good numerical properties for floating point types.
+ */
+template <typename F>
+class sos_section : public detail::sos_coefficients<F> {
+ public:
+  using value_type = F;
+  using state_type = sos_state<value_type>;
+
+  using detail::sos_coefficients<F>::sos_coefficients;
+
+  value_type filter(state_type& state, value_type x) const {
+    value_type const y = b0_ * x + state.y1;
+    state.y1 = b1_ * x - a1_ * y + state.y2;
+    state.y2 = b2_ * x - a2_ * y;
+    return y;
+  }
+
+  void filter(state_type& state, value_type const* in, value_type* out,
+              std::size_t n) const {
+    value_type y1 = state.y1;
+    value_type y2 = state.y2;
+    for (std::size_t i = 0; i < n; ++i) {
+      value_type const x = in[i];
+      value_type const y = b0_ * x + y1;
+      y1 = b1_ * x - a1_ * y + y2;
+      y2 = b2_ * x - a2_ * y;
+      out[i] = y;
+    }
+    state.y1 = y1;
+    state.y2 = y2;
+  }
+
+  // Filter one sample for each of `Channels` channels. The state is
+  // stored as structure-of-arrays, so all channels can be processed
+  // using SIMD instructions where available.
+  template <std::size_t Channels>
+  void filter(sos_multichannel_state<value_type, Channels>& state,
+              value_type const* x, value_type* y) const {
+    using lanes = detail::sos_lanes<value_type>;
+    lanes::filter(b0_, b1_, b2_, a1_, a2_, state.y1, state.y2, x, y,
+                  Channels);
+    for (std::size_t c = lanes::vectorized(Channels); c < Channels; ++c) {
+      value_type const xc = x[c];
+      value_type const yc = b0_ * xc + state.y1[c];
+      state.y1[c] = b1_ * xc - a1_ * yc + state.y2[c];
+      state.y2[c] = b2_ * xc - a2_ * yc;
+      y[c] = yc;
+    }
+  }
+
+ private:
+  using detail::sos_coefficients<F>::b0_;
+  using detail::sos_coefficients<F>::b1_;
+  using detail::sos_coefficients<F>::b2_;
+  using detail::sos_coefficients<F>::a1_;
+  using detail::sos_coefficients<F>::a2_;
+};
+
+/**
+ * Direct Form I section
+ *
+ * Keeps the last two inputs and outputs and computes each output in a
+ * single sum of products. The internal values never exceed the range
+ * of the input and output, and the sum maps directly to a single wide
+ * accumulator on DSPs and for fixed point types.
+ */
+template <typename F>
+class sos_df1_section : public detail::sos_coefficients<F> {
+ public:
+  using value_type = F;
+  using state_type = sos_df1_state<value_type>;
+
+  using detail::sos_coefficients<F>::sos_coefficients;
+
+  value_type filter(state_type& state, value_type x) const {
+    value_type const y = b0_ * x + b1_ * state.x1 + b2_ * state.x2 -
+                         a1_ * state.y1 - a2_ * state.y2;
+    state.x2 = state.x1;
+    state.x1 = x;
+    state.y2 = state.y1;
+    state.y1 = y;
+    return y;
+  }
+
+  void filter(state_type& state, value_type const* in, value_type* out,
+              std::size_t n) const {
+    value_type x1 = state.x1;
+    value_type x2 = state.x2;
+    value_type y1 = state.y1;
+    value_type y2 = state.y2;
+    for (std::size_t i = 0; i < n; ++i) {
+      value_type const x = in[i];
+      value_type const y = b0_ * x + b1_ * x1 + b2_ * x2 - a1_ * y1 - a2_ * y2;
+      x2 = x1;
+      x1 = x;
+      y2 = y1;
+      y1 = y;
+      out[i] = y;
+    }
+    state.x1 = x1;
+    state.x2 = x2;
+    state.y1 = y1;
+    state.y2 = y2;
+  }
+
+ private:
+  using detail::sos_coefficients<F>::b0_;
+  using detail::sos_coefficients<F>::b1_;
+  using detail::sos_coefficients<F>::b2_;
+  using detail::sos_coefficients<F>::a1_;
+  using detail::sos_coefficients<F>::a2_;
+};
+
+/**
+ * Transposed Direct Form I section
+ *
+ * Applies the poles before the zeros, with the delays of each part in
+ * transposed form. Like Direct Form II, the intermediate values are not
+ * bounded by the input or output, but the structure is less sensitive
+ * to coefficient quantization than the transposed Direct Form II.
+ */
+template <typename F>
+class sos_tdf1_section : public detail::sos_coefficients<F> {
+ public:
+  using value_type = F;
+  using state_type = sos_tdf1_state<value_type>;
+
+  using detail::sos_coefficients<F>::sos_coefficients;
+
+  value_type filter(state_type& state, value_type x) const {
+    value_type const w = x + state.p1;
+    state.p1 = state.p2 - a1_ * w;
+    state.p2 = -a2_ * w;
+    value_type const y = b0_ * w + state.z1;
+    state.z1 = b1_ * w + state.z2;
+    state.z2 = b2_ * w;
+    return y;
+  }
+
+  void filter(state_type& state, value_type const* in, value_type* out,
+              std::size_t n) const {
+    value_type p1 = state.p1;
+    value_type p2 = state.p2;
+    value_type z1 = state.z1;
+    value_type z2 = state.z2;
+    for (std::size_t i = 0; i < n; ++i) {
+      value_type const w = in[i] + p1;
+      p1 = p2 - a1_ * w;
+      p2 = -a2_ * w;
+      out[i] = b0_ * w + z1;
+      z1 = b1_ * w + z2;
+      z2 = b2_ * w;
+    }
+    state.p1 = p1;
+    state.p2 = p2;
+    state.z1 = z1;
+    state.z2 = z2;
+  }
+
+ private:
+  using detail::sos_coefficients<F>::b0_;
+  using detail::sos_coefficients<F>::b1_;
+  using detail::sos_coefficients<F>::b2_;
+  using detail::sos_coefficients<F>::a1_;
+  using detail::sos_coefficients<F>::a2_;
+};
+
+/**
+ * Coupled (normal) form section
+ *
+ * Realizes the poles as a rotation of the state vector. For a complex
+ * pole pair `r * exp(+-j * phi)`, the feedback matrix holds the real
+ * and imaginary parts of the pole rather than its polynomial
+ * coefficients. This keeps the pole positions accurate for poles close
+ * to z = 1, i.e. for cutoff frequencies that are low compared to the
+ * sample rate, where the direct forms lose most of their precision.
+ * Two real poles are realized as a cascade of two first order sections.
+ */
+template <typename F>
+class sos_coupled_section {
+ public:
+  using value_type = F;
+  using state_type = sos_coupled_state<value_type>;
+
+  template <typename F2>
+  constexpr sos_coupled_section(
+      cmath::vector<cmath::complex<F2>, 2> const& zeros,
+      cmath::vector<cmath::complex<F2>, 2> const& poles, F2 gain) noexcept
+      : sos_coupled_section(real(gain * poly(zeros)), poles[0], poles[1]) {}
+
+  value_type filter(state_type& state, value_type x) const {
+    value_type const y = d_ * x + c1_ * state.s1 + c2_ * state.s2;
+    value_type const s1 = a11_ * state.s1 + a12_ * state.s2 + x;
+    state.s2 = a21_ * state.s1 + a22_ * state.s2;
+    state.s1 = s1;
+    return y;
+  }
+
+  void filter(state_type& state, value_type const* in, value_type* out,
+              std::size_t n) const {
+    value_type s1 = state.s1;
+    value_type s2 = state.s2;
+    for (std::size_t i = 0; i < n; ++i) {
+      value_type const x = in[i];
+      out[i] = d_ * x + c1_ * s1 + c2_ * s2;
+      value_type const t = a11_ * s1 + a12_ * s2 + x;
+      s2 = a21_ * s1 + a22_ * s2;
+      s1 = t;
+    }
+    state.s1 = s1;
+    state.s2 = s2;
+  }
+
+  constexpr auto b() const noexcept -> cmath::vector<value_type, 3> {
+    return cmath::vector<value_type, 3>{
+        d_, d_ * a1() + c1_, d_ * a2() + c2_ * a21_ - c1_ * a22_};
+  }
+
+  constexpr auto a() const noexcept -> cmath::vector<value_type, 3> {
+    return cmath::vector<value_type, 3>{value_type{1}, a1(), a2()};
+  }
+
+ private:
+  template <typename F2>
+  constexpr sos_coupled_section(cmath::vector<F2, 3> const& b,
+                                cmath::complex<F2> const& p1,
+                                cmath::complex<F2> const& p2) noexcept
+      : sos_coupled_section(
+            b, p1.real(), p1.is_real() ? F2{0} : -cmath::abs(p1.imag()),
+            p1.is_real() ? F2{1} : cmath::abs(p1.imag()),
+            p1.is_real() ? p2.real() : p1.real()) {}
+
+  template <typename F2>
+  constexpr sos_coupled_section(cmath::vector<F2, 3> const& b, F2 a11, F2 a12,
+                                F2 a21, F2 a22) noexcept
+      : sos_coupled_section(b, a11, a12, a21, a22, b[1] + b[0] * (a11 + a22)) {}
+
+  template <typename F2>
+  constexpr sos_coupled_section(cmath::vector<F2, 3> const& b, F2 a11, F2 a12,
+                                F2 a21, F2 a22, F2 c1) noexcept
+      : d_{static_cast<value_type>(b[0])}
+      , c1_{static_cast<value_type>(c1)}
+      , c2_{static_cast<value_type>(
+            (b[2] - b[0] * (a11 * a22 - a12 * a21) + c1 * a22) / a21)}
+      , a11_{static_cast<value_type>(a11)}
+      , a12_{static_cast<value_type>(a12)}
+      , a21_{static_cast<value_type>(a21)}
+      , a22_{static_cast<value_type>(a22)} {}
+
+  constexpr value_type a1() const noexcept { return -(a11_ + a22_); }
+
+  constexpr value_type a2() const noexcept {
+    return a11_ * a22_ - a12_ * a21_;
+  }
+
+  value_type const d_, c1_, c2_;
+  value_type const a11_, a12_, a21_, a22_;
+};
+
+/**
+ * Tags to select the realization structure of an SOS design
+ *
+ * Each structure provides its own section type, which defines the
+ * state type and the per-sample and block kernels.
+ */
+namespace sos_structure {
+
+struct df1 {
+  template <typename F>
+  using section = sos_df1_section<F>;
+};
+
+struct df2t {
+  template <typename F>
+  using section = sos_section<F>;
+};
+
+struct tdf1 {
+  template <typename F>
+  using section = sos_tdf1_section<F>;
+};
+
+struct coupled {
+  template <typename F>
+  using section = sos_coupled_section<F>;
+};
+
+} // namespace sos_structure
+
+namespace sos_instrumentation {
+
+/**
+ * No instrumentation, this is the default and costs nothing
+ */
+struct none {};
+
+/**
+ * Per-section peak magnitude of the state and saturation counters
+ *
+ * See `sos_section_stats`. The instance processes blocks sample by
+ * sample in this mode, so use it for diagnostic builds.
+ */
+struct statistics {};
+
+} // namespace sos_instrumentation
+
+/**
+ * Runtime statistics of a single section
+ *
+ * `peak` is the largest magnitude of any state variable seen so far.
+ * `saturations` counts the samples after which the magnitude of any state
+ * variable was at or above the saturation limit. The default limit is
+ * half of the largest value of the type, i.e. one more doubling would
+ * overflow a wrapping fixed point type. Comparing `peak` against the
+ * range of the type shows how much headroom is left, so narrower types
+ * can be chosen safely.
+ */
+template <typename F>
+struct sos_section_stats {
+  F peak{};
+  std::uint32_t saturations{};
+};
+
+/**
+ * Largest magnitude of any variable in a section state
+ *
+ * Specializations exist for all state types in this library. Specialize
+ * it for state types of custom sections to use them with
+ * `sos_instrumentation::statistics`.
+ */
+template <typename State>
+struct sos_state_peak;
+
+namespace detail {
+
+template <typename F>
+auto magnitude(F x) -> F {
+  return x < F{0} ? -x : x;
+}
+
+template <typename F>
+auto max_magnitude(F a, F b) -> F {
+  return magnitude(a) < magnitude(b) ? magnitude(b) : magnitude(a);
+}
+
+template <typename F>
+auto max_magnitude(F a, F b, F c, F d) -> F {
+  return max_magnitude(max_magnitude(a, b), max_magnitude(c, d));
+}
+
+template <typename Instrumentation, typename Section, std::size_t N>
+class sos_instrumented;
+
+template <typename Section, std::size_t N>
+class sos_instrumented<sos_instrumentation::none, Section, N> {
+ protected:
+  using value_type = typename Section::value_type;
+  using state_type = typename Section::state_type;
+
+  static value_type filter(cmath::vector<Section, N> const& sos,
+                           std::array<state_type, N>& state, value_type x) {
+    return filter_chain<Section, N>{}(sos, state, x);
+  }
+
+  static void
+  filter(cmath::vector<Section, N> const& sos, std::array<state_type, N>& state,
+         value_type const* in, value_type* out, std::size_t n) {
+    filter_block(sos, state, in, out, n);
+  }
+};
+
+template <typename Section, std::size_t N>
+class sos_instrumented<sos_instrumentation::statistics, Section, N> {
+ public:
+  using value_type = typename Section::value_type;
+  using stats_type = std::array<sos_section_stats<value_type>, N>;
+
+  auto statistics() const -> stats_type const& { return stats_; }
+
+  void reset_statistics() { stats_ = stats_type{}; }
+
+  void set_saturation_limit(value_type limit) { limit_ = limit; }
+
+  auto saturation_limit() const -> value_type { return limit_; }
+
+ protected:
+  using state_type = typename Section::state_type;
+
+  value_type filter(cmath::vector<Section, N> const& sos,
+                    std::array<state_type, N>& state, value_type x) {
+    for (std::size_t i = 0; i < N; ++i) {
+      x = sos[i].filter(state[i], x);
+      record(stats_[i], sos_state_peak<state_type>::peak(state[i]));
+    }
+    return x;
+  }
+
+  void
+  filter(cmath::vector<Section, N> const& sos, std::array<state_type, N>& state,
+         value_type const* in, value_type* out, std::size_t n) {
+    for (std::size_t k = 0; k < n; ++k) {
+      out[k] = filter(sos, state, in[k]);
+    }
+  }
+
+ private:
+  void record(sos_section_stats<value_type>& stats, value_type peak) const {
+    if (stats.peak < peak) {
+      stats.peak = peak;
+    }
+    if (!(peak < limit_)) {
+      ++stats.saturations;
+    }
+  }
+
+  stats_type stats_{};
+  value_type limit_{std::numeric_limits<value_type>::max() / value_type{2}};
+};
+
+} // namespace detail
+
+template <typename F>
+struct sos_state_peak<sos_state<F>> {
+  static auto peak(sos_state<F> const& s) -> F {
+    return detail::max_magnitude(s.y1, s.y2);
+  }
+};
+
+template <typename F>
+struct sos_state_peak<sos_df1_state<F>> {
+  static auto peak(sos_df1_state<F> const& s) -> F {
+    return detail::max_magnitude(s.x1, s.x2, s.y1, s.y2);
+  }
+};
+
+template <typename F>
+struct sos_state_peak<sos_tdf1_state<F>> {
+  static auto peak(sos_tdf1_state<F> const& s) -> F {
+    return detail::max_magnitude(s.p1, s.p2, s.z1, s.z2);
+  }
+};
+
+template <typename F>
+struct sos_state_peak<sos_coupled_state<F>> {
+  static auto peak(sos_coupled_state<F> const& s) -> F {
+    return detail::max_magnitude(s.s1, s.s2);
+  }
+};
+
+template <typename F, std::size_t N,
+          typename Structure = sos_structure::df2t,
+          typename Instrumentation = sos_instrumentation::none>
 class sos_instance;
 
-template <typename F, std::size_t N>
+template <typename F, std::size_t N,
+          typename Structure = sos_structure::df2t>
+class sos_pipelined_instance;
+
+template <typename F, std::size_t N, std::size_t Channels>
+class sos_multichannel_instance;
+
+template <typename F, std::size_t N,
+          typename Structure = sos_structure::df2t>
 class sos_design {
  public:
   static constexpr std::size_t sos_count{(N + 1) / 2};
-  using sos_array = cmath::vector<sos_section<F>, sos_count>;
+  using structure = Structure;
+  using section_type = typename Structure::template section<F>;
+  using state_type = typename section_type::state_type;
+  using sos_array = cmath::vector<section_type, sos_count>;
 
   template <typename F2>
   static constexpr auto
   build_sos(detail::zpk_value<2 * sos_count, 2 * sos_count, F2> const& zpk,
             sos_gain mode) noexcept -> sos_array {
-    return detail::zpk_to_sos<F, F2, sos_count>{}(
-        zpk.zeros(), zpk.poles(),
-        mode == sos_gain::distribute ? cmath::pow(zpk.gain(), F2{1} / sos_count)
-                                     : zpk.gain(),
-        mode == sos_gain::distribute);
+    return mode == sos_gain::linf || mode == sos_gain::l2
+               ? build_scaled_sos(zpk, mode == sos_gain::l2)
+               : detail::zpk_to_sos<section_type, F2, sos_count>{}(
+                     zpk.zeros(), zpk.poles(),
+                     mode == sos_gain::distribute
+                         ? cmath::pow(zpk.gain(), F2{1} / sos_count)
+                         : zpk.gain(),
+                     mode == sos_gain::distribute);
   }
 
   template <typename F2>
@@ -117,35 +625,379 @@ class sos_design {
 
   constexpr auto sos() const noexcept -> sos_array const& { return sos_; }
 
-  constexpr auto instance() const noexcept -> sos_instance<F, N> {
-    return sos_instance<F, N>{this};
+  template <typename Instrumentation = sos_instrumentation::none>
+  constexpr auto instance() const noexcept
+      -> sos_instance<F, N, Structure, Instrumentation> {
+    return sos_instance<F, N, Structure, Instrumentation>{this};
+  }
+
+  constexpr auto pipelined_instance() const noexcept
+      -> sos_pipelined_instance<F, N, Structure> {
+    return sos_pipelined_instance<F, N, Structure>{this};
+  }
+
+  template <std::size_t Channels>
+  constexpr auto multichannel_instance() const noexcept
+      -> sos_multichannel_instance<F, N, Channels> {
+    static_assert(std::is_same<Structure, sos_structure::df2t>::value,
+                  "multichannel instances require the df2t structure");
+    return sos_multichannel_instance<F, N, Channels>{this};
   }
 
  private:
+  template <typename F2>
+  static constexpr auto build_scaled_sos(
+      detail::zpk_value<2 * sos_count, 2 * sos_count, F2> const& zpk,
+      bool reverse) noexcept -> sos_array {
+    return reverse ? detail::zpk_to_sos<section_type, F2, sos_count>{}(
+                         zpk.zeros(), zpk.poles(), scaled_gains(zpk, true))
+                         .reverse()
+                   : detail::zpk_to_sos<section_type, F2, sos_count>{}(
+                         zpk.zeros(), zpk.poles(), scaled_gains(zpk, false));
+  }
+
+  // The norms are computed in the design precision, using the same
+  // pairing as build_sos(), but with unit gain sections.
+  template <typename F2>
+  static constexpr auto scaled_gains(
+      detail::zpk_value<2 * sos_count, 2 * sos_count, F2> const& zpk,
+      bool reverse) noexcept -> cmath::vector<F2, sos_count> {
+    return reverse ? detail::sos_norm_gains<sos_section<F2>, sos_count>(
+                         unit_sos(zpk).reverse(), false)(zpk.gain())
+                         .reverse()
+                   : detail::sos_norm_gains<sos_section<F2>, sos_count>(
+                         unit_sos(zpk), true)(zpk.gain());
+  }
+
+  template <typename F2>
+  static constexpr auto
+  unit_sos(detail::zpk_value<2 * sos_count, 2 * sos_count, F2> const& zpk)
+      noexcept -> cmath::vector<sos_section<F2>, sos_count> {
+    return detail::zpk_to_sos<sos_section<F2>, F2, sos_count>{}(
+        zpk.zeros(), zpk.poles(), F2{1}, true);
+  }
+
   sos_array const sos_;
 };
 
-template <typename F, std::size_t N>
-class sos_instance {
+/**
+ * Designs for a linear grid of frequencies
+ *
+ * Built at compile time by `iirfilter::lowpass_bank()` or
+ * `iirfilter::highpass_bank()`, so a filter can be retuned at runtime
+ * by selecting a precomputed design instead of running the design code
+ * on the target:
+ *
+ *   constexpr auto bank = iirfilter<double>(fs).lowpass_bank<float, 64>(
+ *       butterworth<4>(), 100.0, 2000.0);
+ *
+ *   auto filter = bank.design(0).instance();
+ *   filter.set_design(&bank.nearest(f));
+ */
+template <typename F, std::size_t N, std::size_t Count,
+          typename Structure = sos_structure::df2t>
+class sos_design_bank {
+ public:
+  using value_type = F;
+  using design_type = sos_design<value_type, N, Structure>;
+  using design_array = cmath::vector<design_type, Count>;
+
+  static_assert(Count >= 2, "a bank needs at least two designs");
+
+  template <typename T>
+  constexpr sos_design_bank(design_array const& designs, T fmin,
+                            T fmax) noexcept
+      : designs_{designs}
+      , fmin_(fmin)
+      , step_((fmax - fmin) / (Count - 1)) {}
+
+  static constexpr std::size_t size() noexcept { return Count; }
+
+  constexpr auto design(std::size_t i) const noexcept -> design_type const& {
+    return designs_[i];
+  }
+
+  constexpr auto frequency(std::size_t i) const noexcept -> value_type {
+    return fmin_ + step_ * static_cast<value_type>(i);
+  }
+
+  // Index of the grid frequency closest to `f`, clamped to the grid
+  constexpr auto index(value_type f) const noexcept -> std::size_t {
+    return f <= fmin_ ? 0 : clamp_index((f - fmin_) / step_ + value_type{0.5});
+  }
+
+  constexpr auto nearest(value_type f) const noexcept -> design_type const& {
+    return designs_[index(f)];
+  }
+
+ private:
+  static constexpr auto clamp_index(value_type i) noexcept -> std::size_t {
+    return i >= static_cast<value_type>(Count - 1)
+               ? Count - 1
+               : static_cast<std::size_t>(i);
+  }
+
+  design_array const designs_;
+  value_type const fmin_;
+  value_type const step_;
+};
+
+/**
+ * Filter instance of an `sos_design`
+ *
+ * With `sos_instrumentation::statistics`, the instance also provides
+ * `statistics()`, `reset_statistics()` and `set_saturation_limit()`.
+ */
+template <typename F, std::size_t N, typename Structure,
+          typename Instrumentation>
+class sos_instance
+    : public detail::sos_instrumented<
+          Instrumentation,
+          typename sos_design<F, N, Structure>::section_type, (N + 1) / 2> {
  public:
   static constexpr std::size_t sos_count{(N + 1) / 2};
   using value_type = F;
+  using design_type = sos_design<value_type, N, Structure>;
+  using state_type = typename design_type::state_type;
 
-  sos_instance(sos_design<value_type, N> const* i) noexcept
+  constexpr sos_instance(design_type const* i) noexcept
       : impl_{i} {}
 
   value_type operator()(value_type x) {
-    return detail::filter_chain<value_type, sos_count>{}(impl_->sos(), state_,
-                                                         x);
+    return this->filter(impl_->sos(), state_, x);
+  }
+
+  void process(value_type const* in, value_type* out, std::size_t n) {
+    this->filter(impl_->sos(), state_, in, out, n);
+  }
+
+  void process(value_type* data, std::size_t n) { process(data, data, n); }
+
+  // Switch to another design of the same order and structure, e.g. from
+  // an `sos_design_bank`. The filter state is kept, so there is no
+  // restart transient. This must be called from the same context as
+  // `process()`; use `sos_retunable_instance` to retune from an ISR or
+  // another thread.
+  void set_design(design_type const* d) noexcept { impl_ = d; }
+
+  auto design() const noexcept -> design_type const* { return impl_; }
+
+  auto state() const -> std::array<state_type, sos_count> const& {
+    return state_;
+  }
+
+ private:
+  design_type const* impl_;
+  std::array<state_type, sos_count> state_{};
+};
+
+/**
+ * Filter instance whose design can be swapped from another context
+ *
+ * `set_design()` may be called from an ISR or another thread while the
+ * instance is filtering. The new design is only published to a pending
+ * slot, which is picked up at the start of the next call to `process()`
+ * or `operator()`, so the filter loop itself still works on a plain
+ * pointer. Prefer `process()` on blocks, as each call costs an atomic
+ * exchange.
+ */
+template <typename F, std::size_t N,
+          typename Structure = sos_structure::df2t,
+          typename Instrumentation = sos_instrumentation::none>
+class sos_retunable_instance
+    : public sos_instance<F, N, Structure, Instrumentation> {
+  using base = sos_instance<F, N, Structure, Instrumentation>;
+
+ public:
+  using typename base::design_type;
+  using typename base::value_type;
+
+  sos_retunable_instance(design_type const* i) noexcept
+      : base{i} {}
+
+  sos_retunable_instance(sos_retunable_instance const&) = delete;
+  sos_retunable_instance& operator=(sos_retunable_instance const&) = delete;
+
+  value_type operator()(value_type x) {
+    update();
+    return base::operator()(x);
+  }
+
+  void process(value_type const* in, value_type* out, std::size_t n) {
+    update();
+    base::process(in, out, n);
+  }
+
+  void process(value_type* data, std::size_t n) { process(data, data, n); }
+
+  // Publish a new design, which takes effect with the next call
+  void set_design(design_type const* d) noexcept {
+    pending_.store(d, std::memory_order_release);
+  }
+
+ private:
+  void update() noexcept {
+    if (auto d = pending_.exchange(nullptr, std::memory_order_acquire)) {
+      base::set_design(d);
+    }
+  }
+
+  std::atomic<design_type const*> pending_{nullptr};
+};
+
+/**
+ * Filter instance bound to a design at compile time
+ *
+ * Unlike `sos_instance`, this doesn't store a pointer to the design, but
+ * takes a reference to a constexpr design with static storage duration
+ * as a template argument. The instance only holds the filter state and
+ * all coefficients are known to the compiler, so they can be used as
+ * immediates.
+ *
+ *   constexpr auto design = iirfilter<double>(fs).lowpass(...).sos<float>();
+ *
+ *   sos_static_instance<decltype(design), design> filter;
+ */
+template <typename Design, Design const& D>
+class sos_static_instance {
+ public:
+  using design_type = typename std::remove_const<Design>::type;
+  using section_type = typename design_type::section_type;
+  using state_type = typename design_type::state_type;
+  using value_type = typename section_type::value_type;
+  static constexpr std::size_t sos_count{design_type::sos_count};
+
+  static constexpr auto design() noexcept -> design_type const& { return D; }
+
+  value_type operator()(value_type x) {
+    return detail::filter_chain<section_type, sos_count>{}(D.sos(), state_, x);
+  }
+
+  void process(value_type const* in, value_type* out, std::size_t n) {
+    D.sos()[0].filter(state_[0], in, out, n);
+    detail::filter_block_chain<section_type, sos_count>{}(D.sos(), state_, out,
+                                                          n);
+  }
+
+  void process(value_type* data, std::size_t n) { process(data, data, n); }
+
+  auto state() const -> std::array<state_type, sos_count> const& {
+    return state_;
+  }
+
+ private:
+  std::array<state_type, sos_count> state_{};
+};
+
+/**
+ * Software-pipelined filter instance
+ *
+ * In a regular cascade, each section has to wait for the output of the
+ * previous section for the same sample, so the time per sample is the
+ * sum of the latencies of all sections. In this instance, section k
+ * works on sample n - k, i.e. on the output the previous section
+ * produced one step earlier. All sections are independent within a
+ * step and can execute in parallel.
+ *
+ * The price is a delay: the output is identical to that of a regular
+ * `sos_instance`, but delayed by `latency()` samples, i.e. one sample
+ * less than the number of sections.
+ */
+template <typename F, std::size_t N, typename Structure>
+class sos_pipelined_instance {
+ public:
+  static constexpr std::size_t sos_count{(N + 1) / 2};
+  using value_type = F;
+  using design_type = sos_design<value_type, N, Structure>;
+  using section_type = typename design_type::section_type;
+  using state_type = typename design_type::state_type;
+
+  constexpr sos_pipelined_instance(design_type const* i) noexcept
+      : impl_{i} {}
+
+  static constexpr std::size_t latency() noexcept { return sos_count - 1; }
+
+  value_type operator()(value_type x) {
+    detail::pipeline_step<section_type, sos_count>{}(impl_->sos(), state_,
+                                                     pipe_, x);
+    return pipe_[sos_count - 1];
+  }
+
+  void process(value_type const* in, value_type* out, std::size_t n) {
+    using step = detail::pipeline_step<section_type, sos_count>;
+    auto const& sos = impl_->sos();
+    auto state = state_;
+    auto pipe = pipe_;
+    for (std::size_t i = 0; i < n; ++i) {
+      step{}(sos, state, pipe, in[i]);
+      out[i] = pipe[sos_count - 1];
+    }
+    state_ = state;
+    pipe_ = pipe;
+  }
+
+  void process(value_type* data, std::size_t n) { process(data, data, n); }
+
+  auto state() const -> std::array<state_type, sos_count> const& {
+    return state_;
+  }
+
+ private:
+  design_type const* impl_;
+  std::array<state_type, sos_count> state_{};
+  std::array<value_type, sos_count> pipe_{};
+};
+
+/**
+ * Filter instance for running the same design on multiple channels
+ *
+ * Samples are passed in frames of `Channels` values, one per channel.
+ * Blocks of frames are stored interleaved, i.e. frame by frame. The
+ * filter state for all channels is kept as structure-of-arrays, so each
+ * section step is vectorized across channels (SSE/AVX on x86, NEON/Helium
+ * on ARM, see `LIBEMB_SIMD_BYTES`), with a scalar fallback for the
+ * remaining channels or if the target has no SIMD support.
+ */
+template <typename F, std::size_t N, std::size_t Channels>
+class sos_multichannel_instance {
+ public:
+  static constexpr std::size_t sos_count{(N + 1) / 2};
+  using value_type = F;
+  using state_type = sos_multichannel_state<value_type, Channels>;
+
+  static_assert(Channels > 0, "number of channels must be non-zero");
+
+  constexpr sos_multichannel_instance(
+      sos_design<value_type, N> const* i) noexcept
+      : impl_{i} {}
+
+  static constexpr std::size_t channels() noexcept { return Channels; }
+
+  void operator()(value_type const* x, value_type* y) {
+    auto const& sos = impl_->sos();
+    sos[0].filter(state_[0], x, y);
+    for (std::size_t i = 1; i < sos_count; ++i) {
+      sos[i].filter(state_[i], y, y);
+    }
+  }
+
+  void process(value_type const* in, value_type* out, std::size_t frames) {
+    for (std::size_t i = 0; i < frames; ++i) {
+      (*this)(in + i * Channels, out + i * Channels);
+    }
+  }
+
+  void process(value_type* data, std::size_t frames) {
+    process(data, data, frames);
   }
 
-  auto state() const -> std::array<sos_state<value_type>, sos_count> const& {
+  auto state() const -> std::array<state_type, sos_count> const& {
     return state_;
   }
 
  private:
   sos_design<value_type, N> const* impl_;
-  std::array<sos_state<value_type>, sos_count> state_{};
+  std::array<state_type, sos_count> state_{};
 };
 
 } // namespace signal
@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "config.h"
+
+#include "detail/circular_buffer_adapter.h"
+
+namespace embedded {
+
+/**
+ * A lock-free single-producer, single-consumer circular buffer adapter
+ *
+ * Like `circular_buffer_adapter`, this manages arbitrary memory as a
+ * circular buffer, but one producer (e.g. an interrupt handler) can add
+ * items at the back while one consumer (e.g. the main loop) removes items
+ * from the front, without any locking.
+ *
+ * The producer may only call `try_push_back()`, `try_emplace_back()`,
+ * `copy_in_back()`, `reserve_back()`, `commit_back()` and `remaining()`,
+ * the consumer may only call `front()`, `pop_front()`, `try_pop_front()`,
+ * `copy_out_front()`, `peek_front()`, `consume_front()` and
+ * `first_index()`. `size()`, `empty()` and `full()` can be called from
+ * either side and return a snapshot.
+ *
+ * The read and write indices are atomics that are only ever loaded and
+ * stored, so no read-modify-write instructions are needed, which makes
+ * this lock-free on all Cortex-M cores. Each side caches the last index
+ * it has seen from the other side and only reloads it when necessary,
+ * and the bulk operations publish their index once per batch. On hosts,
+ * the indices of both sides live in separate cache lines (see
+ * `LIBEMB_CACHE_LINE_SIZE`).
+ *
+ * Object lifetime is handled in the same way as by `circular_buffer_adapter`.
+ */
+template <typename T>
+class spsc_circular_buffer_adapter {
+ public:
+  using value_type = T;
+  using reference = T&;
+  using const_reference = T const&;
+  using pointer = T*;
+  using const_pointer = T const*;
+  using size_type = std::size_t;
+
+  using array_range = detail::cba_array_range<T>;
+  using array_ranges = detail::cba_array_ranges<T>;
+
+  spsc_circular_buffer_adapter(pointer data, size_type capacity)
+      : spsc_circular_buffer_adapter(data, capacity, 0, 0) {}
+
+  spsc_circular_buffer_adapter(pointer data, size_type capacity,
+                               size_type first_index, size_type item_count)
+      : begin_{data}
+      , capacity_{capacity}
+      , producer_{advance(first_index, item_count), first_index}
+      , consumer_{first_index, advance(first_index, item_count)} {
+    assert(capacity_ > 0);
+    assert(capacity_ <= static_cast<size_type>(-1) / 2);
+    assert(first_index < capacity_);
+    assert(item_count <= capacity_);
+  }
+
+  spsc_circular_buffer_adapter(pointer begin, pointer end)
+      : spsc_circular_buffer_adapter(begin,
+                                     static_cast<size_type>(end - begin)) {}
+
+  spsc_circular_buffer_adapter(spsc_circular_buffer_adapter const&) = delete;
+  spsc_circular_buffer_adapter&
+  operator=(spsc_circular_buffer_adapter const&) = delete;
+
+  size_type capacity() const { return capacity_; }
+
+  size_type size() const {
+    auto const head = consumer_.head.load(std::memory_order_acquire);
+    return distance(head, producer_.tail.load(std::memory_order_acquire));
+  }
+
+  bool empty() const { return size() == 0; }
+  bool full() const { return size() == capacity_; }
+
+  size_type remaining() const {
+    auto const tail = producer_.tail.load(std::memory_order_relaxed);
+    return capacity_ -
+           distance(consumer_.head.load(std::memory_order_acquire), tail);
+  }
+
+  bool try_push_back(value_type const& value) {
+    return try_emplace_back(value);
+  }
+
+  bool try_push_back(value_type&& value) {
+    return try_emplace_back(std::move(value));
+  }
+
+  template <typename... Args>
+  bool try_emplace_back(Args&&... args) {
+    auto const tail = producer_.tail.load(std::memory_order_relaxed);
+    if (writable(tail, 1) == 0) {
+      return false;
+    }
+    new (slot(tail)) value_type(std::forward<Args>(args)...);
+    producer_.tail.store(advance(tail, 1), std::memory_order_release);
+    return true;
+  }
+
+  reference front() const {
+    auto const head = consumer_.head.load(std::memory_order_relaxed);
+    auto const ready = readable(head, 1);
+    assert(ready > 0);
+    static_cast<void>(ready);
+    return *slot(head);
+  }
+
+  void pop_front() {
+    auto const head = consumer_.head.load(std::memory_order_relaxed);
+    assert(readable(head, 1) > 0);
+    slot(head)->~value_type();
+    consumer_.head.store(advance(head, 1), std::memory_order_release);
+  }
+
+  bool try_pop_front(value_type& value) {
+    auto const head = consumer_.head.load(std::memory_order_relaxed);
+    if (readable(head, 1) == 0) {
+      return false;
+    }
+    auto const p = slot(head);
+    value = std::move(*p);
+    p->~value_type();
+    consumer_.head.store(advance(head, 1), std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Copy up to `count` items to the back and publish them at once
+   *
+   * Returns the number of items copied, which is less than `count` if
+   * there isn't enough space.
+   */
+  template <typename U,
+            typename std::enable_if<std::is_trivial<U>::value &&
+                                        std::is_same<U, value_type>::value,
+                                    bool>::type = true>
+  size_type copy_in_back(U const* data, size_type count) {
+    auto const tail = producer_.tail.load(std::memory_order_relaxed);
+    auto const n = min(count, writable(tail, count));
+    auto const dest = position(tail);
+    auto const count_a = min(n, capacity_ - dest);
+    std::memcpy(begin_ + dest, data, sizeof(U) * count_a);
+    if (count_a < n) {
+      std::memcpy(begin_, data + count_a, sizeof(U) * (n - count_a));
+    }
+    producer_.tail.store(advance(tail, n), std::memory_order_release);
+    return n;
+  }
+
+  /**
+   * Copy up to `count` items from the front and release them at once
+   *
+   * Returns the number of items copied, which is less than `count` if
+   * fewer items are available.
+   */
+  template <typename U,
+            typename std::enable_if<std::is_trivial<U>::value &&
+                                        std::is_same<U, value_type>::value,
+                                    bool>::type = true>
+  size_type copy_out_front(U* data, size_type count) {
+    auto const head = consumer_.head.load(std::memory_order_relaxed);
+    auto const n = min(count, readable(head, count));
+    auto const src = position(head);
+    auto const count_a = min(n, capacity_ - src);
+    std::memcpy(data, begin_ + src, sizeof(U) * count_a);
+    if (count_a < n) {
+      std::memcpy(data + count_a, begin_, sizeof(U) * (n - count_a));
+    }
+    consumer_.head.store(advance(head, n), std::memory_order_release);
+    return n;
+  }
+
+  /**
+   * Up to `count` free slots at the back, in at most two contiguous runs
+   *
+   * This allows the producer to write directly into the memory (e.g. with
+   * DMA). The items are only published with `commit_back()`.
+   */
+  array_ranges reserve_back(size_type count) {
+    auto const tail = producer_.tail.load(std::memory_order_relaxed);
+    return ranges(tail, min(count, writable(tail, count)));
+  }
+
+  /**
+   * Publish `count` items previously written to the `reserve_back()` slots
+   */
+  void commit_back(size_type count) {
+    auto const tail = producer_.tail.load(std::memory_order_relaxed);
+    assert(count <= writable(tail, count));
+    producer_.tail.store(advance(tail, count), std::memory_order_release);
+  }
+
+  /**
+   * Up to `count` items at the front, in at most two contiguous runs
+   *
+   * This allows the consumer to process items in place. The items are
+   * only released to the producer with `consume_front()`.
+   */
+  array_ranges peek_front(size_type count) const {
+    auto const head = consumer_.head.load(std::memory_order_relaxed);
+    return ranges(head, min(count, readable(head, count)));
+  }
+
+  /**
+   * Release `count` items at the front, destroying them
+   */
+  void consume_front(size_type count) {
+    auto const head = consumer_.head.load(std::memory_order_relaxed);
+    assert(count <= readable(head, count));
+    for (size_type i = 0; i < count && !std::is_trivial<T>::value; ++i) {
+      slot(advance(head, i))->~value_type();
+    }
+    consumer_.head.store(advance(head, count), std::memory_order_release);
+  }
+
+  /**
+   * Index of the front item in the underlying memory
+   */
+  size_type first_index() const {
+    return position(consumer_.head.load(std::memory_order_relaxed));
+  }
+
+ private:
+  static constexpr size_type line_size =
+      LIBEMB_CACHE_LINE_SIZE > alignof(std::atomic<size_type>)
+          ? LIBEMB_CACHE_LINE_SIZE
+          : alignof(std::atomic<size_type>);
+
+  struct alignas(line_size) producer_side {
+    producer_side(size_type tail, size_type head)
+        : tail{tail}
+        , head_cache{head} {}
+
+    std::atomic<size_type> tail;
+    size_type head_cache;
+  };
+
+  struct alignas(line_size) consumer_side {
+    consumer_side(size_type head, size_type tail)
+        : head{head}
+        , tail_cache{tail} {}
+
+    std::atomic<size_type> head;
+    size_type tail_cache;
+  };
+
+  static size_type min(size_type a, size_type b) { return a < b ? a : b; }
+
+  // Indices run from 0 to 2 * capacity, so a full buffer can be told
+  // apart from an empty one without wasting a slot
+
+  size_type advance(size_type index, size_type n) const {
+    index += n;
+    return index < 2 * capacity_ ? index : index - 2 * capacity_;
+  }
+
+  size_type distance(size_type from, size_type to) const {
+    return to >= from ? to - from : to + 2 * capacity_ - from;
+  }
+
+  size_type position(size_type index) const {
+    return index < capacity_ ? index : index - capacity_;
+  }
+
+  pointer slot(size_type index) const { return begin_ + position(index); }
+
+  array_ranges ranges(size_type index, size_type count) const {
+    auto const pos = position(index);
+    auto const one = min(count, capacity_ - pos);
+    return {{begin_ + pos, one}, {begin_, count - one}};
+  }
+
+  // Free space as seen by the producer, reloading the consumer's index
+  // only if the cached one doesn't leave room for `wanted` items
+  size_type writable(size_type tail, size_type wanted) {
+    auto free = capacity_ - distance(producer_.head_cache, tail);
+    if (free < wanted) {
+      producer_.head_cache = consumer_.head.load(std::memory_order_acquire);
+      free = capacity_ - distance(producer_.head_cache, tail);
+    }
+    return free;
+  }
+
+  // Available items as seen by the consumer, reloading the producer's
+  // index only if the cached one doesn't provide `wanted` items
+  size_type readable(size_type head, size_type wanted) const {
+    auto ready = distance(head, consumer_.tail_cache);
+    if (ready < wanted) {
+      consumer_.tail_cache = producer_.tail.load(std::memory_order_acquire);
+      ready = distance(head, consumer_.tail_cache);
+    }
+    return ready;
+  }
+
+  pointer const begin_;
+  size_type const capacity_;
+  producer_side producer_;
+  consumer_side mutable consumer_;
+};
+
+template <typename T>
+constexpr typename spsc_circular_buffer_adapter<T>::size_type
+    spsc_circular_buffer_adapter<T>::line_size;
+
+} // namespace embedded
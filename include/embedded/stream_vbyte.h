@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "utility/integer_sequence.h"
+#include "varint.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace embedded {
+
+namespace detail {
+
+// number of data bytes of value `k` in a group with control byte `c`
+constexpr std::uint8_t svb_length(unsigned c, unsigned k) {
+  return static_cast<std::uint8_t>(((c >> (2 * k)) & 3) + 1);
+}
+
+constexpr std::uint8_t svb_offset(unsigned c, unsigned k) {
+  return k == 0 ? 0
+                : static_cast<std::uint8_t>(svb_offset(c, k - 1) +
+                                            svb_length(c, k - 1));
+}
+
+// source byte of output byte `j`, or 0xFF for a zero byte
+constexpr std::uint8_t svb_shuffle_byte(unsigned c, unsigned j) {
+  return j % 4 < svb_length(c, j / 4)
+             ? static_cast<std::uint8_t>(svb_offset(c, j / 4) + j % 4)
+             : 0xFF;
+}
+
+struct svb_shuffle {
+  alignas(16) std::uint8_t mask[16];
+};
+
+constexpr svb_shuffle svb_make_shuffle(unsigned c) {
+  return {{svb_shuffle_byte(c, 0), svb_shuffle_byte(c, 1),
+           svb_shuffle_byte(c, 2), svb_shuffle_byte(c, 3),
+           svb_shuffle_byte(c, 4), svb_shuffle_byte(c, 5),
+           svb_shuffle_byte(c, 6), svb_shuffle_byte(c, 7),
+           svb_shuffle_byte(c, 8), svb_shuffle_byte(c, 9),
+           svb_shuffle_byte(c, 10), svb_shuffle_byte(c, 11),
+           svb_shuffle_byte(c, 12), svb_shuffle_byte(c, 13),
+           svb_shuffle_byte(c, 14), svb_shuffle_byte(c, 15)}};
+}
+
+// shuffle masks and total data lengths for all 256 control bytes
+template <std::size_t... C>
+struct svb_tables {
+  static constexpr svb_shuffle shuffle[sizeof...(C)] = {
+      svb_make_shuffle(C)...};
+  static constexpr std::uint8_t length[sizeof...(C)] = {
+      static_cast<std::uint8_t>(svb_offset(C, 4))...};
+};
+
+template <std::size_t... C>
+constexpr svb_shuffle svb_tables<C...>::shuffle[sizeof...(C)];
+
+template <std::size_t... C>
+constexpr std::uint8_t svb_tables<C...>::length[sizeof...(C)];
+
+template <std::size_t... C>
+svb_tables<C...> svb_make_tables(index_sequence<C...>);
+
+using svb_table = decltype(svb_make_tables(make_index_sequence<256>{}));
+
+} // namespace detail
+
+/**
+ * Stream VByte encoding / decoding of 32-bit integers
+ *
+ * Like `varint`, this stores each value in as few bytes as possible, but
+ * the lengths are kept separately from the data: the encoding starts with
+ * one control byte per group of four values, holding the length in bytes
+ * (minus one) of each value in two bits, lowest bits first. This is
+ * followed by the data bytes of all values, least significant byte first.
+ *
+ * https://arxiv.org/abs/1709.08990
+ *
+ * As the lengths of a group are known from a single byte, decoding doesn't
+ * have to test every byte. With SSSE3, AVX2 or AArch64 NEON, a group is
+ * decoded with a single byte shuffle from a table of 256 masks (8 values
+ * per step with AVX2). Encoding is scalar only, so it can be done on the
+ * device, while the host decodes in bulk. Signed values are zig-zag
+ * encoded first, see `varint::zig_zag_encode`.
+ */
+class stream_vbyte {
+ public:
+  /**
+   * Size of the control bytes for `count` values
+   */
+  static constexpr std::size_t control_size(std::size_t count) {
+    return (count + 3) / 4;
+  }
+
+  /**
+   * Upper bound of the encoded size of `count` values
+   */
+  static constexpr std::size_t max_size(std::size_t count) {
+    return control_size(count) + 4 * count;
+  }
+
+  /**
+   * Return the number of bytes required to encode `count` values
+   */
+  static std::size_t size(std::uint32_t const* in, std::size_t count) {
+    std::size_t total = control_size(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      total += length(in[i]);
+    }
+    return total;
+  }
+
+  static std::size_t size(std::int32_t const* in, std::size_t count) {
+    std::size_t total = control_size(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      total += length(varint::zig_zag_encode(in[i]));
+    }
+    return total;
+  }
+
+  /**
+   * Encode `count` values
+   *
+   * \param in       Pointer to the values to encode.
+   *
+   * \param count    Number of values to encode.
+   *
+   * \param out      Pointer to the encoding buffer, which must have room
+   *                 for `size(in, count)` or `max_size(count)` bytes.
+   *
+   * \returns Pointer to end of encoding.
+   */
+  static std::uint8_t*
+  encode(std::uint32_t const* in, std::size_t count, std::uint8_t* out) {
+    return encode_impl(in, count, out, [](std::uint32_t v) { return v; });
+  }
+
+  static std::uint8_t*
+  encode(std::int32_t const* in, std::size_t count, std::uint8_t* out) {
+    return encode_impl(in, count, out, [](std::int32_t v) {
+      return varint::zig_zag_encode(v);
+    });
+  }
+
+  /**
+   * Decode `count` values
+   *
+   * \param begin    Pointer to start of encoding buffer.
+   *
+   * \param end      Pointer to end of encoding buffer.
+   *
+   * \param out      Pointer to the decoded output values.
+   *
+   * \param count    Number of values to decode.
+   *
+   * \returns Pointer to end of encoding, or `begin` if the encoding
+   *          continues past the end of the encoding buffer.
+   */
+  static std::uint8_t const* decode(std::uint8_t const* begin,
+                                    std::uint8_t const* end,
+                                    std::uint32_t* out, std::size_t count) {
+    if (static_cast<std::size_t>(end - begin) < control_size(count)) {
+      return begin;
+    }
+
+    auto ctrl = begin;
+    auto data = begin + control_size(count);
+    std::size_t g = 0;
+
+#if defined(__SSSE3__) || (defined(__ARM_NEON) && defined(__aarch64__))
+    auto const groups = count / 4;
+    auto const& table = detail::svb_table::shuffle;
+    auto const& length = detail::svb_table::length;
+#endif
+
+#if defined(__AVX2__)
+    for (; g + 2 <= groups && end - data >= 32; g += 2) {
+      auto const c0 = ctrl[g];
+      auto const c1 = ctrl[g + 1];
+      auto const len0 = length[c0];
+      auto const lo = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data));
+      auto const hi =
+          _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + len0));
+      auto const mlo =
+          _mm_load_si128(reinterpret_cast<__m128i const*>(table[c0].mask));
+      auto const mhi =
+          _mm_load_si128(reinterpret_cast<__m128i const*>(table[c1].mask));
+      auto const v = _mm256_shuffle_epi8(
+          _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1),
+          _mm256_inserti128_si256(_mm256_castsi128_si256(mlo), mhi, 1));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 4 * g), v);
+      data += len0 + length[c1];
+    }
+#endif
+
+#if defined(__SSSE3__) || (defined(__ARM_NEON) && defined(__aarch64__))
+    for (; g < groups && end - data >= 16; ++g) {
+      auto const c = ctrl[g];
+      auto const mask = table[c].mask;
+#if defined(__SSSE3__)
+      auto const v = _mm_shuffle_epi8(
+          _mm_loadu_si128(reinterpret_cast<__m128i const*>(data)),
+          _mm_load_si128(reinterpret_cast<__m128i const*>(mask)));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * g), v);
+#else
+      auto const v = vqtbl1q_u8(vld1q_u8(data), vld1q_u8(mask));
+      vst1q_u32(out + 4 * g, vreinterpretq_u32_u8(v));
+#endif
+      data += length[c];
+    }
+#endif
+
+    for (std::size_t i = 4 * g; i < count; ++i) {
+      auto const len = detail::svb_length(ctrl[i / 4], i % 4);
+      if (end - data < len) {
+        return begin;
+      }
+      std::uint32_t v = 0;
+      for (unsigned b = 0; b < len; ++b) {
+        v |= static_cast<std::uint32_t>(data[b]) << (8 * b);
+      }
+      out[i] = v;
+      data += len;
+    }
+
+    return data;
+  }
+
+  // signed integer version
+  static std::uint8_t const* decode(std::uint8_t const* begin,
+                                    std::uint8_t const* end, std::int32_t* out,
+                                    std::size_t count) {
+    auto const uout = reinterpret_cast<std::uint32_t*>(out);
+    auto const it = decode(begin, end, uout, count);
+    if (it != begin) {
+      for (std::size_t i = 0; i < count; ++i) {
+        out[i] = varint::zig_zag_decode(uout[i]);
+      }
+    }
+    return it;
+  }
+
+ private:
+  static std::size_t length(std::uint32_t v) {
+    return v < (1u << 8) ? 1 : v < (1u << 16) ? 2 : v < (1u << 24) ? 3 : 4;
+  }
+
+  template <typename T, typename Transform>
+  static std::uint8_t* encode_impl(T const* in, std::size_t count,
+                                   std::uint8_t* out,
+                                   Transform const& transform) {
+    auto ctrl = out;
+    auto data = out + control_size(count);
+
+    for (std::size_t i = 0; i < count; i += 4) {
+      unsigned c = 0;
+      for (std::size_t k = 0; k < 4 && i + k < count; ++k) {
+        auto v = transform(in[i + k]);
+        auto const len = length(v);
+        c |= static_cast<unsigned>(len - 1) << (2 * k);
+        for (std::size_t b = 0; b < len; ++b) {
+          *data++ = static_cast<std::uint8_t>(v);
+          v >>= 8;
+        }
+      }
+      *ctrl++ = static_cast<std::uint8_t>(c);
+    }
+
+    return data;
+  }
+};
+
+} // namespace embedded
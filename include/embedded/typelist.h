@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 namespace embedded {
 
 /**
@@ -33,6 +35,8 @@ namespace embedded {
 template <typename... Ts>
 class typelist {
  public:
+  static constexpr std::size_t size() { return sizeof...(Ts); }
+
   template <typename... Us>
   using append = typelist<Ts..., Us...>;
 
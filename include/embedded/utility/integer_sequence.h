@@ -24,6 +24,8 @@
 
 #include <cstddef>
 
+#include "../config.h"
+
 namespace embedded {
 
 template <typename T, T... Ints>
@@ -35,17 +37,76 @@ struct integer_sequence {
 template <std::size_t... Ints>
 using index_sequence = integer_sequence<std::size_t, Ints...>;
 
-template <typename T, std::size_t N, T... Is>
-struct make_integer_sequence : make_integer_sequence<T, N - 1, N - 1, Is...> {};
+namespace detail {
+
+template <typename T, typename Seq, T Offset>
+struct integer_sequence_shift;
+
+template <typename T, T... Is, T Offset>
+struct integer_sequence_shift<T, integer_sequence<T, Is...>, Offset> {
+  using type = integer_sequence<T, static_cast<T>(Offset + Is)...>;
+};
+
+#if LIBEMB_INTEGER_SEQUENCE_BUILTIN == 1
+
+template <typename T, std::size_t N>
+struct integer_sequence_builder {
+  using type = __make_integer_seq<integer_sequence, T, static_cast<T>(N)>;
+};
+
+#elif LIBEMB_INTEGER_SEQUENCE_BUILTIN == 2
+
+template <typename T, std::size_t N>
+struct integer_sequence_builder {
+  using type = integer_sequence<T, __integer_pack(static_cast<T>(N))...>;
+};
+
+#else
+
+template <typename T, typename Lo, typename Hi>
+struct integer_sequence_concat;
+
+template <typename T, T... Lo, T... Hi>
+struct integer_sequence_concat<T, integer_sequence<T, Lo...>,
+                               integer_sequence<T, Hi...>> {
+  using type =
+      integer_sequence<T, Lo..., static_cast<T>(sizeof...(Lo) + Hi)...>;
+};
+
+// Both halves differ in size by at most one, so only O(log N) distinct
+// instantiations are needed and the recursion depth is O(log N).
+template <typename T, std::size_t N>
+struct integer_sequence_builder {
+  using type = typename integer_sequence_concat<
+      T, typename integer_sequence_builder<T, N / 2>::type,
+      typename integer_sequence_builder<T, N - N / 2>::type>::type;
+};
+
+template <typename T>
+struct integer_sequence_builder<T, 0> {
+  using type = integer_sequence<T>;
+};
+
+template <typename T>
+struct integer_sequence_builder<T, 1> {
+  using type = integer_sequence<T, 0>;
+};
+
+#endif
 
-template <typename T, T... Is>
-struct make_integer_sequence<T, 0, Is...> : integer_sequence<T, Is...> {};
+} // namespace detail
 
-template <typename T, T B, T E, T... Is>
-struct make_integer_range : make_integer_range<T, B, E - 1, E - 1, Is...> {};
+template <typename T, std::size_t N>
+struct make_integer_sequence
+    : detail::integer_sequence_builder<T, N>::type {};
 
-template <typename T, T B, T... Is>
-struct make_integer_range<T, B, B, Is...> : integer_sequence<T, Is...> {};
+template <typename T, T B, T E>
+struct make_integer_range
+    : detail::integer_sequence_shift<
+          T,
+          typename detail::integer_sequence_builder<
+              T, static_cast<std::size_t>(E - B)>::type,
+          B>::type {};
 
 template <std::size_t N>
 using make_index_sequence = make_integer_sequence<std::size_t, N>;
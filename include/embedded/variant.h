@@ -34,6 +34,8 @@
 #endif
 // clang-format on
 
+#include "visit.h"
+
 namespace embedded {
 
 using namespace mpark;
@@ -22,12 +22,28 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <iterator>
 #include <type_traits>
 
+#include "config.h"
+#include "utility/integer_sequence.h"
+
+#if LIBEMB_VARINT_WORD_DECODE && defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
 namespace embedded {
 
+namespace detail {
+
+template <typename T, T... Values>
+struct varint_table;
+
+} // namespace detail
+
 /**
  * Variable length integer encoding / decoding
  *
@@ -177,6 +193,10 @@ class varint {
    *          continues past the end of the encoding buffer, the other is
    *          where the target type isn't wide enough to store the encoded
    *          value.
+   *
+   * If the input is a pointer and at least 8 bytes are readable, values
+   * of up to 8 bytes are decoded from a single 64-bit word without a loop
+   * (see `LIBEMB_VARINT_WORD_DECODE`).
    */
   template <
       typename T, typename It,
@@ -186,28 +206,10 @@ class varint {
                                uint8_t>::value,
                   "varint can only be encoded to uint8_t iterators");
 
-    constexpr int type_bits = 8 * sizeof(T);
-    constexpr int max_shift = type_bits - 1;
-    int shift = 0;
-    auto it = begin;
-
-    value = 0;
-
-    for (value = 0; it != end && shift <= max_shift; shift += 7) {
-      auto const byte = *it++;
-
-      value |= static_cast<T>(byte & 0x7f) << shift;
-
-      if (!(byte & 0x80)) {
-        if (shift > type_bits - 7 && (byte >> (type_bits - shift)) != 0) {
-          break;
-        }
-
-        return it;
-      }
-    }
-
-    return begin;
+    return decode_impl(
+        value, begin, end,
+        std::integral_constant<bool, LIBEMB_VARINT_WORD_DECODE &&
+                                         std::is_pointer<It>::value>{});
   }
 
   // signed integer version
@@ -224,6 +226,98 @@ class varint {
     return i;
   }
 
+  /**
+   * Return the number of bytes required to encode a range of values
+   *
+   * Unlike `size()`, this computes the size of each value from its number
+   * of leading zero bits rather than in a loop.
+   */
+  template <typename ForwardIt>
+  static std::size_t size_n(ForwardIt first, ForwardIt last) {
+    std::size_t total = 0;
+    for (; first != last; ++first) {
+      total += fast_size(to_unsigned(*first));
+    }
+    return total;
+  }
+
+  /**
+   * Encode a range of values
+   *
+   * The range is traversed twice, once to check the space and once to
+   * encode the values, so it must be a forward range.
+   *
+   * \param first    Iterator to the first value to encode.
+   *
+   * \param last     Iterator past the last value to encode.
+   *
+   * \param begin    Iterator to start of encoding buffer.
+   *
+   * \param end      Iterator to end of encoding buffer.
+   *
+   * \returns Iterator to end of encoding, or `begin` if there was not enough
+   *          space for the encoding. The space is checked once up front, so
+   *          in the error case, the buffer is left untouched.
+   */
+  template <typename ForwardIt, typename It>
+  static It encode_n(ForwardIt first, ForwardIt last, It begin, It end) {
+    if (size_n(first, last) >
+        static_cast<std::size_t>(std::distance(begin, end))) {
+      return begin;
+    }
+    for (; first != last; ++first) {
+      begin = encode(*first, begin);
+    }
+    return begin;
+  }
+
+  /**
+   * Decode `count` values
+   *
+   * \param begin    Iterator to start of encoding buffer.
+   *
+   * \param end      Iterator to end of encoding buffer.
+   *
+   * \param out      Pointer to the decoded output values.
+   *
+   * \param count    Number of values to decode.
+   *
+   * \returns Iterator to end of encoding, or `begin` if any of the values
+   *          could not be decoded (see `decode()`). In the error case,
+   *          the values before the failing one have already been written
+   *          to `out`.
+   */
+  template <typename T, typename It>
+  static It decode_n(It begin, It end, T* out, std::size_t count) {
+    auto it = begin;
+    for (; count > 0; --count) {
+      auto const next = decode(*out++, it, end);
+      if (next == it) {
+        return begin;
+      }
+      it = next;
+    }
+    return it;
+  }
+
+  /**
+   * Encode a table of constant values at compile time
+   *
+   * This returns the concatenated encodings of `Values...`, e.g.
+   *
+   *     constexpr auto table =
+   *         varint::encode_array<std::int16_t, 0, -3, 1000, 4711>();
+   *
+   * is a `std::array<std::uint8_t, 6>`. Use `varint_view` to iterate over
+   * the decoded values.
+   */
+  template <typename T, T... Values>
+  static constexpr std::array<std::uint8_t,
+                              detail::varint_table<T, Values...>::size>
+  encode_array() {
+    return detail::varint_table<T, Values...>::array();
+  }
+
   // signed to unsigned transform
   template <
       typename T,
@@ -244,6 +338,134 @@ class varint {
   }
 
  private:
+  template <typename T, typename It>
+  static It decode_impl(T& value, It begin, It end, std::false_type) {
+    constexpr int type_bits = 8 * sizeof(T);
+    constexpr int max_shift = type_bits - 1;
+    int shift = 0;
+    auto it = begin;
+
+    value = 0;
+
+    for (value = 0; it != end && shift <= max_shift; shift += 7) {
+      auto const byte = *it++;
+
+      value |= static_cast<T>(byte & 0x7f) << shift;
+
+      if (!(byte & 0x80)) {
+        if (shift > type_bits - 7 && (byte >> (type_bits - shift)) != 0) {
+          break;
+        }
+
+        return it;
+      }
+    }
+
+    return begin;
+  }
+
+  // Decodes values of up to 8 bytes from a single 64-bit word. The
+  // terminating byte is the lowest one with a clear MSB, then the 7-bit
+  // chunks are gathered with PEXT, or by merging pairs of chunks in three
+  // steps. Longer values and errors are left to the loop.
+  template <typename T, typename It>
+  static It decode_impl(T& value, It begin, It end, std::true_type) {
+    constexpr int type_bits = 8 * sizeof(T);
+
+    if (end - begin >= 8) {
+      auto const word = load64(begin);
+      auto const stop = ~word & UINT64_C(0x8080808080808080);
+
+      if (stop != 0) {
+        auto const bytes = ctz64(stop) / 8 + 1;
+        auto const keep =
+            bytes == 8 ? ~UINT64_C(0) : (UINT64_C(1) << (8 * bytes)) - 1;
+        auto const v = gather7(word & keep);
+
+        if (bytes <= (type_bits + 6) / 7 &&
+            (type_bits >= 64 || (v >> (type_bits % 64)) == 0)) {
+          value = static_cast<T>(v);
+          return begin + bytes;
+        }
+
+        return begin;
+      }
+    }
+
+    return decode_impl(value, begin, end, std::false_type{});
+  }
+
+  template <typename T, typename std::enable_if<std::is_unsigned<T>::value,
+                                                bool>::type = true>
+  static constexpr T to_unsigned(T value) {
+    return value;
+  }
+
+  template <typename T, typename std::enable_if<std::is_signed<T>::value,
+                                                bool>::type = true>
+  static constexpr typename std::make_unsigned<T>::type to_unsigned(T value) {
+    return zig_zag_encode(value);
+  }
+
+  // ceil(bits / 7) for 1 <= bits <= 64, without a division
+  static std::size_t fast_size(std::uint64_t value) {
+    auto const bits = 64 - clz64(value | 1);
+    return static_cast<std::size_t>((bits * 9 + 64) / 64);
+  }
+
+  // little-endian load, compiles to a single load on little-endian targets
+  static std::uint64_t load64(std::uint8_t const* p) {
+    return static_cast<std::uint64_t>(p[0]) |
+           static_cast<std::uint64_t>(p[1]) << 8 |
+           static_cast<std::uint64_t>(p[2]) << 16 |
+           static_cast<std::uint64_t>(p[3]) << 24 |
+           static_cast<std::uint64_t>(p[4]) << 32 |
+           static_cast<std::uint64_t>(p[5]) << 40 |
+           static_cast<std::uint64_t>(p[6]) << 48 |
+           static_cast<std::uint64_t>(p[7]) << 56;
+  }
+
+  static int clz64(std::uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_clzll(x);
+#else
+    int n = 0;
+    while (!(x & (UINT64_C(1) << 63))) {
+      x <<= 1;
+      ++n;
+    }
+    return n;
+#endif
+  }
+
+  static int ctz64(std::uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    while (!(x & 1)) {
+      x >>= 1;
+      ++n;
+    }
+    return n;
+#endif
+  }
+
+  static std::uint64_t gather7(std::uint64_t x) {
+#if LIBEMB_VARINT_WORD_DECODE && defined(__BMI2__)
+    return _pext_u64(x, UINT64_C(0x7f7f7f7f7f7f7f7f));
+#else
+    x &= UINT64_C(0x7f7f7f7f7f7f7f7f);
+    x = ((x & UINT64_C(0x7f007f007f007f00)) >> 1) |
+        (x & UINT64_C(0x007f007f007f007f));
+    x = ((x & UINT64_C(0x3fff00003fff0000)) >> 2) |
+        (x & UINT64_C(0x00003fff00003fff));
+    x = ((x & UINT64_C(0x0fffffff00000000)) >> 4) |
+        (x & UINT64_C(0x000000000fffffff));
+    return x;
+#endif
+  }
+
   template <
       typename T, typename It, typename CheckFunc,
       typename std::enable_if<std::is_unsigned<T>::value, bool>::type = true>
@@ -264,4 +486,190 @@ class varint {
   }
 };
 
+namespace detail {
+
+template <std::size_t N>
+struct varint_bytes {
+  std::uint8_t data[N];
+};
+
+template <typename T, typename std::enable_if<std::is_unsigned<T>::value,
+                                              bool>::type = true>
+constexpr T varint_unsigned(T value) {
+  return value;
+}
+
+template <typename T, typename std::enable_if<std::is_signed<T>::value,
+                                              bool>::type = true>
+constexpr typename std::make_unsigned<T>::type varint_unsigned(T value) {
+  return varint::zig_zag_encode(value);
+}
+
+template <typename U, U Value, std::size_t... I>
+constexpr varint_bytes<sizeof...(I)> varint_encode_value(index_sequence<I...>) {
+  return {{static_cast<std::uint8_t>(((Value >> (7 * I)) & 0x7f) |
+                                     (I + 1 < sizeof...(I) ? 0x80 : 0))...}};
+}
+
+template <std::size_t A, std::size_t B, std::size_t... I>
+constexpr varint_bytes<A + B> varint_join(varint_bytes<A> const& a,
+                                          varint_bytes<B> const& b,
+                                          index_sequence<I...>) {
+  return {{(I < A ? a.data[I] : b.data[I - A])...}};
+}
+
+// Encoding of the values [Lo, Hi) of a table. The range is split in halves
+// to keep the template instantiation depth logarithmic in the table size.
+template <typename Table, std::size_t Lo, std::size_t Hi,
+          bool Single = (Hi - Lo == 1)>
+struct varint_encode_range {
+  using lower = varint_encode_range<Table, Lo, (Lo + Hi) / 2>;
+  using upper = varint_encode_range<Table, (Lo + Hi) / 2, Hi>;
+
+  static constexpr std::size_t size = lower::size + upper::size;
+
+  static constexpr varint_bytes<size> bytes() {
+    return varint_join(lower::bytes(), upper::bytes(),
+                       make_index_sequence<size>{});
+  }
+};
+
+template <typename Table, std::size_t Lo, std::size_t Hi>
+struct varint_encode_range<Table, Lo, Hi, true> {
+  using value_type = typename Table::unsigned_type;
+
+  static constexpr value_type value = Table::values[Lo];
+  static constexpr std::size_t size = varint::size(value);
+
+  static constexpr varint_bytes<size> bytes() {
+    return varint_encode_value<value_type, value>(
+        make_index_sequence<size>{});
+  }
+};
+
+template <typename T, T... Values>
+struct varint_table {
+  static_assert(sizeof...(Values) > 0, "table must not be empty");
+
+  using unsigned_type = decltype(varint_unsigned(T{}));
+  using range = varint_encode_range<varint_table, 0, sizeof...(Values)>;
+
+  static constexpr unsigned_type values[] = {varint_unsigned(Values)...};
+  static constexpr std::size_t size = range::size;
+
+  static constexpr std::array<std::uint8_t, size> array() {
+    return array(range::bytes(), make_index_sequence<size>{});
+  }
+
+ private:
+  template <std::size_t... I>
+  static constexpr std::array<std::uint8_t, size>
+  array(varint_bytes<size> const& b, index_sequence<I...>) {
+    return {{b.data[I]...}};
+  }
+};
+
+template <typename T, T... Values>
+constexpr typename varint_table<T, Values...>::unsigned_type
+    varint_table<T, Values...>::values[];
+
+} // namespace detail
+
+/**
+ * Forward iterator decoding `varint` values of type `T` on the fly
+ *
+ * Each value is decoded when the iterator is advanced to it, so iterating
+ * over an encoded table doesn't need any extra memory. The iterator ends
+ * at the end of the encoding buffer or at the first value that cannot be
+ * decoded.
+ */
+template <typename T, typename It = std::uint8_t const*>
+class varint_iterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T const*;
+  using reference = T const&;
+
+  varint_iterator() = default;
+
+  varint_iterator(It begin, It end)
+      : pos_{begin}
+      , end_{end} {
+    read();
+  }
+
+  reference operator*() const { return value_; }
+  pointer operator->() const { return &value_; }
+
+  varint_iterator& operator++() {
+    pos_ = next_;
+    read();
+    return *this;
+  }
+
+  varint_iterator operator++(int) {
+    auto tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+  bool operator==(varint_iterator const& other) const {
+    return pos_ == other.pos_;
+  }
+
+  bool operator!=(varint_iterator const& other) const {
+    return pos_ != other.pos_;
+  }
+
+  /**
+   * Position of the encoding of the current value
+   */
+  It base() const { return pos_; }
+
+ private:
+  void read() {
+    if (pos_ != end_) {
+      next_ = varint::decode(value_, pos_, end_);
+      if (next_ == pos_) {
+        pos_ = end_;
+      }
+    }
+  }
+
+  It pos_{};
+  It end_{};
+  It next_{};
+  T value_{};
+};
+
+/**
+ * Range of `varint` values of type `T`, decoded while iterating
+ *
+ *     for (auto v : varint_view<std::int16_t>(table)) {
+ *       // ...
+ *     }
+ */
+template <typename T, typename It = std::uint8_t const*>
+class varint_view {
+ public:
+  using iterator = varint_iterator<T, It>;
+
+  varint_view(It begin, It end)
+      : begin_{begin}
+      , end_{end} {}
+
+  template <std::size_t N>
+  explicit varint_view(std::array<std::uint8_t, N> const& a)
+      : varint_view(a.data(), a.data() + N) {}
+
+  iterator begin() const { return iterator(begin_, end_); }
+  iterator end() const { return iterator(end_, end_); }
+
+ private:
+  It begin_;
+  It end_;
+};
+
 } // namespace embedded
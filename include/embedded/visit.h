@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "typelist.h"
+#include "utility/integer_sequence.h"
+
+namespace embedded {
+
+/**
+ * Alternatives of a variant type as a `typelist`
+ *
+ * This works for all variant templates that take the alternatives as
+ * their template parameters, such as `embedded::variant`. Specialize it
+ * for other variant types.
+ */
+template <typename Variant>
+struct variant_alternatives;
+
+template <template <typename...> class Variant, typename... Ts>
+struct variant_alternatives<Variant<Ts...>> {
+  using type = typelist<Ts...>;
+};
+
+namespace detail {
+
+// Only declared so that `get_if<I>(...)` below is parsed as a template
+// call and the variant's own `get_if` can be found by ADL.
+struct visit_adl_tag {};
+
+template <std::size_t I>
+void get_if(visit_adl_tag);
+
+template <std::size_t I, typename Variant>
+struct visit_access {
+  using variant_type = typename std::remove_reference<Variant>::type;
+  using value_type = typename std::remove_pointer<decltype(get_if<I>(
+      std::declval<variant_type*>()))>::type;
+  using reference =
+      typename std::conditional<std::is_lvalue_reference<Variant>::value,
+                                value_type&, value_type&&>::type;
+
+  static reference get(variant_type& v) {
+    return static_cast<reference>(*get_if<I>(&v));
+  }
+};
+
+template <typename Visitor, typename Variant>
+using visit_result = decltype(std::declval<Visitor>()(
+    visit_access<0, Variant>::get(std::declval<Variant&>())));
+
+template <typename R, typename Visitor, typename Variant, std::size_t I>
+R visit_alternative(Visitor&& vis, Variant&& v) {
+  return std::forward<Visitor>(vis)(visit_access<I, Variant>::get(v));
+}
+
+template <typename R, typename Visitor, typename Variant, std::size_t... Is>
+struct visit_table {
+  using function = R (*)(Visitor&&, Variant&&);
+
+  static constexpr function entries[sizeof...(Is)] = {
+      &visit_alternative<R, Visitor, Variant, Is>...};
+};
+
+template <typename R, typename Visitor, typename Variant, std::size_t... Is>
+constexpr typename visit_table<R, Visitor, Variant, Is...>::function
+    visit_table<R, Visitor, Variant, Is...>::entries[sizeof...(Is)];
+
+template <typename R, typename Visitor, typename Variant, std::size_t... Is>
+visit_table<R, Visitor, Variant, Is...>
+    make_visit_table(index_sequence<Is...>);
+
+// Up to this number of alternatives, a `switch` is used, which lets the
+// compiler inline the visitor for each alternative.
+constexpr std::size_t visit_switch_limit = 8;
+
+template <typename R, typename Visitor, typename Variant, std::size_t N,
+          bool Switch = (N <= visit_switch_limit)>
+struct visit_dispatch {
+  static R call(std::size_t index, Visitor&& vis, Variant&& v) {
+    using table = decltype(make_visit_table<R, Visitor, Variant>(
+        make_index_sequence<N>{}));
+    return table::entries[index](std::forward<Visitor>(vis),
+                                 std::forward<Variant>(v));
+  }
+};
+
+// Cases beyond `N` are never taken, they repeat the last alternative so
+// they can be merged.
+#define LIBEMB_VISIT_CASE(I)                                                   \
+  case I:                                                                      \
+    return visit_alternative<R, Visitor, Variant, (I < N ? I : N - 1)>(        \
+        std::forward<Visitor>(vis), std::forward<Variant>(v))
+
+template <typename R, typename Visitor, typename Variant, std::size_t N>
+struct visit_dispatch<R, Visitor, Variant, N, true> {
+  static_assert(visit_switch_limit == 8, "update the cases below");
+
+  static R call(std::size_t index, Visitor&& vis, Variant&& v) {
+    switch (index) {
+      LIBEMB_VISIT_CASE(0);
+      LIBEMB_VISIT_CASE(1);
+      LIBEMB_VISIT_CASE(2);
+      LIBEMB_VISIT_CASE(3);
+      LIBEMB_VISIT_CASE(4);
+      LIBEMB_VISIT_CASE(5);
+      LIBEMB_VISIT_CASE(6);
+    default:
+      return visit_alternative<R, Visitor, Variant, N - 1>(
+          std::forward<Visitor>(vis), std::forward<Variant>(v));
+    }
+  }
+};
+
+#undef LIBEMB_VISIT_CASE
+
+} // namespace detail
+
+/**
+ * Visit a variant with a single indirect jump
+ *
+ * Calls `vis` with the active alternative of `v`, like `visit()`, but
+ * always dispatches in constant time and without recursive templates:
+ * for up to 8 alternatives through a `switch` on `v.index()`, and beyond
+ * that through a constant table of function pointers indexed by
+ * `v.index()`. This keeps the generated code small and flat, even with
+ * compilers that don't optimize deeply nested dispatch code well.
+ *
+ * The visitor must return the same type for all alternatives. Only a
+ * single variant can be visited and it must not be valueless. The
+ * variant type needs `index()` and a `get_if<I>()` that can be found by
+ * ADL, as well as a `variant_alternatives` specialization.
+ */
+template <typename Visitor, typename Variant>
+auto flat_visit(Visitor&& vis, Variant&& v)
+    -> detail::visit_result<Visitor, Variant> {
+  using alternatives = typename variant_alternatives<
+      typename std::decay<Variant>::type>::type;
+  constexpr std::size_t size = alternatives::size();
+  static_assert(size > 0, "variant must have alternatives");
+  assert(v.index() < size);
+  return detail::visit_dispatch<detail::visit_result<Visitor, Variant>,
+                                Visitor, Variant,
+                                size>::call(v.index(),
+                                            std::forward<Visitor>(vis),
+                                            std::forward<Variant>(v));
+}
+
+} // namespace embedded
@@ -0,0 +1,223 @@
+#
+# Copyright (c) Marcus Holland-Moritz
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+#
+
+# Measure the compile time cost of constexpr filter designs
+#
+# For every filter family, order and value type, a small translation unit
+# containing a single constexpr SOS design is compiled and the wall time
+# and peak memory of the compiler are recorded. Optionally, the minimal
+# template instantiation depth and constexpr evaluation limits needed to
+# compile the design are determined by bisection.
+#
+# Results are written as CSV. When a baseline from a previous run is
+# given, entries that got slower or bigger than the threshold are
+# reported and the script exits with a non-zero status.
+#
+# Example:
+#
+#   scripts/compile-bench.py --cxx g++ --cxx clang++ --orders 1-20 \
+#       --output bench.csv --baseline main.csv
+
+import argparse
+import csv
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+FAMILIES = {
+    "butter": ("butterworth.h", "butterworth<{order}>()"),
+    "cheby1": ("chebyshev.h", "chebyshev1<{order}>(1.0)"),
+    "cheby2": ("chebyshev.h", "chebyshev2<{order}>(20.0)"),
+    "bessel": ("bessel_table.h", "bessel<{order}>()"),
+    "ellip": ("elliptic.h", "elliptic<{order}>(1.0, 60.0)"),
+}
+
+TYPES = {
+    "float": ("", "float"),
+    "double": ("", "double"),
+    "fixed": (
+        '#include <cstdint>\n#include <fpm/fixed.hpp>\n',
+        "fpm::fixed<std::int32_t, std::int64_t, 24>",
+    ),
+}
+
+# (option name, gcc flag, clang flag)
+LIMITS = {
+    "template_depth": ("-ftemplate-depth=", "-ftemplate-depth="),
+    "constexpr_depth": ("-fconstexpr-depth=", "-fconstexpr-depth="),
+    "constexpr_ops": ("-fconstexpr-ops-limit=", "-fconstexpr-steps="),
+}
+
+FIELDS = ["compiler", "family", "order", "type", "status", "time_s", "rss_kb"]
+
+
+def source(family, order, fptype):
+    header, spec = FAMILIES[family]
+    extra, typename = TYPES[fptype]
+    return (
+        f'{extra}#include "embedded/signal/filter.h"\n'
+        f'#include "embedded/signal/{header}"\n'
+        "using namespace embedded::signal;\n"
+        "constexpr auto design = iirfilter<double>(1000.0)\n"
+        f"    .lowpass({spec.format(order=order)}, 100.0)\n"
+        f"    .sos<{typename}>();\n"
+        "int main() { return &design.sos()[0] != nullptr ? 0 : 1; }\n"
+    )
+
+
+def is_clang(cxx):
+    out = subprocess.run([cxx, "--version"], capture_output=True, text=True)
+    return "clang" in out.stdout.lower()
+
+
+def compile_once(cmd):
+    """Run the compiler, return (ok, wall time, peak RSS in kB)"""
+    start = time.perf_counter()
+    proc = subprocess.Popen(
+        cmd, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL
+    )
+    _, status, usage = os.wait4(proc.pid, 0)
+    elapsed = time.perf_counter() - start
+    proc.returncode = os.waitstatus_to_exitcode(status)
+    return proc.returncode == 0, elapsed, usage.ru_maxrss
+
+
+def bisect_limit(cmd, flag, hi=1 << 26):
+    """Smallest value of `flag` for which `cmd` still compiles"""
+    lo = 1
+    if not compile_once(cmd + [f"{flag}{hi}"])[0]:
+        return None
+    while lo < hi:
+        mid = (lo + hi) // 2
+        if compile_once(cmd + [f"{flag}{mid}"])[0]:
+            hi = mid
+        else:
+            lo = mid + 1
+    return lo
+
+
+def parse_range(text):
+    values = []
+    for part in text.split(","):
+        if "-" in part:
+            a, b = part.split("-")
+            values.extend(range(int(a), int(b) + 1))
+        else:
+            values.append(int(part))
+    return values
+
+
+def compare(results, baseline_file, threshold):
+    with open(baseline_file) as fh:
+        key = lambda r: (r["compiler"], r["family"], r["order"], r["type"])
+        baseline = {key(r): r for r in csv.DictReader(fh)}
+    regressions = 0
+    for r in results:
+        b = baseline.get(key({k: str(v) for k, v in r.items()}))
+        if b is None or b["status"] != "ok":
+            continue
+        if r["status"] != "ok":
+            print(f"REGRESSION {key(r)}: now fails to compile")
+            regressions += 1
+            continue
+        for field in ["time_s", "rss_kb"] + list(LIMITS):
+            if field not in r or not b.get(field):
+                continue
+            old, new = float(b[field]), float(r[field])
+            if old > 0 and new / old > threshold:
+                print(f"REGRESSION {key(r)}: {field} {old:g} -> {new:g}")
+                regressions += 1
+    return regressions
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__)
+    ap.add_argument("--cxx", action="append", help="compiler(s) to use")
+    ap.add_argument("--std", default="c++17")
+    ap.add_argument("--families", default=",".join(FAMILIES))
+    ap.add_argument("--types", default=",".join(TYPES))
+    ap.add_argument("--orders", default="1-30")
+    ap.add_argument("--repeat", type=int, default=1,
+                    help="compile each design N times, keep the fastest")
+    ap.add_argument("--limits", action="store_true",
+                    help="bisect template depth and constexpr limits (slow)")
+    ap.add_argument("-I", dest="includes", action="append", default=[])
+    ap.add_argument("--output", help="CSV file to write")
+    ap.add_argument("--baseline", help="CSV file of a previous run")
+    ap.add_argument("--threshold", type=float, default=1.25,
+                    help="ratio to the baseline reported as regression")
+    args = ap.parse_args()
+
+    compilers = args.cxx or [os.environ.get("CXX", "c++")]
+    includes = [os.path.join(ROOT, "include")] + [
+        os.path.join(ROOT, d, "include") for d in ("fpm", "gcem", "variant")
+    ] + args.includes
+    fields = FIELDS + (list(LIMITS) if args.limits else [])
+    results = []
+    print(",".join(fields), flush=True)
+
+    with tempfile.TemporaryDirectory() as tmp:
+        for cxx in compilers:
+            clang = is_clang(cxx)
+            for family in args.families.split(","):
+                for fptype in args.types.split(","):
+                    for order in parse_range(args.orders):
+                        name = f"{family}_{fptype}_{order}.cpp"
+                        path = os.path.join(tmp, name)
+                        with open(path, "w") as fh:
+                            fh.write(source(family, order, fptype))
+                        cmd = [cxx, f"-std={args.std}", "-fsyntax-only", path]
+                        cmd += [f"-I{d}" for d in includes]
+                        runs = [compile_once(cmd) for _ in range(args.repeat)]
+                        ok = all(r[0] for r in runs)
+                        res = {
+                            "compiler": cxx,
+                            "family": family,
+                            "order": order,
+                            "type": fptype,
+                            "status": "ok" if ok else "fail",
+                            "time_s": f"{min(r[1] for r in runs):.3f}",
+                            "rss_kb": max(r[2] for r in runs),
+                        }
+                        if args.limits and ok:
+                            for name, flags in LIMITS.items():
+                                res[name] = bisect_limit(cmd, flags[clang])
+                        results.append(res)
+                        print(",".join(str(res.get(f, "")) for f in fields),
+                              flush=True)
+
+    if args.output:
+        with open(args.output, "w", newline="") as fh:
+            writer = csv.DictWriter(fh, fieldnames=fields)
+            writer.writeheader()
+            writer.writerows(results)
+
+    if args.baseline and compare(results, args.baseline, args.threshold):
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,206 @@
+#!/usr/bin/python
+
+import argparse
+import sys
+from struct import unpack
+
+# Record kinds, see `serialize_kind` in include/embedded/serialize.h
+SOS_DESIGN = 1
+POLY_DESIGN = 2
+SOS_STATE = 3
+SOS_STATISTICS = 4
+CBA_STATISTICS = 5
+
+STRUCTURES = {
+    0: ("df2t", ["y1", "y2"]),
+    1: ("df1", ["x1", "x2", "y1", "y2"]),
+    2: ("tdf1", ["p1", "p2", "z1", "z2"]),
+    3: ("coupled", ["s1", "s2"]),
+    4: ("df1_wide", ["x1", "x2", "y1", "y2", "e"]),
+}
+
+# Wrapping structures, followed by the code of the wrapped structure
+DENORMAL_SAFE = 5
+
+SOSCOEF = ["b0", "b1", "b2", "a1", "a2"]
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def remaining(self):
+        return len(self.data) - self.pos
+
+    def byte(self):
+        if self.pos >= len(self.data):
+            raise RuntimeError("unexpected end of data")
+        b = self.data[self.pos]
+        self.pos += 1
+        return b
+
+    def bytes(self, n):
+        if self.pos + n > len(self.data):
+            raise RuntimeError("unexpected end of data")
+        b = self.data[self.pos : self.pos + n]
+        self.pos += n
+        return b
+
+    def varint(self):
+        value = 0
+        shift = 0
+        while True:
+            b = self.byte()
+            value |= (b & 0x7F) << shift
+            shift += 7
+            if b < 0x80:
+                return value
+
+    def signed(self):
+        v = self.varint()
+        return (v >> 1) ^ -(v & 1)
+
+
+class Structure:
+    def __init__(self, r):
+        code = r.byte()
+        self.extra = []
+        if code == DENORMAL_SAFE:
+            code = r.byte()
+            self.extra = ["offset", "next"]
+        if code not in STRUCTURES:
+            raise RuntimeError(f"unsupported filter structure: {code}")
+        self.code = code
+        self.name, self.fields = STRUCTURES[code]
+        if self.extra:
+            self.name = f"denormal_safe<{self.name}>"
+
+
+class ValueType:
+    def __init__(self, r):
+        code = r.byte()
+        self.fraction_bits = None
+        if code == 0:
+            self.name = "float"
+        elif code == 1:
+            self.name = "double"
+        elif code == 3:
+            self.fraction_bits = r.byte()
+            size = r.byte()
+            self.name = f"fixed<{8 * size}, {self.fraction_bits}>"
+        else:
+            raise RuntimeError(f"unsupported value type: {code}")
+        self.code = code
+
+    def read(self, r):
+        if self.code == 0:
+            return unpack("<f", r.bytes(4))[0]
+        if self.code == 1:
+            return unpack("<d", r.bytes(8))[0]
+        return self.scale(r.signed())
+
+    def scale(self, raw):
+        return raw / (1 << self.fraction_bits)
+
+
+def decode_sos_design(r):
+    st = Structure(r)
+    vt = ValueType(r)
+    order = r.varint()
+    print(f"  SOS design, order {order}, {st.name}, {vt.name}")
+    for i in range((order + 1) // 2):
+        print(f"    SOS stage {i + 1}:")
+        for k in SOSCOEF:
+            print(f"      {k} = {vt.read(r)}")
+
+
+def decode_poly_design(r):
+    vt = ValueType(r)
+    order = r.varint()
+    print(f"  transfer function, order {order}, {vt.name}")
+    for coef in ["b", "a"]:
+        for i in range(order + 1):
+            print(f"    {coef}[{i}] = {vt.read(r)}")
+
+
+def decode_sos_state(r):
+    st = Structure(r)
+    vt = ValueType(r)
+    count = r.varint()
+    print(f"  SOS state, {count} sections, {st.name}, {vt.name}")
+    for i in range(count):
+        print(f"    SOS stage {i + 1}:")
+        for k in st.fields:
+            if st.code == 4:
+                # raw values, the error feedback term has twice the
+                # fraction bits
+                raw = r.signed()
+                scale = 2 if k == "e" else 1
+                value = raw / (1 << (scale * vt.fraction_bits))
+                print(f"      {k} = {value} ({raw})")
+            else:
+                print(f"      {k} = {vt.read(r)}")
+        for k in st.extra:
+            print(f"      {k} = {vt.read(r)}")
+
+
+def decode_sos_statistics(r):
+    vt = ValueType(r)
+    count = r.varint()
+    print(f"  SOS statistics, {count} sections, {vt.name}")
+    for i in range(count):
+        peak = vt.read(r)
+        saturations = r.varint()
+        print(f"    SOS stage {i + 1}: peak = {peak}, saturations = {saturations}")
+
+
+def decode_cba_statistics(r):
+    print("  circular buffer statistics")
+    for k in ["high_water", "overflows", "underflows", "pushed", "popped"]:
+        print(f"    {k} = {r.varint()}")
+
+
+DECODERS = {
+    SOS_DESIGN: decode_sos_design,
+    POLY_DESIGN: decode_poly_design,
+    SOS_STATE: decode_sos_state,
+    SOS_STATISTICS: decode_sos_statistics,
+    CBA_STATISTICS: decode_cba_statistics,
+}
+
+
+def parse(data):
+    r = Reader(data)
+    while r.remaining() > 0:
+        kind = r.varint()
+        ident = r.varint()
+        length = r.varint()
+        payload = Reader(r.bytes(length))
+        print(f"record {ident} (kind {kind}, {length} bytes):")
+        if kind in DECODERS:
+            DECODERS[kind](payload)
+        else:
+            print("  unknown kind, skipped")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Diagnostics record decoder")
+    parser.add_argument(
+        "input", type=str, nargs="?", help="input file (default: stdin)"
+    )
+    parser.add_argument(
+        "--hex", action="store_true", help="input is a hex dump, e.g. from a UART"
+    )
+    opt = parser.parse_args()
+
+    if opt.input:
+        with open(opt.input, "rb") as fh:
+            data = fh.read()
+    else:
+        data = sys.stdin.buffer.read()
+
+    if opt.hex:
+        data = bytes.fromhex(data.decode("ascii"))
+
+    parse(data)
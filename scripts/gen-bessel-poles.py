@@ -24,8 +24,13 @@ import os
 from textwrap import dedent
 from scipy.signal.filter_design import besselap
 
+# Lower orders are computed by the compiler, this must match
+# `detail::bessel_max_computed_order`.
+MIN_ORDER = 17
+MAX_ORDER = 100
+
 filename = os.path.join(
-    os.path.dirname(__file__), f"../include/embedded/signal/detail/bessel_poles.h"
+    os.path.dirname(__file__), f"../include/embedded/signal/bessel_table.h"
 )
 
 with open(filename, "w") as fh:
@@ -58,25 +63,21 @@ with open(filename, "w") as fh:
 
             #include <cstddef>
 
-            #include "../../constexpr_math/complex.h"
-            #include "../../constexpr_math/vector.h"
+            #include "bessel.h"
 
             namespace embedded {
             namespace signal {
             namespace detail {
-
-            template <typename F, std::size_t Order>
-            struct bessel_poles;
             """
         )
     )
 
-    for order in range(1, 101):
+    for order in range(MIN_ORDER, MAX_ORDER + 1):
         fh.write(
             dedent(
                 f"""
                 template <typename F>
-                struct bessel_poles<F, {order}> {{
+                struct bessel_pole_table<F, {order}> {{
                   static constexpr cmath::vector<cmath::complex<F>, {order}> value{{
                 """
             )
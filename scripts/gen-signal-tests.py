@@ -32,7 +32,7 @@ IMPULSE_LEN = 1024
 
 def file_header(fh, fptype, ftype):
     hmap = {
-        "bessel": "bessel.h",
+        "bessel": "bessel_table.h",
         "butter": "butterworth.h",
         "cheby1": "chebyshev.h",
         "cheby2": "chebyshev.h",
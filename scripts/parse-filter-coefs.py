@@ -5,7 +5,20 @@ from elftools.elf.elffile import ELFFile
 from struct import unpack
 
 
-def parse(data):
+def read_address(elf, address, size):
+    for section in elf.iter_sections():
+        start = section["sh_addr"]
+        if (
+            section["sh_type"] != "SHT_NOBITS"
+            and start <= address
+            and address + size <= start + section["sh_size"]
+        ):
+            offset = address - start
+            return section.data()[offset : offset + size]
+    raise RuntimeError(f"no section contains address 0x{address:x}")
+
+
+def parse(data, elf):
     if data.startswith(b"TLIF"):
         raise RuntimeError("big endian byte order not implemented")
     elif not data.startswith(b"FILT"):
@@ -22,6 +35,7 @@ def parse(data):
     }
 
     soscoef = ["b0", "b1", "b2", "a1", "a2"]
+    coupledcoef = ["d", "c1", "c2", "a11", "a12", "a21", "a22"]
 
     while len(data) > 0:
         header_size = 128
@@ -29,12 +43,27 @@ def parse(data):
             "IHBBB119s", data[:header_size]
         )
         assert magic == 0x544C4946
-        assert version == 0
         size -= header_size
         data = data[header_size:]
-        valnum = size // valsizes[valtype]
-        values = unpack(f"{valnum}{valtypes[valtype]}", data[:size])
+        if version == 0:
+            coef = data[:size]
+        elif version == 1:
+            # reference to the coefficients of a placed design
+            if elf.header["e_type"] == "ET_REL":
+                raise RuntimeError(
+                    "placed design references can only be resolved in a "
+                    "linked ELF file, not in a relocatable object"
+                )
+            ptrfmt = "I" if elf.elfclass == 32 else "Q"
+            ptrsize = elf.elfclass // 8
+            (address,) = unpack(ptrfmt, data[:ptrsize])
+            (coefsize,) = unpack("I", data[ptrsize : ptrsize + 4])
+            coef = read_address(elf, address, coefsize)
+        else:
+            raise RuntimeError(f"unsupported record version: {version}")
         data = data[size:]
+        valnum = len(coef) // valsizes[valtype]
+        values = unpack(f"{valnum}{valtypes[valtype]}", coef)
         name = name.rstrip(b"\0").decode("utf-8")
         print(f"{name}:")
 
@@ -44,6 +73,12 @@ def parse(data):
                 print(f"  SOS stage {i + 1}:")
                 for k in range(5):
                     print(f"    {soscoef[k]} = {values[5*i + k]}")
+        elif structure == 2:
+            sosnum = valnum // 7
+            for i in range(sosnum):
+                print(f"  SOS stage {i + 1} (coupled):")
+                for k in range(7):
+                    print(f"    {coupledcoef[k]} = {values[7*i + k]}")
         elif structure == 1:
             polynum = valnum // 2
             for k, coef in enumerate(["b", "a"]):
@@ -52,17 +87,23 @@ def parse(data):
         else:
             raise RuntimeError("unsupported filter structure: {structure}")
 
+        # skip padding between records
         npos = data.find(b"FILT")
-        if npos > 0:
-            data = data[npos:]
+        if npos < 0:
+            break
+        data = data[npos:]
 
 
 if __name__ == "__main__":
     parser = argparse.ArgumentParser(description="Filter coefficient parser")
-    parser.add_argument("object", type=str, help="object file")
+    parser.add_argument(
+        "object",
+        type=str,
+        help="ELF file; placed designs can only be decoded after linking",
+    )
     opt = parser.parse_args()
 
     with open(opt.object, "rb") as fh:
         elf = ELFFile(fh)
         coef = elf.get_section_by_name(".libemb_filter_coefs")
-        parse(coef.data())
+        parse(coef.data(), elf)
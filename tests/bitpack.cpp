@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "embedded/bitpack.h"
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace embedded;
+
+TEST(bitpack, format) {
+  // 128 values 1000..1007, i.e. 3 bits relative to 1000
+  std::vector<std::uint32_t> in(128);
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    in[i] = 1000 + i % 8;
+  }
+
+  std::vector<std::uint8_t> buf(bitpack::max_size(in.size()));
+  EXPECT_EQ(5 + 16 * 3, bitpack::size(in.data(), in.size()));
+
+  auto end = bitpack::encode(in.data(), in.size(), buf.data());
+  ASSERT_EQ(buf.data() + 5 + 16 * 3, end);
+
+  EXPECT_EQ(1000 & 0xFF, buf[0]);
+  EXPECT_EQ(1000 >> 8, buf[1]);
+  EXPECT_EQ(0, buf[2]);
+  EXPECT_EQ(0, buf[3]);
+  EXPECT_EQ(3, buf[4]);
+
+  // the first word of lane 1 holds 1, 5, 1, 5, ... in 3 bits each
+  EXPECT_EQ(0x29 /* 0b101'001 */, buf[5 + 4] & 0x3F);
+}
+
+TEST(bitpack, all_widths) {
+  std::mt19937 rng(42);
+
+  for (unsigned bits = 0; bits <= 32; ++bits) {
+    std::vector<std::uint32_t> in(3 * 128);
+    auto const mask = bits == 32 ? ~0u : (1u << bits) - 1;
+    auto const ref = static_cast<std::uint32_t>(rng());
+    for (auto& v : in) {
+      v = ref + (static_cast<std::uint32_t>(rng()) & mask);
+    }
+
+    auto const size = bitpack::size(in.data(), in.size());
+    EXPECT_GE(3 * (5 + 16 * bits), size) << bits;
+
+    std::vector<std::uint8_t> buf(size);
+    ASSERT_EQ(buf.data() + size,
+              bitpack::encode(in.data(), in.size(), buf.data()));
+
+    std::vector<std::uint32_t> out(in.size());
+    ASSERT_EQ(buf.data() + size, bitpack::decode(buf.data(),
+                                                 buf.data() + size,
+                                                 out.data(), out.size()))
+        << bits;
+    EXPECT_EQ(in, out) << bits;
+  }
+}
+
+TEST(bitpack, partial_blocks) {
+  std::mt19937 rng(1);
+
+  for (std::size_t count : {0, 1, 5, 127, 128, 129, 300}) {
+    std::vector<std::uint32_t> in(count);
+    for (auto& v : in) {
+      v = 2048 + rng() % 4096;
+    }
+
+    auto const size = bitpack::size(in.data(), count);
+    std::vector<std::uint8_t> buf(size);
+    ASSERT_EQ(buf.data() + size, bitpack::encode(in.data(), count, buf.data()));
+
+    std::vector<std::uint32_t> out(count + 1, 0xDEADBEEF);
+    ASSERT_EQ(buf.data() + size,
+              bitpack::decode(buf.data(), buf.data() + size, out.data(),
+                              count));
+    EXPECT_TRUE(std::equal(in.begin(), in.end(), out.begin()));
+    EXPECT_EQ(0xDEADBEEF, out.back());
+
+    // input buffer exhausted
+    if (count > 0) {
+      EXPECT_EQ(buf.data(), bitpack::decode(buf.data(), buf.data() + size - 1,
+                                            out.data(), count));
+    }
+  }
+}
+
+TEST(bitpack, signed_values) {
+  using lim = std::numeric_limits<std::int32_t>;
+
+  std::vector<std::int32_t> in(200);
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    in[i] = static_cast<std::int32_t>(i) - 100;
+  }
+  in[150] = lim::min();
+  in[151] = lim::max();
+
+  auto const size = bitpack::size(in.data(), in.size());
+  EXPECT_EQ(5 + 16 * 7 + 5 + 16 * 32, size);
+
+  std::vector<std::uint8_t> buf(size);
+  ASSERT_EQ(buf.data() + size,
+            bitpack::encode(in.data(), in.size(), buf.data()));
+
+  std::vector<std::int32_t> out(in.size());
+  ASSERT_EQ(buf.data() + size, bitpack::decode(buf.data(), buf.data() + size,
+                                               out.data(), out.size()));
+  EXPECT_EQ(in, out);
+}
+
+TEST(bitpack, invalid_width) {
+  std::vector<std::uint8_t> buf(5 + 16 * 33, 0);
+  buf[4] = 33;
+  std::uint32_t out[1];
+  EXPECT_EQ(buf.data(), bitpack::decode(buf.data(), buf.data() + buf.size(),
+                                        out, 1));
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "embedded/block_pool.h"
+
+#include <gtest/gtest.h>
+
+using namespace embedded;
+
+TEST(block_pool, basic) {
+  struct tag {};
+  using pool = static_block_pool<10, 4, 8, tag>;
+
+  static_assert(pool::block_size == 16, "block size");
+
+  std::vector<void*> blocks;
+
+  for (std::size_t i = 0; i < pool::blocks; ++i) {
+    auto p = pool::allocate();
+    ASSERT_TRUE(p);
+    EXPECT_TRUE(pool::owns(p));
+    EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(p) % 8);
+    blocks.push_back(p);
+  }
+
+  EXPECT_FALSE(pool::allocate());
+
+  std::sort(blocks.begin(), blocks.end());
+  EXPECT_EQ(blocks.end(), std::unique(blocks.begin(), blocks.end()));
+
+  int local = 0;
+  EXPECT_FALSE(pool::owns(&local));
+
+  pool::deallocate(blocks[2]);
+  pool::deallocate(blocks[0]);
+  EXPECT_EQ(blocks[0], pool::allocate());
+  EXPECT_EQ(blocks[2], pool::allocate());
+  EXPECT_FALSE(pool::allocate());
+
+  for (auto p : blocks) {
+    pool::deallocate(p);
+  }
+}
+
+TEST(block_pool, threads) {
+  struct tag {};
+  using pool = static_block_pool<sizeof(std::uint32_t), 16, 4, tag>;
+
+  std::atomic<std::size_t> failed{0};
+  std::vector<std::thread> threads;
+
+  // Each thread repeatedly holds a few blocks, tagging them with its id
+  // to detect blocks handed out twice
+  for (std::uint32_t id = 0; id < 4; ++id) {
+    threads.emplace_back([id, &failed] {
+      for (int round = 0; round < 20000; ++round) {
+        std::uint32_t* held[3];
+        for (auto& p : held) {
+          p = static_cast<std::uint32_t*>(pool::allocate());
+          ASSERT_TRUE(p);
+          *p = id;
+        }
+        for (auto p : held) {
+          if (*p != id) {
+            ++failed;
+          }
+          pool::deallocate(p);
+        }
+      }
+    });
+  }
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  EXPECT_EQ(0, failed.load());
+
+  std::vector<void*> blocks;
+  while (auto p = pool::allocate()) {
+    blocks.push_back(p);
+  }
+  EXPECT_EQ(pool::blocks, blocks.size());
+}
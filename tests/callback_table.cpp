@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "embedded/callback_table.h"
+
+#include <gtest/gtest.h>
+
+using namespace embedded;
+
+namespace {
+
+using log_t = std::vector<int>;
+
+// Callables of different sizes, each records its id when invoked
+template <std::size_t Padding>
+struct recorder {
+  log_t* log;
+  int id;
+  char padding[Padding];
+
+  void operator()(int) const { log->push_back(id); }
+};
+
+template <std::size_t Padding>
+auto make(log_t& log, int id) -> recorder<Padding> {
+  recorder<Padding> r;
+  r.log = &log;
+  r.id = id;
+  return r;
+}
+
+template <typename Table>
+auto invoked(Table& table, log_t& log) -> log_t {
+  log.clear();
+  table.invoke_all(0);
+  return log;
+}
+
+auto sorted(log_t v) -> log_t {
+  std::sort(v.begin(), v.end());
+  return v;
+}
+
+} // namespace
+
+TEST(callback_table, basic) {
+  callback_table<void(int), 256> table;
+  int sum = 0;
+  int* ps = &sum;
+
+  EXPECT_TRUE(table.empty());
+
+  auto const h1 = table.add([ps](int x) { *ps += x; });
+  auto const h2 = table.add([ps](int x) { *ps += 2 * x; });
+  EXPECT_NE(h1, table.invalid_handle);
+  EXPECT_NE(h2, table.invalid_handle);
+  EXPECT_EQ(2, table.size());
+
+  table.invoke_all(3);
+  EXPECT_EQ(9, sum);
+
+  EXPECT_TRUE(table.remove(h1));
+  EXPECT_FALSE(table.remove(h1));
+  EXPECT_FALSE(table.remove(table.invalid_handle));
+  EXPECT_EQ(1, table.size());
+
+  table.invoke_all(1);
+  EXPECT_EQ(11, sum);
+
+  table.clear();
+  EXPECT_TRUE(table.empty());
+  EXPECT_EQ(0, table.arena_used());
+  table.invoke_all(1);
+  EXPECT_EQ(11, sum);
+}
+
+TEST(callback_table, grouping) {
+  callback_table<void(int), 512> table;
+  log_t log;
+
+  table.add(make<1>(log, 1));
+  table.add(make<9>(log, 2));
+  table.add(make<1>(log, 3));
+  table.add(make<9>(log, 4));
+  table.add(make<1>(log, 5));
+
+  EXPECT_EQ((log_t{1, 3, 5, 2, 4}), invoked(table, log));
+}
+
+TEST(callback_table, remove) {
+  callback_table<void(int), 512> table;
+  log_t log;
+
+  auto const h1 = table.add(make<1>(log, 1));
+  auto const h2 = table.add(make<1>(log, 2));
+  auto const h3 = table.add(make<1>(log, 3));
+  auto const used = table.arena_used();
+
+  // the last callable of the group takes the place of the removed one
+  EXPECT_TRUE(table.remove(h1));
+  EXPECT_EQ((log_t{3, 2}), invoked(table, log));
+
+  // the handle of the moved callable is still valid
+  EXPECT_TRUE(table.remove(h3));
+  EXPECT_EQ((log_t{2}), invoked(table, log));
+
+  // the group is at the end of the arena, so space is returned
+  EXPECT_LT(table.arena_used(), used);
+
+  EXPECT_TRUE(table.remove(h2));
+  EXPECT_TRUE(table.empty());
+  EXPECT_EQ(0, table.arena_used());
+}
+
+TEST(callback_table, reuse_and_compact) {
+  // The strides of the three types are 24, 32 and 40 bytes on 64-bit
+  // and 16, 24 and 32 bytes on 32-bit platforms. After compaction, the
+  // arena is exactly full.
+  constexpr std::size_t bytes = sizeof(void*) == 8 ? 128 : 96;
+  callback_table<void(int), bytes, 32, 4> table;
+  log_t log;
+
+  auto const s1 = table.add(make<1>(log, 1));
+  auto const s2 = table.add(make<1>(log, 2));
+  table.add(make<9>(log, 3));
+  table.add(make<9>(log, 4));
+  auto const used = table.arena_used();
+
+  // a free slot in the middle of the arena is reused by the same type
+  EXPECT_TRUE(table.remove(s1));
+  EXPECT_EQ(used, table.arena_used());
+  auto const s3 = table.add(make<1>(log, 5));
+  EXPECT_NE(table.invalid_handle, s3);
+  EXPECT_EQ(used, table.arena_used());
+  EXPECT_EQ((log_t{2, 5, 3, 4}), invoked(table, log));
+
+  // a different type only fits after compaction
+  EXPECT_TRUE(table.remove(s2));
+  auto const l1 = table.add(make<20>(log, 6));
+  EXPECT_NE(table.invalid_handle, l1);
+  EXPECT_EQ(table.arena_size(), table.arena_used());
+  EXPECT_EQ((log_t{5, 3, 4, 6}), invoked(table, log));
+
+  // no space left to move the small group to the end
+  EXPECT_EQ(table.invalid_handle, table.add(make<1>(log, 7)));
+
+  EXPECT_TRUE(table.remove(l1));
+  EXPECT_NE(table.invalid_handle, table.add(make<1>(log, 8)));
+  EXPECT_EQ((log_t{5, 8, 3, 4}), invoked(table, log));
+  EXPECT_TRUE(table.remove(s3));
+  EXPECT_EQ((log_t{8, 3, 4}), invoked(table, log));
+}
+
+TEST(callback_table, limits) {
+  callback_table<void(int), 1024, 4, 2> table;
+  log_t log;
+
+  EXPECT_NE(table.invalid_handle, table.add(make<1>(log, 1)));
+  EXPECT_NE(table.invalid_handle, table.add(make<2>(log, 2)));
+  // out of groups
+  EXPECT_EQ(table.invalid_handle, table.add(make<3>(log, 3)));
+  EXPECT_NE(table.invalid_handle, table.add(make<1>(log, 4)));
+  EXPECT_NE(table.invalid_handle, table.add(make<2>(log, 5)));
+  // out of handles
+  EXPECT_EQ(table.invalid_handle, table.add(make<1>(log, 6)));
+  EXPECT_EQ((log_t{1, 4, 2, 5}), invoked(table, log));
+}
+
+TEST(callback_table, random) {
+  using table_t = callback_table<void(int), 512, 48, 3>;
+  table_t table;
+  log_t log;
+  std::map<table_t::handle, int> model;
+  std::uint32_t seed = 1;
+  auto rand = [&seed](std::uint32_t n) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) % n;
+  };
+
+  for (int i = 0; i < 5000; ++i) {
+    if (!model.empty() && rand(3) == 0) {
+      auto it = model.begin();
+      std::advance(it, rand(static_cast<std::uint32_t>(model.size())));
+      EXPECT_TRUE(table.remove(it->first));
+      model.erase(it);
+    } else {
+      table_t::handle h = table.invalid_handle;
+      switch (rand(3)) {
+      case 0:
+        h = table.add(make<1>(log, i));
+        break;
+      case 1:
+        h = table.add(make<17>(log, i));
+        break;
+      default:
+        h = table.add(make<40>(log, i));
+        break;
+      }
+      if (h != table.invalid_handle) {
+        EXPECT_EQ(0, model.count(h));
+        model[h] = i;
+      }
+    }
+
+    if (i % 97 == 0) {
+      table.compact();
+    }
+
+    log_t expected;
+    for (auto const& e : model) {
+      expected.push_back(e.second);
+    }
+    ASSERT_EQ(sorted(expected), sorted(invoked(table, log))) << i;
+    ASSERT_EQ(model.size(), table.size());
+  }
+}
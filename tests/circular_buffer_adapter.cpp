@@ -25,6 +25,8 @@
 #include <algorithm>
 #include <iterator>
 #include <numeric>
+#include <random>
+#include <string>
 #include <unordered_set>
 #include <vector>
 
@@ -1133,6 +1135,488 @@ TYPED_TEST(copy_in_out_fixture, copy_in_out) {
   EXPECT_EQ(std::vector<TypeParam>({26, 21}), out);
 }
 
+TYPED_TEST(copy_in_out_fixture, zero_copy) {
+  std::vector<TypeParam> raw(10);
+  embedded::circular_buffer_adapter<TypeParam> cba(raw.data(), raw.size(), 6,
+                                                   0);
+
+  EXPECT_TRUE(cba.array_one().empty());
+  EXPECT_TRUE(cba.array_two().empty());
+
+  auto r = cba.reserve_back(7);
+
+  //  w   w   w                   w   w   w   w
+  // --  --  --  --  --  --  --  --  --  --
+  //                         b
+  //                         e
+
+  EXPECT_EQ(7, r.size());
+  EXPECT_EQ(raw.data() + 6, r.first.data);
+  EXPECT_EQ(4, r.first.size);
+  EXPECT_EQ(raw.data(), r.second.data);
+  EXPECT_EQ(3, r.second.size);
+
+  TypeParam value = 1;
+  for (auto& x : r.first) {
+    x = value++;
+  }
+  for (auto& x : r.second) {
+    x = value++;
+  }
+
+  EXPECT_TRUE(cba.empty());
+  cba.commit_back(7);
+
+  //  5   6   7                   1   2   3   4
+  // --  --  --  --  --  --  --  --  --  --
+  //                         b
+  //             e
+
+  EXPECT_EQ(7, cba.size());
+  EXPECT_EQ(1, cba.front());
+  EXPECT_EQ(7, cba.back());
+
+  EXPECT_EQ(raw.data() + 6, cba.array_one().data);
+  EXPECT_EQ(4, cba.array_one().size);
+  EXPECT_EQ(raw.data(), cba.array_two().data);
+  EXPECT_EQ(3, cba.array_two().size);
+
+  EXPECT_EQ(3, cba.reserve_back(5).size());
+  EXPECT_EQ(raw.data() + 3, cba.reserve_back(5).first.data);
+  EXPECT_TRUE(cba.reserve_back(5).second.empty());
+
+  auto p = cba.peek_front(2);
+  EXPECT_EQ(2, p.size());
+  EXPECT_TRUE(p.second.empty());
+  EXPECT_EQ(7, cba.peek_front(9).size());
+
+  // process in place
+  for (auto& x : cba.array_one()) {
+    x *= 2;
+  }
+  for (auto& x : cba.array_two()) {
+    x *= 2;
+  }
+
+  cba.consume_front(5);
+
+  //  x  12  14                    x   x   x   x
+  // --  --  --  --  --  --  --  --  --  --
+  //     b
+  //             e
+
+  EXPECT_EQ(2, cba.size());
+  EXPECT_EQ(12, cba.front());
+  EXPECT_EQ(raw.data() + 1, cba.array_one().data);
+  EXPECT_EQ(2, cba.array_one().size);
+  EXPECT_TRUE(cba.array_two().empty());
+
+  auto w = cba.reserve_back(20);
+  EXPECT_EQ(8, w.size());
+  EXPECT_EQ(7, w.first.size);
+  EXPECT_EQ(1, w.second.size);
+  EXPECT_EQ(raw.data(), w.second.data);
+}
+
+TYPED_TEST(copy_in_out_fixture, copy_in_back_overwrite) {
+  std::vector<TypeParam> raw(10);
+  embedded::circular_buffer_adapter<TypeParam> cba(raw.data(), raw.size(), 3,
+                                                   0);
+
+  std::vector<TypeParam> in(25);
+  std::iota(in.begin(), in.end(), 1);
+
+  cba.copy_in_back_overwrite(in.data(), 6);
+
+  EXPECT_EQ(6, cba.size());
+  EXPECT_EQ(1, cba.front());
+  EXPECT_EQ(6, cba.back());
+
+  cba.copy_in_back_overwrite(in.data() + 6, 7);
+
+  //  8   9  10  11  12  13   4   5   6   7
+  // --  --  --  --  --  --  --  --  --  --
+  //                         b
+  //                         e
+
+  EXPECT_TRUE(cba.full());
+  EXPECT_EQ(4, cba.front());
+  EXPECT_EQ(13, cba.back());
+  EXPECT_EQ(3, cba.raw_index(cba.begin() + 7));
+  EXPECT_TRUE(std::equal(cba.begin(), cba.end(), in.begin() + 3));
+
+  // more than the capacity, only the last 10 items remain
+  cba.copy_in_back_overwrite(in.data() + 13, 12);
+
+  EXPECT_TRUE(cba.full());
+  EXPECT_EQ(16, cba.front());
+  EXPECT_EQ(25, cba.back());
+  EXPECT_TRUE(std::equal(cba.begin(), cba.end(), in.begin() + 15));
+
+  cba.pop_front(8);
+  cba.copy_in_back_overwrite(in.data(), 3);
+
+  EXPECT_EQ(5, cba.size());
+  EXPECT_EQ(24, cba.front());
+  EXPECT_EQ(3, cba.back());
+
+  embedded::circular_buffer_adapter<TypeParam, 8> pow2(raw.data(), 8);
+  pow2.copy_in_back_overwrite(in.data(), 11);
+
+  EXPECT_TRUE(pow2.full());
+  EXPECT_TRUE(std::equal(pow2.begin(), pow2.end(), in.begin() + 3));
+}
+
+TEST(circular_buffer_adapter, push_back_overwrite) {
+  constexpr size_t num_items = 3;
+  std::aligned_storage<num_items * sizeof(testdata), alignof(testdata)>::type
+      buffer;
+  embedded::circular_buffer_adapter<testdata> cba(
+      reinterpret_cast<testdata*>(&buffer), num_items);
+
+  testdata::reset();
+
+  cba.emplace_back_overwrite(1);
+  cba.push_back_overwrite(testdata(2));
+  cba.emplace_back_overwrite(3);
+  EXPECT_TRUE(testdata::expect_ops(
+      {CONSTRUCT, CONSTRUCT, MOVE_CONSTRUCT, DESTRUCT, CONSTRUCT}));
+  EXPECT_TRUE(cba.full());
+
+  for (int i = 4; i < 10; ++i) {
+    auto& r = cba.emplace_back_overwrite(i);
+    EXPECT_EQ(i, r.x_);
+    // the new item is built before the front item is dropped
+    EXPECT_TRUE(
+        testdata::expect_ops({CONSTRUCT, DESTRUCT, MOVE_CONSTRUCT, DESTRUCT}));
+    EXPECT_EQ(3, cba.size());
+    EXPECT_EQ(i - 2, cba.front().x_);
+    EXPECT_EQ(i, cba.back().x_);
+  }
+
+  EXPECT_EQ(3, testdata::alive());
+  cba.clear();
+  EXPECT_EQ(0, testdata::alive());
+}
+
+TEST(circular_buffer_adapter, overwrite_from_front) {
+  constexpr size_t num_items = 3;
+  std::aligned_storage<num_items * sizeof(std::string),
+                       alignof(std::string)>::type buffer;
+  embedded::circular_buffer_adapter<std::string> cba(
+      reinterpret_cast<std::string*>(&buffer), num_items);
+
+  // long enough to not fit into the small string buffer
+  cba.push_back(std::string(40, 'a'));
+  cba.push_back(std::string(40, 'b'));
+  cba.push_back(std::string(40, 'c'));
+
+  cba.push_back_overwrite(cba.front());
+  EXPECT_EQ(std::string(40, 'b'), cba.front());
+  EXPECT_EQ(std::string(40, 'a'), cba.back());
+
+  cba.emplace_back_overwrite(std::move(cba.front()));
+  EXPECT_EQ(std::string(40, 'c'), cba.front());
+  EXPECT_EQ(std::string(40, 'b'), cba.back());
+
+  cba.emplace_back_overwrite(cba.front(), 0, 10);
+  EXPECT_EQ(std::string(40, 'a'), cba.front());
+  EXPECT_EQ(std::string(10, 'c'), cba.back());
+
+  cba.clear();
+}
+
+TEST(circular_buffer_adapter, move_in_out) {
+  constexpr size_t num_items = 5;
+  std::aligned_storage<num_items * sizeof(testdata), alignof(testdata)>::type
+      buffer;
+  embedded::circular_buffer_adapter<testdata> cba(
+      reinterpret_cast<testdata*>(&buffer), num_items, 3, 0);
+
+  testdata::reset();
+
+  std::vector<testdata> in;
+  in.reserve(4);
+  for (int i = 1; i <= 4; ++i) {
+    in.emplace_back(i);
+  }
+
+  EXPECT_TRUE(
+      testdata::expect_ops({CONSTRUCT, CONSTRUCT, CONSTRUCT, CONSTRUCT}));
+
+  cba.move_in_back(in.data(), 4);
+
+  EXPECT_TRUE(testdata::expect_ops(
+      {MOVE_CONSTRUCT, MOVE_CONSTRUCT, MOVE_CONSTRUCT, MOVE_CONSTRUCT}));
+  EXPECT_EQ(4, cba.size());
+  EXPECT_EQ(1, cba.front().x_);
+  EXPECT_EQ(4, cba.back().x_);
+  EXPECT_EQ(1, cba.raw_index(cba.begin() + 3));
+
+  std::vector<testdata> out;
+  out.reserve(3);
+  for (int i = 0; i < 3; ++i) {
+    out.emplace_back(0);
+  }
+
+  EXPECT_TRUE(testdata::expect_ops({CONSTRUCT, CONSTRUCT, CONSTRUCT}));
+
+  cba.move_out_front(out.data(), 3);
+
+  EXPECT_TRUE(testdata::expect_ops({MOVE_ASSIGN, MOVE_ASSIGN, MOVE_ASSIGN,
+                                    DESTRUCT, DESTRUCT, DESTRUCT}));
+  EXPECT_EQ(1, cba.size());
+  EXPECT_EQ(4, cba.front().x_);
+  EXPECT_EQ(1, out[0].x_);
+  EXPECT_EQ(3, out[2].x_);
+
+#if LIBEMB_HAS_EXCEPTIONS
+  in[0].x_ = 5;
+  in[1].x_ = 6;
+  in[2].x_ = 4712;
+
+  EXPECT_THROW(cba.move_in_back(in.data(), 3), std::invalid_argument);
+  EXPECT_TRUE(testdata::expect_ops(
+      {MOVE_CONSTRUCT, MOVE_CONSTRUCT, DESTRUCT, DESTRUCT}));
+  EXPECT_EQ(1, cba.size());
+#endif
+
+  cba.clear();
+  EXPECT_EQ(7, testdata::alive());
+}
+
+TEST(circular_buffer_adapter, move_in_out_trivially_copyable) {
+  struct message {
+    int id{-1};
+    float value{0.0f};
+  };
+
+  static_assert(!std::is_trivial<message>::value, "");
+  static_assert(std::is_trivially_copyable<message>::value, "");
+
+  std::vector<message> raw(6);
+  embedded::circular_buffer_adapter<message> cba(raw.data(), raw.size(), 4,
+                                                 0);
+
+  std::vector<message> in(5);
+  for (int i = 0; i < 5; ++i) {
+    in[i].id = i;
+    in[i].value = 0.5f * i;
+  }
+
+  cba.move_in_back(in.data(), 5);
+
+  EXPECT_EQ(5, cba.size());
+  EXPECT_EQ(2, raw[0].id);
+  EXPECT_EQ(4, cba.back().id);
+
+  std::vector<message> out(5);
+  cba.move_out_front(out.data(), 5);
+
+  EXPECT_TRUE(cba.empty());
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(i, out[i].id);
+    EXPECT_EQ(0.5f * i, out[i].value);
+  }
+}
+
+TEST(circular_buffer_adapter, statistics) {
+  using stats_adapter = embedded::circular_buffer_adapter<
+      int, 0, embedded::cba_instrumentation::statistics>;
+
+  static_assert(sizeof(embedded::circular_buffer_adapter<int>) ==
+                    sizeof(embedded::circular_buffer_adapter<
+                           int, 0, embedded::cba_instrumentation::none>),
+                "");
+
+  std::vector<int> raw(8);
+  stats_adapter cba(raw.data(), raw.size(), 2, 3);
+
+  EXPECT_EQ(3, cba.statistics().high_water);
+  EXPECT_EQ(0, cba.statistics().pushed);
+
+  cba.push_back(1);
+  cba.emplace_front(2);
+  cba.pop_back();
+
+  std::vector<int> in(20);
+  std::iota(in.begin(), in.end(), 0);
+  cba.copy_in_back(in.data(), 3);
+  cba.move_in_back(in.data(), 1);
+
+  EXPECT_EQ(8, cba.size());
+  EXPECT_EQ(8, cba.statistics().high_water);
+  EXPECT_EQ(6, cba.statistics().pushed);
+  EXPECT_EQ(1, cba.statistics().popped);
+  EXPECT_EQ(0, cba.statistics().overflows);
+
+  std::vector<int> out(5);
+  cba.copy_out_front(out.data(), 2);
+  cba.move_out_front(out.data(), 2);
+  cba.consume_front(1);
+  cba.pop_front();
+
+  EXPECT_EQ(2, cba.size());
+  EXPECT_EQ(7, cba.statistics().popped);
+
+  cba.push_back_overwrite(42);
+  cba.copy_in_back_overwrite(in.data(), 5);
+  EXPECT_EQ(0, cba.statistics().overflows);
+  cba.push_back_overwrite(43);
+  EXPECT_EQ(1, cba.statistics().overflows);
+  cba.copy_in_back_overwrite(in.data(), 11);
+  EXPECT_EQ(12, cba.statistics().overflows);
+  EXPECT_EQ(24, cba.statistics().pushed);
+  EXPECT_EQ(8, cba.statistics().high_water);
+  EXPECT_EQ(0, cba.statistics().underflows);
+
+  // the initial and added items are either still there, removed or dropped
+  auto const& st = cba.statistics();
+  EXPECT_EQ(3 + st.pushed, cba.size() + st.popped + st.overflows);
+
+  cba.reset_statistics();
+  EXPECT_EQ(0, cba.statistics().pushed);
+  EXPECT_EQ(0, cba.statistics().high_water);
+
+  cba.clear();
+  EXPECT_EQ(0, cba.statistics().popped);
+}
+
+TEST(circular_buffer_adapter, static_capacity) {
+  constexpr size_t capacity = 8;
+
+  std::vector<int> raw_dyn(capacity);
+  std::vector<int> raw_pow2(capacity);
+  embedded::circular_buffer_adapter<int> dyn(raw_dyn.data(), capacity, 5, 0);
+  embedded::circular_buffer_adapter<int, capacity> pow2(raw_pow2.data(),
+                                                        capacity, 5, 0);
+
+  EXPECT_EQ(capacity, pow2.capacity());
+
+  std::mt19937 rng(42);
+  int next = 0;
+
+  for (int round = 0; round < 2000; ++round) {
+    auto const op = rng() % 6;
+    switch (op) {
+    case 0:
+      if (!dyn.full()) {
+        dyn.push_back(next);
+        pow2.push_back(next);
+        ++next;
+      }
+      break;
+    case 1:
+      if (!dyn.full()) {
+        dyn.push_front(next);
+        pow2.push_front(next);
+        ++next;
+      }
+      break;
+    case 2:
+      if (!dyn.empty()) {
+        dyn.pop_front();
+        pow2.pop_front();
+      }
+      break;
+    case 3:
+      if (!dyn.empty()) {
+        dyn.pop_back();
+        pow2.pop_back();
+      }
+      break;
+    case 4: {
+      std::vector<int> in(rng() % (dyn.remaining() + 1));
+      std::iota(in.begin(), in.end(), next);
+      next += static_cast<int>(in.size());
+      dyn.copy_in_back(in.data(), in.size());
+      pow2.copy_in_back(in.data(), in.size());
+      break;
+    }
+    default: {
+      auto const n = rng() % (dyn.size() + 1);
+      dyn.pop_front(n);
+      pow2.pop_front(n);
+      break;
+    }
+    }
+
+    ASSERT_EQ(dyn.size(), pow2.size());
+    ASSERT_TRUE(std::equal(dyn.begin(), dyn.end(), pow2.begin()));
+    ASSERT_TRUE(std::equal(dyn.rbegin(), dyn.rend(), pow2.rbegin()));
+    ASSERT_EQ(dyn.raw_index(dyn.begin()), pow2.raw_index(pow2.begin()));
+    ASSERT_EQ(dyn.raw_index(dyn.end()), pow2.raw_index(pow2.end()));
+
+    for (size_t i = 0; i < pow2.size(); ++i) {
+      ASSERT_EQ(dyn[i], pow2[i]);
+      auto const it = pow2.begin() + i;
+      ASSERT_EQ(static_cast<std::ptrdiff_t>(i), it - pow2.begin());
+      ASSERT_TRUE(it < pow2.end());
+      ASSERT_TRUE(pow2.end() - (pow2.size() - i) == it);
+    }
+
+    if (!pow2.empty()) {
+      ASSERT_EQ(dyn.front(), pow2.front());
+      ASSERT_EQ(dyn.back(), pow2.back());
+    }
+  }
+}
+
+namespace {
+
+template <typename Adapter>
+void check_iterator_stability(Adapter& cba) {
+  for (int i = 0; i < 6; ++i) {
+    cba.push_back(i);
+  }
+  cba.pop_front(4);
+  for (int i = 6; i < 9; ++i) {
+    cba.push_back(i);
+  }
+
+  // the items now wrap around the end of the memory
+  auto it = cba.begin() + 2;
+  typename Adapter::const_iterator cit = cba.begin() + 3;
+  EXPECT_EQ(6, *it);
+  EXPECT_EQ(7, *cit);
+
+  cba.pop_front();
+  EXPECT_EQ(6, *it);
+  EXPECT_EQ(7, *cit);
+  EXPECT_EQ(1, it - cba.begin());
+  EXPECT_TRUE(cba.begin() < it);
+
+  cba.push_front(10);
+  cba.push_front(11);
+  EXPECT_EQ(6, *it);
+  EXPECT_EQ(7, *cit);
+  EXPECT_EQ(3, it - cba.begin());
+  EXPECT_TRUE(it + 1 == cit);
+  EXPECT_TRUE(it + 3 == cba.end());
+
+  cba.push_back(9);
+  cba.push_back(12);
+  EXPECT_TRUE(cba.full());
+  EXPECT_EQ(7, *cit);
+  EXPECT_EQ(9, *(it + 3));
+  EXPECT_EQ(cba.end(), it + 5);
+  EXPECT_EQ(cba.begin(), it - 3);
+  EXPECT_EQ(11, *(it - 3));
+}
+
+} // namespace
+
+TEST(circular_buffer_adapter, iterator_stability) {
+  std::vector<int> raw_dyn(8);
+  std::vector<int> raw_pow2(8);
+  embedded::circular_buffer_adapter<int> dyn(raw_dyn.data(), raw_dyn.size());
+  embedded::circular_buffer_adapter<int, 8> pow2(raw_pow2.data(),
+                                                 raw_pow2.size());
+
+  check_iterator_stability(dyn);
+  check_iterator_stability(pow2);
+}
+
 #if LIBEMB_HAS_EXCEPTIONS
 TEST(circular_buffer_adapter, exceptions) {
   std::vector<uint8_t> raw(4);
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "embedded/circular_buffer_algorithm.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+// Buffers of both kinds with capacity 16, filled with `count` items
+// starting at raw index `first`, so that they wrap around for most
+// parameters
+template <std::size_t Capacity>
+class filled {
+ public:
+  using adapter = embedded::circular_buffer_adapter<int, Capacity>;
+
+  filled(std::size_t first, std::size_t count)
+      : raw_(16, -1)
+      , cba_(raw_.data(), raw_.size(), first, 0) {
+    for (std::size_t i = 0; i < count; ++i) {
+      // not monotonic, with duplicates
+      cba_.push_back(static_cast<int>((i * 7) % 11));
+    }
+  }
+
+  adapter& get() { return cba_; }
+  std::vector<int>& raw() { return raw_; }
+
+  std::vector<int> items() const {
+    return std::vector<int>(cba_.begin(), cba_.end());
+  }
+
+ private:
+  std::vector<int> raw_;
+  adapter cba_;
+};
+
+template <typename T>
+class circular_buffer_algorithm : public ::testing::Test {};
+
+using capacities = ::testing::Types<std::integral_constant<std::size_t, 0>,
+                                    std::integral_constant<std::size_t, 16>>;
+
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpragmas"
+#pragma GCC diagnostic ignored "-Wgnu-zero-variadic-macro-arguments"
+#endif
+
+TYPED_TEST_SUITE(circular_buffer_algorithm, capacities);
+
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+
+} // namespace
+
+TYPED_TEST(circular_buffer_algorithm, for_each_segment) {
+  filled<TypeParam::value> buf(12, 10);
+  auto& cba = buf.get();
+  auto& raw = buf.raw();
+
+  std::vector<std::pair<int const*, int const*>> segments;
+  auto collect = [&](int* b, int* e) { segments.emplace_back(b, e); };
+
+  embedded::for_each_segment(cba.begin(), cba.end(), collect);
+  ASSERT_EQ(2, segments.size());
+  EXPECT_EQ(raw.data() + 12, segments[0].first);
+  EXPECT_EQ(raw.data() + 16, segments[0].second);
+  EXPECT_EQ(raw.data(), segments[1].first);
+  EXPECT_EQ(raw.data() + 6, segments[1].second);
+
+  segments.clear();
+  embedded::for_each_segment(cba.begin() + 5, cba.end() - 1, collect);
+  ASSERT_EQ(1, segments.size());
+  EXPECT_EQ(raw.data() + 1, segments[0].first);
+  EXPECT_EQ(raw.data() + 5, segments[0].second);
+
+  segments.clear();
+  embedded::for_each_segment(cba.end(), cba.end(), collect);
+  EXPECT_TRUE(segments.empty());
+
+  std::vector<int> seen;
+  embedded::for_each_segment(
+      cba.cbegin(), cba.cend(),
+      [&](int const* b, int const* e) { seen.insert(seen.end(), b, e); });
+  EXPECT_EQ(buf.items(), seen);
+}
+
+TYPED_TEST(circular_buffer_algorithm, matches_std) {
+  for (std::size_t first = 0; first < 16; first += 3) {
+    for (std::size_t count = 0; count <= 16; ++count) {
+      filled<TypeParam::value> buf(first, count);
+      auto& cba = buf.get();
+      auto const items = buf.items();
+
+      for (std::size_t a = 0; a <= count; a += 2) {
+        for (std::size_t b = a; b <= count; b += 3) {
+          auto const f = cba.begin() + a;
+          auto const l = cba.begin() + b;
+          auto const vf = items.begin() + a;
+          auto const vl = items.begin() + b;
+
+          std::vector<int> out;
+          embedded::copy(f, l, std::back_inserter(out));
+          ASSERT_EQ(std::vector<int>(vf, vl), out);
+
+          ASSERT_EQ(std::accumulate(vf, vl, 5), embedded::accumulate(f, l, 5));
+          ASSERT_EQ(std::accumulate(vf, vl, 1, std::multiplies<int>()),
+                    embedded::accumulate(f, l, 1, std::multiplies<int>()));
+
+          std::vector<int> coef(b - a);
+          std::iota(coef.begin(), coef.end(), -3);
+          ASSERT_EQ(std::inner_product(vf, vl, coef.begin(), 2),
+                    embedded::inner_product(f, l, coef.begin(), 2));
+
+          ASSERT_EQ(std::min_element(vf, vl) - items.begin(),
+                    embedded::min_element(f, l) - cba.begin());
+          ASSERT_EQ(std::max_element(vf, vl) - items.begin(),
+                    embedded::max_element(f, l) - cba.begin());
+          ASSERT_EQ(
+              std::min_element(vf, vl, std::greater<int>()) - items.begin(),
+              embedded::min_element(f, l, std::greater<int>()) - cba.begin());
+        }
+      }
+    }
+  }
+}
+
+TYPED_TEST(circular_buffer_algorithm, modify) {
+  filled<TypeParam::value> buf(13, 9);
+  auto& cba = buf.get();
+
+  embedded::fill(cba.begin() + 1, cba.end() - 2, 42);
+  auto items = buf.items();
+  EXPECT_EQ(0, items[0]);
+  EXPECT_EQ(6, std::count(items.begin(), items.end(), 42));
+  EXPECT_NE(42, items[7]);
+  EXPECT_NE(42, items[8]);
+
+  std::vector<int> in{1, 2, 3, 4, 5, 6};
+  auto const end = embedded::copy(in.begin(), in.end(), cba.begin() + 1);
+  EXPECT_TRUE(end == cba.begin() + 7);
+  items = buf.items();
+  EXPECT_EQ(0, items[0]);
+  EXPECT_TRUE(std::equal(in.begin(), in.end(), items.begin() + 1));
+  EXPECT_EQ(2, buf.raw()[15]);
+  EXPECT_EQ(3, buf.raw()[0]);
+
+  // copying between buffers uses the segments of the source
+  filled<0> other(3, 9);
+  embedded::copy(cba.cbegin(), cba.cend(), other.get().begin());
+  EXPECT_EQ(buf.items(), other.items());
+}
@@ -20,9 +20,12 @@
  * DEALINGS IN THE SOFTWARE.
  */
 
+#include "embedded/circular_buffer_adapter.h"
 #include "embedded/constexpr_math/convolve.h"
 #include "embedded/constexpr_math/vector.h"
 
+#include <cmath>
+
 #include <gtest/gtest.h>
 
 #include "test_util.h"
@@ -42,3 +45,117 @@ TEST(constexpr_convolve, basic) {
   static_assert(almost_equal(c[3], 4.0), "conv");
   static_assert(almost_equal(c[4], 1.5), "conv");
 }
+
+TEST(constexpr_convolve, valid_same) {
+  constexpr cmath::vector<double, 5> a{1.0, 2.0, 3.0, 4.0, 5.0};
+  constexpr cmath::vector<double, 3> b{1.0, 0.0, -1.0};
+  constexpr auto full = convolve_full(a, b);
+  constexpr auto valid = convolve_valid(a, b);
+  constexpr auto valid2 = convolve_valid(b, a);
+  constexpr auto same = convolve_same(a, b);
+
+  static_assert(valid.size() == 3, "size");
+  static_assert(valid2.size() == 3, "size");
+  static_assert(same.size() == 5, "size");
+
+  for (std::size_t i = 0; i < valid.size(); ++i) {
+    EXPECT_EQ(full[i + 2], valid[i]);
+    EXPECT_EQ(full[i + 2], valid2[i]);
+  }
+  for (std::size_t i = 0; i < same.size(); ++i) {
+    EXPECT_EQ(full[i + 1], same[i]);
+  }
+}
+
+namespace {
+
+// Targets with FMA may contract the run-time multiply-adds, so results
+// can differ in the last bits.
+#if defined(__FP_FAST_FMAF)
+#define EXPECT_CONV_EQ(a, b) EXPECT_NEAR(a, b, 1e-5f * (1.0f + std::abs(a)))
+#else
+#define EXPECT_CONV_EQ EXPECT_EQ
+#endif
+
+struct test_signal {
+  constexpr float operator()(std::size_t i) const {
+    return 1.0f / (1.0f + i) - 0.3f * i;
+  }
+};
+
+template <std::size_t S>
+constexpr auto make_signal() -> cmath::vector<float, S> {
+  return cmath::vector<float, S>::create(test_signal{});
+}
+
+template <std::size_t S1, std::size_t S2>
+void cross_check() {
+  constexpr auto a = make_signal<S1>();
+  constexpr auto b = 0.5f * make_signal<S2>().reverse();
+  constexpr auto full = convolve_full(a, b);
+  constexpr auto valid = convolve_valid(a, b);
+  constexpr auto same = convolve_same(a, b);
+
+  float ra[S1], rb[S2];
+  for (std::size_t i = 0; i < S1; ++i) {
+    ra[i] = a[i];
+  }
+  for (std::size_t i = 0; i < S2; ++i) {
+    rb[i] = b[i];
+  }
+
+  // bit-identical results without FMA
+  float out[S1 + S2 - 1];
+  ASSERT_EQ(out + full.size(), cmath::convolve_full(ra, S1, rb, S2, out));
+  for (std::size_t i = 0; i < full.size(); ++i) {
+    EXPECT_CONV_EQ(full[i], out[i]) << S1 << "/" << S2 << " full " << i;
+  }
+
+  ASSERT_EQ(out + valid.size(), cmath::convolve_valid(ra, S1, rb, S2, out));
+  for (std::size_t i = 0; i < valid.size(); ++i) {
+    EXPECT_CONV_EQ(valid[i], out[i]) << S1 << "/" << S2 << " valid " << i;
+  }
+
+  ASSERT_EQ(out + same.size(), cmath::convolve_same(ra, S1, rb, S2, out));
+  for (std::size_t i = 0; i < same.size(); ++i) {
+    EXPECT_CONV_EQ(same[i], out[i]) << S1 << "/" << S2 << " same " << i;
+  }
+
+  // circular buffer input, wrapped at every possible position
+  float raw[S1];
+  for (std::size_t first = 0; first < S1; ++first) {
+    circular_buffer_adapter<float> cb(raw, S1);
+    for (std::size_t i = 0; i < first; ++i) {
+      cb.push_back(0.0f);
+    }
+    cb.pop_front(first);
+    cb.copy_in_back(ra, S1);
+
+    ASSERT_EQ(out + full.size(), cmath::convolve_full(cb, rb, S2, out));
+    for (std::size_t i = 0; i < full.size(); ++i) {
+      EXPECT_CONV_EQ(full[i], out[i]) << S1 << "/" << S2 << " cb " << first;
+    }
+
+    ASSERT_EQ(out + valid.size(), cmath::convolve_valid(cb, rb, S2, out));
+    for (std::size_t i = 0; i < valid.size(); ++i) {
+      EXPECT_CONV_EQ(valid[i], out[i]) << S1 << "/" << S2 << " cb " << first;
+    }
+
+    ASSERT_EQ(out + same.size(), cmath::convolve_same(cb, rb, S2, out));
+    for (std::size_t i = 0; i < same.size(); ++i) {
+      EXPECT_CONV_EQ(same[i], out[i]) << S1 << "/" << S2 << " cb " << first;
+    }
+  }
+}
+
+} // namespace
+
+TEST(constexpr_convolve, runtime) {
+  cross_check<1, 1>();
+  cross_check<7, 3>();
+  cross_check<3, 7>();
+  cross_check<64, 9>();
+  cross_check<9, 64>();
+  cross_check<100, 100>();
+  cross_check<133, 17>();
+}
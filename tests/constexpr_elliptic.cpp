@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#include "embedded/constexpr_math/elliptic.h"
+
+#include <gtest/gtest.h>
+
+#include "test_util.h"
+
+using namespace embedded;
+using namespace embedded::test;
+
+TEST(constexpr_elliptic, ellipk) {
+  static_assert(almost_equal(cmath::ellipk(0.0), cmath::pi<double>() / 2),
+                "K(0)");
+  static_assert(almost_equal(cmath::ellipk(0.5), 1.8540746773013719), "K(0.5)");
+  static_assert(almost_equal(cmath::ellipk(0.5f), 1.8540747f), "K(0.5)");
+  static_assert(almost_equal(cmath::ellipkm1(0.5), cmath::ellipk(0.5)),
+                "K(1 - 0.5)");
+  static_assert(almost_equal(cmath::ellipkm1(0.25), cmath::ellipk(0.75)),
+                "K(1 - 0.25)");
+  static_assert(cmath::ellipkm1(1e-12) > cmath::ellipkm1(1e-11), "monotonic");
+}
+
+TEST(constexpr_elliptic, ellipf) {
+  static_assert(cmath::ellipf(0.0, 0.3) == 0.0, "F(0)");
+  static_assert(almost_equal(cmath::ellipf(0.5, 0.0), 0.5), "F(phi | 0)");
+  static_assert(
+      almost_equal(cmath::ellipf(cmath::pi<double>() / 2, 0.8),
+                   cmath::ellipk(0.8)),
+      "F(pi / 2)");
+  static_assert(almost_equal(cmath::ellipf(-0.5, 0.3),
+                             -cmath::ellipf(0.5, 0.3)),
+                "odd");
+}
+
+TEST(constexpr_elliptic, ellipj) {
+  {
+    constexpr auto j = cmath::ellipj(0.7, 0.0);
+    static_assert(almost_equal(j.sn, cmath::sin(0.7)), "sn");
+    static_assert(almost_equal(j.cn, cmath::cos(0.7)), "cn");
+    static_assert(j.dn == 1.0, "dn");
+  }
+
+  {
+    constexpr auto j = cmath::ellipj(0.7, 0.3);
+    static_assert(almost_equal(j.sn * j.sn + j.cn * j.cn, 1.0), "sn^2 + cn^2");
+    static_assert(almost_equal(j.dn * j.dn + 0.3 * j.sn * j.sn, 1.0),
+                  "dn^2 + m sn^2");
+    static_assert(almost_equal(cmath::ellipf(cmath::asin(j.sn), 0.3), 0.7),
+                  "inverse");
+  }
+
+  {
+    // quarter period
+    constexpr auto j = cmath::ellipj(cmath::ellipk(0.8), 0.8);
+    static_assert(almost_equal(j.sn, 1.0), "sn");
+    static_assert(j.cn < 1e-15 && j.cn > -1e-15, "cn");
+    static_assert(almost_equal(j.dn, cmath::sqrt(0.2)), "dn");
+  }
+
+  {
+    // half quarter period
+    constexpr auto j = cmath::ellipj(cmath::ellipk(0.6) / 2, 0.6);
+    static_assert(almost_equal(j.sn, 1.0 / cmath::sqrt(1.0 + cmath::sqrt(0.4))),
+                  "sn");
+    static_assert(almost_equal(j.dn, cmath::sqrt(cmath::sqrt(0.4))), "dn");
+  }
+
+  {
+    constexpr auto j = cmath::ellipj(1.2f, 0.5f);
+    static_assert(almost_equal(j.sn * j.sn + j.cn * j.cn, 1.0f), "float");
+  }
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "embedded/constexpr_math/lut.h"
+#include "embedded/constexpr_math/constants.h"
+#include "embedded/constexpr_math/functions.h"
+
+#include <cmath>
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+using namespace embedded;
+
+namespace {
+
+struct sine {
+  constexpr double operator()(double x) const { return cmath::sin(x); }
+};
+
+struct soft_clip {
+  constexpr double operator()(double x) const {
+    return 32000 * cmath::tanh(x);
+  }
+};
+
+struct ramp {
+  constexpr double operator()(double x) const { return 2 * x + 1; }
+};
+
+constexpr auto sine_lut = cmath::make_periodic_lut<float, 256>(
+    sine{}, 0.0, 2 * cmath::pi<double>());
+
+constexpr auto clip_lut = cmath::make_lut<std::int16_t, 65>(soft_clip{}, -4, 4);
+
+} // namespace
+
+TEST(constexpr_lut, periodic) {
+  EXPECT_EQ(256, sine_lut.size());
+  EXPECT_EQ(0x40000000u, sine_lut.phase(0.25));
+  EXPECT_FLOAT_EQ(1.0f, sine_lut[64]);
+  EXPECT_FLOAT_EQ(1.0f, sine_lut.nearest(sine_lut.phase(0.25)));
+  EXPECT_FLOAT_EQ(1.0f, sine_lut.linear(sine_lut.phase(0.25)));
+  EXPECT_FLOAT_EQ(1.0f, sine_lut.cubic(sine_lut.phase(0.25)));
+
+  double max_nearest = 0, max_linear = 0, max_cubic = 0;
+  for (std::uint32_t i = 0; i < 100000; ++i) {
+    auto const phase = i * 42949u + 12345u * (i % 7);
+    auto const ref =
+        std::sin(2 * cmath::pi<double>() * (phase / 4294967296.0));
+    max_nearest = std::max(max_nearest,
+                           std::abs(sine_lut.nearest(phase) - ref));
+    max_linear = std::max(max_linear, std::abs(sine_lut.linear(phase) - ref));
+    max_cubic = std::max(max_cubic, std::abs(sine_lut.cubic(phase) - ref));
+  }
+
+  EXPECT_LT(max_nearest, 0.0124);
+  EXPECT_LT(max_linear, 8e-5);
+  EXPECT_LT(max_cubic, 1e-6);
+
+  // wrap around from the last sample to the first
+  EXPECT_NEAR(0.0, sine_lut.linear(0xFFFFFFFFu), 1e-6);
+  EXPECT_NEAR(0.0, sine_lut.cubic(0xFFFFFFFFu), 1e-6);
+  EXPECT_FLOAT_EQ(0.0f, sine_lut.nearest(0xFFFFFFFFu));
+}
+
+TEST(constexpr_lut, integral) {
+  EXPECT_EQ(65, clip_lut.size());
+  EXPECT_EQ(0, clip_lut[32]);
+  EXPECT_EQ(std::lround(32000 * std::tanh(-4.0)), clip_lut[0]);
+  EXPECT_EQ(std::lround(32000 * std::tanh(0.125)), clip_lut[33]);
+
+  // clamped to [lo, hi]
+  EXPECT_EQ(clip_lut[0], clip_lut.linear(-100.0f));
+  EXPECT_EQ(clip_lut[64], clip_lut.cubic(100.0f));
+  EXPECT_EQ(clip_lut[0], clip_lut.nearest(std::nanf("")));
+  EXPECT_EQ(clip_lut[64], clip_lut.cubic_fixed<16>(0xFFFFFFFFu));
+
+  for (int i = -4500; i <= 4500; ++i) {
+    auto const x = i / 1000.0f;
+    auto const ref = 32000 * std::tanh(std::max(-4.0f, std::min(4.0f, x)));
+    EXPECT_NEAR(ref, clip_lut.nearest(x), 2000);
+    EXPECT_NEAR(ref, clip_lut.linear(x), 50);
+    EXPECT_NEAR(ref, clip_lut.cubic(x), 4);
+
+    // same position in units of samples
+    auto const pos = static_cast<std::uint32_t>(
+        std::max(0.0f, (x + 4) * 8 * 65536));
+    EXPECT_EQ(clip_lut.nearest(x), clip_lut.nearest_fixed<16>(pos));
+    EXPECT_NEAR(clip_lut.linear(x), clip_lut.linear_fixed<16>(pos), 1);
+    EXPECT_NEAR(clip_lut.cubic(x), clip_lut.cubic_fixed<16>(pos), 1);
+  }
+}
+
+TEST(constexpr_lut, exact) {
+  // linear functions are reproduced exactly, including the guard samples
+  // at the ends
+  constexpr auto lin = cmath::make_lut<double, 11>(ramp{}, 0.0, 1.0);
+
+  for (int i = 0; i <= 100; ++i) {
+    auto const x = i / 100.0;
+    EXPECT_NEAR(2 * x + 1, lin.linear(x), 1e-12);
+    EXPECT_NEAR(2 * x + 1, lin.cubic(x), 1e-12);
+  }
+
+  for (std::uint32_t pos = 0; pos <= 10 << 8; ++pos) {
+    EXPECT_NEAR(2 * (pos / 2560.0) + 1, lin.cubic_fixed<8>(pos), 1e-12);
+  }
+}
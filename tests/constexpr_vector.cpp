@@ -71,6 +71,9 @@ TEST(constexpr_vector, basic) {
     static_assert(a1.erase<1, 3>() == a3, "erase");
     static_assert(a3.swap(0, 1) == a4, "swap");
     static_assert(a1.swap(1, 3) == a5, "swap");
+    static_assert(a3.reverse() == a4, "reverse");
+    static_assert(cmath::sum(a1) == 15, "sum");
+    static_assert(cmath::prod(a1) == 120, "prod");
   }
   {
     constexpr cmath::vector<int, 4> a{2, 1, 1, 2};
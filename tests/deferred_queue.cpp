@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "embedded/deferred_queue.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace embedded;
+
+namespace {
+
+struct counting_call {
+  counting_call(std::vector<int>& log, int id, int& moves)
+      : log_{&log}
+      , moves_{&moves}
+      , id_{id} {}
+
+  counting_call(counting_call&& other) noexcept
+      : log_{other.log_}
+      , moves_{other.moves_}
+      , id_{other.id_} {
+    ++*moves_;
+  }
+
+  counting_call(counting_call const&) = delete;
+
+  void operator()() { log_->push_back(id_); }
+
+  std::vector<int>* log_;
+  int* moves_;
+  int id_;
+};
+
+} // namespace
+
+TEST(deferred_queue, basic) {
+  deferred_queue<4> q;
+  std::vector<int> log;
+
+  EXPECT_EQ(4, q.capacity());
+  EXPECT_EQ(1, q.priorities());
+  EXPECT_TRUE(q.empty());
+  EXPECT_EQ(0, q.drain());
+
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(q.post([&log, i] { log.push_back(i); }));
+  }
+  EXPECT_FALSE(q.post([&log] { log.push_back(99); }));
+  EXPECT_EQ(4, q.size());
+
+  EXPECT_EQ(4, q.drain());
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3}), log);
+  EXPECT_TRUE(q.empty());
+
+  // wrap around
+  log.clear();
+  for (int round = 0; round < 5; ++round) {
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_TRUE(q.post([&log, round, i] { log.push_back(10 * round + i); }));
+    }
+    EXPECT_EQ(3, q.drain());
+  }
+  EXPECT_EQ(15, log.size());
+  EXPECT_EQ(42, log.back());
+}
+
+TEST(deferred_queue, budget) {
+  deferred_queue<8> q;
+  int calls = 0;
+
+  for (int i = 0; i < 7; ++i) {
+    q.post([&calls] { ++calls; });
+  }
+
+  EXPECT_EQ(3, q.drain(3));
+  EXPECT_EQ(3, calls);
+  EXPECT_EQ(4, q.size());
+  EXPECT_EQ(0, q.drain(0));
+  EXPECT_EQ(3, q.drain(3));
+  EXPECT_EQ(1, q.drain(3));
+  EXPECT_EQ(7, calls);
+}
+
+TEST(deferred_queue, priorities) {
+  deferred_queue<4, 3> q;
+  std::vector<int> log;
+
+  q.post(2, [&log] { log.push_back(20); });
+  q.post(1, [&log] { log.push_back(10); });
+  q.post(2, [&log] { log.push_back(21); });
+  // a high priority call posted while draining runs next
+  q.post(1, [&log, &q] {
+    log.push_back(11);
+    q.post(0, [&log] { log.push_back(0); });
+  });
+
+  EXPECT_EQ(2, q.size(1));
+  EXPECT_EQ(4, q.size());
+
+  EXPECT_EQ(3, q.drain(3));
+  EXPECT_EQ((std::vector<int>{10, 11, 0}), log);
+  EXPECT_EQ(2, q.drain());
+  EXPECT_EQ((std::vector<int>{10, 11, 0, 20, 21}), log);
+}
+
+TEST(deferred_queue, in_place) {
+  deferred_queue<2> q;
+  std::vector<int> log;
+  int moves = 0;
+
+  // the callable is moved once into its slot
+  EXPECT_TRUE(q.post(counting_call{log, 1, moves}));
+  EXPECT_EQ(1, moves);
+
+  // and not at all when draining
+  EXPECT_EQ(1, q.drain());
+  EXPECT_EQ(1, moves);
+  EXPECT_EQ((std::vector<int>{1}), log);
+}
+
+TEST(deferred_queue, clear) {
+  auto token = std::make_shared<int>(0);
+
+  {
+    deferred_queue<4, 2> q;
+    q.post(0, [token] { ++*token; });
+    q.post(1, [token] { ++*token; });
+    EXPECT_EQ(3, token.use_count());
+
+    q.clear();
+    EXPECT_TRUE(q.empty());
+    EXPECT_EQ(1, token.use_count());
+
+    q.post(1, [token] { ++*token; });
+    EXPECT_EQ(2, token.use_count());
+  }
+
+  // pending calls are destroyed with the queue
+  EXPECT_EQ(1, token.use_count());
+  EXPECT_EQ(0, *token);
+}
+
+TEST(deferred_queue, threads) {
+  struct state {
+    std::uint32_t next{0};
+    std::uint32_t errors{0};
+    std::uint64_t sum{0};
+    std::atomic<bool> done{false};
+  };
+
+  constexpr std::uint32_t count = 100000;
+  deferred_queue<13, 2> q;
+  state st[2];
+
+  auto producer = [&q, &st](std::size_t level) {
+    auto const s = &st[level];
+    for (std::uint32_t i = 0; i < count;) {
+      if (q.post(level, [s, i] {
+            if (s->next++ != i) {
+              ++s->errors;
+            }
+            s->sum += i;
+          })) {
+        ++i;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+    s->done = true;
+  };
+
+  std::thread p0(producer, 0);
+  std::thread p1(producer, 1);
+
+  while (!st[0].done || !st[1].done || !q.empty()) {
+    if (q.drain(5) == 0) {
+      std::this_thread::yield();
+    }
+  }
+
+  p0.join();
+  p1.join();
+
+  for (auto const& s : st) {
+    EXPECT_EQ(0, s.errors);
+    EXPECT_EQ(count, s.next);
+    EXPECT_EQ(std::uint64_t{count} * (count - 1) / 2, s.sum);
+  }
+}
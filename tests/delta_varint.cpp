@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "embedded/circular_buffer_adapter.h"
+#include "embedded/delta_varint.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace embedded;
+
+namespace {
+
+std::vector<std::int16_t> ramp_signal(std::size_t count) {
+  std::vector<std::int16_t> v(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    v[i] = static_cast<std::int16_t>(-16000 + 70 * i +
+                                     std::lround(3 * std::sin(0.1 * i)));
+  }
+  return v;
+}
+
+template <typename T, unsigned Order>
+void roundtrip(std::vector<T> const& in, std::size_t interval,
+               std::size_t& bytes) {
+  std::vector<std::uint8_t> raw(4096);
+  circular_buffer_adapter<std::uint8_t> cb(raw.data(), raw.size());
+
+  delta_varint_encoder<T, Order> enc(interval);
+  for (auto v : in) {
+    ASSERT_TRUE(enc.encode(v, cb));
+  }
+  bytes = cb.size();
+
+  delta_varint_decoder<T, Order> dec(interval);
+  auto it = cb.begin();
+  for (auto v : in) {
+    T out{};
+    auto next = dec.decode(out, it, cb.end());
+    ASSERT_NE(it, next);
+    EXPECT_EQ(v, out);
+    it = next;
+  }
+  EXPECT_EQ(cb.end(), it);
+}
+
+} // namespace
+
+TEST(delta_varint, roundtrip) {
+  auto const in = ramp_signal(500);
+  std::size_t bytes1, bytes2;
+
+  roundtrip<std::int16_t, 1>(in, 64, bytes1);
+  roundtrip<std::int16_t, 2>(in, 64, bytes2);
+
+  // raw storage takes 1000 bytes, the first order residuals need two
+  // bytes, the second order residuals only one
+  EXPECT_LT(bytes1, 1020);
+  EXPECT_LT(bytes2, 550);
+}
+
+TEST(delta_varint, extremes) {
+  using lim = std::numeric_limits<std::int32_t>;
+  std::vector<std::int32_t> in{0,        lim::max(), lim::min(), lim::max(),
+                               -1,       lim::min(), 1,          lim::min(),
+                               lim::max(), 0};
+  std::size_t bytes{};
+
+  roundtrip<std::int32_t, 1>(in, 3, bytes);
+  roundtrip<std::int32_t, 2>(in, 3, bytes);
+  roundtrip<std::int32_t, 2>(in, 100, bytes);
+}
+
+TEST(delta_varint, buffer_full) {
+  std::uint8_t raw[4];
+  circular_buffer_adapter<std::uint8_t> cb(raw, 4);
+  delta_varint_encoder<std::int32_t> enc(16);
+
+  EXPECT_TRUE(enc.encode(1000, cb)); // 2 bytes
+  EXPECT_TRUE(enc.encode(1001, cb)); // 1 byte
+  EXPECT_FALSE(enc.encode(2000, cb));
+  EXPECT_EQ(3, cb.size());
+  EXPECT_TRUE(enc.encode(1002, cb));
+  EXPECT_TRUE(cb.full());
+
+  // make room by dropping the first two values
+  cb.pop_front(3);
+  EXPECT_TRUE(enc.encode(1003, cb));
+}
+
+TEST(delta_varint, seek) {
+  auto const in = ramp_signal(100);
+  std::uint8_t raw[256];
+  circular_buffer_adapter<std::uint8_t> cb(raw, sizeof(raw));
+
+  delta_varint_encoder<std::int16_t, 2> enc(10);
+  for (auto v : in) {
+    ASSERT_TRUE(enc.encode(v, cb));
+  }
+  EXPECT_TRUE(enc.at_sync_point());
+
+  delta_varint_decoder<std::int16_t, 2> dec(10);
+
+  auto it = dec.seek(cb.begin(), cb.end(), 7);
+  ASSERT_NE(cb.begin(), it);
+  for (std::size_t i = 70; i < 100; ++i) {
+    std::int16_t out{};
+    it = dec.decode(out, it, cb.end());
+    EXPECT_EQ(in[i], out);
+  }
+  EXPECT_EQ(cb.end(), it);
+
+  EXPECT_EQ(cb.begin(), dec.seek(cb.begin(), cb.end(), 11));
+  EXPECT_EQ(cb.end(), dec.seek(cb.begin(), cb.end(), 10));
+
+  // drop the oldest interval, the rest still decodes
+  cb.pop_front(dec.seek(cb.begin(), cb.end(), 1) - cb.begin());
+  std::int16_t out{};
+  EXPECT_NE(cb.begin(), dec.decode(out, cb.begin(), cb.end()));
+  EXPECT_EQ(in[10], out);
+}
@@ -22,6 +22,7 @@
 
 #include <array>
 
+#include "embedded/block_pool.h"
 #include "embedded/function.h"
 #include "embedded/variant.h"
 
@@ -77,6 +78,13 @@ size_t tracer::dtor;
 size_t tracer::move_ctor;
 size_t tracer::move_assign;
 
+struct wide_tracer : tracer {
+  explicit wide_tracer(int val) noexcept
+      : tracer(val) {}
+
+  std::array<void*, 4> padding{};
+};
+
 template <class T>
 struct store {
   T value{};
@@ -107,9 +115,50 @@ TEST(function, basic) {
   EXPECT_EQ(55, doit2(&test::y));
 }
 
+template <typename Signature, size_t Capacity = 3 * sizeof(void*)>
+using inline_function =
+    function<Signature, Capacity, alignof(void*), function_layout::inline_call>;
+
 TEST(function, layout) {
   EXPECT_EQ(4 * sizeof(void*), sizeof(function<int(int)>));
   EXPECT_LE(alignof(int), alignof(function<int(int)>));
+  EXPECT_EQ(5 * sizeof(void*), sizeof(inline_function<int(int)>));
+}
+
+TEST(function, inline_call) {
+  int num = 42;
+  inline_function<int()> counter{[num]() mutable { return num++; }};
+  EXPECT_EQ(42, counter());
+  EXPECT_EQ(43, counter());
+
+  store<int> s;
+  inline_function<int() const> getter = std::ref(s);
+  inline_function<void(int)> setter = std::ref(s);
+  setter(13);
+  EXPECT_EQ(13, getter());
+
+  auto moved = std::move(counter);
+  EXPECT_FALSE(counter);
+  EXPECT_TRUE(moved);
+  EXPECT_EQ(44, moved());
+
+  moved = nullptr;
+  EXPECT_FALSE(moved);
+
+  tracer::reset();
+  {
+    inline_function<int(int), 8 * sizeof(void*)> big{tracer(5)};
+    EXPECT_EQ(47, big(42));
+    auto other = std::move(big);
+    EXPECT_EQ(48, other(43));
+  }
+  EXPECT_EQ(tracer::ctor + tracer::move_ctor, tracer::dtor);
+
+#if LIBEMB_HAS_EXCEPTIONS
+  EXPECT_THROW(moved(), std::bad_function_call);
+#else
+  EXPECT_DEATH(moved(), "terminate");
+#endif
 }
 
 TEST(function, const_fun) {
@@ -156,6 +205,86 @@ TEST(function, moveonly) {
   EXPECT_EQ(1, tracer::dtor);
 }
 
+TEST(function, trivial_move) {
+  int a = 3;
+  int const* pa = &a;
+  auto lambda = [pa](int x) { return *pa * x; };
+  using trivial_vtbl = detail::typed_vtbl<int(int), decltype(lambda)>;
+  using tracer_vtbl = detail::typed_vtbl<int(int), tracer>;
+  static_assert(trivial_vtbl::value.trivial, "trivial");
+  static_assert(!tracer_vtbl::value.trivial, "non-trivial");
+  static_assert(detail::empty_vtbl<int(int)>::value.trivial, "empty");
+
+  function<int(int)> f{lambda};
+  auto g = std::move(f);
+  EXPECT_FALSE(f);
+  EXPECT_EQ(42, g(14));
+  f = std::move(g);
+  a = 4;
+  EXPECT_EQ(56, f(14));
+
+  inline_function<int(int)> h{lambda};
+  auto i = std::move(h);
+  EXPECT_EQ(28, i(7));
+
+  tracer::reset();
+  {
+    function<int(int)> t{tracer(1)};
+    auto u = std::move(t);
+    EXPECT_EQ(2, u(1));
+  }
+  EXPECT_EQ(2, tracer::move_ctor);
+  EXPECT_EQ(3, tracer::dtor);
+}
+
+TEST(function, pool) {
+  struct tag {};
+  using pool = static_block_pool<8 * sizeof(void*), 2, alignof(void*), tag>;
+  using pooled_function =
+      function<int(int), sizeof(void*), alignof(void*),
+               function_layout::compact, pool>;
+
+  EXPECT_EQ(2 * sizeof(void*), sizeof(pooled_function));
+
+  int a = 3;
+  pooled_function small{[&a](int x) { return a * x; }};
+  EXPECT_EQ(42, small(14));
+
+  tracer::reset();
+  {
+    std::array<int, 4> v{{1, 2, 3, 4}};
+    pooled_function big{[v](int x) { return v[0] + v[3] + x; }};
+    EXPECT_EQ(47, big(42));
+
+    pooled_function other{wide_tracer(5)};
+    EXPECT_EQ(1, tracer::move_ctor);
+    EXPECT_EQ(1, tracer::dtor);
+    EXPECT_FALSE(pool::allocate());
+
+    // moves only transfer ownership of the block
+    auto moved = std::move(other);
+    EXPECT_FALSE(other);
+    EXPECT_EQ(48, moved(43));
+    EXPECT_EQ(1, tracer::move_ctor);
+    EXPECT_EQ(1, tracer::dtor);
+
+    big = nullptr;
+    pooled_function again{[v](int x) { return v[1] * x; }};
+    EXPECT_EQ(26, again(13));
+
+    // pool exhausted
+    EXPECT_DEATH(pooled_function([v](int x) { return v[2] + x; }), "");
+  }
+  EXPECT_EQ(tracer::ctor + tracer::move_ctor, tracer::dtor);
+
+  auto p = pool::allocate();
+  auto q = pool::allocate();
+  EXPECT_TRUE(p);
+  EXPECT_TRUE(q);
+  pool::deallocate(p);
+  pool::deallocate(q);
+}
+
 TEST(function, variant) {
   using call1 = function<int(int)>;
   using call2 = function<int(int, int)>;
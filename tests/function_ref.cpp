@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <type_traits>
+
+#include "embedded/function.h"
+#include "embedded/function_ref.h"
+
+#include <gtest/gtest.h>
+
+using namespace embedded;
+
+namespace {
+
+int twice(int x) { return 2 * x; }
+
+struct counter {
+  int count{0};
+  int operator()(int x) { return count += x; }
+};
+
+struct getter {
+  int value;
+  int operator()() const { return value; }
+};
+
+int apply(function_ref<int(int)> f, int x) { return f(x); }
+
+int sum(function_ref<int(int) const> f, int n) {
+  int s = 0;
+  for (int i = 0; i < n; ++i) {
+    s += f(i);
+  }
+  return s;
+}
+
+} // namespace
+
+TEST(function_ref, layout) {
+  EXPECT_EQ(2 * sizeof(void*), sizeof(function_ref<int(int)>));
+  EXPECT_TRUE(std::is_trivially_copyable<function_ref<int(int)>>::value);
+}
+
+TEST(function_ref, lambda) {
+  int const k = 3;
+  EXPECT_EQ(42, apply([k](int x) { return k * x; }, 14));
+  EXPECT_EQ(135, sum([k](int x) { return k * x; }, 10));
+
+  int calls = 0;
+  auto inc = [&calls](int x) {
+    ++calls;
+    return x + 1;
+  };
+  function_ref<int(int)> ref{inc};
+  EXPECT_EQ(2, ref(1));
+  auto copy = ref;
+  EXPECT_EQ(3, copy(2));
+  EXPECT_EQ(2, calls);
+}
+
+TEST(function_ref, free_function) {
+  EXPECT_EQ(28, apply(twice, 14));
+  EXPECT_EQ(28, apply(&twice, 14));
+  EXPECT_EQ(90, sum(twice, 10));
+}
+
+TEST(function_ref, stateful) {
+  counter c;
+  function_ref<int(int)> ref{c};
+  ref(5);
+  ref(7);
+  EXPECT_EQ(12, c.count);
+
+  getter const g{42};
+  function_ref<int() const> get{g};
+  EXPECT_EQ(42, get());
+}
+
+TEST(function_ref, const_correct) {
+  static_assert(std::is_constructible<function_ref<int(int)>, counter&>::value,
+                "non-const");
+  static_assert(
+      !std::is_constructible<function_ref<int(int) const>, counter&>::value,
+      "const");
+  static_assert(
+      std::is_constructible<function_ref<int() const>, getter const&>::value,
+      "const getter");
+  static_assert(!std::is_constructible<function_ref<int(int)>, getter&>::value,
+                "signature");
+}
+
+TEST(function_ref, function) {
+  function<int(int)> fn{[](int x) { return x - 1; }};
+  EXPECT_EQ(13, apply(fn, 14));
+
+  function<int(int) const> cfn{[](int x) { return x + 1; }};
+  EXPECT_EQ(55, sum(cfn, 10));
+  static_assert(!std::is_constructible<function_ref<int(int) const>,
+                                       function<int(int)>&>::value,
+                "const function");
+}
@@ -22,12 +22,30 @@
 
 #include "embedded/utility/integer_sequence.h"
 
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 using namespace embedded;
 
 namespace {
 
+template <typename T, T... Ints>
+std::vector<T> to_vector(integer_sequence<T, Ints...>) {
+  return {Ints...};
+}
+
+template <typename T>
+std::vector<T> iota(T begin, T end) {
+  std::vector<T> v;
+  for (T i = begin; i < end; ++i) {
+    v.push_back(i);
+  }
+  return v;
+}
+
 template <typename T1, T1... Ints1, typename T2, T2... Ints2>
 constexpr bool equal_integer_sequence(integer_sequence<T1, Ints1...>,
                                       integer_sequence<T2, Ints2...>) noexcept {
@@ -55,3 +73,23 @@ TEST(integer_sequence, basic) {
   equal_integer_sequence(make_index_range<2, 4>{},
                          integer_sequence<std::size_t, 2, 3>{});
 }
+
+TEST(integer_sequence, large) {
+  // far beyond the default template depth if built one by one
+  EXPECT_EQ(iota<std::size_t>(0, 4099), to_vector(make_index_sequence<4099>{}));
+  EXPECT_EQ(iota<int>(-100, 3000),
+            to_vector(make_integer_range<int, -100, 3000>{}));
+  EXPECT_EQ(iota<unsigned char>(0, 255),
+            to_vector(make_integer_sequence<unsigned char, 255>{}));
+
+  for (auto const& v : {to_vector(make_index_sequence<0>{}),
+                        to_vector(make_index_sequence<1>{}),
+                        to_vector(make_index_sequence<2>{}),
+                        to_vector(make_index_sequence<7>{}),
+                        to_vector(make_index_sequence<64>{}),
+                        to_vector(make_index_sequence<65>{})}) {
+    EXPECT_EQ(iota<std::size_t>(0, v.size()), v);
+  }
+
+  static_assert(index_sequence_for<int, char, long>::size() == 3, "");
+}
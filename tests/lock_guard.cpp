@@ -22,6 +22,10 @@
 
 #include "embedded/mutex.h"
 
+#include <cstdint>
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 namespace {
@@ -33,6 +37,70 @@ struct MutexMock {
   int lock_level{0};
 };
 
+// Simulates a mask register with one bit per priority level
+struct mask_policy {
+  using state_type = std::uint32_t;
+
+  static state_type save_and_mask() {
+    auto const state = mask;
+    mask |= level;
+    return state;
+  }
+
+  static void restore(state_type state) { mask = state; }
+
+  static std::uint32_t level;
+  static std::uint32_t mask;
+};
+
+std::uint32_t mask_policy::level = 0;
+std::uint32_t mask_policy::mask = 0;
+
+template <typename Mutex>
+void test_contention() {
+  // Spinning on a single core only makes progress when the scheduler
+  // preempts the waiter, so keep the number of iterations low there.
+  bool const multicore = std::thread::hardware_concurrency() > 1;
+  int const num_threads = multicore ? 4 : 2;
+  int const iterations = multicore ? 20000 : 50;
+
+  Mutex mx;
+  int counter = 0;
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < iterations; ++i) {
+        embedded::lock_guard<Mutex> lock(mx);
+        ++counter;
+      }
+    });
+  }
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  EXPECT_EQ(num_threads * iterations, counter);
+}
+
+template <typename Mutex>
+void test_try_lock() {
+  Mutex mx;
+
+  ASSERT_TRUE(mx.try_lock());
+  EXPECT_FALSE(mx.try_lock());
+  mx.unlock();
+
+  {
+    embedded::lock_guard<Mutex> lock(mx);
+    EXPECT_FALSE(mx.try_lock());
+  }
+
+  EXPECT_TRUE(mx.try_lock());
+  mx.unlock();
+}
+
 } // namespace
 
 TEST(lock_guard, basic) {
@@ -47,3 +115,57 @@ TEST(lock_guard, basic) {
 
   EXPECT_EQ(0, mx.lock_level);
 }
+
+TEST(lock_guard, null_mutex) {
+  embedded::null_mutex mx;
+  embedded::lock_guard<embedded::null_mutex> lock(mx);
+  EXPECT_TRUE(mx.try_lock());
+}
+
+TEST(lock_guard, interrupt_mutex) {
+  using mutex = embedded::basic_interrupt_mutex<mask_policy>;
+  mutex a;
+  mutex b;
+
+  mask_policy::level = 1;
+  mask_policy::mask = 0;
+
+  {
+    embedded::lock_guard<mutex> l1(a);
+    EXPECT_EQ(1, mask_policy::mask);
+
+    {
+      // nested locks of the same instance must not unmask early
+      embedded::lock_guard<mutex> l2(a);
+      embedded::lock_guard<mutex> l3(b);
+      EXPECT_EQ(1, mask_policy::mask);
+    }
+
+    EXPECT_EQ(1, mask_policy::mask);
+  }
+
+  EXPECT_EQ(0, mask_policy::mask);
+
+  // masking state from before the outermost lock is kept
+  mask_policy::mask = 4;
+  mask_policy::level = 2;
+
+  {
+    embedded::lock_guard<mutex> l1(a);
+    EXPECT_EQ(6, mask_policy::mask);
+    embedded::lock_guard<mutex> l2(a);
+    EXPECT_EQ(6, mask_policy::mask);
+  }
+
+  EXPECT_EQ(4, mask_policy::mask);
+}
+
+TEST(lock_guard, spin_mutex) {
+  test_try_lock<embedded::spin_mutex>();
+  test_contention<embedded::spin_mutex>();
+}
+
+TEST(lock_guard, ticket_mutex) {
+  test_try_lock<embedded::ticket_mutex>();
+  test_contention<embedded::ticket_mutex>();
+}
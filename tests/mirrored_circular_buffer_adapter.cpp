@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "embedded/mirrored_circular_buffer_adapter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace embedded;
+
+TEST(mirrored_circular_buffer_adapter, basic) {
+  int raw[2 * 4];
+  mirrored_circular_buffer_adapter<int> cb(raw, 4);
+
+  EXPECT_EQ(4, cb.capacity());
+  EXPECT_TRUE(cb.empty());
+
+  for (int i = 0; i < 4; ++i) {
+    cb.push_back(i);
+  }
+
+  EXPECT_TRUE(cb.full());
+  EXPECT_EQ(0, cb.front());
+  EXPECT_EQ(3, cb.back());
+
+  // slide over the end of the memory several times, the window always
+  // stays contiguous
+  for (int i = 4; i < 20; ++i) {
+    cb.push_back_overwrite(i);
+    EXPECT_EQ(4, cb.size());
+    for (int k = 0; k < 4; ++k) {
+      EXPECT_EQ(i - 3 + k, cb.data()[k]);
+    }
+    EXPECT_EQ(i - 1, cb.window(2)[0]);
+    EXPECT_EQ(i, cb.window(2)[1]);
+  }
+
+  cb.pop_front(3);
+  EXPECT_EQ(1, cb.size());
+  EXPECT_EQ(19, cb.front());
+
+  cb.clear();
+  EXPECT_TRUE(cb.empty());
+}
+
+TEST(mirrored_circular_buffer_adapter, bulk) {
+  std::vector<std::int16_t> raw(2 * 7);
+  mirrored_circular_buffer_adapter<std::int16_t> cb(raw.data(), 7);
+  std::deque<std::int16_t> ref;
+
+  std::vector<std::int16_t> in(20);
+  std::iota(in.begin(), in.end(), 1);
+
+  std::int16_t next = 0;
+  for (std::size_t count : {3, 5, 7, 1, 12, 0, 6, 20, 4}) {
+    count = std::min<std::size_t>(count, in.size());
+    for (std::size_t i = 0; i < count; ++i) {
+      in[i] = next++;
+      ref.push_back(in[i]);
+    }
+    while (ref.size() > cb.capacity()) {
+      ref.pop_front();
+    }
+
+    cb.copy_in_back_overwrite(in.data(), count);
+
+    ASSERT_EQ(ref.size(), cb.size());
+    EXPECT_TRUE(std::equal(ref.begin(), ref.end(), cb.data()));
+
+    if (cb.size() > 2) {
+      std::int16_t out[2];
+      cb.copy_out_front(out, 2);
+      EXPECT_EQ(ref[0], out[0]);
+      EXPECT_EQ(ref[1], out[1]);
+      ref.erase(ref.begin(), ref.begin() + 2);
+    }
+
+    auto const room = cb.remaining();
+    for (std::size_t i = 0; i < room; ++i) {
+      in[i] = next++;
+      ref.push_back(in[i]);
+    }
+    cb.copy_in_back(in.data(), room);
+
+    EXPECT_TRUE(cb.full());
+    EXPECT_TRUE(std::equal(ref.begin(), ref.end(), cb.data()));
+  }
+}
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "embedded/persistent_circular_buffer.h"
+
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace embedded;
+
+namespace {
+
+// memory_storage that counts page programs
+class counting_storage : public memory_storage<32> {
+ public:
+  counting_storage(std::vector<unsigned char>& mem, int& programs)
+      : memory_storage<32>(mem.data(), mem.size())
+      , programs_{&programs} {}
+
+  void program(std::size_t offset, void const* data, std::size_t count) {
+    ++*programs_;
+    memory_storage<32>::program(offset, data, count);
+  }
+
+ private:
+  int* programs_;
+};
+
+using pcb = persistent_circular_buffer<std::uint32_t, counting_storage>;
+
+struct nvm {
+  std::vector<unsigned char> data = std::vector<unsigned char>(4 * 32, 0xFF);
+  std::vector<unsigned char> journal = std::vector<unsigned char>(64, 0xFF);
+  int data_programs = 0;
+  int journal_programs = 0;
+
+  counting_storage data_storage() {
+    return counting_storage(data, data_programs);
+  }
+
+  counting_storage journal_storage() {
+    return counting_storage(journal, journal_programs);
+  }
+};
+
+} // namespace
+
+TEST(persistent_circular_buffer, empty_at_first_boot) {
+  nvm mem;
+  pcb cb(mem.data_storage(), mem.journal_storage());
+
+  EXPECT_EQ(32, cb.capacity());
+  EXPECT_TRUE(cb.empty());
+  EXPECT_FALSE(cb.dirty());
+  EXPECT_EQ(0, mem.data_programs);
+  EXPECT_EQ(0, mem.journal_programs);
+}
+
+TEST(persistent_circular_buffer, page_batching) {
+  nvm mem;
+  pcb cb(mem.data_storage(), mem.journal_storage());
+
+  // 8 items per page, the first page is programmed once it's complete
+  for (std::uint32_t i = 0; i < 7; ++i) {
+    cb.push_back(i);
+  }
+  EXPECT_EQ(0, mem.data_programs);
+  EXPECT_EQ(7, cb.size());
+  EXPECT_EQ(0, cb.front());
+  EXPECT_EQ(6, cb.back());
+  cb.push_back(7);
+  EXPECT_EQ(1, mem.data_programs);
+
+  cb.push_back(8);
+  EXPECT_EQ(1, mem.data_programs);
+  EXPECT_TRUE(cb.dirty());
+
+  cb.flush();
+  EXPECT_EQ(2, mem.data_programs);
+  EXPECT_EQ(1, mem.journal_programs);
+  EXPECT_FALSE(cb.dirty());
+
+  // nothing to do
+  cb.flush();
+  EXPECT_EQ(2, mem.data_programs);
+  EXPECT_EQ(1, mem.journal_programs);
+
+  // removing items only touches the journal
+  cb.pop_front(3);
+  cb.flush();
+  EXPECT_EQ(2, mem.data_programs);
+  EXPECT_EQ(2, mem.journal_programs);
+}
+
+TEST(persistent_circular_buffer, bulk) {
+  nvm mem;
+  pcb cb(mem.data_storage(), mem.journal_storage());
+
+  std::vector<std::uint32_t> in(40);
+  std::iota(in.begin(), in.end(), 100);
+
+  cb.copy_in_back(in.data(), 5);
+  cb.pop_front(5);
+  cb.flush();
+  mem.data_programs = 0;
+
+  // fills the rest of page 0, pages 1-3 and wraps into page 0 again
+  cb.copy_in_back(in.data(), 30);
+  EXPECT_EQ(30, cb.size());
+  EXPECT_EQ(4, mem.data_programs);
+
+  std::vector<std::uint32_t> out(30);
+  cb.copy_out_front(out.data(), 30);
+  EXPECT_TRUE(std::equal(out.begin(), out.end(), in.begin()));
+  EXPECT_TRUE(cb.empty());
+}
+
+TEST(persistent_circular_buffer, restore) {
+  nvm mem;
+
+  {
+    pcb cb(mem.data_storage(), mem.journal_storage());
+    for (std::uint32_t i = 0; i < 20; ++i) {
+      cb.push_back(i);
+    }
+    cb.pop_front(2);
+    cb.flush();
+
+    // not flushed, lost on the next boot
+    cb.push_back(20);
+    cb.pop_front();
+  }
+
+  {
+    pcb cb(mem.data_storage(), mem.journal_storage());
+    EXPECT_EQ(2, cb.first_index());
+    EXPECT_EQ(18, cb.size());
+    for (std::uint32_t i = 0; i < 18; ++i) {
+      EXPECT_EQ(i + 2, cb[i]);
+    }
+
+    // wrap around the data and the journal several times
+    for (std::uint32_t i = 20; i < 200; ++i) {
+      cb.pop_front();
+      cb.push_back(i);
+      cb.flush();
+    }
+  }
+
+  {
+    pcb cb(mem.data_storage(), mem.journal_storage());
+    EXPECT_EQ(18, cb.size());
+    EXPECT_EQ(182, cb.front());
+    EXPECT_EQ(199, cb.back());
+  }
+}
+
+TEST(persistent_circular_buffer, popped_slots_not_reused) {
+  nvm mem;
+
+  {
+    pcb cb(mem.data_storage(), mem.journal_storage());
+    for (std::uint32_t i = 0; i < 24; ++i) {
+      cb.push_back(i);
+    }
+    cb.flush();
+
+    // the journal still refers to the popped items
+    cb.pop_front(8);
+    EXPECT_EQ(8, cb.remaining());
+    for (std::uint32_t i = 24; i < 32; ++i) {
+      cb.push_back(i);
+    }
+    EXPECT_TRUE(cb.full());
+    EXPECT_EQ(24, cb.size());
+  }
+
+  {
+    // power failed before the pop was flushed
+    pcb cb(mem.data_storage(), mem.journal_storage());
+    EXPECT_EQ(24, cb.size());
+    for (std::uint32_t i = 0; i < 24; ++i) {
+      EXPECT_EQ(i, cb[i]);
+    }
+
+    cb.pop_front(8);
+    cb.flush();
+    EXPECT_EQ(16, cb.remaining());
+    for (std::uint32_t i = 24; i < 40; ++i) {
+      cb.push_back(i);
+    }
+    EXPECT_TRUE(cb.full());
+    EXPECT_EQ(8, cb.front());
+    EXPECT_EQ(39, cb.back());
+  }
+}
+
+TEST(persistent_circular_buffer, torn_journal_record) {
+  nvm mem;
+
+  {
+    pcb cb(mem.data_storage(), mem.journal_storage());
+    cb.push_back(1);
+    cb.flush();
+    cb.push_back(2);
+    cb.flush();
+  }
+
+  // power failed while writing the second record
+  mem.journal[16 + 5] ^= 0x40;
+
+  pcb cb(mem.data_storage(), mem.journal_storage());
+  EXPECT_EQ(1, cb.size());
+  EXPECT_EQ(1, cb.front());
+
+  // the corrupt slot is reused
+  cb.push_back(3);
+  cb.flush();
+  EXPECT_EQ(3, mem.journal_programs);
+
+  pcb cb2(mem.data_storage(), mem.journal_storage());
+  EXPECT_EQ(2, cb2.size());
+  EXPECT_EQ(3, cb2.back());
+}
@@ -20,10 +20,26 @@
  * DEALINGS IN THE SOFTWARE.
  */
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <cstdint>
 #include <limits>
+#include <thread>
+#include <vector>
 
+#include "embedded/signal/bessel.h"
 #include "embedded/signal/butterworth.h"
+#include "embedded/signal/chebyshev.h"
+#include "embedded/signal/debug_filter_coefs.h"
+#include "embedded/signal/denormal.h"
+#include "embedded/signal/elliptic.h"
 #include "embedded/signal/filter.h"
+#include "embedded/signal/fixed_point.h"
+#include "embedded/signal/order.h"
+#include "embedded/signal/placement.h"
 
 #include <gtest/gtest.h>
 
@@ -75,6 +91,347 @@ TEST(signal, butterworth) {
   }
 }
 
+namespace {
+
+template <std::size_t Order>
+void test_bessel_poles() {
+  constexpr auto p = bessel<Order>().template spec<double>().poles();
+  double prod_abs = 1.0;
+  for (std::size_t i = 0; i < Order; ++i) {
+    EXPECT_LT(p[i].real(), 0.0) << Order << ": " << i;
+    EXPECT_EQ(p[i], p[Order - 1 - i].conj()) << Order << ": " << i;
+    prod_abs *= p[i].abs();
+  }
+  // phase normalization
+  EXPECT_NEAR(1.0, prod_abs, 1e-13) << Order;
+}
+
+} // namespace
+
+TEST(signal, bessel) {
+  {
+    constexpr auto p = bessel<2>().spec<double>().poles();
+    static_assert(almost_equal(p[0].real(), -0.8660254037844386), "real");
+    static_assert(almost_equal(p[0].imag(), 0.5), "imag");
+    static_assert(p[1] == p[0].conj(), "conj");
+  }
+
+  {
+    constexpr auto p = bessel<3>().spec<double>().poles();
+    static_assert(almost_equal(p[0].real(), -0.7456403858480765), "real");
+    static_assert(almost_equal(p[0].imag(), 0.7113666249728352), "imag");
+    static_assert(almost_equal(p[1].real(), -0.9416000265332067), "real");
+    static_assert(p[1].imag() == 0.0, "imag");
+  }
+
+  {
+    constexpr auto p = bessel<7>().spec<float>().poles();
+    static_assert(p[3].imag() == 0.0f, "real pole");
+    static_assert(almost_equal(p[3].real(), -0.91948716f), "real");
+  }
+
+  test_bessel_poles<1>();
+  test_bessel_poles<4>();
+  test_bessel_poles<11>();
+  test_bessel_poles<16>();
+}
+
+namespace {
+
+template <std::size_t Order>
+void test_elliptic(double rp, double rs) {
+  auto const spec = elliptic<Order>(rp, rs).template spec<double>();
+  auto const z = spec.zeros();
+  auto const p = spec.poles();
+  auto const db = [&](double w) {
+    std::complex<double> h{spec.gain()};
+    for (std::size_t i = 0; i < z.size(); ++i) {
+      h *= std::complex<double>(-z[i].real(), w - z[i].imag());
+    }
+    for (std::size_t i = 0; i < p.size(); ++i) {
+      h /= std::complex<double>(-p[i].real(), w - p[i].imag());
+    }
+    return 20.0 * std::log10(std::abs(h));
+  };
+
+  EXPECT_NEAR(Order % 2 == 0 ? -rp : 0.0, db(0.0), 1e-9) << Order;
+  EXPECT_NEAR(-rp, db(1.0), 1e-9) << Order;
+  for (double w = 0.0; w < 1.0; w += 1e-3) {
+    EXPECT_LT(db(w), 1e-9) << Order << ": " << w;
+    EXPECT_GT(db(w), -rp - 1e-9) << Order << ": " << w;
+  }
+  for (double w = spec.stopband(); w < 1e3; w *= 1.001) {
+    EXPECT_LT(db(w), -rs + 1e-6) << Order << ": " << w;
+  }
+}
+
+} // namespace
+
+TEST(signal, elliptic) {
+  test_elliptic<1>(1.0, 40.0);
+  test_elliptic<2>(1.0, 40.0);
+  test_elliptic<3>(0.5, 60.0);
+  test_elliptic<4>(0.1, 80.0);
+  test_elliptic<7>(1.0, 60.0);
+  test_elliptic<10>(0.5, 100.0);
+
+  {
+    constexpr auto zpk = elliptic<5>(1.0, 40.0).spec<double>().zpk();
+    static_assert(zpk.zeros().size() == 4, "zeros");
+    static_assert(zpk.poles().size() == 5, "poles");
+    static_assert(zpk.poles()[0].imag() == 0.0, "real pole");
+    static_assert(zpk.zeros()[0].real() == 0.0, "imaginary zero");
+    static_assert(zpk.zeros()[2] == zpk.zeros()[0].conj(), "conj");
+  }
+
+  {
+    constexpr auto lp =
+        iirfilter<double>(1000.0).lowpass(elliptic<6>(0.5, 60.0), 100.0);
+    constexpr auto sos = lp.sos<double>();
+    static_assert(sos.size() == 3, "size");
+    std::complex<double> dc{1.0}, edge{1.0};
+    auto const z1 = std::polar(1.0, -2.0 * cmath::pi<double>() * 0.1);
+    for (std::size_t i = 0; i < sos.size(); ++i) {
+      auto const b = sos.sos()[i].b();
+      auto const a = sos.sos()[i].a();
+      dc *= (b[0] + b[1] + b[2]) / (a[0] + a[1] + a[2]);
+      edge *=
+          (b[0] + z1 * (b[1] + z1 * b[2])) / (a[0] + z1 * (a[1] + z1 * a[2]));
+    }
+    EXPECT_NEAR(-0.5, 20.0 * std::log10(std::abs(dc)), 1e-9);
+    EXPECT_NEAR(-0.5, 20.0 * std::log10(std::abs(edge)), 1e-9);
+  }
+
+  {
+    constexpr auto hp =
+        iirfilter<float>(1000.0f).highpass(elliptic<5>(1.0f, 40.0f), 100.0f);
+    constexpr auto hp_sos = hp.sos<float>();
+    auto inst = hp_sos.instance();
+    float y = 0.0f;
+    for (int i = 0; i < 2000; ++i) {
+      y = inst(1.0f);
+    }
+    EXPECT_NEAR(0.0f, y, 1e-4f);
+  }
+}
+
+namespace {
+
+struct lowpass_mask {
+  static constexpr double fs = 1000.0;
+  static constexpr double fpass = 100.0;
+  static constexpr double fstop = 150.0;
+  static constexpr double gpass = 1.0;
+  static constexpr double gstop = 40.0;
+};
+
+struct highpass_mask {
+  static constexpr double fs = 1000.0;
+  static constexpr double fpass = 150.0;
+  static constexpr double fstop = 100.0;
+  static constexpr double gpass = 0.5;
+  static constexpr double gstop = 60.0;
+};
+
+template <typename Design>
+double response_db(Design const& design, double f, double fs) {
+  auto const z1 = std::polar(1.0, -2.0 * cmath::pi<double>() * f / fs);
+  std::complex<double> h{1.0};
+  for (std::size_t i = 0; i < design.size(); ++i) {
+    auto const b = design.sos()[i].b();
+    auto const a = design.sos()[i].a();
+    h *= (b[0] + z1 * (b[1] + z1 * b[2])) / (a[0] + z1 * (a[1] + z1 * a[2]));
+  }
+  return 20.0 * std::log10(std::abs(h));
+}
+
+template <typename Mask, typename Design>
+void test_minimum_order(Design const& design) {
+  auto const sos = design.template sos<double>();
+  double const fs = Mask::fs;
+  double const fpass = Mask::fpass;
+  double const fstop = Mask::fstop;
+  EXPECT_GT(response_db(sos, fpass, fs), -Mask::gpass - 1e-6);
+  EXPECT_LT(response_db(sos, fstop, fs), -Mask::gstop + 1e-6);
+}
+
+} // namespace
+
+TEST(signal, minimum_order) {
+  {
+    constexpr auto b = buttord(1000.0, 100.0, 150.0, 1.0, 40.0);
+    static_assert(b.order == 12, "order");
+    static_assert(almost_equal(b.frequency, 105.38763656811084, 1e3), "wn");
+
+    constexpr auto c1 = cheb1ord(1000.0, 100.0, 150.0, 1.0, 40.0);
+    static_assert(c1.order == 6, "order");
+    static_assert(c1.frequency == 100.0, "wn");
+
+    constexpr auto c2 = cheb2ord(1000.0, 100.0, 150.0, 1.0, 40.0);
+    static_assert(c2.order == 6, "order");
+    static_assert(almost_equal(c2.frequency, 147.51205530530723, 1e3), "wn");
+
+    constexpr auto e = ellipord(1000.0, 100.0, 150.0, 1.0, 40.0);
+    static_assert(e.order == 4, "order");
+    static_assert(e.frequency == 100.0, "wn");
+  }
+
+  {
+    constexpr auto b = buttord(1000.0, 150.0, 100.0, 0.5, 60.0);
+    static_assert(b.order == 18, "order");
+    static_assert(almost_equal(b.frequency, 142.60666242468696, 1e3), "wn");
+
+    constexpr auto c2 = cheb2ord(1000.0, 150.0, 100.0, 0.5, 60.0);
+    static_assert(c2.order == 9, "order");
+    static_assert(almost_equal(c2.frequency, 104.30534321652881, 1e3), "wn");
+
+    static_assert(ellipord(1000.0, 150.0, 100.0, 0.5, 60.0).order == 6,
+                  "order");
+  }
+
+  {
+    constexpr auto lp =
+        iirfilter<double>::lowpass_spec<family::elliptic, lowpass_mask>();
+    static_assert(lp.sos<double>().size() == 2, "cascade length");
+    constexpr auto hp =
+        iirfilter<float>::highpass_spec<family::chebyshev2, highpass_mask>();
+    static_assert(hp.sos<float>().size() == 5, "cascade length");
+  }
+
+  using iir = iirfilter<double>;
+  test_minimum_order<lowpass_mask>(
+      iir::lowpass_spec<family::butterworth, lowpass_mask>());
+  test_minimum_order<lowpass_mask>(
+      iir::lowpass_spec<family::chebyshev1, lowpass_mask>());
+  test_minimum_order<lowpass_mask>(
+      iir::lowpass_spec<family::chebyshev2, lowpass_mask>());
+  test_minimum_order<lowpass_mask>(
+      iir::lowpass_spec<family::elliptic, lowpass_mask>());
+  test_minimum_order<highpass_mask>(
+      iir::highpass_spec<family::butterworth, highpass_mask>());
+  test_minimum_order<highpass_mask>(
+      iir::highpass_spec<family::chebyshev1, highpass_mask>());
+  test_minimum_order<highpass_mask>(
+      iir::highpass_spec<family::chebyshev2, highpass_mask>());
+  test_minimum_order<highpass_mask>(
+      iir::highpass_spec<family::elliptic, highpass_mask>());
+}
+
+namespace {
+
+template <typename Instance>
+bool has_subnormal_state(Instance const& inst) {
+  auto const& state = inst.state();
+  auto const* p = reinterpret_cast<float const*>(state.data());
+  for (std::size_t i = 0; i < sizeof(state) / sizeof(float); ++i) {
+    if (std::fpclassify(p[i]) == FP_SUBNORMAL) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename Structure>
+void test_denormal_safe() {
+  constexpr auto base =
+      iirfilter<double>(1000.0).lowpass(butterworth<7>(), 20.0);
+  auto const plain = base.template sos<float, Structure>();
+  auto const design =
+      base.template sos<float, sos_structure::denormal_safe<Structure>>();
+  auto ref = plain.instance();
+  auto inst = design.instance();
+  auto block = design.instance();
+  bool subnormal = false;
+  for (std::size_t i = 0; i < 50000; ++i) {
+    float const x = i < 200 ? std::sin(0.1f * static_cast<float>(i)) : 0.0f;
+    float const y = inst(x);
+    float yb;
+    block.process(&x, &yb, 1);
+    EXPECT_NEAR(ref(x), y, 1e-6f) << i;
+    EXPECT_EQ(y, yb) << i;
+    subnormal = subnormal || has_subnormal_state(inst);
+  }
+  EXPECT_FALSE(subnormal);
+  EXPECT_TRUE(has_subnormal_state(ref));
+}
+
+} // namespace
+
+TEST(signal, denormal_safe) {
+  test_denormal_safe<sos_structure::df2t>();
+  test_denormal_safe<sos_structure::df1>();
+  test_denormal_safe<sos_structure::tdf1>();
+  test_denormal_safe<sos_structure::coupled>();
+
+  if (denormal_guard::supported) {
+    volatile float tiny = std::numeric_limits<float>::min();
+    EXPECT_NE(0.0f, tiny / 4.0f);
+    {
+      denormal_guard guard;
+      EXPECT_EQ(0.0f, tiny / 4.0f);
+    }
+    EXPECT_NE(0.0f, tiny / 4.0f);
+  }
+}
+
+TEST(signal, instrumentation) {
+  constexpr auto design = iirfilter<double>(1000.0)
+                              .lowpass(chebyshev1<6>(1.0), 100.0)
+                              .sos<double, sos_structure::df1>();
+
+  using plain_type = decltype(design.instance());
+  static_assert(sizeof(plain_type) ==
+                    sizeof(void*) + sizeof(plain_type::state_type) * 3,
+                "no overhead without instrumentation");
+
+  auto ref = design.instance();
+  auto inst = design.instance<sos_instrumentation::statistics>();
+  auto block = design.instance<sos_instrumentation::statistics>();
+  inst.set_saturation_limit(1.0);
+  block.set_saturation_limit(1.0);
+  EXPECT_EQ(1.0, inst.saturation_limit());
+
+  std::array<double, 300> in, out;
+  std::array<double, 3> peak{};
+  std::array<std::uint32_t, 3> saturations{};
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    in[i] = i < 100 ? 1.0 : 0.0;
+    EXPECT_EQ(ref(in[i]), inst(in[i])) << i;
+    for (std::size_t k = 0; k < 3; ++k) {
+      auto const& s = inst.state()[k];
+      double const p = std::max({std::abs(s.x1), std::abs(s.x2),
+                                 std::abs(s.y1), std::abs(s.y2)});
+      peak[k] = std::max(peak[k], p);
+      saturations[k] += p >= 1.0 ? 1 : 0;
+    }
+  }
+
+  block.process(in.data(), out.data(), 123);
+  block.process(in.data() + 123, out.data() + 123, in.size() - 123);
+
+  for (std::size_t k = 0; k < 3; ++k) {
+    EXPECT_EQ(peak[k], inst.statistics()[k].peak) << k;
+    EXPECT_EQ(saturations[k], inst.statistics()[k].saturations) << k;
+    EXPECT_EQ(peak[k], block.statistics()[k].peak) << k;
+    EXPECT_EQ(saturations[k], block.statistics()[k].saturations) << k;
+  }
+
+  // the input step alone reaches the limit in the first section
+  EXPECT_GE(inst.statistics()[0].saturations, 100u);
+  // the overshoot of the Chebyshev filter exceeds 1 at the output
+  EXPECT_GT(inst.statistics()[2].peak, 1.0);
+
+  inst.reset_statistics();
+  EXPECT_EQ(0.0, inst.statistics()[0].peak);
+  EXPECT_EQ(0u, inst.statistics()[0].saturations);
+
+  // the default limit is far away for floating point types
+  constexpr auto fd =
+      iirfilter<double>(1000.0).lowpass(butterworth<4>(), 100.0).sos<float>();
+  auto fi = fd.instance<sos_instrumentation::statistics>();
+  EXPECT_EQ(std::numeric_limits<float>::max() / 2, fi.saturation_limit());
+}
+
 TEST(signal, zpk) {
   constexpr auto zpk = butterworth<2>().spec<double>().zpk();
   static_assert(zpk.poles().size() == 2, "poles");
@@ -86,7 +443,7 @@ TEST(signal, zpk) {
   constexpr double wn = 2.0 * 100.0 / 1000.0;
   constexpr double fs = 2.0;
   constexpr double expected = 0.9190116821894447;
-  constexpr double warped_f = detail::warp_frequency(wn, fs);
+  constexpr double warped_f = signal::detail::warp_frequency(wn, fs);
   constexpr auto zpk_lp = lowpass_zpk(zpk, warped_f);
   static_assert(almost_equal(warped_f, 1.2996787849316251), "warp");
   static_assert(zpk_lp.poles().size() == 2, "poles");
@@ -133,3 +490,605 @@ TEST(signal, filter) {
   static_assert(almost_equal(lp.a()[1], -1.1429805025399011), "a[1]");
   static_assert(almost_equal(lp.a()[2], 0.41280159809618866), "a[2]");
 }
+
+TEST(signal, cascade) {
+  constexpr auto iir = iirfilter<double>(1000.0);
+  constexpr auto hp = iir.highpass(butterworth<3>(), 20.0);
+  constexpr auto lp = iir.lowpass(butterworth<4>(), 200.0);
+  constexpr auto band = hp.cascade(lp);
+
+  constexpr auto fused = band.sos<double>();
+  constexpr auto hp_sos = hp.sos<double>();
+  constexpr auto lp_sos = lp.sos<double>();
+
+  static_assert(band.zpk().zeros().size() == 7, "zeros");
+  static_assert(band.zpk().poles().size() == 7, "poles");
+  static_assert(fused.size() == 4, "sections");
+
+  auto fi = fused.instance();
+  auto hi = hp_sos.instance();
+  auto li = lp_sos.instance();
+  constexpr auto band_poly = band.poly<double>();
+  auto pi = band_poly.instance();
+
+  for (std::size_t i = 0; i < 300; ++i) {
+    double const x = static_cast<double>((i * 7919) % 17) - 8.0;
+    double const y = li(hi(x));
+    EXPECT_NEAR(y, fi(x), 1e-12) << i;
+    EXPECT_NEAR(y, pi(x), 1e-9) << i;
+  }
+}
+
+namespace {
+
+template <typename D>
+void test_scaling(D const& design, bool linf) {
+  auto const ref = design.template sos<double>();
+  auto const scaled =
+      design.template sos<double>(linf ? sos_gain::linf : sos_gain::l2);
+
+  // same overall response
+  auto ri = ref.instance();
+  auto si = scaled.instance();
+  for (std::size_t i = 0; i < 200; ++i) {
+    double const x = i == 0 ? 1.0 : 0.0;
+    EXPECT_NEAR(ri(x), si(x), 1e-12) << i;
+  }
+
+  // unit norm at the output of all but the last section
+  for (std::size_t k = 0; k + 1 < scaled.size(); ++k) {
+    double norm = 0.0;
+    if (linf) {
+      for (double w = 0.0; w <= cmath::pi<double>(); w += 1e-4) {
+        std::complex<double> h{1.0};
+        std::complex<double> const z1 = std::polar(1.0, -w);
+        for (std::size_t i = 0; i <= k; ++i) {
+          auto const b = scaled.sos()[i].b();
+          auto const a = scaled.sos()[i].a();
+          h *= (b[0] + z1 * (b[1] + z1 * b[2])) /
+               (a[0] + z1 * (a[1] + z1 * a[2]));
+        }
+        norm = std::max(norm, std::abs(h));
+      }
+    } else {
+      std::vector<sos_state<double>> state(k + 1);
+      for (std::size_t n = 0; n < 20000; ++n) {
+        double y = n == 0 ? 1.0 : 0.0;
+        for (std::size_t i = 0; i <= k; ++i) {
+          y = scaled.sos()[i].filter(state[i], y);
+        }
+        norm += y * y;
+      }
+      norm = std::sqrt(norm);
+    }
+    EXPECT_NEAR(1.0, norm, 2e-3) << k;
+  }
+}
+
+} // namespace
+
+TEST(signal, gain_scaling) {
+  constexpr auto iir = iirfilter<double>(1000.0);
+  constexpr auto lp = iir.lowpass(chebyshev1<8>(1.0), 100.0);
+  constexpr auto hp = iir.highpass(butterworth<7>(), 30.0);
+
+  test_scaling(lp, true);
+  test_scaling(lp, false);
+  test_scaling(hp, true);
+  test_scaling(hp, false);
+
+  constexpr auto l2 = lp.sos<double>(sos_gain::l2);
+  constexpr auto linf = lp.sos<double>(sos_gain::linf);
+
+  // poles closest to the unit circle first for l2, last for linf
+  static_assert(l2.sos()[0].a()[2] > l2.sos()[3].a()[2], "l2 order");
+  static_assert(linf.sos()[0].a()[2] < linf.sos()[3].a()[2], "linf order");
+}
+
+TEST(signal, block_processing) {
+  constexpr auto base =
+      iirfilter<double>(1000.0).lowpass(butterworth<7>(), 100.0);
+  constexpr auto sos = base.sos<double>();
+  constexpr auto poly = base.poly<double>();
+
+  std::array<double, 100> in;
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    in[i] = static_cast<double>((i * 7919) % 17) - 8.0;
+  }
+
+  auto sos_ref = sos.instance();
+  auto poly_ref = poly.instance();
+  std::array<double, 100> sos_expected, poly_expected;
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    sos_expected[i] = sos_ref(in[i]);
+    poly_expected[i] = poly_ref(in[i]);
+  }
+
+  // process in uneven chunks to make sure state carries over
+  auto sos_block = sos.instance();
+  auto poly_block = poly.instance();
+  std::array<double, 100> sos_out, poly_out;
+  sos_block.process(in.data(), sos_out.data(), 37);
+  sos_block.process(in.data() + 37, sos_out.data() + 37, 63);
+  poly_block.process(in.data(), poly_out.data(), 1);
+  poly_block.process(in.data() + 1, poly_out.data() + 1, 99);
+
+  // in-place
+  auto sos_inplace = sos.instance();
+  auto poly_inplace = poly.instance();
+  std::array<double, 100> sos_data = in, poly_data = in;
+  sos_inplace.process(sos_data.data(), sos_data.size());
+  poly_inplace.process(poly_data.data(), poly_data.size());
+
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    EXPECT_DOUBLE_EQ(sos_expected[i], sos_out[i]) << i;
+    EXPECT_DOUBLE_EQ(sos_expected[i], sos_data[i]) << i;
+    EXPECT_DOUBLE_EQ(poly_expected[i], poly_out[i]) << i;
+    EXPECT_DOUBLE_EQ(poly_expected[i], poly_data[i]) << i;
+  }
+
+  EXPECT_DOUBLE_EQ(sos_ref.state()[3].y1, sos_block.state()[3].y1);
+  EXPECT_DOUBLE_EQ(sos_ref.state()[3].y2, sos_block.state()[3].y2);
+}
+
+namespace {
+
+template <typename F, std::size_t Channels>
+void test_multichannel() {
+  constexpr auto design =
+      iirfilter<double>(1000.0).highpass(butterworth<5>(), 50.0).sos<F>();
+  constexpr std::size_t frames = 64;
+
+  std::array<F, frames * Channels> in;
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    in[i] = static_cast<F>((i * 7919) % 23) - F{11};
+  }
+
+  std::vector<decltype(design.instance())> ref(Channels, design.instance());
+
+  auto mc = design.template multichannel_instance<Channels>();
+  static_assert(mc.channels() == Channels, "channels");
+
+  std::array<F, frames * Channels> out;
+  mc.process(in.data(), out.data(), 10);
+  mc.process(in.data() + 10 * Channels, out.data() + 10 * Channels,
+             frames - 10);
+
+  for (std::size_t i = 0; i < frames; ++i) {
+    for (std::size_t c = 0; c < Channels; ++c) {
+      auto const expected = ref[c](in[i * Channels + c]);
+      EXPECT_NEAR(expected, out[i * Channels + c], 1e-5) << i << "/" << c;
+    }
+  }
+
+  for (std::size_t c = 0; c < Channels; ++c) {
+    EXPECT_NEAR(ref[c].state()[1].y1, mc.state()[1].y1[c], 1e-5) << c;
+    EXPECT_NEAR(ref[c].state()[1].y2, mc.state()[1].y2[c], 1e-5) << c;
+  }
+}
+
+} // namespace
+
+TEST(signal, multichannel) {
+  test_multichannel<float, 1>();
+  test_multichannel<float, 16>();
+  test_multichannel<float, 19>();
+  test_multichannel<double, 7>();
+}
+
+TEST(signal, pipelined) {
+  constexpr auto design = iirfilter<double>(1000.0)
+                              .highpass(butterworth<9>(), 40.0)
+                              .sos<double>(sos_gain::distribute);
+
+  auto ref = design.instance();
+  auto pipelined = design.pipelined_instance();
+  auto block = design.pipelined_instance();
+
+  static_assert(pipelined.latency() == 4, "latency");
+
+  std::array<double, 200> in, out;
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    in[i] = static_cast<double>((i * 7919) % 17) - 8.0;
+  }
+
+  block.process(in.data(), out.data(), 50);
+  block.process(in.data() + 50, out.data() + 50, 150);
+
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    auto const y = pipelined(in[i]);
+    EXPECT_DOUBLE_EQ(y, out[i]) << i;
+    if (i < pipelined.latency()) {
+      EXPECT_EQ(0.0, y) << i;
+    } else {
+      EXPECT_DOUBLE_EQ(ref(in[i - pipelined.latency()]), y) << i;
+    }
+  }
+}
+
+namespace {
+
+template <typename F, std::size_t M, typename Base>
+void test_lookahead(Base const& base, F tolerance) {
+  constexpr std::size_t N = 200;
+  auto const design = base.template lookahead<F, M>();
+  auto const sos = base.template sos<F>();
+
+  auto ref = sos.instance();
+  auto la = design.instance();
+
+  std::array<F, N> in, out;
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    in[i] = static_cast<F>((i * 7919) % 17) - F{8};
+  }
+
+  // uneven chunks, so partial blocks and single samples are mixed in
+  la.process(in.data(), out.data(), 3 * M + 1);
+  out[3 * M + 1] = la(in[3 * M + 1]);
+  la.process(in.data() + 3 * M + 2, out.data() + 3 * M + 2, N - 3 * M - 2);
+
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    EXPECT_NEAR(ref(in[i]), out[i], tolerance) << M << ": " << i;
+  }
+
+  for (std::size_t i = 0; i < sos.size(); ++i) {
+    EXPECT_NEAR(ref.state()[i].y1, la.state()[i].y1, tolerance) << i;
+    EXPECT_NEAR(ref.state()[i].y2, la.state()[i].y2, tolerance) << i;
+  }
+}
+
+} // namespace
+
+TEST(signal, lookahead) {
+  constexpr auto iir = iirfilter<double>(1000.0);
+  constexpr auto lp = iir.lowpass(chebyshev1<8>(1.0), 50.0);
+  constexpr auto hp = iir.highpass(butterworth<7>(), 40.0);
+
+  test_lookahead<double, 1>(lp, 1e-12);
+  test_lookahead<double, 3>(lp, 1e-12);
+  test_lookahead<double, 4>(lp, 1e-12);
+  test_lookahead<double, 8>(hp, 1e-12);
+  test_lookahead<float, 4>(lp, 1e-4f);
+  test_lookahead<float, 8>(hp, 1e-4f);
+  test_lookahead<float, 16>(lp, 1e-4f);
+
+  constexpr auto design = lp.lookahead<float, 4>();
+  static_assert(design.block_size() == 4, "block size");
+  static_assert(design.size() == 4, "size");
+}
+
+TEST(signal, design_bank) {
+  constexpr auto iir = iirfilter<double>(1000.0);
+  constexpr auto bank =
+      iir.lowpass_bank<double, 16>(butterworth<4>(), 50.0, 200.0);
+  constexpr auto hp_bank = iir.highpass_bank<float, 4, sos_structure::df1>(
+      chebyshev1<3>(1.0), 10.0, 40.0, sos_gain::distribute);
+
+  static_assert(bank.size() == 16, "size");
+  static_assert(bank.frequency(0) == 50.0, "fmin");
+  static_assert(bank.frequency(15) == 200.0, "fmax");
+  static_assert(bank.index(0.0) == 0, "clamp low");
+  static_assert(bank.index(54.9) == 0, "nearest");
+  static_assert(bank.index(55.1) == 1, "nearest");
+  static_assert(bank.index(1000.0) == 15, "clamp high");
+  static_assert(hp_bank.index(20.0) == 1, "nearest");
+
+  {
+    constexpr auto ref = iir.lowpass(butterworth<4>(), 130.0).sos<double>();
+    auto const& d = bank.nearest(131.0);
+    for (std::size_t i = 0; i < ref.size(); ++i) {
+      for (std::size_t k = 0; k < 3; ++k) {
+        EXPECT_DOUBLE_EQ(ref.sos()[i].b()[k], d.sos()[i].b()[k]);
+        EXPECT_DOUBLE_EQ(ref.sos()[i].a()[k], d.sos()[i].a()[k]);
+      }
+    }
+  }
+
+  {
+    constexpr auto ref = iir.highpass(chebyshev1<3>(1.0), 30.0)
+                             .sos<float, sos_structure::df1>(
+                                 sos_gain::distribute);
+    auto const& d = hp_bank.nearest(30.0f);
+    for (std::size_t i = 0; i < ref.size(); ++i) {
+      for (std::size_t k = 0; k < 3; ++k) {
+        EXPECT_FLOAT_EQ(ref.sos()[i].b()[k], d.sos()[i].b()[k]);
+        EXPECT_FLOAT_EQ(ref.sos()[i].a()[k], d.sos()[i].a()[k]);
+      }
+    }
+  }
+
+  // swapping the design keeps the state
+  auto filter = bank.design(0).instance();
+  auto low = bank.design(0).instance();
+  for (int i = 0; i < 50; ++i) {
+    EXPECT_DOUBLE_EQ(low(1.0), filter(1.0));
+  }
+  filter.set_design(&bank.design(15));
+  EXPECT_EQ(&bank.design(15), filter.design());
+  EXPECT_DOUBLE_EQ(low.state()[1].y1, filter.state()[1].y1);
+
+  // the step response continues from the current output level
+  EXPECT_NEAR(1.0, filter(1.0), 0.05);
+}
+
+TEST(signal, design_swap_threads) {
+  static constexpr auto bank = iirfilter<float>(1000.0f)
+                                   .lowpass_bank<float, 8>(butterworth<4>(),
+                                                           50.0f, 200.0f);
+  sos_retunable_instance<float, 4> filter{&bank.design(0)};
+
+  std::atomic<bool> done{false};
+  std::thread tuner{[&] {
+    for (std::size_t i = 0; !done.load(); i = (i + 1) % bank.size()) {
+      filter.set_design(&bank.design(i));
+    }
+  }};
+  std::array<float, 64> block;
+  for (int i = 0; i < 200; ++i) {
+    block.fill(1.0f);
+    filter.process(block.data(), block.size());
+  }
+  done = true;
+  tuner.join();
+
+  // every design has unity DC gain, so the step response settles at one
+  EXPECT_NEAR(1.0f, block.back(), 1e-3f);
+
+  // a pending design only takes effect with the next call
+  filter(1.0f);
+  auto const next = filter.design() == &bank.design(0) ? &bank.design(1)
+                                                       : &bank.design(0);
+  filter.set_design(next);
+  EXPECT_NE(next, filter.design());
+  filter(1.0f);
+  EXPECT_EQ(next, filter.design());
+}
+
+namespace {
+
+constexpr auto static_design =
+    iirfilter<double>(1000.0).lowpass(butterworth<7>(), 100.0);
+constexpr auto static_sos = static_design.sos<double>();
+constexpr auto static_poly = static_design.poly<double>();
+
+} // namespace
+
+TEST(signal, static_instance) {
+  sos_static_instance<decltype(static_sos), static_sos> sos;
+  poly_static_instance<decltype(static_poly), static_poly> poly;
+  auto sos_block = sos;
+  auto poly_block = poly;
+  auto sos_ref = static_sos.instance();
+  auto poly_ref = static_poly.instance();
+
+  static_assert(sizeof(sos) == sizeof(sos.state()), "state only");
+  static_assert(sizeof(poly) == 7 * sizeof(double), "state only");
+
+  std::array<double, 200> in, sos_out, poly_out;
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    in[i] = static_cast<double>((i * 7919) % 17) - 8.0;
+  }
+
+  sos_block.process(in.data(), sos_out.data(), 77);
+  sos_block.process(in.data() + 77, sos_out.data() + 77, in.size() - 77);
+  poly_out = in;
+  poly_block.process(poly_out.data(), 77);
+  poly_block.process(poly_out.data() + 77, in.size() - 77);
+
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    auto const y = sos(in[i]);
+    EXPECT_DOUBLE_EQ(sos_ref(in[i]), y) << i;
+    EXPECT_DOUBLE_EQ(y, sos_out[i]) << i;
+    auto const yp = poly(in[i]);
+    EXPECT_DOUBLE_EQ(poly_ref(in[i]), yp) << i;
+    EXPECT_DOUBLE_EQ(yp, poly_out[i]) << i;
+  }
+}
+
+namespace {
+
+template <typename Structure, typename D>
+void test_structure(D const& design) {
+  auto const other = design.template sos<double, Structure>();
+  auto const ref = design.template sos<double>();
+
+  for (std::size_t i = 0; i < ref.size(); ++i) {
+    for (std::size_t k = 0; k < 3; ++k) {
+      EXPECT_NEAR(ref.sos()[i].b()[k], other.sos()[i].b()[k], 1e-12);
+      EXPECT_NEAR(ref.sos()[i].a()[k], other.sos()[i].a()[k], 1e-12);
+    }
+  }
+
+  auto ri = ref.instance();
+  auto oi = other.instance();
+  auto block = other.instance();
+
+  std::array<double, 300> in, out;
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    in[i] = i % 50 == 0 ? 1.0 : 0.0;
+  }
+
+  block.process(in.data(), out.data(), 33);
+  block.process(in.data() + 33, out.data() + 33, in.size() - 33);
+
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    auto const y = oi(in[i]);
+    EXPECT_DOUBLE_EQ(y, out[i]) << i;
+    EXPECT_NEAR(ri(in[i]), y, 1e-12) << i;
+  }
+}
+
+} // namespace
+
+TEST(signal, structures) {
+  constexpr auto lp =
+      iirfilter<double>(48000.0).lowpass(butterworth<5>(), 200.0);
+  constexpr auto hp =
+      iirfilter<double>(1000.0).highpass(butterworth<6>(), 50.0);
+
+  test_structure<sos_structure::df1>(lp);
+  test_structure<sos_structure::tdf1>(lp);
+  test_structure<sos_structure::coupled>(lp);
+  test_structure<sos_structure::df1>(hp);
+  test_structure<sos_structure::tdf1>(hp);
+  test_structure<sos_structure::coupled>(hp);
+
+  constexpr auto coupled =
+      lp.sos<float, sos_structure::coupled>(sos_gain::distribute);
+  auto pipelined = coupled.pipelined_instance();
+  static_assert(pipelined.latency() == 2, "latency");
+  EXPECT_EQ(0.0f, pipelined(1.0f));
+}
+
+namespace {
+
+class q28 {
+ public:
+  static constexpr unsigned fraction_bits = 28;
+
+  constexpr explicit q28(double x) noexcept
+      : v_{static_cast<int32_t>(x * (int64_t{1} << fraction_bits) +
+                                (x < 0 ? -0.5 : 0.5))} {}
+
+  static constexpr q28 from_raw(int32_t v) noexcept { return q28{v, 0}; }
+
+  constexpr int32_t raw() const noexcept { return v_; }
+
+  constexpr double to_double() const noexcept {
+    return static_cast<double>(v_) / (int64_t{1} << fraction_bits);
+  }
+
+ private:
+  constexpr q28(int32_t v, int) noexcept
+      : v_{v} {}
+
+  int32_t v_;
+};
+
+} // namespace
+
+namespace embedded {
+namespace signal {
+
+template <>
+struct fixed_point_traits<q28> {
+  using base_type = int32_t;
+  using intermediate_type = int64_t;
+
+  static constexpr unsigned fraction_bits = q28::fraction_bits;
+
+  static constexpr int32_t raw(q28 x) noexcept { return x.raw(); }
+  static constexpr q28 from_raw(int32_t x) noexcept {
+    return q28::from_raw(x);
+  }
+};
+
+} // namespace signal
+} // namespace embedded
+
+namespace {
+
+template <bool ErrorFeedback>
+void test_fixed_point(double tolerance) {
+  constexpr auto design = iirfilter<double>(1000.0).lowpass(butterworth<6>(),
+                                                            100.0);
+  constexpr auto ref = design.sos<double>(sos_gain::distribute);
+  constexpr auto fixed =
+      design.sos<q28, sos_structure::df1_wide<ErrorFeedback>>(
+          sos_gain::distribute);
+
+  auto ri = ref.instance();
+  auto fi = fixed.instance();
+  auto block = fixed.instance();
+
+  std::vector<q28> in, out;
+  std::vector<double> ref_in;
+  for (std::size_t i = 0; i < 500; ++i) {
+    ref_in.push_back(0.05 * (static_cast<double>((i * 7919) % 17) - 8.0));
+    in.push_back(q28{ref_in.back()});
+  }
+  out.resize(in.size(), q28{0.0});
+
+  block.process(in.data(), out.data(), 111);
+  block.process(in.data() + 111, out.data() + 111, in.size() - 111);
+
+  double max_error = 0.0;
+
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    auto const y = fi(in[i]);
+    EXPECT_EQ(y.raw(), out[i].raw()) << i;
+    max_error = std::max(max_error, std::abs(ri(ref_in[i]) - y.to_double()));
+  }
+
+  EXPECT_LT(max_error, tolerance);
+}
+
+} // namespace
+
+TEST(signal, fixed_point) {
+  test_fixed_point<false>(1e-7);
+  test_fixed_point<true>(1e-7);
+}
+
+namespace {
+
+// Section names that are valid C identifiers, so the linker provides
+// `__start_` and `__stop_` symbols for them
+LIBEMB_FILTER_DESIGN_SECTION(
+    "libemb_test_coefs", placed_design,
+    iirfilter<double>(1000.0).lowpass(butterworth<4>(), 100.0).sos<float>());
+
+LIBEMB_FILTER_INSTANCE_SECTION("libemb_test_state", placed_filter,
+                               placed_design.instance());
+
+LIBEMB_FILTER_DESIGN(default_design,
+                     iirfilter<double>(1000.0)
+                         .lowpass(butterworth<2>(), 100.0)
+                         .sos<double, sos_structure::df1>());
+
+LIBEMB_FILTER_INSTANCE(default_filter, default_design.instance());
+
+constexpr signal::detail::filter_design_debug_ref<
+    std::decay<decltype(placed_design)>::type>
+    placed_record{placed_design, "placed"};
+
+static_assert(placed_record.coef == &placed_design.sos(), "coef");
+static_assert(placed_record.header.version ==
+                  signal::detail::filter_debug_version::REFERENCE,
+              "version");
+static_assert(placed_record.header.length ==
+                  sizeof(signal::detail::filter_debug_header) +
+                      sizeof(void*) + 4,
+              "length");
+
+} // namespace
+
+LIBEMB_DEBUG_FILTER_COEFS_REF(placed_design);
+
+#ifdef __ELF__
+extern "C" char const __start_libemb_test_coefs[];
+extern "C" char const __stop_libemb_test_coefs[];
+extern "C" char const __start_libemb_test_state[];
+extern "C" char const __stop_libemb_test_state[];
+#endif
+
+TEST(signal, placement) {
+  EXPECT_EQ(&placed_design, placed_filter.design());
+  EXPECT_EQ(&default_design, default_filter.design());
+
+#ifdef __ELF__
+  auto const coefs = reinterpret_cast<char const*>(&placed_design);
+  auto const state = reinterpret_cast<char const*>(&placed_filter);
+  EXPECT_GE(coefs, __start_libemb_test_coefs);
+  EXPECT_LE(coefs + sizeof(placed_design), __stop_libemb_test_coefs);
+  EXPECT_GE(state, __start_libemb_test_state);
+  EXPECT_LE(state + sizeof(placed_filter), __stop_libemb_test_state);
+#endif
+
+  auto ref = placed_design.instance();
+  for (int i = 0; i < 32; ++i) {
+    float const x = i == 0 ? 1.0f : 0.0f;
+    EXPECT_EQ(ref(x), placed_filter(x)) << i;
+  }
+  EXPECT_NEAR(1.0, default_filter(1.0), 1.0);
+}
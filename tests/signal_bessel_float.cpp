@@ -23,7 +23,7 @@
 #include <array>
 #include <vector>
 
-#include "embedded/signal/bessel.h"
+#include "embedded/signal/bessel_table.h"
 #include "embedded/signal/filter.h"
 
 #include <gmock/gmock.h>
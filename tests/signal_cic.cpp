@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "embedded/signal/butterworth.h"
+#include "embedded/signal/cic.h"
+#include "embedded/signal/filter.h"
+#include "embedded/signal/fir.h"
+
+#include <gtest/gtest.h>
+
+using namespace embedded;
+using namespace embedded::signal;
+
+namespace {
+
+template <typename T>
+std::vector<T> input(std::size_t count) {
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> dist(std::numeric_limits<T>::min(),
+                                          std::numeric_limits<T>::max());
+  std::vector<T> in;
+  for (std::size_t i = 0; i < count; ++i) {
+    // full scale runs to provoke the worst case bit growth
+    in.push_back(i % 100 < 50 ? dist(rng)
+                 : i % 100 < 75 ? std::numeric_limits<T>::max()
+                                : std::numeric_limits<T>::min());
+  }
+  return in;
+}
+
+// `Order` moving sums over `Length` samples
+template <typename T>
+std::vector<std::int64_t>
+moving_sums(std::vector<T> const& in, std::size_t order, std::size_t length) {
+  std::vector<std::int64_t> x(in.begin(), in.end());
+  for (std::size_t k = 0; k < order; ++k) {
+    std::vector<std::int64_t> y(x.size());
+    for (std::size_t n = 0; n < x.size(); ++n) {
+      for (std::size_t i = 0; i < length && i <= n; ++i) {
+        y[n] += x[n - i];
+      }
+    }
+    x.swap(y);
+  }
+  return x;
+}
+
+template <typename T, std::size_t Order, std::size_t Rate, std::size_t Delay>
+void test_decimator() {
+  using cic = cic_decimator<T, Order, Rate, Delay>;
+  auto const in = input<T>(50 * Rate + 3);
+  auto const full = moving_sums(in, Order, Rate * Delay);
+
+  cic block;
+  cic chunked;
+  std::vector<typename cic::output_type> out(cic::max_output(in.size()));
+  std::vector<typename cic::output_type> out_chunked(out.size());
+  std::vector<double> out_float(out.size());
+
+  EXPECT_EQ(in.size() / Rate, block.process(in.data(), out.data(), in.size()));
+
+  std::size_t count = 0;
+  std::size_t pos = 0;
+  for (std::size_t chunk = 1; pos < in.size(); chunk += 3) {
+    auto const n = std::min(chunk, in.size() - pos);
+    count += chunked.process(&in[pos], &out_chunked[count], n);
+    pos += n;
+  }
+  ASSERT_EQ(in.size() / Rate, count);
+
+  cic flt;
+  EXPECT_EQ(count, flt.process(in.data(), out_float.data(), in.size()));
+
+  for (std::size_t i = 0; i < count; ++i) {
+    auto const ref = full[i * Rate + Rate - 1];
+    EXPECT_EQ(ref, out[i]) << i;
+    EXPECT_EQ(ref, out_chunked[i]) << i;
+    EXPECT_DOUBLE_EQ(double(ref) / double(cic::gain()), out_float[i]) << i;
+  }
+
+  block.reset();
+  std::vector<typename cic::output_type> again(out.size());
+  block.process(in.data(), again.data(), in.size());
+  EXPECT_EQ(out, again);
+}
+
+template <typename T, std::size_t Order, std::size_t Rate, std::size_t Delay>
+void test_interpolator() {
+  using cic = cic_interpolator<T, Order, Rate, Delay>;
+  auto const in = input<T>(150);
+  std::vector<T> up(in.size() * Rate);
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    up[i * Rate] = in[i];
+  }
+  auto const full = moving_sums(up, Order, Rate * Delay);
+
+  cic block;
+  cic chunked;
+  std::vector<typename cic::output_type> out(cic::max_output(in.size()));
+  std::vector<typename cic::output_type> out_chunked(out.size());
+
+  EXPECT_EQ(out.size(), block.process(in.data(), out.data(), in.size()));
+
+  std::size_t count = 0;
+  std::size_t pos = 0;
+  for (std::size_t chunk = 1; pos < in.size(); ++chunk) {
+    auto const n = std::min(chunk, in.size() - pos);
+    count += chunked.process(&in[pos], &out_chunked[count], n);
+    pos += n;
+  }
+  ASSERT_EQ(out.size(), count);
+
+  for (std::size_t i = 0; i < count; ++i) {
+    EXPECT_EQ(full[i], out[i]) << i;
+    EXPECT_EQ(full[i], out_chunked[i]) << i;
+  }
+}
+
+template <typename H>
+double magnitude(H const& h, double f) {
+  std::complex<double> sum;
+  for (std::size_t i = 0; i < h.size(); ++i) {
+    sum += h[i] * std::polar(1.0, -2.0 * cmath::pi<double>() * f * i);
+  }
+  return std::abs(sum);
+}
+
+// CIC response at `f` relative to the low rate, normalized to unity gain
+double cic_magnitude(std::size_t order, std::size_t rate, double f) {
+  auto const x = cmath::pi<double>() * f;
+  if (x == 0.0) {
+    return 1.0;
+  }
+  return std::pow(std::sin(x) / (rate * std::sin(x / rate)), order);
+}
+
+} // namespace
+
+TEST(signal_cic, bit_growth) {
+  using d1 = cic_decimator<std::int16_t, 4, 32>;
+  static_assert(d1::gain() == 1 << 20, "");
+  static_assert(d1::bit_growth() == 20, "");
+  static_assert(d1::output_bits() == 36, "");
+  static_assert(std::is_same<d1::output_type, std::int64_t>::value, "");
+
+  using d2 = cic_decimator<std::int8_t, 5, 10, 2>;
+  static_assert(d2::gain() == 3200000, "");
+  static_assert(d2::bit_growth() == 22, "");
+  static_assert(d2::output_bits() == 30, "");
+  static_assert(std::is_same<d2::output_type, std::int32_t>::value, "");
+
+  using d3 = cic_decimator<std::uint8_t, 3, 64>;
+  static_assert(d3::output_bits() == 8 + 18 + 1, "");
+
+  using i1 = cic_interpolator<std::int16_t, 4, 16>;
+  static_assert(i1::gain() == 4096, "");
+  static_assert(i1::bit_growth() == 12, "");
+  static_assert(std::is_same<i1::output_type, std::int32_t>::value, "");
+}
+
+TEST(signal_cic, decimator) {
+  test_decimator<std::int16_t, 4, 32, 1>();
+  test_decimator<std::int16_t, 1, 3, 1>();
+  test_decimator<std::int8_t, 5, 10, 2>();
+  test_decimator<std::uint8_t, 3, 64, 1>();
+  test_decimator<std::int32_t, 2, 8, 3>();
+}
+
+TEST(signal_cic, interpolator) {
+  test_interpolator<std::int16_t, 4, 16, 1>();
+  test_interpolator<std::int8_t, 3, 5, 2>();
+  test_interpolator<std::int16_t, 1, 2, 1>();
+}
+
+TEST(signal_cic, compensator) {
+  constexpr auto comp =
+      firfilter<>(1000.0).cic_compensator<4, 32>(hann<31>{}, 250.0);
+  auto const& h = comp.taps();
+
+  EXPECT_NEAR(1.0, magnitude(h, 0.0), 1e-12);
+
+  for (double f = 0.0; f <= 0.2; f += 0.01) {
+    auto const droop = cic_magnitude(4, 32, f);
+    EXPECT_NEAR(1.0, droop * magnitude(h, f), 0.01) << f;
+  }
+
+  // without compensation, the droop is far beyond that
+  EXPECT_LT(cic_magnitude(4, 32, 0.2), 0.8);
+}
+
+TEST(signal_cic, sos_at_low_rate) {
+  cic_decimator<std::int16_t, 4, 32> cic;
+  constexpr auto design =
+      iirfilter<>(1000.0).lowpass(butterworth<2>(), 100.0).sos<float>();
+  auto filter = design.instance();
+
+  std::vector<std::int16_t> in(32 * 64, 1000);
+  float out[decltype(cic)::max_output(32 * 64)];
+  auto const n = cic.process(in.data(), out, in.size());
+  filter.process(out, n);
+
+  EXPECT_EQ(64, n);
+  EXPECT_NEAR(1000.0f, out[n - 1], 1e-2f);
+}
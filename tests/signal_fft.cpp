@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "embedded/signal/fft.h"
+
+#include <gtest/gtest.h>
+
+using namespace embedded;
+using namespace embedded::signal;
+
+namespace {
+
+// Minimal fixed point type with 24 fractional bits
+struct q24 {
+  std::int32_t raw;
+};
+
+} // namespace
+
+namespace embedded {
+namespace signal {
+
+template <>
+struct fixed_point_traits<q24> {
+  using value_type = q24;
+  using base_type = std::int32_t;
+  using intermediate_type = std::int64_t;
+
+  static constexpr unsigned int fraction_bits = 24;
+
+  static constexpr base_type raw(value_type x) noexcept { return x.raw; }
+
+  static constexpr value_type from_raw(base_type x) noexcept {
+    return value_type{x};
+  }
+};
+
+} // namespace signal
+} // namespace embedded
+
+namespace {
+
+double to_double(double x) { return x; }
+double to_double(float x) { return x; }
+double to_double(q24 x) { return x.raw / double(1 << 24); }
+
+template <typename F>
+F from_double(double x) {
+  return static_cast<F>(x);
+}
+
+template <>
+q24 from_double<q24>(double x) {
+  return q24{static_cast<std::int32_t>(std::lround(x * (1 << 24)))};
+}
+
+std::vector<std::complex<double>> test_signal(std::size_t n) {
+  std::vector<std::complex<double>> x(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    x[i] = std::complex<double>(
+        0.5 * std::sin(0.37 * i) + 0.25 * std::cos(2.1 * i),
+        0.25 * (static_cast<double>((i * 7919) % 17) / 8 - 1));
+  }
+  return x;
+}
+
+std::vector<std::complex<double>>
+dft(std::vector<std::complex<double>> const& x) {
+  auto const n = x.size();
+  std::vector<std::complex<double>> y(n);
+  for (std::size_t k = 0; k < n; ++k) {
+    for (std::size_t i = 0; i < n; ++i) {
+      y[k] += x[i] * std::polar(1.0, -2 * cmath::pi<double>() *
+                                         double((k * i) % n) / n);
+    }
+  }
+  return y;
+}
+
+// `scale` is the expected output scale. Rounding errors grow with
+// `sqrt(N)` for floating point types and with the number of stages for
+// fixed point types, where the output is scaled down.
+template <typename F, std::size_t N>
+double tolerance(double eps) {
+  return std::is_floating_point<F>::value
+             ? eps * std::sqrt(double(N))
+             : eps * signal::detail::fft_log2(N);
+}
+
+template <typename F, std::size_t N>
+void test_complex(double scale, double eps) {
+  auto const x = test_signal(N);
+  auto const ref = dft(x);
+
+  std::vector<F> data;
+  for (auto const& v : x) {
+    data.push_back(from_double<F>(v.real()));
+    data.push_back(from_double<F>(v.imag()));
+  }
+
+  fft<F, N>::forward(data.data());
+
+  auto const tol = tolerance<F, N>(eps);
+  for (std::size_t k = 0; k < N; ++k) {
+    EXPECT_NEAR(ref[k].real() * scale, to_double(data[2 * k]), tol)
+        << N << " " << k;
+    EXPECT_NEAR(ref[k].imag() * scale, to_double(data[2 * k + 1]), tol)
+        << N << " " << k;
+  }
+}
+
+template <typename F, std::size_t N>
+void test_real(double scale, double eps) {
+  auto x = test_signal(N);
+  for (auto& v : x) {
+    v = v.real();
+  }
+  auto const ref = dft(x);
+
+  std::vector<F> data;
+  for (auto const& v : x) {
+    data.push_back(from_double<F>(v.real()));
+  }
+
+  real_fft<F, N>::forward(data.data());
+
+  auto const tol = tolerance<F, N>(eps);
+  EXPECT_NEAR(ref[0].real() * scale, to_double(data[0]), tol) << N;
+  EXPECT_NEAR(ref[N / 2].real() * scale, to_double(data[1]), tol) << N;
+  for (std::size_t k = 1; k < N / 2; ++k) {
+    EXPECT_NEAR(ref[k].real() * scale, to_double(data[2 * k]), tol)
+        << N << " " << k;
+    EXPECT_NEAR(ref[k].imag() * scale, to_double(data[2 * k + 1]), tol)
+        << N << " " << k;
+  }
+}
+
+} // namespace
+
+TEST(signal_fft, tables) {
+  using table = signal::detail::fft_bitrev_table<16>;
+  EXPECT_EQ(0, table::index[0]);
+  EXPECT_EQ(8, table::index[1]);
+  EXPECT_EQ(4, table::index[2]);
+  EXPECT_EQ(15, table::index[15]);
+
+  using twiddles =
+      signal::detail::fft_twiddle_table<signal::detail::fft_arith<q24>, 8, 6>;
+  EXPECT_EQ(1 << 24, twiddles::re[0]);
+  EXPECT_EQ(0, twiddles::im[0]);
+  EXPECT_EQ(0, twiddles::re[2]);
+  EXPECT_EQ(-(1 << 24), twiddles::im[2]);
+}
+
+TEST(signal_fft, complex_double) {
+  test_complex<double, 2>(1.0, 1e-14);
+  test_complex<double, 4>(1.0, 1e-14);
+  test_complex<double, 8>(1.0, 1e-14);
+  test_complex<double, 16>(1.0, 1e-14);
+  test_complex<double, 32>(1.0, 1e-14);
+  test_complex<double, 256>(1.0, 1e-14);
+  test_complex<double, 512>(1.0, 1e-14);
+  test_complex<double, 2048>(1.0, 1e-13);
+}
+
+TEST(signal_fft, complex_float) {
+  test_complex<float, 8>(1.0, 1e-6);
+  test_complex<float, 64>(1.0, 1e-6);
+  test_complex<float, 128>(1.0, 1e-6);
+}
+
+TEST(signal_fft, complex_fixed) {
+  // a few LSBs per stage
+  test_complex<q24, 2>(1.0 / 2, 2e-7);
+  test_complex<q24, 8>(1.0 / 8, 2e-7);
+  test_complex<q24, 64>(1.0 / 64, 2e-7);
+  test_complex<q24, 512>(1.0 / 512, 2e-7);
+}
+
+TEST(signal_fft, real) {
+  test_real<double, 4>(1.0, 1e-14);
+  test_real<double, 8>(1.0, 1e-14);
+  test_real<double, 64>(1.0, 1e-14);
+  test_real<double, 512>(1.0, 1e-14);
+  test_real<double, 4096>(1.0, 1e-13);
+  test_real<float, 128>(1.0, 1e-6);
+  test_real<q24, 4>(1.0 / 4, 2e-7);
+  test_real<q24, 128>(1.0 / 128, 2e-7);
+}
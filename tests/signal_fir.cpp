@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+#include "embedded/signal/fir.h"
+
+#include <gtest/gtest.h>
+
+#include "test_util.h"
+
+using namespace embedded;
+using namespace embedded::signal;
+using namespace embedded::test;
+
+namespace {
+
+template <typename H>
+double magnitude(H const& h, double f, double fs) {
+  std::complex<double> sum;
+  double const w = -2.0 * cmath::pi<double>() * f / fs;
+  for (std::size_t i = 0; i < h.size(); ++i) {
+    sum += double(h[i]) * std::polar(1.0, w * double(i));
+  }
+  return std::abs(sum);
+}
+
+template <typename D>
+void test_instance(D const& design, double tolerance) {
+  using value_type = typename D::value_type;
+  auto const& h = design.b();
+
+  std::vector<value_type> in;
+  for (std::size_t i = 0; i < 333; ++i) {
+    in.push_back(static_cast<value_type>((i * 7919) % 17) - value_type(8));
+  }
+
+  std::vector<double> ref(in.size());
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    for (std::size_t k = 0; k < design.taps() && k <= i; ++k) {
+      ref[i] += double(h[k]) * double(in[i - k]);
+    }
+  }
+
+  auto single = design.instance();
+  auto block = design.instance();
+  auto small = design.template instance<5>();
+  std::vector<value_type> out(in.size());
+  std::vector<value_type> inplace = in;
+
+  std::size_t pos = 0;
+  for (std::size_t chunk = 1; pos < in.size(); ++chunk) {
+    auto n = std::min(chunk, in.size() - pos);
+    block.process(&in[pos], &out[pos], n);
+    small.process(&inplace[pos], n);
+    pos += n;
+  }
+
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    EXPECT_NEAR(ref[i], single(in[i]), tolerance) << i;
+    EXPECT_NEAR(ref[i], out[i], tolerance) << i;
+    EXPECT_NEAR(ref[i], inplace[i], tolerance) << i;
+  }
+}
+
+} // namespace
+
+TEST(signal_fir, windows) {
+  static_assert(almost_equal(hamming<5>().value<double>(0), 0.08), "hamming");
+  static_assert(almost_equal(hamming<5>().value<double>(2), 1.0), "hamming");
+  static_assert(hann<5>().value<double>(0) == 0.0, "hann");
+  static_assert(almost_equal(hann<5>().value<double>(1), 0.5), "hann");
+  static_assert(almost_equal(blackman<5>().value<double>(2), 1.0), "blackman");
+  static_assert(rectangular<5>().value<double>(3) == 1.0, "rectangular");
+  static_assert(hamming<1>().value<double>(0) == 1.0, "single tap");
+}
+
+TEST(signal_fir, lowpass) {
+  constexpr auto lp = firfilter<double>(1000.0).lowpass(hamming<31>(), 100.0);
+  constexpr auto design = lp.fir<double>();
+
+  static_assert(design.taps() == 31, "taps");
+  static_assert(design.order() == 30, "order");
+  static_assert(design.symmetric(), "symmetric");
+  static_assert(almost_equal(cmath::sum(lp.taps()), 1.0), "dc gain");
+
+  EXPECT_NEAR(1.0, magnitude(design.b(), 0.0, 1000.0), 1e-12);
+  EXPECT_NEAR(0.5, magnitude(design.b(), 100.0, 1000.0), 0.01);
+  for (double f = 200.0; f <= 500.0; f += 10.0) {
+    EXPECT_LT(magnitude(design.b(), f, 1000.0), 0.003) << f;
+  }
+
+  test_instance(design, 1e-12);
+  test_instance(lp.fir<float>(), 1e-5);
+}
+
+TEST(signal_fir, highpass) {
+  constexpr auto hp = firfilter<double>(1000.0).highpass(blackman<41>(), 200.0);
+  constexpr auto design = hp.fir<float>();
+
+  static_assert(design.symmetric(), "symmetric");
+
+  EXPECT_NEAR(0.0, magnitude(design.b(), 0.0, 1000.0), 1e-6);
+  EXPECT_NEAR(1.0, magnitude(design.b(), 500.0, 1000.0), 1e-3);
+  EXPECT_NEAR(0.5, magnitude(design.b(), 200.0, 1000.0), 0.01);
+
+  test_instance(design, 1e-5);
+  test_instance(hp.fir<double>(), 1e-12);
+}
+
+TEST(signal_fir, asymmetric) {
+  constexpr auto design = fir_design<float, 6>(
+      cmath::vector<double, 6>{0.5, 0.25, -0.125, 0.0625, 1.0, -2.0});
+
+  static_assert(!design.symmetric(), "asymmetric");
+
+  test_instance(design, 1e-5);
+  test_instance(fir_design<float, 1>(cmath::vector<double, 1>{2.0}), 1e-5);
+}
+
+TEST(signal_fir, cascade) {
+  constexpr auto fir = firfilter<double>(1000.0);
+  constexpr auto band = fir.highpass(hamming<21>(), 100.0)
+                            .cascade(fir.lowpass(hamming<21>(), 300.0));
+  constexpr auto design = band.fir<double>();
+
+  static_assert(design.taps() == 41, "taps");
+
+  EXPECT_LT(magnitude(design.b(), 0.0, 1000.0), 5e-3);
+  EXPECT_NEAR(1.0, magnitude(design.b(), 200.0, 1000.0), 0.01);
+  EXPECT_LT(magnitude(design.b(), 500.0, 1000.0), 5e-3);
+
+  test_instance(design, 1e-12);
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+#include "embedded/signal/goertzel.h"
+
+#include <gtest/gtest.h>
+
+using namespace embedded;
+using namespace embedded::signal;
+
+namespace {
+
+constexpr auto dtmf = goertzel<>(8000).bins(
+    cmath::vector<double, 8>(697.0, 770.0, 852.0, 941.0, 1209.0, 1336.0,
+                             1477.0, 1633.0),
+    205);
+
+std::vector<double> test_signal(std::size_t n) {
+  std::vector<double> x(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    x[i] = std::sin(0.37 * i) + 0.5 * std::cos(1.91 * i + 0.3) +
+           0.25 * (static_cast<double>((i * 7919) % 17) / 8 - 1);
+  }
+  return x;
+}
+
+// DFT of `n` samples at `x` with the phase relative to the last sample,
+// optionally exponentially weighted
+std::complex<double>
+reference(double omega, double const* x, std::size_t n, double r = 1) {
+  std::complex<double> sum;
+  for (std::size_t m = 0; m < n; ++m) {
+    sum += x[n - 1 - m] * std::polar(std::pow(r, double(m)), omega * m);
+  }
+  return sum;
+}
+
+template <typename F, std::size_t Bins>
+void test_block(cmath::vector<double, Bins> const& f, double tolerance) {
+  constexpr std::size_t length = 100;
+  auto const design = goertzel<>(1000).bins(f, length);
+  auto const x = test_signal(length + 10);
+  std::vector<F> in(x.begin(), x.end());
+
+  auto bank = design.template bank<F>();
+  EXPECT_EQ(length, bank.length());
+  EXPECT_FALSE(bank.ready());
+
+  // feed in chunks of growing size, stopping at the end of the block
+  std::size_t pos = 0;
+  for (std::size_t chunk = 1; !bank.ready(); ++chunk) {
+    auto const n = bank.process(&in[pos], chunk);
+    EXPECT_EQ(std::min(chunk, length - pos), n);
+    pos += n;
+  }
+  EXPECT_EQ(length, pos);
+  EXPECT_EQ(0, bank.process(&in[pos], 10));
+
+  F power[Bins];
+  bank.power(power);
+
+  for (std::size_t b = 0; b < Bins; ++b) {
+    auto const ref = reference(design.omega()[b], x.data(), length);
+    auto const res = bank.result(b);
+    EXPECT_NEAR(ref.real(), res.real(), tolerance) << b;
+    EXPECT_NEAR(ref.imag(), res.imag(), tolerance) << b;
+    EXPECT_NEAR(std::norm(ref), power[b], tolerance * std::norm(ref)) << b;
+  }
+
+  bank.reset();
+  EXPECT_EQ(0, bank.count());
+  EXPECT_EQ(length, bank.process(&in[10], length));
+  EXPECT_TRUE(bank.ready());
+  auto const ref = reference(design.omega()[0], &x[10], length);
+  EXPECT_NEAR(ref.real(), bank.result(0).real(), tolerance);
+}
+
+template <typename F>
+void test_sliding(double r, double tolerance) {
+  constexpr std::size_t length = 64;
+  auto const design = goertzel<>(1000).bins(
+      cmath::vector<double, 5>(10.0, 59.0, 123.4, 250.0, 499.0), length);
+  auto const bank_proto = design.template sliding_bank<F>(r);
+  auto bank = bank_proto;
+
+  // window history starts out with zeros
+  auto const x = test_signal(1000);
+  std::vector<double> hist(length);
+  hist.insert(hist.end(), x.begin(), x.end());
+  std::vector<F> in(hist.begin(), hist.end());
+
+  std::size_t pos = 0;
+  for (std::size_t chunk = 1; pos < x.size(); ++chunk) {
+    auto const n = std::min(chunk, x.size() - pos);
+    bank.slide(&in[pos], n);
+    pos += n;
+
+    F power[5];
+    bank.power(power);
+    for (std::size_t b = 0; b < 5; ++b) {
+      auto const ref = reference(design.omega()[b], &hist[pos], length, r);
+      auto const res = bank.result(b);
+      ASSERT_NEAR(ref.real(), res.real(), tolerance) << b << " " << pos;
+      ASSERT_NEAR(ref.imag(), res.imag(), tolerance) << b << " " << pos;
+      ASSERT_NEAR(std::norm(ref), power[b], tolerance * (1 + std::norm(ref)))
+          << b << " " << pos;
+    }
+  }
+
+  bank.reset();
+  F power[5];
+  bank.power(power);
+  EXPECT_EQ(0, power[0]);
+}
+
+} // namespace
+
+TEST(signal_goertzel, design) {
+  static_assert(dtmf.length() == 205, "length");
+  static_assert(dtmf.bank<float>().bins() == 8, "bins");
+  static_assert(!dtmf.bank<float>().ready(), "ready");
+  EXPECT_NEAR(2 * cmath::pi<double>() * 697 / 8000, dtmf.omega()[0], 1e-15);
+}
+
+TEST(signal_goertzel, block) {
+  // the number of bins covers vector and scalar code paths
+  test_block<double>(cmath::vector<double, 1>(50.0), 1e-9);
+  test_block<double>(cmath::vector<double, 3>(50.0, 60.5, 499.0), 1e-9);
+  test_block<float>(cmath::vector<double, 7>(0.0, 12.5, 59.0, 60.0, 123.4,
+                                             333.3, 498.0),
+                    2e-3);
+  test_block<float>(
+      cmath::vector<double, 19>(1.0, 10.0, 20.0, 30.0, 40.0, 50.0, 60.0,
+                                70.0, 80.0, 90.0, 100.0, 110.0, 120.0, 130.0,
+                                140.0, 150.0, 160.0, 170.0, 180.0),
+      2e-3);
+}
+
+TEST(signal_goertzel, sliding) {
+  test_sliding<double>(1.0, 1e-9);
+  test_sliding<double>(0.999, 1e-9);
+  test_sliding<float>(1.0, 2e-3);
+  test_sliding<float>(0.999, 2e-3);
+}
+
+TEST(signal_goertzel, dtmf) {
+  auto bank = dtmf.bank<float>();
+
+  // '5' is 770 Hz + 1336 Hz
+  std::vector<float> x(205);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<float>(
+        std::sin(2 * cmath::pi<double>() * 770 * i / 8000) +
+        std::sin(2 * cmath::pi<double>() * 1336 * i / 8000 + 1.0));
+  }
+
+  EXPECT_EQ(x.size(), bank.process(x.data(), x.size()));
+  ASSERT_TRUE(bank.ready());
+
+  float power[8];
+  bank.power(power);
+
+  auto const row = std::max_element(power, power + 4) - power;
+  auto const col = std::max_element(power + 4, power + 8) - power;
+  EXPECT_EQ(1, row);
+  EXPECT_EQ(5, col);
+
+  for (std::size_t b = 0; b < 8; ++b) {
+    if (b != 1 && b != 5) {
+      EXPECT_LT(power[b], 0.02 * power[row]) << b;
+    }
+  }
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "embedded/signal/butterworth.h"
+#include "embedded/signal/filter.h"
+#include "embedded/signal/parallel.h"
+
+#include <gtest/gtest.h>
+
+using namespace embedded;
+using namespace embedded::signal;
+
+namespace {
+
+constexpr auto design =
+    iirfilter<>(1000.0).lowpass(butterworth<6>(), 50.0).sos<double>();
+
+std::vector<double> input(std::size_t channels, std::size_t samples) {
+  std::mt19937 rng(42);
+  std::normal_distribution<double> noise;
+  std::vector<double> in(channels * samples);
+  for (auto& x : in) {
+    x = noise(rng);
+  }
+  return in;
+}
+
+std::vector<double> reference(std::vector<double> const& in,
+                              std::size_t channels, std::size_t samples) {
+  std::vector<double> out(in.size());
+  for (std::size_t c = 0; c < channels; ++c) {
+    auto filter = design.instance();
+    filter.process(in.data() + c * samples, out.data() + c * samples,
+                   samples);
+  }
+  return out;
+}
+
+} // namespace
+
+TEST(signal_parallel, work_stealing) {
+  constexpr std::size_t workers = 4;
+  signal::detail::work_stealing_ranges ranges(workers);
+
+  for (std::size_t count : {0, 1, 3, 4, 7, 1000}) {
+    std::vector<std::atomic<int>> seen(count);
+    for (auto& s : seen) {
+      s = 0;
+    }
+
+    ranges.reset(count);
+
+    // worker 0 doesn't take part, its tasks are stolen
+    std::vector<std::thread> threads;
+    for (std::size_t w = 1; w < workers; ++w) {
+      threads.emplace_back([&, w] {
+        std::size_t task;
+        while (ranges.next(w, task)) {
+          ++seen[task];
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+      EXPECT_EQ(1, seen[i]) << count << ", " << i;
+    }
+  }
+}
+
+TEST(signal_parallel, pool) {
+  signal::detail::worker_pool pool(3);
+  std::atomic<int> calls[3];
+
+  EXPECT_EQ(3, pool.size());
+
+  for (auto& c : calls) {
+    c = 0;
+  }
+
+  for (int round = 0; round < 50; ++round) {
+    pool.run([&](std::size_t w) { ++calls[w]; });
+  }
+
+  for (auto& c : calls) {
+    EXPECT_EQ(50, c);
+  }
+}
+
+TEST(signal_parallel, channels) {
+  std::size_t const channels = 13;
+  std::size_t const samples = 1000;
+  auto const in = input(channels, samples);
+  auto const ref = reference(in, channels, samples);
+
+  std::vector<double> single;
+
+  for (std::size_t workers : {1, 2, 5}) {
+    sos_parallel_engine engine(workers);
+    EXPECT_EQ(workers, engine.workers());
+
+    std::vector<double> out(in.size());
+    engine.process<4>(design, in.data(), out.data(), channels, samples);
+
+    for (std::size_t i = 0; i < out.size(); ++i) {
+      ASSERT_NEAR(ref[i], out[i], 1e-12) << workers << ", " << i;
+    }
+
+    // the result doesn't depend on the number of workers
+    if (single.empty()) {
+      single = out;
+    } else {
+      EXPECT_EQ(single, out);
+    }
+
+    // in place
+    out = in;
+    engine.process<4>(design, out.data(), out.data(), channels, samples);
+    EXPECT_EQ(single, out);
+  }
+}
+
+TEST(signal_parallel, segments) {
+  std::size_t const channels = 3;
+  std::size_t const samples = 5000;
+  auto const in = input(channels, samples);
+  auto const ref = reference(in, channels, samples);
+
+  sos_parallel_engine engine(4);
+  std::vector<double> out(in.size());
+
+  // the impulse response has decayed below 1e-9 after 300 samples
+  engine.process(design, in.data(), out.data(), channels, samples, 700, 300);
+
+  double max_error = 0.0;
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    max_error = std::max(max_error, std::abs(ref[i] - out[i]));
+  }
+  EXPECT_LT(max_error, 1e-9);
+
+  // first segment of each channel is exact
+  for (std::size_t c = 0; c < channels; ++c) {
+    for (std::size_t i = 0; i < 700; ++i) {
+      ASSERT_NEAR(ref[c * samples + i], out[c * samples + i], 1e-12);
+    }
+  }
+
+  // without warm-up, segments start with a transient
+  engine.process(design, in.data(), out.data(), channels, samples, 700);
+  EXPECT_GT(std::abs(ref[700] - out[700]) + std::abs(ref[701] - out[701]),
+            1e-3);
+}
+
+TEST(signal_parallel, empty) {
+  sos_parallel_engine engine(2);
+  double x = 1.0;
+  engine.process(design, &x, &x, 0, 100);
+  engine.process(design, &x, &x, 1, 0);
+  EXPECT_EQ(1.0, x);
+}
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "embedded/signal/butterworth.h"
+#include "embedded/signal/cic.h"
+#include "embedded/signal/filter.h"
+#include "embedded/signal/fir.h"
+#include "embedded/signal/pipeline.h"
+#include "embedded/signal/resampler.h"
+
+#include <gtest/gtest.h>
+
+using namespace embedded;
+using namespace embedded::signal;
+
+namespace {
+
+constexpr auto sos_lp =
+    iirfilter<>(1000.0).lowpass(butterworth<4>(), 100.0).sos<float>();
+
+constexpr auto fir_proto = firfilter<>(3000.0).lowpass(hann<15>{}, 400.0);
+constexpr auto fir_lp = fir_proto.fir<float>();
+constexpr auto rs_lp = fir_proto.resampler<float, 3, 2>();
+
+struct gain {
+  using value_type = float;
+
+  constexpr gain(float f) noexcept
+      : factor{f} {}
+
+  void process(float const* in, float* out, std::size_t n) {
+    ++copies;
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = factor * in[i];
+    }
+  }
+
+  void process(float* data, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+      data[i] *= factor;
+    }
+  }
+
+  float factor;
+  int copies{0};
+};
+
+struct framer {
+  using value_type = float;
+  using output_type = std::int16_t;
+
+  void process(float const* in, std::int16_t* out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+      auto const v = std::round(in[i]);
+      out[i] = static_cast<std::int16_t>(
+          std::max(-32768.0f, std::min(32767.0f, v)));
+    }
+  }
+};
+
+using cic_type = cic_decimator<std::int16_t, 4, 16>;
+using sos_type = decltype(sos_lp.instance());
+
+using chain = typelist<cic_type, sos_type, gain, framer>;
+
+std::vector<std::int16_t> input(std::size_t count) {
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> noise(-2000, 2000);
+  std::vector<std::int16_t> in(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    auto const s = 12000.0 * std::sin(0.002 * static_cast<double>(i));
+    in[i] = static_cast<std::int16_t>(s + noise(rng));
+  }
+  return in;
+}
+
+std::vector<std::int16_t> reference(std::vector<std::int16_t> const& in) {
+  cic_type cic;
+  auto sos = sos_lp.instance();
+  gain g{0.5f};
+  framer f;
+
+  std::vector<float> tmp(cic_type::max_output(in.size()));
+  tmp.resize(cic.process(in.data(), tmp.data(), in.size()));
+  sos.process(tmp.data(), tmp.size());
+  g.process(tmp.data(), tmp.size());
+  std::vector<std::int16_t> out(tmp.size());
+  f.process(tmp.data(), out.data(), tmp.size());
+  return out;
+}
+
+} // namespace
+
+TEST(signal_pipeline, traits) {
+  using signal::detail::pipeline_stage_traits;
+
+  static_assert(std::is_same<pipeline_stage_traits<cic_type>::output_type,
+                             std::int32_t>::value,
+                "");
+  static_assert(std::is_same<pipeline_stage_traits<framer>::output_type,
+                             std::int16_t>::value,
+                "");
+  static_assert(pipeline_stage_traits<gain>::in_place<float>::value, "");
+  static_assert(pipeline_stage_traits<sos_type>::in_place<float>::value, "");
+  static_assert(!pipeline_stage_traits<framer>::in_place<float>::value, "");
+  static_assert(!pipeline_stage_traits<cic_type>::in_place<float>::value,
+                "");
+
+  EXPECT_EQ(4, pipeline_stage_traits<cic_type>::max_output(64));
+  EXPECT_EQ(64, pipeline_stage_traits<gain>::max_output(64));
+}
+
+TEST(signal_pipeline, buffers) {
+  using p = pipeline<chain, 256>;
+
+  static_assert(std::is_same<p::input_type, std::int16_t>::value, "");
+  static_assert(std::is_same<p::output_type, std::int16_t>::value, "");
+
+  EXPECT_EQ(4, p::size());
+  EXPECT_EQ(256, p::block_size());
+
+  // only the CIC output needs a buffer, everything else runs in place
+  EXPECT_EQ(16 * sizeof(float), p::buffer_bytes());
+
+  EXPECT_EQ(0, p::max_output(0));
+  EXPECT_EQ(16, p::max_output(1));
+  EXPECT_EQ(16, p::max_output(256));
+  EXPECT_EQ(32, p::max_output(257));
+
+  // the first stage can't work in place in the caller's input
+  using q = pipeline<typelist<gain, framer>, 32>;
+  EXPECT_EQ(32 * sizeof(float), q::buffer_bytes());
+}
+
+TEST(signal_pipeline, process) {
+  auto const in = input(16 * 300 + 5);
+  auto const ref = reference(in);
+
+  for (std::size_t chunk : {1, 7, 16, 100, 1000, 5000}) {
+    auto p = make_pipeline<chain, 64>(cic_type{}, sos_lp.instance(),
+                                      gain{0.5f}, framer{});
+    std::vector<std::int16_t> out(p.max_output(in.size()) + chunk);
+    std::size_t count = 0;
+
+    for (std::size_t i = 0; i < in.size(); i += chunk) {
+      auto const n = std::min(chunk, in.size() - i);
+      count += p.process(in.data() + i, out.data() + count, n);
+    }
+
+    ASSERT_EQ(ref.size(), count) << chunk;
+    ASSERT_GT(*std::max_element(ref.begin(), ref.end()), 4000);
+    out.resize(count);
+    EXPECT_EQ(ref, out) << chunk;
+
+    EXPECT_EQ(0, p.stage<2>().copies);
+    EXPECT_EQ(0.5f, p.stage<2>().factor);
+  }
+}
+
+TEST(signal_pipeline, stage_access) {
+  auto p = make_pipeline<chain>(cic_type{}, sos_lp.instance(), gain{1.0f},
+                                framer{});
+  auto const in = input(1024);
+  std::vector<std::int16_t> a(p.max_output(in.size()));
+  std::vector<std::int16_t> b(p.max_output(in.size()));
+
+  auto const n = p.process(in.data(), a.data(), in.size());
+
+  p.stage<0>().reset();
+  p.stage<1>() = sos_lp.instance();
+  EXPECT_EQ(n, p.process(in.data(), b.data(), in.size()));
+  EXPECT_EQ(a, b);
+
+  p.stage<2>().factor = 0.0f;
+  p.process(in.data(), b.data(), in.size());
+  EXPECT_TRUE(std::all_of(b.begin(), b.begin() + n,
+                          [](std::int16_t v) { return v == 0; }));
+}
+
+TEST(signal_pipeline, rate_change) {
+  using chain2 = typelist<gain, decltype(fir_lp.instance()),
+                          decltype(rs_lp.instance())>;
+  std::vector<float> in(1000);
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    in[i] = std::sin(0.05f * static_cast<float>(i));
+  }
+
+  gain g{2.0f};
+  auto fir = fir_lp.instance();
+  auto rs = rs_lp.instance();
+  std::vector<float> tmp(in.size());
+  std::vector<float> ref(decltype(rs)::max_output(in.size()));
+  g.process(in.data(), tmp.data(), in.size());
+  fir.process(tmp.data(), tmp.size());
+  ref.resize(rs.process(tmp.data(), ref.data(), tmp.size()));
+
+  auto p = make_pipeline<chain2, 50>(gain{2.0f}, fir_lp.instance(),
+                                     rs_lp.instance());
+  // the FIR filter runs in place in the output of `gain`, the resampler
+  // needs its own output buffer
+  EXPECT_EQ(50 * sizeof(float), decltype(p)::buffer_bytes());
+  EXPECT_EQ(75, decltype(p)::max_output(50));
+
+  std::vector<float> out(p.max_output(in.size()));
+  out.resize(p.process(in.data(), out.data(), in.size()));
+  ASSERT_EQ(ref.size(), out.size());
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    EXPECT_FLOAT_EQ(ref[i], out[i]) << i;
+  }
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "embedded/circular_buffer_adapter.h"
+#include "embedded/signal/fir.h"
+#include "embedded/signal/resampler.h"
+
+#include <gtest/gtest.h>
+
+using namespace embedded;
+using namespace embedded::signal;
+
+namespace {
+
+template <typename T>
+std::vector<T> input(std::size_t count) {
+  std::vector<T> in;
+  for (std::size_t i = 0; i < count; ++i) {
+    in.push_back(static_cast<T>((i * 7919) % 17) - T(8));
+  }
+  return in;
+}
+
+// Zero-stuff by `L`, filter with `L * h` and keep every `M`-th output
+template <std::size_t L, std::size_t M, typename H, typename T>
+std::vector<double> reference(H const& h, std::vector<T> const& in) {
+  std::vector<double> up(in.size() * L);
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    up[i * L] = double(L) * double(in[i]);
+  }
+  std::vector<double> out;
+  for (std::size_t n = 0; n < up.size(); n += M) {
+    double sum = 0.0;
+    for (std::size_t k = 0; k < h.size() && k <= n; ++k) {
+      sum += h[k] * up[n - k];
+    }
+    out.push_back(sum);
+  }
+  return out;
+}
+
+template <typename F, std::size_t L, std::size_t M, typename D>
+void test_resampler(D const& proto, double tolerance) {
+  auto const design = proto.template resampler<F, L, M>();
+  using design_type = decltype(design);
+
+  EXPECT_EQ(L, design_type::up());
+  EXPECT_EQ(M, design_type::down());
+  EXPECT_EQ((proto.taps().size() + L - 1) / L,
+            design_type::taps_per_phase());
+
+  auto const in = input<F>(401);
+  auto const ref = reference<L, M>(proto.taps(), in);
+
+  auto block = design.instance();
+  auto small = design.template instance<(M + L - 1) / L>();
+  std::vector<F> out(design_type::max_output(in.size()));
+  std::vector<F> out_small(out.size());
+  std::size_t count = 0;
+  std::size_t count_small = 0;
+
+  std::size_t pos = 0;
+  for (std::size_t chunk = 1; pos < in.size(); ++chunk) {
+    auto const n = std::min(chunk, in.size() - pos);
+    auto const produced = block.process(&in[pos], &out[count], n);
+    EXPECT_LE(produced, design_type::max_output(n));
+    count += produced;
+    count_small += small.process(&in[pos], &out_small[count_small], n);
+    pos += n;
+  }
+
+  ASSERT_EQ(ref.size(), count);
+  ASSERT_EQ(ref.size(), count_small);
+
+  for (std::size_t i = 0; i < ref.size(); ++i) {
+    EXPECT_NEAR(ref[i], double(out[i]), tolerance) << i;
+    EXPECT_NEAR(ref[i], double(out_small[i]), tolerance) << i;
+  }
+}
+
+} // namespace
+
+TEST(signal_resampler, phases) {
+  constexpr auto proto = firfilter<>(3000.0).lowpass(hann<8>{}, 400.0);
+  constexpr auto design = proto.resampler<double, 3, 2>();
+  auto const& h = proto.taps();
+
+  EXPECT_EQ(3, design.taps_per_phase());
+
+  // phase 1 uses h[1], h[4], h[7], reversed and scaled by 3
+  EXPECT_DOUBLE_EQ(3.0 * h[7], design.phase(1)[0]);
+  EXPECT_DOUBLE_EQ(3.0 * h[4], design.phase(1)[1]);
+  EXPECT_DOUBLE_EQ(3.0 * h[1], design.phase(1)[2]);
+
+  // phase 2 is padded with a zero tap
+  EXPECT_DOUBLE_EQ(0.0, design.phase(2)[0]);
+  EXPECT_DOUBLE_EQ(3.0 * h[5], design.phase(2)[1]);
+  EXPECT_DOUBLE_EQ(3.0 * h[2], design.phase(2)[2]);
+}
+
+TEST(signal_resampler, rational) {
+  test_resampler<double, 1, 3>(
+      firfilter<>(3000.0).lowpass(hann<31>{}, 400.0), 1e-12);
+  test_resampler<double, 3, 1>(
+      firfilter<>(3000.0).lowpass(hann<31>{}, 400.0), 1e-12);
+  test_resampler<double, 2, 3>(
+      firfilter<>(2000.0).lowpass(hann<24>{}, 300.0), 1e-12);
+  test_resampler<double, 3, 2>(
+      firfilter<>(3000.0).lowpass(hann<31>{}, 400.0), 1e-12);
+  test_resampler<double, 5, 7>(
+      firfilter<>(5000.0).lowpass(hann<47>{}, 400.0), 1e-12);
+  test_resampler<float, 1, 3>(
+      firfilter<>(3000.0).lowpass(hann<31>{}, 400.0), 1e-5);
+  test_resampler<float, 3, 2>(
+      firfilter<>(3000.0).lowpass(hann<31>{}, 400.0), 1e-5);
+  test_resampler<float, 5, 7>(
+      firfilter<>(5000.0).lowpass(hann<47>{}, 400.0), 1e-5);
+}
+
+TEST(signal_resampler, circular_buffer) {
+  constexpr auto design = firfilter<>(2000.0)
+                              .lowpass(hann<24>{}, 300.0)
+                              .resampler<float, 2, 3>();
+  using design_type = decltype(design);
+
+  auto const in = input<float>(200);
+  auto ref = design.instance();
+  std::vector<float> expected(design_type::max_output(in.size()));
+  expected.resize(ref.process(in.data(), expected.data(), in.size()));
+
+  float raw[16];
+  circular_buffer_adapter<float> cb(raw, 16);
+  auto rs = design.instance<8>();
+  std::vector<float> out;
+  std::size_t pos = 0;
+
+  while (pos < in.size()) {
+    // leave the buffer wrapped around most of the time
+    auto const n = std::min<std::size_t>(11, in.size() - pos);
+    for (std::size_t i = 0; i < n; ++i) {
+      cb.push_back(in[pos++]);
+    }
+    float tmp[design_type::max_output(16)];
+    auto const count = rs.process(cb, tmp);
+    EXPECT_TRUE(cb.empty());
+    out.insert(out.end(), tmp, tmp + count);
+  }
+
+  EXPECT_EQ(expected, out);
+}
@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "embedded/circular_buffer_adapter.h"
+#include "embedded/serialize.h"
+#include "embedded/signal/butterworth.h"
+#include "embedded/signal/filter.h"
+#include "embedded/signal/serialize.h"
+
+#include <gtest/gtest.h>
+
+using namespace embedded;
+using namespace embedded::signal;
+
+namespace {
+
+class q20 {
+ public:
+  constexpr explicit q20(double x) noexcept
+      : v_{static_cast<std::int32_t>(x * (1 << 20) + (x < 0 ? -0.5 : 0.5))} {}
+
+  static constexpr q20 from_raw(std::int32_t v) noexcept { return q20{v, 0}; }
+
+  constexpr std::int32_t raw() const noexcept { return v_; }
+
+ private:
+  constexpr q20(std::int32_t v, int) noexcept
+      : v_{v} {}
+
+  std::int32_t v_;
+};
+
+} // namespace
+
+namespace embedded {
+namespace signal {
+
+template <>
+struct fixed_point_traits<q20> {
+  using base_type = std::int32_t;
+  using intermediate_type = std::int64_t;
+
+  static constexpr unsigned fraction_bits = 20;
+
+  static constexpr std::int32_t raw(q20 x) noexcept { return x.raw(); }
+  static constexpr q20 from_raw(std::int32_t x) noexcept {
+    return q20::from_raw(x);
+  }
+};
+
+} // namespace signal
+} // namespace embedded
+
+namespace {
+
+constexpr auto lp = iirfilter<double>(1000.0).lowpass(butterworth<4>(), 50.0);
+
+class reader {
+ public:
+  reader(std::uint8_t const* begin, std::uint8_t const* end)
+      : it_{begin}
+      , end_{end} {}
+
+  template <typename T>
+  T get() {
+    T value{};
+    auto const next = varint::decode(value, it_, end_);
+    EXPECT_NE(it_, next);
+    it_ = next;
+    return value;
+  }
+
+  std::uint8_t byte() { return *it_++; }
+
+  float get_float() {
+    std::uint32_t bits = 0;
+    for (int i = 0; i < 4; ++i) {
+      bits |= static_cast<std::uint32_t>(*it_++) << (8 * i);
+    }
+    float x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+  }
+
+  double get_double() {
+    std::uint64_t bits = 0;
+    for (int i = 0; i < 8; ++i) {
+      bits |= static_cast<std::uint64_t>(*it_++) << (8 * i);
+    }
+    double x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+  }
+
+  bool done() const { return it_ == end_; }
+
+  // checks the record header and returns the payload size
+  std::size_t header(std::uint32_t kind, std::uint32_t id) {
+    EXPECT_EQ(kind, get<std::uint32_t>());
+    EXPECT_EQ(id, get<std::uint32_t>());
+    auto const length = get<std::size_t>();
+    EXPECT_EQ(length, static_cast<std::size_t>(end_ - it_));
+    return length;
+  }
+
+ private:
+  std::uint8_t const* it_;
+  std::uint8_t const* end_;
+};
+
+} // namespace
+
+TEST(signal_serialize, sos_design) {
+  constexpr auto design = lp.sos<float>();
+  std::uint8_t buf[64];
+
+  auto const size = serialized_size(design, 7);
+  // header, structure, value type, order, 2 * 5 floats
+  EXPECT_EQ(3 + 3 + 40, size);
+
+  // not enough space
+  std::memset(buf, 0xAA, sizeof(buf));
+  EXPECT_EQ(buf, serialize(design, buf, buf + size - 1, 7));
+  EXPECT_EQ(0xAA, buf[0]);
+
+  auto const end = serialize(design, buf, buf + sizeof(buf), 7);
+  ASSERT_EQ(buf + size, end);
+
+  reader r(buf, end);
+  r.header(serialize_kind::sos_design, 7);
+  EXPECT_EQ(0, r.byte()); // df2t
+  EXPECT_EQ(0, r.byte()); // float
+  EXPECT_EQ(4, r.get<std::size_t>());
+  for (std::size_t i = 0; i < design.size(); ++i) {
+    auto const& s = design.sos()[i];
+    EXPECT_EQ(s.b()[0], r.get_float());
+    EXPECT_EQ(s.b()[1], r.get_float());
+    EXPECT_EQ(s.b()[2], r.get_float());
+    EXPECT_EQ(s.a()[1], r.get_float());
+    EXPECT_EQ(s.a()[2], r.get_float());
+  }
+  EXPECT_TRUE(r.done());
+}
+
+TEST(signal_serialize, poly_design) {
+  constexpr auto design = lp.poly<double>();
+  std::vector<std::uint8_t> buf(serialized_size(design));
+
+  auto const end = serialize(design, buf.data(), buf.data() + buf.size());
+  ASSERT_EQ(buf.data() + buf.size(), end);
+
+  reader r(buf.data(), end);
+  r.header(serialize_kind::poly_design, 0);
+  EXPECT_EQ(1, r.byte()); // double
+  EXPECT_EQ(4, r.get<std::size_t>());
+  for (std::size_t i = 0; i <= 4; ++i) {
+    EXPECT_EQ(design.b()[i], r.get_double());
+  }
+  for (std::size_t i = 0; i <= 4; ++i) {
+    EXPECT_EQ(design.a()[i], r.get_double());
+  }
+  EXPECT_TRUE(r.done());
+}
+
+TEST(signal_serialize, state) {
+  constexpr auto design = lp.sos<float, sos_structure::df1>();
+  auto filter = design.instance();
+  for (int i = 0; i < 10; ++i) {
+    filter(1.0f);
+  }
+
+  std::uint8_t buf[128];
+  auto const end = serialize(filter.state(), buf, buf + sizeof(buf), 3);
+  ASSERT_NE(buf, end);
+
+  reader r(buf, end);
+  r.header(serialize_kind::sos_state, 3);
+  EXPECT_EQ(1, r.byte()); // df1
+  EXPECT_EQ(0, r.byte()); // float
+  EXPECT_EQ(2, r.get<std::size_t>());
+  for (auto const& s : filter.state()) {
+    EXPECT_EQ(s.x1, r.get_float());
+    EXPECT_EQ(s.x2, r.get_float());
+    EXPECT_EQ(s.y1, r.get_float());
+    EXPECT_EQ(s.y2, r.get_float());
+  }
+  EXPECT_TRUE(r.done());
+}
+
+TEST(signal_serialize, denormal_safe) {
+  constexpr auto design =
+      lp.sos<float, sos_structure::denormal_safe<sos_structure::tdf1>>();
+  auto filter = design.instance();
+  for (int i = 0; i < 9; ++i) {
+    filter(1.0f);
+  }
+
+  std::uint8_t buf[192];
+  auto end = serialize(design, buf, buf + sizeof(buf), 1);
+  ASSERT_NE(buf, end);
+
+  reader d(buf, end);
+  d.header(serialize_kind::sos_design, 1);
+  EXPECT_EQ(5, d.byte()); // denormal_safe
+  EXPECT_EQ(2, d.byte()); // tdf1
+  EXPECT_EQ(0, d.byte()); // float
+  EXPECT_EQ(4, d.get<std::size_t>());
+  for (std::size_t i = 0; i < design.size(); ++i) {
+    auto const& sec = design.sos()[i];
+    EXPECT_EQ(sec.b()[0], d.get_float());
+    EXPECT_EQ(sec.b()[1], d.get_float());
+    EXPECT_EQ(sec.b()[2], d.get_float());
+    EXPECT_EQ(sec.a()[1], d.get_float());
+    EXPECT_EQ(sec.a()[2], d.get_float());
+  }
+  EXPECT_TRUE(d.done());
+
+  end = serialize(filter.state(), buf, buf + sizeof(buf), 2);
+  ASSERT_NE(buf, end);
+
+  reader r(buf, end);
+  r.header(serialize_kind::sos_state, 2);
+  EXPECT_EQ(5, r.byte()); // denormal_safe
+  EXPECT_EQ(2, r.byte()); // tdf1
+  EXPECT_EQ(0, r.byte()); // float
+  EXPECT_EQ(2, r.get<std::size_t>());
+  for (auto const& s : filter.state()) {
+    EXPECT_EQ(s.p1, r.get_float());
+    EXPECT_EQ(s.p2, r.get_float());
+    EXPECT_EQ(s.z1, r.get_float());
+    EXPECT_EQ(s.z2, r.get_float());
+    EXPECT_EQ(s.offset, r.get_float());
+    EXPECT_EQ(s.next, r.get_float());
+  }
+  EXPECT_TRUE(r.done());
+}
+
+TEST(signal_serialize, fixed_point) {
+  constexpr auto design =
+      lp.sos<q20, sos_structure::df1_wide<true>>(sos_gain::distribute);
+  auto filter = design.instance();
+  for (int i = 0; i < 10; ++i) {
+    filter(q20{0.25});
+  }
+
+  std::uint8_t buf[128];
+  auto end = serialize(design, buf, buf + sizeof(buf));
+  ASSERT_NE(buf, end);
+
+  {
+    reader r(buf, end);
+    r.header(serialize_kind::sos_design, 0);
+    EXPECT_EQ(4, r.byte()); // df1_wide
+    EXPECT_EQ(3, r.byte()); // fixed
+    EXPECT_EQ(20, r.byte());
+    EXPECT_EQ(4, r.byte());
+    EXPECT_EQ(4, r.get<std::size_t>());
+    for (std::size_t i = 0; i < design.size(); ++i) {
+      auto const& s = design.sos()[i];
+      EXPECT_EQ(s.b()[0].raw(), r.get<std::int32_t>());
+      EXPECT_EQ(s.b()[1].raw(), r.get<std::int32_t>());
+      EXPECT_EQ(s.b()[2].raw(), r.get<std::int32_t>());
+      EXPECT_EQ(s.a()[1].raw(), r.get<std::int32_t>());
+      EXPECT_EQ(s.a()[2].raw(), r.get<std::int32_t>());
+    }
+    EXPECT_TRUE(r.done());
+  }
+
+  end = serialize(filter.state(), buf, buf + sizeof(buf));
+  ASSERT_NE(buf, end);
+
+  {
+    reader r(buf, end);
+    r.header(serialize_kind::sos_state, 0);
+    EXPECT_EQ(4, r.byte());
+    EXPECT_EQ(3, r.byte());
+    EXPECT_EQ(20, r.byte());
+    EXPECT_EQ(4, r.byte());
+    EXPECT_EQ(2, r.get<std::size_t>());
+    for (auto const& s : filter.state()) {
+      EXPECT_EQ(s.x1, r.get<std::int32_t>());
+      EXPECT_EQ(s.x2, r.get<std::int32_t>());
+      EXPECT_EQ(s.y1, r.get<std::int32_t>());
+      EXPECT_EQ(s.y2, r.get<std::int32_t>());
+      EXPECT_EQ(s.e, r.get<std::int64_t>());
+    }
+    EXPECT_TRUE(r.done());
+  }
+}
+
+TEST(signal_serialize, statistics) {
+  constexpr auto design = lp.sos<float>();
+  auto filter = design.instance<sos_instrumentation::statistics>();
+  filter.set_saturation_limit(0.5f);
+  for (int i = 0; i < 100; ++i) {
+    filter(i % 10 < 5 ? 1.0f : -1.0f);
+  }
+
+  std::uint8_t raw[64];
+  circular_buffer_adapter<std::uint8_t> cb(raw, sizeof(raw));
+
+  // records don't fit, the buffer is left alone
+  cb.push_back(0xEE);
+  while (cb.remaining() > 4) {
+    cb.push_back(0xEE);
+  }
+  EXPECT_FALSE(serialize(filter.statistics(), cb, 1));
+  EXPECT_EQ(sizeof(raw) - 4, cb.size());
+  cb.clear();
+
+  ASSERT_TRUE(serialize(filter.statistics(), cb, 1));
+
+  std::vector<std::uint8_t> buf(cb.begin(), cb.end());
+  EXPECT_EQ(serialized_size(filter.statistics(), 1), buf.size());
+
+  reader r(buf.data(), buf.data() + buf.size());
+  r.header(serialize_kind::sos_statistics, 1);
+  EXPECT_EQ(0, r.byte());
+  EXPECT_EQ(2, r.get<std::size_t>());
+  for (auto const& s : filter.statistics()) {
+    EXPECT_EQ(s.peak, r.get_float());
+    EXPECT_EQ(s.saturations, r.get<std::uint32_t>());
+  }
+  EXPECT_TRUE(r.done());
+}
+
+TEST(signal_serialize, cba_statistics) {
+  std::uint8_t data[4];
+  circular_buffer_adapter<std::uint8_t, 0, cba_instrumentation::statistics>
+      cb(data, sizeof(data));
+  for (int i = 0; i < 6; ++i) {
+    cb.push_back_overwrite(static_cast<std::uint8_t>(i));
+  }
+  cb.pop_front();
+
+  std::uint8_t buf[16];
+  auto const end = serialize(cb.statistics(), buf, buf + sizeof(buf), 200);
+  ASSERT_NE(buf, end);
+
+  reader r(buf, end);
+  EXPECT_EQ(r.header(serialize_kind::cba_statistics, 200), 5);
+  EXPECT_EQ(cb.statistics().high_water, r.get<std::size_t>());
+  EXPECT_EQ(cb.statistics().overflows, r.get<std::uint32_t>());
+  EXPECT_EQ(cb.statistics().underflows, r.get<std::uint32_t>());
+  EXPECT_EQ(cb.statistics().pushed, r.get<std::uint32_t>());
+  EXPECT_EQ(cb.statistics().popped, r.get<std::uint32_t>());
+  EXPECT_TRUE(r.done());
+}
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "embedded/spsc_circular_buffer_adapter.h"
+
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace embedded;
+
+TEST(spsc_circular_buffer_adapter, basic) {
+  int storage[5];
+  spsc_circular_buffer_adapter<int> cb(storage, 5);
+
+  EXPECT_EQ(5, cb.capacity());
+  EXPECT_TRUE(cb.empty());
+  EXPECT_EQ(5, cb.remaining());
+
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_TRUE(cb.try_push_back(i));
+  }
+
+  EXPECT_TRUE(cb.full());
+  EXPECT_EQ(0, cb.remaining());
+  EXPECT_FALSE(cb.try_push_back(5));
+
+  EXPECT_EQ(0, cb.front());
+  cb.pop_front();
+
+  int value = -1;
+  EXPECT_TRUE(cb.try_pop_front(value));
+  EXPECT_EQ(1, value);
+  EXPECT_EQ(3, cb.size());
+  EXPECT_EQ(2, cb.first_index());
+
+  // wrap around several times
+  for (int i = 5; i < 20; ++i) {
+    EXPECT_TRUE(cb.try_emplace_back(i));
+    EXPECT_TRUE(cb.try_pop_front(value));
+    EXPECT_EQ(i - 3, value);
+  }
+
+  EXPECT_EQ(3, cb.size());
+
+  while (cb.try_pop_front(value)) {
+  }
+
+  EXPECT_EQ(19, value);
+  EXPECT_TRUE(cb.empty());
+}
+
+TEST(spsc_circular_buffer_adapter, bulk) {
+  std::uint16_t storage[7];
+  spsc_circular_buffer_adapter<std::uint16_t> cb(storage, storage + 7);
+
+  std::vector<std::uint16_t> in(32);
+  std::iota(in.begin(), in.end(), 100);
+  std::vector<std::uint16_t> out;
+
+  std::size_t pos = 0;
+
+  while (out.size() < in.size()) {
+    std::uint16_t chunk[4];
+    pos += cb.copy_in_back(in.data() + pos, std::min<std::size_t>(5, 32 - pos));
+    auto const n = cb.copy_out_front(chunk, 4);
+    out.insert(out.end(), chunk, chunk + n);
+  }
+
+  EXPECT_EQ(in, out);
+  EXPECT_TRUE(cb.empty());
+
+  EXPECT_EQ(7, cb.copy_in_back(in.data(), 10));
+  EXPECT_EQ(0, cb.copy_in_back(in.data(), 1));
+  EXPECT_EQ(7, cb.copy_out_front(out.data(), 10));
+  EXPECT_EQ(0, cb.copy_out_front(out.data(), 1));
+}
+
+TEST(spsc_circular_buffer_adapter, zero_copy) {
+  int storage[8];
+  spsc_circular_buffer_adapter<int> cb(storage, 8, 5, 0);
+
+  auto r = cb.reserve_back(6);
+  EXPECT_EQ(6, r.size());
+  EXPECT_EQ(storage + 5, r.first.data);
+  EXPECT_EQ(3, r.first.size);
+  EXPECT_EQ(storage, r.second.data);
+  EXPECT_EQ(3, r.second.size);
+
+  int value = 0;
+  for (auto& x : r.first) {
+    x = value++;
+  }
+  for (auto& x : r.second) {
+    x = value++;
+  }
+
+  EXPECT_TRUE(cb.empty());
+  cb.commit_back(6);
+  EXPECT_EQ(6, cb.size());
+  EXPECT_EQ(2, cb.reserve_back(6).size());
+
+  auto p = cb.peek_front(10);
+  EXPECT_EQ(6, p.size());
+  EXPECT_EQ(storage + 5, p.first.data);
+  EXPECT_EQ(3, p.second.size);
+  EXPECT_EQ(5, p.second.data[2]);
+
+  cb.consume_front(4);
+  EXPECT_EQ(2, cb.size());
+  EXPECT_EQ(4, cb.front());
+  EXPECT_EQ(1, cb.first_index());
+  EXPECT_TRUE(cb.peek_front(2).second.empty());
+  EXPECT_EQ(6, cb.remaining());
+}
+
+TEST(spsc_circular_buffer_adapter, existing_data) {
+  int storage[6] = {4, 5, 0, 0, 2, 3};
+  spsc_circular_buffer_adapter<int> cb(storage, 6, 4, 4);
+
+  EXPECT_EQ(4, cb.size());
+  EXPECT_EQ(2, cb.remaining());
+
+  int out[4];
+  EXPECT_EQ(4, cb.copy_out_front(out, 4));
+  EXPECT_EQ(2, out[0]);
+  EXPECT_EQ(3, out[1]);
+  EXPECT_EQ(4, out[2]);
+  EXPECT_EQ(5, out[3]);
+  EXPECT_EQ(2, cb.first_index());
+}
+
+TEST(spsc_circular_buffer_adapter, lifetime) {
+  using ptr = std::shared_ptr<int>;
+  typename std::aligned_storage<sizeof(ptr), alignof(ptr)>::type storage[3];
+  spsc_circular_buffer_adapter<ptr> cb(reinterpret_cast<ptr*>(storage), 3);
+
+  auto p = std::make_shared<int>(42);
+
+  EXPECT_TRUE(cb.try_push_back(p));
+  EXPECT_TRUE(cb.try_emplace_back(p));
+  EXPECT_EQ(3, p.use_count());
+
+  cb.pop_front();
+  EXPECT_EQ(2, p.use_count());
+
+  ptr q;
+  EXPECT_TRUE(cb.try_pop_front(q));
+  EXPECT_EQ(2, p.use_count());
+  q.reset();
+  EXPECT_EQ(1, p.use_count());
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(cb.try_push_back(p));
+  }
+  EXPECT_EQ(4, p.use_count());
+  cb.consume_front(3);
+  EXPECT_EQ(1, p.use_count());
+}
+
+TEST(spsc_circular_buffer_adapter, threads) {
+  constexpr std::uint32_t count = 100000;
+  std::uint32_t storage[13];
+  spsc_circular_buffer_adapter<std::uint32_t> cb(storage, 13);
+
+  std::thread producer([&cb] {
+    std::uint32_t next = 0;
+    while (next < count) {
+      if (next % 3 == 0) {
+        std::uint32_t chunk[5];
+        std::iota(chunk, chunk + 5, next);
+        auto const n =
+            cb.copy_in_back(chunk, std::min<std::uint32_t>(5, count - next));
+        if (n == 0) {
+          std::this_thread::yield();
+        }
+        next += static_cast<std::uint32_t>(n);
+      } else if (cb.try_push_back(next)) {
+        ++next;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  std::uint32_t expected = 0;
+  std::size_t errors = 0;
+
+  while (expected < count) {
+    std::uint32_t chunk[4];
+    auto const n = cb.copy_out_front(chunk, 4);
+    if (n == 0) {
+      std::this_thread::yield();
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      if (chunk[i] != expected++) {
+        ++errors;
+      }
+    }
+  }
+
+  producer.join();
+
+  EXPECT_EQ(0, errors);
+  EXPECT_TRUE(cb.empty());
+}
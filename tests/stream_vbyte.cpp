@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "embedded/stream_vbyte.h"
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace embedded;
+
+TEST(stream_vbyte, tables) {
+  // lengths 1, 2, 3, 4
+  auto const& s = detail::svb_table::shuffle[0xE4];
+  EXPECT_EQ(10, detail::svb_table::length[0xE4]);
+  EXPECT_EQ(0, s.mask[0]);
+  EXPECT_EQ(0xFF, s.mask[1]);
+  EXPECT_EQ(1, s.mask[4]);
+  EXPECT_EQ(2, s.mask[5]);
+  EXPECT_EQ(0xFF, s.mask[6]);
+  EXPECT_EQ(9, s.mask[15]);
+  EXPECT_EQ(4, detail::svb_table::length[0x00]);
+  EXPECT_EQ(16, detail::svb_table::length[0xFF]);
+}
+
+TEST(stream_vbyte, format) {
+  std::vector<std::uint32_t> in{1, 0x100, 0x10000, 0x1000000, 0xAB};
+  std::vector<std::uint8_t> buf(stream_vbyte::max_size(in.size()));
+
+  EXPECT_EQ(2 + 11, stream_vbyte::size(in.data(), in.size()));
+
+  auto end = stream_vbyte::encode(in.data(), in.size(), buf.data());
+
+  ASSERT_EQ(buf.data() + 13, end);
+  EXPECT_EQ(0xE4, buf[0]);
+  EXPECT_EQ(0x00, buf[1]);
+  EXPECT_EQ(1, buf[2]);
+  EXPECT_EQ(0, buf[3]);
+  EXPECT_EQ(1, buf[4]);
+  EXPECT_EQ(0xAB, buf[12]);
+}
+
+TEST(stream_vbyte, encode_decode) {
+  std::mt19937 rng(42);
+
+  for (std::size_t count : {0, 1, 3, 4, 5, 7, 8, 9, 31, 32, 33, 1000}) {
+    std::vector<std::uint32_t> in(count);
+    for (auto& v : in) {
+      v = rng() >> (rng() % 32);
+    }
+
+    auto const size = stream_vbyte::size(in.data(), count);
+    std::vector<std::uint8_t> buf(size);
+
+    ASSERT_EQ(buf.data() + size,
+              stream_vbyte::encode(in.data(), count, buf.data()));
+
+    std::vector<std::uint32_t> out(count);
+    ASSERT_EQ(buf.data() + size, stream_vbyte::decode(buf.data(),
+                                                      buf.data() + size,
+                                                      out.data(), count));
+    EXPECT_EQ(in, out);
+
+    // input buffer exhausted
+    if (count > 0) {
+      EXPECT_EQ(buf.data(),
+                stream_vbyte::decode(buf.data(), buf.data() + size - 1,
+                                     out.data(), count));
+    }
+  }
+}
+
+TEST(stream_vbyte, encode_decode_signed) {
+  std::vector<std::int32_t> in;
+  for (int bits = 0; bits < 31; ++bits) {
+    in.push_back(1 << bits);
+    in.push_back(-(1 << bits));
+  }
+  in.push_back(std::numeric_limits<std::int32_t>::min());
+  in.push_back(std::numeric_limits<std::int32_t>::max());
+
+  auto const size = stream_vbyte::size(in.data(), in.size());
+  std::vector<std::uint8_t> buf(size);
+
+  EXPECT_EQ(buf.data() + size,
+            stream_vbyte::encode(in.data(), in.size(), buf.data()));
+
+  // 1, -1, 2, -2 take a single byte each
+  auto const data = stream_vbyte::control_size(in.size());
+  EXPECT_EQ(0x00, buf[0]);
+  EXPECT_EQ(2, buf[data]);
+  EXPECT_EQ(1, buf[data + 1]);
+  EXPECT_EQ(4, buf[data + 2]);
+  EXPECT_EQ(3, buf[data + 3]);
+
+  std::vector<std::int32_t> out(in.size());
+  EXPECT_EQ(buf.data() + size,
+            stream_vbyte::decode(buf.data(), buf.data() + size, out.data(),
+                                 out.size()));
+  EXPECT_EQ(in, out);
+}
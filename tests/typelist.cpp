@@ -53,6 +53,10 @@ using T5 = TL5::to<std::tuple>;
 using T6 = TL6::to<std::tuple>;
 using T7 = TL7::to<std::tuple>;
 
+static_assert(0 == TL1::size(), "");
+static_assert(2 == TL5::size(), "");
+static_assert(5 == TL7::size(), "");
+
 static_assert(0 == std::tuple_size<T1>::value, "");
 static_assert(1 == std::tuple_size<T2>::value, "");
 static_assert(2 == std::tuple_size<T3>::value, "");
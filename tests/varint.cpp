@@ -22,6 +22,8 @@
 
 #include "embedded/varint.h"
 
+#include <algorithm>
+#include <array>
 #include <numeric>
 #include <vector>
 
@@ -235,3 +237,187 @@ INSTANTIATE_TYPED_TEST_SUITE_P(varint, varint_test, UnsignedTypes);
 #ifdef __GNUC__
 #pragma GCC diagnostic pop
 #endif
+
+template <typename T>
+void check_pointer_decode(std::vector<uint8_t> const& buf) {
+  using namespace embedded;
+
+  // the pointer version must behave exactly like the iterator version,
+  // including all error cases
+  for (size_t i = 0; i < buf.size(); ++i) {
+    for (size_t n = 0; i + n <= buf.size() && n <= 12; ++n) {
+      T v_it{}, v_ptr{};
+      auto it = varint::decode(v_it, buf.begin() + i, buf.begin() + i + n);
+      auto ptr = varint::decode(v_ptr, buf.data() + i, buf.data() + i + n);
+      ASSERT_EQ(it - buf.begin(), ptr - buf.data()) << i << "/" << n;
+      if (ptr != buf.data() + i) {
+        ASSERT_EQ(v_it, v_ptr) << i << "/" << n;
+      }
+    }
+  }
+}
+
+TEST(varint, pointer_decode) {
+  using namespace embedded;
+
+  std::vector<uint8_t> buf;
+  std::vector<uint64_t> values;
+
+  for (int bits = 0; bits <= 64; ++bits) {
+    auto v = bits == 64 ? ~uint64_t{0} : (uint64_t{1} << bits) - 1;
+    values.push_back(v);
+    values.push_back(v + 1);
+  }
+
+  for (auto v : values) {
+    varint::encode(v, std::back_inserter(buf));
+  }
+
+  // over-long encodings of zero, and an unterminated tail
+  for (int n = 1; n <= 11; ++n) {
+    buf.insert(buf.end(), n, 0x80);
+    buf.push_back(0);
+  }
+  buf.insert(buf.end(), 12, 0xff);
+
+  check_pointer_decode<uint8_t>(buf);
+  check_pointer_decode<uint16_t>(buf);
+  check_pointer_decode<uint32_t>(buf);
+  check_pointer_decode<uint64_t>(buf);
+  check_pointer_decode<int8_t>(buf);
+  check_pointer_decode<int16_t>(buf);
+  check_pointer_decode<int32_t>(buf);
+  check_pointer_decode<int64_t>(buf);
+
+  auto p = buf.data();
+  auto const end = buf.data() + buf.size();
+  for (auto v : values) {
+    uint64_t out;
+    auto next = varint::decode(out, p, end);
+    ASSERT_NE(p, next);
+    EXPECT_EQ(v, out);
+    p = next;
+  }
+}
+
+TEST(varint, batch) {
+  using namespace embedded;
+
+  std::vector<int32_t> values;
+  for (int bits = 0; bits < 32; ++bits) {
+    values.push_back(static_cast<int32_t>(uint32_t{1} << bits));
+    values.push_back(static_cast<int32_t>(0u - (uint32_t{1} << bits)));
+    values.push_back(static_cast<int32_t>((uint32_t{1} << bits) - 1));
+  }
+
+  size_t expected = 0;
+  for (auto v : values) {
+    expected += varint::size(v);
+  }
+
+  EXPECT_EQ(expected, varint::size_n(values.begin(), values.end()));
+  EXPECT_EQ(1, varint::size_n(values.begin(), values.begin() + 1));
+  EXPECT_EQ(0, varint::size_n(values.begin(), values.begin()));
+
+  std::vector<uint64_t> u64{0, 127, 128, ~uint64_t{0}, uint64_t{1} << 63,
+                            (uint64_t{1} << 56) - 1, uint64_t{1} << 56};
+  EXPECT_EQ(1 + 1 + 2 + 10 + 10 + 8 + 9,
+            varint::size_n(u64.begin(), u64.end()));
+
+  std::vector<uint8_t> buf(expected);
+
+  // not enough space, nothing is written
+  EXPECT_TRUE(varint::encode_n(values.begin(), values.end(), buf.begin(),
+                               buf.end() - 1) == buf.begin());
+  EXPECT_TRUE(std::all_of(buf.begin(), buf.end(),
+                          [](uint8_t b) { return b == 0; }));
+
+  EXPECT_TRUE(varint::encode_n(values.begin(), values.end(), buf.begin(),
+                               buf.end()) == buf.end());
+
+  std::vector<int32_t> out(values.size());
+  EXPECT_EQ(buf.data() + buf.size(),
+            varint::decode_n(buf.data(), buf.data() + buf.size(), out.data(),
+                             out.size()));
+  EXPECT_EQ(values, out);
+
+  // input buffer exhausted
+  EXPECT_EQ(buf.data(), varint::decode_n(buf.data(),
+                                         buf.data() + buf.size() - 1,
+                                         out.data(), out.size()));
+
+  // target type not wide enough
+  std::vector<int16_t> out16(values.size());
+  EXPECT_TRUE(varint::decode_n(buf.begin(), buf.end(), out16.data(),
+                               out16.size()) == buf.begin());
+}
+
+namespace {
+
+template <std::size_t... I>
+constexpr auto encode_squares(embedded::index_sequence<I...>)
+    -> decltype(embedded::varint::encode_array<uint16_t, (I * I)...>()) {
+  return embedded::varint::encode_array<uint16_t, (I * I)...>();
+}
+
+} // namespace
+
+TEST(varint, encode_array) {
+  using namespace embedded;
+
+  constexpr auto table = varint::encode_array<int16_t, 0, -3, 1000, 4711>();
+  static_assert(table.size() == 6, "unexpected size");
+
+  std::vector<uint8_t> expected(6);
+  auto it = expected.begin();
+  for (int16_t v : {0, -3, 1000, 4711}) {
+    it = varint::encode(v, it);
+  }
+  EXPECT_TRUE(std::equal(table.begin(), table.end(), expected.begin()));
+
+  std::vector<int16_t> out;
+  for (auto v : varint_view<int16_t>(table)) {
+    out.push_back(v);
+  }
+  EXPECT_EQ((std::vector<int16_t>{0, -3, 1000, 4711}), out);
+
+  constexpr auto one = varint::encode_array<uint64_t, ~uint64_t{0}>();
+  static_assert(one.size() == 10, "unexpected size");
+  EXPECT_EQ(0xFF, one[0]);
+  EXPECT_EQ(0x01, one[9]);
+
+  // 0..99 squared: 12 values with one byte, 88 with two bytes
+  static constexpr auto squares = encode_squares(make_index_sequence<100>{});
+  static_assert(squares.size() == 12 + 2 * 88, "unexpected size");
+  varint_view<uint16_t> view(squares.data(), squares.data() + squares.size());
+  uint16_t i = 0;
+  for (auto v : view) {
+    EXPECT_EQ(i * i, v);
+    ++i;
+  }
+  EXPECT_EQ(100, i);
+}
+
+TEST(varint, iterator) {
+  using namespace embedded;
+
+  std::vector<uint8_t> buf{0x01, 0xFF, 0x7F, 0x80};
+  varint_view<uint8_t, std::vector<uint8_t>::const_iterator> view(
+      buf.cbegin(), buf.cend());
+
+  auto it = view.begin();
+  EXPECT_EQ(1, *it);
+  EXPECT_TRUE(it.base() == buf.cbegin());
+  auto prev = it++;
+  EXPECT_EQ(1, *prev);
+
+  // 0xFF 0x7F doesn't fit into 8 bits, iteration stops there
+  EXPECT_TRUE(it == view.end());
+  EXPECT_EQ(1, std::distance(view.begin(), view.end()));
+
+  // incomplete encoding at the end
+  varint_view<uint16_t, std::vector<uint8_t>::const_iterator> view16(
+      buf.cbegin(), buf.cend());
+  std::vector<uint16_t> out(view16.begin(), view16.end());
+  EXPECT_EQ((std::vector<uint16_t>{1, 0x3FFF}), out);
+}
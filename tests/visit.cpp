@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) Marcus Holland-Moritz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "embedded/variant.h"
+#include "embedded/visit.h"
+
+#include <gtest/gtest.h>
+
+using namespace embedded;
+
+namespace {
+
+template <int I>
+struct msg {
+  int value;
+};
+
+struct index_of {
+  template <int I>
+  int operator()(msg<I> const& m) const {
+    return 100 * I + m.value;
+  }
+};
+
+struct ref_kind {
+  template <typename T>
+  int operator()(T&) const {
+    return 1;
+  }
+
+  template <typename T>
+  int operator()(T const&) const {
+    return 2;
+  }
+
+  template <typename T>
+  int operator()(T&&) const {
+    return 3;
+  }
+};
+
+struct doubler {
+  template <typename T>
+  void operator()(T& x) const {
+    x += x;
+  }
+};
+
+struct mover {
+  std::string& out;
+
+  void operator()(int) const {}
+  void operator()(std::string&& x) const { out = std::move(x); }
+};
+
+template <typename Variant, int I>
+int check() {
+  Variant const v(msg<I>{7});
+  EXPECT_EQ(100 * I + 7, flat_visit(index_of{}, v));
+  return 0;
+}
+
+template <typename Variant, std::size_t... Is>
+void test_all(index_sequence<Is...>) {
+  using expand = int[];
+  static_cast<void>(expand{0, check<Variant, static_cast<int>(Is)>()...});
+}
+
+} // namespace
+
+TEST(visit, alternatives) {
+  using list = variant_alternatives<variant<int, char, msg<0>>>::type;
+  static_assert(std::is_same<list, typelist<int, char, msg<0>>>::value, "");
+  static_assert(list::size() == 3, "");
+}
+
+TEST(visit, switch_dispatch) {
+  test_all<variant<msg<0>>>(make_index_sequence<1>{});
+  test_all<variant<msg<0>, msg<1>, msg<2>>>(make_index_sequence<3>{});
+  test_all<variant<msg<0>, msg<1>, msg<2>, msg<3>, msg<4>, msg<5>, msg<6>,
+                   msg<7>>>(make_index_sequence<8>{});
+}
+
+TEST(visit, table_dispatch) {
+  test_all<variant<msg<0>, msg<1>, msg<2>, msg<3>, msg<4>, msg<5>, msg<6>,
+                   msg<7>, msg<8>>>(make_index_sequence<9>{});
+  test_all<variant<msg<0>, msg<1>, msg<2>, msg<3>, msg<4>, msg<5>, msg<6>,
+                   msg<7>, msg<8>, msg<9>, msg<10>, msg<11>, msg<12>,
+                   msg<13>, msg<14>, msg<15>, msg<16>>>(
+      make_index_sequence<17>{});
+}
+
+TEST(visit, value_category) {
+  using var = variant<int, std::string>;
+  var v{std::string("abc")};
+  var const& cv = v;
+
+  EXPECT_EQ(1, flat_visit(ref_kind{}, v));
+  EXPECT_EQ(2, flat_visit(ref_kind{}, cv));
+  EXPECT_EQ(3, flat_visit(ref_kind{}, std::move(v)));
+
+  // modify in place
+  var w{std::string("abc")};
+  flat_visit(doubler{}, w);
+  EXPECT_EQ("abcabc", get<std::string>(w));
+
+  // move out of an rvalue
+  std::string moved;
+  flat_visit(mover{moved}, std::move(w));
+  EXPECT_EQ("abcabc", moved);
+  EXPECT_TRUE(get<std::string>(w).empty());
+}